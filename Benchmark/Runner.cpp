@@ -1,19 +1,39 @@
 #include "Printer.hpp"
 #include "CharConv.hpp"
+#include "CSVColumns.hpp"
+#include "CSVParallel.hpp"
+#include "CSVParser.hpp"
+#include "CSVReader.hpp"
+#include "CSVWriter.hpp"
 #include "String.hpp"
 #include "Vector.hpp"
 #include "Enumerate.hpp"
+#include "JSONBinding.hpp"
 #include "JSONParser.hpp"
+#include "JSONQuery.hpp"
+#include "JSONStructural.hpp"
+#include "JSONCompact.hpp"
+#include "JSONLines.hpp"
+#include "JSONOnDemand.hpp"
+#include "JSONStreamReader.hpp"
+#include "JSONWriter.hpp"
 #include "Array.hpp"
 #include "Chrono.hpp"
 #include "Assertion.hpp"
 #include "Set.hpp"
 #include "FlatSet.hpp"
 #include "FlatMap.hpp"
+#include "Parallel.hpp"
+#include "Random.hpp"
+#include "Regex.hpp"
+#include "CompileTimeRegex.hpp"
+#include "AsyncFileIO.hpp"
 #include <benchmark/benchmark.h>
 #include <inttypes.h>
 #include <unordered_map>
 #include <unordered_set>
+#include <algorithm>
+#include <regex>
 
 using namespace ARLib;
 static void BM_ARLibSprintf(benchmark::State& state) {
@@ -38,6 +58,78 @@ static void BM_StdSprintf(benchmark::State& state) {
         benchmark::ClobberMemory();
     }
 }
+// geo coordinate like values, shortest representation so most of them have 15-17 significant digits
+static Vector<String> make_double_corpus() {
+    auto rng = Random::PCG::create();
+    Vector<String> values{};
+    values.reserve(10000);
+    for (size_t i = 0; i < 10000; ++i) {
+        const double unit = static_cast<double>(rng.random()) / static_cast<double>(NumberTraits<uint32_t>::max);
+        values.append(DoubleToShortestStr(unit * 360.0 - 180.0));
+    }
+    return values;
+}
+static void BM_ARLibStrViewToDouble(benchmark::State& state) {
+    const auto values = make_double_corpus();
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& value : values) { sum += StrViewToDouble(value.view()).to_ok(); }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(values.size()));
+}
+static void BM_StdStrtod(benchmark::State& state) {
+    const auto values = make_double_corpus();
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const auto& value : values) { sum += ::strtod(value.data(), nullptr); }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(values.size()));
+}
+// telemetry like column, mostly 10-19 digit values
+static String make_integer_column() {
+    auto rng = Random::PCG::create();
+    String column{};
+    for (size_t i = 0; i < 10000; ++i) {
+        const uint64_t value = (static_cast<uint64_t>(rng.random()) << 31) ^ rng.random();
+        column.append(IntToStr(static_cast<int64_t>(i % 2 == 0 ? value : 0 - value)));
+        column.append('\n');
+    }
+    return column;
+}
+static void BM_ARLibStrViewToI64(benchmark::State& state) {
+    const auto column = make_integer_column();
+    const auto values = column.view().split("\n");
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const auto& value : values) {
+            if (value.size() != 0) sum += StrViewToI64(value).to_ok();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(values.size()));
+}
+static void BM_StdStrtoll(benchmark::State& state) {
+    const auto column = make_integer_column();
+    const auto values = column.view().split("\n");
+    for (auto _ : state) {
+        int64_t sum = 0;
+        // every value is followed by a newline, which stops strtoll
+        for (const auto& value : values) { sum += ::strtoll(value.data(), nullptr, 10); }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(values.size()));
+}
+static void BM_ARLibDelimitedToI64(benchmark::State& state) {
+    const auto column = make_integer_column();
+    for (auto _ : state) {
+        auto values = DelimitedToI64(column.view(), '\n');
+        if (values.is_error()) { ASSERT_NOT_REACHED("Benchmark column failed to convert") }
+        benchmark::DoNotOptimize(values.to_ok());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(column.size()));
+}
 constexpr static const Array strings{
     "XZk6g68IJe"_sv, "xLX1I3D9Ju"_sv, "c8iChK6P5U"_sv, "ke1fjfqM4h"_sv, "C14RwSqFaK"_sv, "ZYApUXmw8i"_sv,
     "NSsOfFyYQw"_sv, "2embvf20ZJ"_sv, "QXreMhn9Rk"_sv, "OyTfRkPoWP"_sv, "kHXnimdjGb"_sv, "mtylTdDHs8"_sv,
@@ -127,10 +219,704 @@ static void BM_ARLibFlatMapInt(benchmark::State& state) {
         if (map.size() != 0) { ASSERT_NOT_REACHED("Map size is wrong") }
     }
 }
+enum class SortInput : int64_t { Random, Sorted, Reversed, ManyDuplicates };
+static Vector<uint32_t> make_sort_input(SortInput kind = SortInput::Random) {
+    constexpr size_t count = 1'000'000;
+    Vector<uint32_t> values{};
+    values.reserve(count);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        switch (kind) {
+            case SortInput::Random: values.append(seed); break;
+            case SortInput::Sorted: values.append(static_cast<uint32_t>(i)); break;
+            case SortInput::Reversed: values.append(static_cast<uint32_t>(count - i)); break;
+            case SortInput::ManyDuplicates: values.append(seed % 16); break;
+        }
+    }
+    return values;
+}
+template <typename Sorter>
+static void run_sort_benchmark(benchmark::State& state, Sorter&& sorter) {
+    const auto input = make_sort_input(static_cast<SortInput>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Vector<uint32_t> values = input;
+        state.ResumeTiming();
+        sorter(values);
+        benchmark::DoNotOptimize(values.data());
+    }
+}
+static void BM_ARLibSort(benchmark::State& state) {
+    run_sort_benchmark(state, [](Vector<uint32_t>& values) { sort(values); });
+}
+static void BM_ARLibStableSort(benchmark::State& state) {
+    run_sort_benchmark(state, [](Vector<uint32_t>& values) { stable_sort(values); });
+}
+static void BM_ARLibRadixSort(benchmark::State& state) {
+    run_sort_benchmark(state, [](Vector<uint32_t>& values) { radix_sort(values); });
+}
+static void BM_StdSort(benchmark::State& state) {
+    run_sort_benchmark(state, [](Vector<uint32_t>& values) { std::sort(&values[0], &values[0] + values.size()); });
+}
+static void BM_ARLibParallelSort(benchmark::State& state) {
+    const auto input = make_sort_input();
+    for (auto _ : state) {
+        state.PauseTiming();
+        Vector<uint32_t> values = input;
+        state.ResumeTiming();
+        parallel::sort(values);
+        benchmark::DoNotOptimize(values.data());
+    }
+}
+static void BM_ARLibParallelTransformReduce(benchmark::State& state) {
+    const auto input = make_sort_input();
+    for (auto _ : state) {
+        auto sum = parallel::transform_reduce(
+        input, uint64_t{ 0 }, [](uint64_t a, uint64_t b) { return a + b; }, [](uint32_t v) { return uint64_t{ v }; }
+        );
+        benchmark::DoNotOptimize(sum);
+    }
+}
+// synthetic stand-ins shaped like the usual json corpora, the real files aren't vendored
+// twitter.json: lots of short strings with escapes, canada.json: huge arrays of doubles, citm_catalog.json: integer heavy
+enum class JsonCorpus : int64_t { Twitter, Canada, CitmCatalog };
+static String make_json_corpus(JsonCorpus kind) {
+    uint32_t seed = 12345;
+    auto next     = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    String json{};
+    switch (kind) {
+        case JsonCorpus::Twitter:
+            json.append(R"({"statuses": [)");
+            for (size_t i = 0; i < 600; ++i) {
+                if (i != 0) json.append(", ");
+                json.append(String::formatted(
+                R"({"id": %u%u, "id_str": "%u", "text": "@user%u \u3042\u3044 RT \"quoted\" https:\/\/t.co\/%u\n",)",
+                next(), next(), next(), next() % 1000, next()
+                ));
+                json.append(String::formatted(
+                R"( "user": {"id": %u, "name": "name %u", "screen_name": "screen_%u", "followers_count": %u,)", next(),
+                next(), next(), next() % 100000
+                ));
+                json.append(R"( "description": "some fairly long profile description text", "verified": false,)");
+                json.append(R"( "profile_image_url": "http:\/\/a0.twimg.com\/profile_images\/1\/a_normal.png"},)");
+                json.append(String::formatted(
+                R"( "entities": {"hashtags": [], "urls": [{"url": "x", "indices": [%u, %u]}]}, "retweet_count": %u,)",
+                next() % 140, next() % 140, next() % 500
+                ));
+                json.append(R"( "favorited": false, "in_reply_to_status_id": null, "lang": "ja"})");
+            }
+            json.append(R"(], "search_metadata": {"completed_in": 0.087, "count": 600}})");
+            break;
+        case JsonCorpus::Canada:
+            json.append(R"({"type": "FeatureCollection", "features": [{"type": "Feature", "properties": {"name": "Canada"},)");
+            json.append(R"( "geometry": {"type": "Polygon", "coordinates": [)");
+            for (size_t ring = 0; ring < 40; ++ring) {
+                if (ring != 0) json.append(',');
+                json.append('[');
+                for (size_t point = 0; point < 1400; ++point) {
+                    if (point != 0) json.append(',');
+                    json.append(String::formatted(
+                    "[-%u.%09u%06u,%u.%09u%06u]", 50 + next() % 90, next() % 1000000000, next() % 1000000,
+                    40 + next() % 40, next() % 1000000000, next() % 1000000
+                    ));
+                }
+                json.append(']');
+            }
+            json.append("]}}]}");
+            break;
+        case JsonCorpus::CitmCatalog:
+            json.append(R"({"events": {)");
+            for (size_t i = 0; i < 3000; ++i) {
+                const auto id = 138586341u + static_cast<uint32_t>(i);
+                if (i != 0) json.append(", ");
+                json.append(String::formatted(
+                R"("%u": {"id": %u, "name": "Event %zu", "logo": null, "subjectCode": null, "subtitle": null,)", id,
+                id, i
+                ));
+                json.append(String::formatted(
+                R"( "subTopicIds": [%u, %u, %u], "topicIds": [%u, %u]})", next(), next(), next(), next(), next()
+                ));
+            }
+            json.append(R"(}, "performances": [)");
+            for (size_t i = 0; i < 2500; ++i) {
+                if (i != 0) json.append(", ");
+                json.append(String::formatted(
+                R"({"id": %u, "eventId": %u, "logo": "\/images\/UE0AAAAACEKo6QAAAAVDSVRN", "name": null, "prices": [)",
+                next(), next()
+                ));
+                for (size_t price = 0; price < 4; ++price) {
+                    if (price != 0) json.append(", ");
+                    json.append(String::formatted(
+                    R"({"amount": %u, "audienceSubCategoryId": 337100890, "seatCategoryId": %u})", next() % 100000,
+                    next()
+                    ));
+                }
+                json.append(String::formatted(
+                R"(], "seatMapImage": null, "start": %u000, "venueCode": "PLEYEL_PLEYEL"})", next()
+                ));
+            }
+            json.append("]}");
+            break;
+    }
+    return json;
+}
+template <typename ParseFn>
+static void run_json_benchmark(benchmark::State& state, ParseFn&& parse) {
+    const auto json = make_json_corpus(static_cast<JsonCorpus>(state.range(0)));
+    for (auto _ : state) {
+        auto document = parse(json.view());
+        if (document.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        benchmark::DoNotOptimize(document.to_ok());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(json.size()));
+}
+static void BM_JSONParser(benchmark::State& state) {
+    run_json_benchmark(state, [](StringView view) { return JSON::Parser::parse(view); });
+}
+static void BM_JSONStructuralParser(benchmark::State& state) {
+    run_json_benchmark(state, [](StringView view) { return JSON::StructuralParser::parse(view); });
+}
+static void BM_JSONCompactDocument(benchmark::State& state) {
+    run_json_benchmark(state, [](StringView view) { return JSON::CompactDocument::parse(view); });
+}
+static void BM_JSONStructuralIndex(benchmark::State& state) {
+    run_json_benchmark(state, [](StringView view) { return JSON::StructuralIndex::build(view); });
+}
+// pulls a couple of fields out of the twitter corpus, everything else just gets skipped over
+static void BM_JSONOnDemandFewFields(benchmark::State& state) {
+    const auto json = make_json_corpus(JsonCorpus::Twitter);
+    for (auto _ : state) {
+        auto document = JSON::OnDemandDocument::parse(json.view()).to_ok();
+        auto root     = document.root();
+        auto count    = root["search_metadata"_sv]["count"_sv].get_int64();
+        auto name     = root["statuses"_sv][0]["user"_sv]["screen_name"_sv].get_string_view();
+        if (count.is_error() || name.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        benchmark::DoNotOptimize(count.to_ok());
+        benchmark::DoNotOptimize(name.to_ok());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(json.size()));
+}
+static void BM_JSONStreamReader(benchmark::State& state) {
+    const auto json = make_json_corpus(static_cast<JsonCorpus>(state.range(0)));
+    JSON::SaxHandler handler{};
+    for (auto _ : state) {
+        JSON::StreamReader reader{ handler };
+        for (size_t pos = 0; pos < json.size(); pos += JSON::StreamReader::default_chunk_size) {
+            auto res = reader.feed(json.view().substringview_fromlen(pos, JSON::StreamReader::default_chunk_size));
+            if (res.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        }
+        if (reader.finish().is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(json.size()));
+}
+// serializes the parsed corpus back to compact json, throughput is measured on the output
+static void BM_JSONWriter(benchmark::State& state) {
+    const auto json = make_json_corpus(static_cast<JsonCorpus>(state.range(0)));
+    auto document   = JSON::CompactDocument::parse(json.view()).to_ok();
+    size_t written  = 0;
+    for (auto _ : state) {
+        JSON::Writer writer{};
+        writer.value(document.root());
+        written = writer.str().size();
+        benchmark::DoNotOptimize(writer.str().data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(written));
+}
+static void BM_JSONDumpCompact(benchmark::State& state) {
+    const auto json = make_json_corpus(static_cast<JsonCorpus>(state.range(0)));
+    auto document   = JSON::StructuralParser::parse(json.view()).to_ok();
+    size_t written  = 0;
+    for (auto _ : state) {
+        auto dumped = JSON::dump_json_compact(document.root());
+        written     = dumped.size();
+        benchmark::DoNotOptimize(dumped.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(written));
+}
+// the performances of the citm corpus decoded into structs, without and with a Document in between
+struct CitmPrice {
+    int64_t amount;
+    int64_t seat_category_id;
+};
+struct CitmPerformance {
+    int64_t id;
+    int64_t event_id;
+    Optional<String> name;
+    Vector<CitmPrice> prices;
+    int64_t start;
+    String venue_code;
+};
+struct CitmCatalog {
+    Vector<CitmPerformance> performances;
+};
+template <>
+struct ARLib::JSON::Binding<CitmPrice> {
+    constexpr static auto fields = JSON::fields(
+    JSON::field("amount", &CitmPrice::amount), JSON::field("seatCategoryId", &CitmPrice::seat_category_id)
+    );
+};
+template <>
+struct ARLib::JSON::Binding<CitmPerformance> {
+    constexpr static auto fields = JSON::fields(
+    JSON::field("id", &CitmPerformance::id), JSON::field("eventId", &CitmPerformance::event_id),
+    JSON::field("name", &CitmPerformance::name), JSON::field("prices", &CitmPerformance::prices),
+    JSON::field("start", &CitmPerformance::start), JSON::field("venueCode", &CitmPerformance::venue_code)
+    );
+};
+template <>
+struct ARLib::JSON::Binding<CitmCatalog> {
+    constexpr static auto fields = JSON::fields(JSON::field("performances", &CitmCatalog::performances));
+};
+static void BM_JSONBinding(benchmark::State& state) {
+    const auto json = make_json_corpus(JsonCorpus::CitmCatalog);
+    for (auto _ : state) {
+        auto catalog = JSON::from_json<CitmCatalog>(json.view());
+        if (catalog.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        benchmark::DoNotOptimize(catalog.to_ok().performances.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(json.size()));
+}
+static void BM_JSONBindingViaDocument(benchmark::State& state) {
+    const auto json = make_json_corpus(JsonCorpus::CitmCatalog);
+    for (auto _ : state) {
+        auto document = JSON::StructuralParser::parse(json.view());
+        if (document.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        const auto doc = document.to_ok();
+        CitmCatalog catalog{};
+        for (const auto& item : doc.root()["performances"_sv].as<JSON::Type::JArray>()) {
+            const auto& object = item->as<JSON::Type::JObject>();
+            CitmPerformance performance{};
+            performance.id       = object["id"_sv].as<JSON::Type::JNumber>().value_integer();
+            performance.event_id = object["eventId"_sv].as<JSON::Type::JNumber>().value_integer();
+            if (object["name"_sv].type() == JSON::Type::JString) {
+                performance.name = object["name"_sv].as<JSON::Type::JString>();
+            }
+            for (const auto& price : object["prices"_sv].as<JSON::Type::JArray>()) {
+                const auto& price_object = price->as<JSON::Type::JObject>();
+                performance.prices.append(CitmPrice{
+                price_object["amount"_sv].as<JSON::Type::JNumber>().value_integer(),
+                price_object["seatCategoryId"_sv].as<JSON::Type::JNumber>().value_integer() });
+            }
+            performance.start      = object["start"_sv].as<JSON::Type::JNumber>().value_integer();
+            performance.venue_code = object["venueCode"_sv].as<JSON::Type::JString>();
+            catalog.performances.append(move(performance));
+        }
+        benchmark::DoNotOptimize(catalog.performances.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(json.size()));
+}
+// the same 50 lookups done on every iteration, like a router would on every message
+static void BM_JSONQueryPrecompiled(benchmark::State& state) {
+    const auto json = make_json_corpus(JsonCorpus::Twitter);
+    auto document   = JSON::StructuralParser::parse(json.view()).to_ok();
+    Vector<JSON::Query> queries{};
+    for (size_t i = 0; i < 50; ++i) {
+        const auto pointer = String::formatted("/statuses/%zu/user/screen_name", i * 10);
+        queries.append(JSON::Query::pointer(pointer.view()).to_ok());
+    }
+    for (auto _ : state) {
+        size_t total = 0;
+        for (const auto& query : queries) { total += query.find(document.root())->as<JSON::Type::JString>().size(); }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 50);
+}
+static void BM_JSONQueryOperatorIndex(benchmark::State& state) {
+    const auto json     = make_json_corpus(JsonCorpus::Twitter);
+    const auto document = JSON::StructuralParser::parse(json.view()).to_ok();
+    for (auto _ : state) {
+        size_t total = 0;
+        for (size_t i = 0; i < 50; ++i) {
+            const auto& name = document.root()["statuses"_sv][i * 10]["user"_sv]["screen_name"_sv];
+            total += name.as<JSON::Type::JString>().size();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 50);
+}
+// the twitter corpus split back into its statuses, one per line
+static String make_json_lines() {
+    const auto corpus = make_json_corpus(JsonCorpus::Twitter);
+    auto document     = JSON::OnDemandDocument::parse(corpus.view()).to_ok();
+    String lines{};
+    for (size_t repeat = 0; repeat < 8; ++repeat) {
+        auto res = document.root()["statuses"_sv].for_each_element([&lines](const JSON::OnDemandValue& status) {
+            lines.append(status.get_raw_view().to_ok());
+            lines.append('\n');
+        });
+        if (res.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+    }
+    return lines;
+}
+static void BM_JSONLines(benchmark::State& state) {
+    const auto lines = make_json_lines();
+    JSON::LinesOptions options{};
+    options.ordered = state.range(0) == 1;
+    for (auto _ : state) {
+        Atomic<size_t> members{ 0 };
+        auto res = JSON::LinesParser::parse(lines.view(), [&members](size_t, JSON::CompactValue value) {
+            members.fetch_add(value.size(), MemoryOrder::Relaxed);
+        }, options);
+        if (res.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        benchmark::DoNotOptimize(members.load());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(lines.size()));
+}
+static void BM_JSONLinesSequential(benchmark::State& state) {
+    const auto lines = make_json_lines();
+    for (auto _ : state) {
+        size_t members = 0;
+        size_t pos     = 0;
+        while (pos < lines.size()) {
+            const size_t end = lines.index_of('\n', pos);
+            auto document    = JSON::CompactDocument::parse(lines.view().substringview(pos, end));
+            if (document.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+            members += document.to_ok().root().size();
+            pos = end + 1;
+        }
+        benchmark::DoNotOptimize(members);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(lines.size()));
+}
+// 5000 rows of mixed fields, a few of them quoted and some with escaped quotes or newlines inside
+static String make_csv_corpus() {
+    String csv{ "id,name,price,description,city\n" };
+    for (size_t i = 0; i < 5000; ++i) {
+        csv.append(String::formatted("%zu,item %zu,%zu.%02zu,", i, i * 7, i % 1000, i % 100));
+        if (i % 10 == 0) {
+            csv.append("\"a \"\"quoted\"\" description, with a comma\""_sv);
+        } else if (i % 25 == 0) {
+            csv.append("\"two\nlines\""_sv);
+        } else {
+            csv.append("plain description of the item"_sv);
+        }
+        csv.append(",Some City\n"_sv);
+    }
+    return csv;
+}
+static void BM_CSVReader(benchmark::State& state) {
+    const auto csv = make_csv_corpus();
+    for (auto _ : state) {
+        CSVReader reader{ csv.view() };
+        size_t total = 0;
+        auto res     = reader.for_each_row([&total](Span<const StringView> row) { total += row[3].size(); });
+        if (res.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(csv.size()));
+}
+static void BM_CSVParser(benchmark::State& state) {
+    const auto csv = make_csv_corpus();
+    for (auto _ : state) {
+        CSVParser parser{ csv };
+        if (parser.open().is_error()) { ASSERT_NOT_REACHED("Couldn't open the benchmark corpus") }
+        size_t total = 0;
+        auto rows    = parser.read_all();
+        if (rows.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        for (auto& row : rows.to_ok()) { total += row.to_ok()[3].size(); }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(csv.size()));
+}
+// the csv corpus repeated until it's big enough to be worth splitting
+static String make_large_csv_corpus() {
+    const auto csv = make_csv_corpus();
+    String large{};
+    for (size_t i = 0; i < 40; ++i) { large.append(csv.view()); }
+    return large;
+}
+static void BM_CSVParallel(benchmark::State& state) {
+    const auto csv = make_large_csv_corpus();
+    CSVParallelOptions options{};
+    options.chunk_size = 1024 * 1024;
+    options.ordered    = state.range(0) == 1;
+    for (auto _ : state) {
+        Atomic<size_t> total{ 0 };
+        auto res = CSVParallelParser::parse(csv.view(), [&total](size_t, Span<const StringView> row) {
+            total.fetch_add(row[3].size(), MemoryOrder::Relaxed);
+        }, options);
+        if (res.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        benchmark::DoNotOptimize(total.load());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(csv.size()));
+}
+static void BM_CSVParallelSequential(benchmark::State& state) {
+    const auto csv = make_large_csv_corpus();
+    for (auto _ : state) {
+        CSVReader reader{ csv.view() };
+        size_t total = 0;
+        auto res     = reader.for_each_row([&total](Span<const StringView> row) { total += row[3].size(); });
+        if (res.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(csv.size()));
+}
+// the large corpus read from a file, into a String like File::read_all does (0) or mapped (1)
+static void BM_CSVReaderFromFile(benchmark::State& state) {
+    const auto csv = make_large_csv_corpus();
+    const Path path{ "csv_reader_benchmark.csv"_p };
+    if (File::write_all(path, csv).is_error()) { ASSERT_NOT_REACHED("Couldn't write the benchmark corpus") }
+    for (auto _ : state) {
+        size_t total = 0;
+        auto count   = [&total](Span<const StringView> row) { total += row[3].size(); };
+        if (state.range(0) == 0) {
+            const auto contents = File::read_all(path).to_ok();
+            CSVReader reader{ contents.view() };
+            if (reader.for_each_row(count).is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        } else {
+            auto reader = CSVReader::from_file(path).to_ok();
+            if (reader.for_each_row(count).is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    File::remove(path);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(csv.size()));
+}
+static void BM_CSVTable(benchmark::State& state) {
+    const auto csv = make_csv_corpus();
+    for (auto _ : state) {
+        auto table = CSVTable::parse(csv.view());
+        if (table.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        const auto columns = table.to_ok();
+        double total       = 0.0;
+        for (double price : columns.column(columns.column_index("price"_sv)).doubles()) { total += price; }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(csv.size()));
+}
+// the same sum done on the rows of strings CSVParser gives back
+static void BM_CSVParserSum(benchmark::State& state) {
+    const auto csv = make_csv_corpus();
+    for (auto _ : state) {
+        CSVParser parser{ csv };
+        parser.with_header(true);
+        if (parser.open().is_error()) { ASSERT_NOT_REACHED("Couldn't open the benchmark corpus") }
+        auto rows = parser.read_all();
+        if (rows.is_error()) { ASSERT_NOT_REACHED("Benchmark corpus failed to parse") }
+        double total = 0.0;
+        for (auto& row : rows.to_ok()) { total += StrViewToDouble(row.to_ok()["price"_sv].to_ok().view()).to_ok(); }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(csv.size()));
+}
+// 0 writes the corpus a row at a time, 1 writes it back from a CSVTable
+static void BM_CSVWriter(benchmark::State& state) {
+    const auto csv   = make_csv_corpus();
+    const auto table = CSVTable::parse(csv.view()).to_ok();
+    size_t written   = 0;
+    for (auto _ : state) {
+        CSVWriter writer{};
+        if (state.range(0) == 0) {
+            for (size_t i = 0; i < 5000; ++i) {
+                const auto description = i % 10 == 0 ? "a \"quoted\" description, with a comma"_sv
+                                                     : "plain description of the item"_sv;
+                writer.row(i, "item"_sv, static_cast<double>(i % 1000) + 0.25, description, "Some City"_sv);
+            }
+        } else {
+            writer.table(table);
+        }
+        written = writer.str().size();
+        benchmark::DoNotOptimize(writer.str().data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(written));
+}
+// 20000 lines of a service log, a quarter of them errors
+static String make_log_corpus() {
+    const Array levels{ "INFO"_sv, "WARN"_sv, "ERROR"_sv, "DEBUG"_sv };
+    String logs{};
+    for (size_t i = 0; i < 20000; ++i) {
+        logs.append(String::formatted("2024-05-%02zu 12:%02zu:%02zu [", i % 28 + 1, i % 60, (i * 7) % 60));
+        logs.append(levels[i % 4]);
+        logs.append(String::formatted("] worker-%zu: request %zu finished in %zu ms\n", i % 16, i, (i * 13) % 1000));
+    }
+    return logs;
+}
+constexpr static auto log_filter_pattern = "\\[ERROR\\] worker-1[0-5]: .* in \\d{3} ms";
+// the lines of the log that match, one line at a time
+static void BM_RegexLogFilter(benchmark::State& state) {
+    const auto logs  = make_log_corpus();
+    const auto regex = MUST(Regex::create(StringView{ log_filter_pattern }));
+    for (auto _ : state) {
+        size_t matching = 0;
+        size_t pos      = 0;
+        while (pos < logs.size()) {
+            const size_t end = logs.index_of('\n', pos);
+            if (regex.contains(logs.view().substringview(pos, end))) ++matching;
+            pos = end + 1;
+        }
+        benchmark::DoNotOptimize(matching);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(logs.size()));
+}
+static void BM_StdRegexLogFilter(benchmark::State& state) {
+    const auto logs = make_log_corpus();
+    const std::regex regex{ log_filter_pattern };
+    for (auto _ : state) {
+        size_t matching = 0;
+        size_t pos      = 0;
+        while (pos < logs.size()) {
+            const size_t end = logs.index_of('\n', pos);
+            if (std::regex_search(logs.data() + pos, logs.data() + end, regex)) ++matching;
+            pos = end + 1;
+        }
+        benchmark::DoNotOptimize(matching);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(logs.size()));
+}
+// every match in the whole log at once
+static void BM_RegexFindAll(benchmark::State& state) {
+    const auto logs  = make_log_corpus();
+    const auto regex = MUST(Regex::create(StringView{ log_filter_pattern }));
+    for (auto _ : state) {
+        size_t matches = 0;
+        for (const auto& match : regex.find_all(logs.view())) { matches += match.size(); }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(logs.size()));
+}
+// a pattern that matches a handful of lines in the whole log, with its literal at the start (0), a few bytes into
+// the match (1) or with no literal at all (2)
+static void BM_RegexRareMatch(benchmark::State& state) {
+    const Array patterns{ "request 1234\\d finished"_sv, "\\d\\d \\[ERROR\\] worker-\\d+: request 1234\\d"_sv,
+                          "[a-z]+[ ][1][2][3][4]\\d[ ][a-z]+"_sv };
+    const auto logs  = make_log_corpus();
+    const auto regex = MUST(Regex::create(patterns[static_cast<size_t>(state.range(0))]));
+    for (auto _ : state) {
+        size_t matches = 0;
+        for (const auto& match : regex.find_all(logs.view())) { matches += match.size(); }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(logs.size()));
+}
+// 500 patterns, each one looking for other requests in the log. plain literals or regexes
+static Vector<String> make_request_patterns(bool plain) {
+    Vector<String> patterns{};
+    for (size_t i = 0; i < 500; ++i) {
+        if (plain) {
+            patterns.append(String::formatted("request %zu finished", i * 37 + 5));
+        } else {
+            patterns.append(String::formatted("request %zu[0-9]? finished in \\d+ ms", i * 37 + 5));
+        }
+    }
+    return patterns;
+}
+// every line of the log against every pattern, with a set (0: regexes, 1: plain literals) or one regex at a time (2)
+static void BM_RegexSetLogLines(benchmark::State& state) {
+    const auto logs     = make_log_corpus();
+    const auto patterns = make_request_patterns(state.range(0) == 1);
+    Vector<StringView> views{};
+    for (const auto& pattern : patterns) views.append(pattern.view());
+    const auto set = MUST(RegexSet::create(Span<const StringView>{ views.data(), views.size() }));
+    Vector<size_t> matched{};
+    for (auto _ : state) {
+        size_t matches = 0;
+        size_t pos     = 0;
+        while (pos < logs.size()) {
+            const size_t end = logs.index_of('\n', pos);
+            const auto line  = logs.view().substringview(pos, end);
+            if (state.range(0) == 2) {
+                for (size_t i = 0; i < set.size(); ++i) matches += set.regex(i).contains(line);
+            } else {
+                set.matches(line, matched);
+                matches += matched.size();
+            }
+            pos = end + 1;
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(logs.size()));
+}
+// every word of the log checked against a date pattern, with a Regex (0) or with the pattern parsed while
+// compiling (1)
+static void BM_RegexMatchWords(benchmark::State& state) {
+    const auto logs       = make_log_corpus();
+    const auto regex      = "\\d{4}-\\d{2}-\\d{2}"_re;
+    constexpr auto& cx    = cx_regex<"\\d{4}-\\d{2}-\\d{2}">;
+    const bool at_compile = state.range(0) == 1;
+    for (auto _ : state) {
+        size_t dates = 0;
+        size_t pos   = 0;
+        while (pos < logs.size()) {
+            size_t end = pos;
+            while (end < logs.size() && logs[end] != ' ' && logs[end] != '\n') ++end;
+            const auto word = logs.view().substringview(pos, end);
+            dates += at_compile ? cx.match(word) : regex.match(word);
+            pos = end + 1;
+        }
+        benchmark::DoNotOptimize(dates);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(logs.size()));
+}
+// 1000 files of 4 KiB read whole and kept, one after the other (0), through io_uring (1) and through the thread
+// pool fallback (2)
+static void BM_ReadSmallFiles(benchmark::State& state) {
+    Vector<Path> paths{};
+    const String contents{ 4096, 'x' };
+    for (size_t i = 0; i < 1000; ++i) {
+        paths.append(Path{ String::formatted("async_io_benchmark_%zu.txt", i) });
+        if (File::write_all(paths[i], contents).is_error()) { ASSERT_NOT_REACHED("Couldn't write the benchmark files") }
+    }
+    AsyncFileIO io{ { .queue_depth = 64, .force_thread_pool = state.range(0) == 2 } };
+    for (auto _ : state) {
+        Vector<String> files{};
+        if (state.range(0) == 0) {
+            for (const auto& path : paths) files.append(File::read_all(path).to_ok());
+        } else {
+            files = io.read_files(Span<const Path>{ paths.data(), paths.size() }).to_ok();
+        }
+        benchmark::DoNotOptimize(files.data());
+    }
+    for (const auto& path : paths) File::remove(path);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(paths.size()));
+}
 BENCHMARK(BM_StdSprintf);
 BENCHMARK(BM_ARLibSprintf);
+BENCHMARK(BM_ARLibStrViewToDouble);
+BENCHMARK(BM_StdStrtod);
+BENCHMARK(BM_ARLibStrViewToI64);
+BENCHMARK(BM_StdStrtoll);
+BENCHMARK(BM_ARLibDelimitedToI64);
 BENCHMARK(BM_StdUnorderedMapStringView);
 BENCHMARK(BM_StdUnorderedMapInt);
 BENCHMARK(BM_ARLibFlatMapStringView);
 BENCHMARK(BM_ARLibFlatMapInt);
+BENCHMARK(BM_ARLibSort)->DenseRange(0, 3);
+BENCHMARK(BM_ARLibStableSort)->DenseRange(0, 3);
+BENCHMARK(BM_ARLibRadixSort)->DenseRange(0, 3);
+BENCHMARK(BM_StdSort)->DenseRange(0, 3);
+BENCHMARK(BM_ARLibParallelSort);
+BENCHMARK(BM_ARLibParallelTransformReduce);
+BENCHMARK(BM_JSONParser)->DenseRange(0, 2);
+BENCHMARK(BM_JSONStructuralParser)->DenseRange(0, 2);
+BENCHMARK(BM_JSONCompactDocument)->DenseRange(0, 2);
+BENCHMARK(BM_JSONStructuralIndex)->DenseRange(0, 2);
+BENCHMARK(BM_JSONOnDemandFewFields);
+BENCHMARK(BM_JSONStreamReader)->DenseRange(0, 2);
+BENCHMARK(BM_JSONWriter)->DenseRange(0, 2);
+BENCHMARK(BM_JSONDumpCompact)->DenseRange(0, 2);
+BENCHMARK(BM_JSONBinding);
+BENCHMARK(BM_JSONBindingViaDocument);
+BENCHMARK(BM_JSONQueryPrecompiled);
+BENCHMARK(BM_JSONQueryOperatorIndex);
+BENCHMARK(BM_JSONLines)->DenseRange(0, 1);
+BENCHMARK(BM_JSONLinesSequential);
+BENCHMARK(BM_CSVReader);
+BENCHMARK(BM_CSVParser);
+BENCHMARK(BM_CSVParallel)->DenseRange(0, 1);
+BENCHMARK(BM_CSVParallelSequential);
+BENCHMARK(BM_CSVReaderFromFile)->DenseRange(0, 1);
+BENCHMARK(BM_CSVTable);
+BENCHMARK(BM_CSVParserSum);
+BENCHMARK(BM_CSVWriter)->DenseRange(0, 1);
+BENCHMARK(BM_RegexLogFilter);
+BENCHMARK(BM_StdRegexLogFilter);
+BENCHMARK(BM_RegexFindAll);
+BENCHMARK(BM_RegexRareMatch)->DenseRange(0, 2);
+BENCHMARK(BM_RegexSetLogLines)->DenseRange(0, 2);
+BENCHMARK(BM_RegexMatchWords)->DenseRange(0, 1);
+BENCHMARK(BM_ReadSmallFiles)->DenseRange(0, 2);
 BENCHMARK_MAIN();
@@ -532,6 +532,293 @@ TEST(ARLibTests, ThreadingTests) {
     RecursiveMutex m4{};
     { UniqueLock ll{ m4 }; }
 }
+TEST(ARLibTests, LockPrimitivesTests) {
+    static_assert(sizeof(AdaptiveMutex) == sizeof(uint32_t));
+    constexpr int thread_count = 4;
+    constexpr int iterations   = 10000;
+    auto run_threads           = [](auto&& func) {
+        Array<Thread, thread_count> threads{};
+        for (auto& t : threads) { t = Thread{ func }; }
+        for (auto& t : threads) { t.join(); }
+    };
+
+    AdaptiveMutex adaptive{};
+    int adaptive_counter = 0;
+    run_threads([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            LockGuard guard{ adaptive };
+            ++adaptive_counter;
+        }
+    });
+    EXPECT_EQ(adaptive_counter, thread_count * iterations);
+
+    SpinLock spin{};
+    int spin_counter = 0;
+    run_threads([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            UniqueLock lock{ spin };
+            ++spin_counter;
+        }
+    });
+    EXPECT_EQ(spin_counter, thread_count * iterations);
+
+    SharedMutex shared{};
+    Pair<int, int> shared_values{ 0, 0 };
+    Atomic<int> torn_reads{ 0 };
+    run_threads([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            if (i % 4 == 0) {
+                ScopedLock lock{ shared };
+                ++shared_values.first();
+                ++shared_values.second();
+            } else {
+                SharedLock lock{ shared };
+                if (shared_values.first() != shared_values.second()) { ++torn_reads; }
+            }
+        }
+    });
+    EXPECT_EQ(torn_reads.load(), 0);
+    EXPECT_EQ(shared_values.first(), thread_count * iterations / 4);
+    EXPECT_TRUE(shared.try_lock());
+    EXPECT_FALSE(shared.try_lock_shared());
+    shared.unlock();
+    EXPECT_TRUE(shared.try_lock_shared());
+    EXPECT_FALSE(shared.try_lock());
+    shared.unlock_shared();
+
+    struct Snapshot {
+        int a;
+        int b;
+    };
+    SeqLock<Snapshot> seq{ Snapshot{ 0, 0 } };
+    Atomic<int> torn_snapshots{ 0 };
+    run_threads([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            if (i % 8 == 0) {
+                seq.update([](Snapshot& s) {
+                    ++s.a;
+                    ++s.b;
+                });
+            } else {
+                auto snap = seq.load();
+                if (snap.a != snap.b) { ++torn_snapshots; }
+            }
+        }
+    });
+    EXPECT_EQ(torn_snapshots.load(), 0);
+    EXPECT_EQ(seq.load().a, thread_count * iterations / 8);
+    EXPECT_EQ(seq.sequence(), static_cast<uint32_t>(2 * thread_count * iterations / 8));
+}
+TEST(ARLibTests, AtomicMemoryOrderTests) {
+    constexpr int thread_count = 4;
+    constexpr int iterations   = 10000;
+    Atomic<uint64_t> counter{ 0 };
+    Atomic<int> max_seen{ NumberTraits<int>::min };
+    Atomic<int> min_seen{ NumberTraits<int>::max };
+    Array<Thread, thread_count> threads{};
+    for (int t = 0; t < thread_count; ++t) {
+        threads[static_cast<size_t>(t)] = Thread{ [&, t]() {
+            for (int i = 0; i < iterations; ++i) {
+                counter.fetch_add(1, MemoryOrder::Relaxed);
+                max_seen.fetch_max(t * iterations + i, MemoryOrder::Relaxed);
+                min_seen.fetch_min(t * iterations + i, MemoryOrder::Relaxed);
+            }
+        } };
+    }
+    for (auto& t : threads) { t.join(); }
+    EXPECT_EQ(counter.load(MemoryOrder::Acquire), static_cast<uint64_t>(thread_count * iterations));
+    EXPECT_EQ(max_seen.load(), thread_count * iterations - 1);
+    EXPECT_EQ(min_seen.load(), 0);
+    EXPECT_EQ(max_seen.fetch_max(0), thread_count * iterations - 1);
+    EXPECT_EQ(max_seen.load(), thread_count * iterations - 1);
+
+    Atomic<uint32_t> flags{ 0 };
+    uint32_t expected = 1;
+    EXPECT_FALSE(flags.compare_exchange_strong(expected, 2, MemoryOrder::AcqRel));
+    EXPECT_EQ(expected, 0u);
+    EXPECT_TRUE(flags.compare_exchange_strong(expected, 2, MemoryOrder::AcqRel, MemoryOrder::Acquire));
+    EXPECT_EQ(flags.exchange(3, MemoryOrder::Release), 2u);
+
+    int values[4]{ 1, 2, 3, 4 };
+    Atomic<int*> ptr{ values };
+    int* expected_ptr = values;
+    EXPECT_TRUE(ptr.compare_exchange_strong(expected_ptr, values + 1, MemoryOrder::Release));
+    EXPECT_EQ(ptr.fetch_add(2), values + 1);
+    EXPECT_EQ(*ptr.load(MemoryOrder::Acquire), 4);
+    EXPECT_EQ(--ptr, values + 2);
+    ptr = values;
+    EXPECT_EQ(ptr.load(), values);
+
+    struct Wide {
+        uint64_t low;
+        uint64_t high;
+    };
+    Atomic<Wide> wide{ Wide{ 1, 2 } };
+    EXPECT_TRUE(wide.is_lock_free());
+    Wide expected_wide{ 1, 3 };
+    EXPECT_FALSE(wide.compare_exchange_strong(expected_wide, Wide{ 5, 6 }));
+    EXPECT_EQ(expected_wide.high, 2u);
+    EXPECT_TRUE(wide.compare_exchange_strong(expected_wide, Wide{ 5, 6 }));
+    EXPECT_EQ(wide.load().low, 5u);
+    EXPECT_EQ(wide.load().high, 6u);
+}
+TEST(ARLibTests, ParallelAlgorithmsTests) {
+    ThreadPool pool{ 3 };
+    EXPECT_EQ(pool.size(), 3ull);
+    constexpr size_t count = 100000;
+    Vector<uint32_t> values{};
+    values.reserve(count);
+    uint32_t state = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 1664525u + 1013904223u;
+        values.append(state >> 8);
+    }
+    const parallel::Options small{ .grain_size = 1000, .deterministic = false, .pool = &pool };
+    const parallel::Options deterministic{ .grain_size = 1000, .deterministic = true, .pool = &pool };
+
+    Vector<uint64_t> doubled{};
+    doubled.resize(count);
+    parallel::for_each(
+    doubled.begin(), doubled.end(), [&](uint64_t& v) { v = 2 * values[static_cast<size_t>(&v - doubled.data())]; },
+    small
+    );
+    uint64_t serial_sum = 0;
+    for (auto v : values) { serial_sum += v; }
+    auto plus  = [](uint64_t a, uint64_t b) { return a + b; };
+    auto widen = [](uint32_t v) { return uint64_t{ v }; };
+    EXPECT_EQ(
+    parallel::transform_reduce(doubled, uint64_t{ 0 }, plus, [](uint64_t v) { return v / 2; }, small), serial_sum
+    );
+    EXPECT_EQ(parallel::transform_reduce(values, uint64_t{ 0 }, plus, widen, deterministic), serial_sum);
+    EXPECT_EQ(parallel::transform_reduce(values, uint64_t{ 7 }, plus, widen), serial_sum + 7);
+
+    // floating point sums are only reproducible in deterministic mode, the result must not depend on the pool size
+    Vector<double> fractions{};
+    for (size_t i = 0; i < count; ++i) { fractions.append(1.0 / static_cast<double>(i + 1)); }
+    auto fplus    = [](double a, double b) { return a + b; };
+    auto identity = [](double v) { return v; };
+    ThreadPool single{ 1 };
+    const double sum_one = parallel::transform_reduce(
+    fractions, 0.0, fplus, identity, parallel::Options{ .grain_size = 777, .deterministic = true, .pool = &single }
+    );
+    const double sum_many = parallel::transform_reduce(
+    fractions, 0.0, fplus, identity, parallel::Options{ .grain_size = 777, .deterministic = true, .pool = &pool }
+    );
+    EXPECT_EQ(sum_one, sum_many);
+
+    Vector<uint64_t> scanned{};
+    scanned.resize(count);
+    Vector<uint64_t> widened{};
+    for (auto v : values) { widened.append(v); }
+    parallel::inclusive_scan(widened.begin(), widened.end(), scanned.begin(), small);
+    uint64_t running = 0;
+    bool scan_ok     = true;
+    for (size_t i = 0; i < count; ++i) {
+        running += values[i];
+        scan_ok = scan_ok && scanned[i] == running;
+    }
+    EXPECT_TRUE(scan_ok);
+
+    Vector<uint32_t> sorted = values;
+    parallel::sort(sorted, small);
+    bool sorted_ok = true;
+    for (size_t i = 1; i < count; ++i) { sorted_ok = sorted_ok && sorted[i - 1] <= sorted[i]; }
+    EXPECT_TRUE(sorted_ok);
+    EXPECT_EQ(parallel::transform_reduce(sorted, uint64_t{ 0 }, plus, widen, small), serial_sum);
+
+    Vector<String> words{};
+    for (size_t i = 0; i < 5000; ++i) { words.append(String::formatted("word%04zu", (i * 7919) % 5000)); }
+    parallel::sort(
+    words, [](const String& a, const String& b) { return b <=> a; }, parallel::Options{ .grain_size = 300, .pool = &pool }
+    );
+    bool words_ok = true;
+    for (size_t i = 1; i < words.size(); ++i) { words_ok = words_ok && !(words[i - 1] < words[i]); }
+    EXPECT_TRUE(words_ok);
+    EXPECT_EQ(words.size(), 5000ull);
+}
+TEST(ARLibTests, MemoryReclamationTests) {
+    struct Node {
+        int value;
+        Atomic<int>* destroyed;
+        ~Node() { destroyed->fetch_add(1, MemoryOrder::Relaxed); }
+    };
+    constexpr int reader_count = 3;
+    constexpr int updates      = 2000;
+    Atomic<int> destroyed{ 0 };
+    Atomic<bool> done{ false };
+    Atomic<bool> bad_read{ false };
+    {
+        EpochDomain domain{};
+        Atomic<Node*> shared{ new Node{ 0, &destroyed } };
+        Array<Thread, reader_count> readers{};
+        for (auto& reader : readers) {
+            reader = Thread{ [&]() {
+                auto participant = domain.register_thread();
+                int last         = 0;
+                while (!done.load(MemoryOrder::Acquire)) {
+                    auto guard = participant.pin();
+                    Node* node = guard.protect(shared);
+                    // values only ever grow, reading a freed (and reused) node would break that
+                    if (node->value < last) bad_read.store(true);
+                    last = node->value;
+                }
+            } };
+        }
+        auto writer = domain.register_thread();
+        for (int i = 1; i <= updates; ++i) {
+            auto guard = writer.pin();
+            writer.retire(shared.exchange(new Node{ i, &destroyed }, MemoryOrder::AcqRel));
+        }
+        done.store(true, MemoryOrder::Release);
+        for (auto& reader : readers) { reader.join(); }
+        EXPECT_FALSE(writer.is_pinned());
+        while (writer.pending() != 0) { writer.collect(); }
+        EXPECT_EQ(destroyed.load(), updates);
+        delete shared.load();
+    }
+    EXPECT_FALSE(bad_read.load());
+    EXPECT_EQ(destroyed.load(), updates + 1);
+
+    destroyed.store(0);
+    done.store(false);
+    {
+        HazardDomain domain{};
+        Atomic<Node*> shared{ new Node{ 0, &destroyed } };
+        Array<Thread, reader_count> readers{};
+        for (auto& reader : readers) {
+            reader = Thread{ [&]() {
+                auto hazard = domain.make_hazard_pointer();
+                int last    = 0;
+                while (!done.load(MemoryOrder::Acquire)) {
+                    Node* node = hazard.protect(shared);
+                    if (node->value < last) bad_read.store(true);
+                    last = node->value;
+                    hazard.reset_protection();
+                }
+            } };
+        }
+        for (int i = 1; i <= updates; ++i) {
+            domain.retire(shared.exchange(new Node{ i, &destroyed }, MemoryOrder::AcqRel));
+        }
+        done.store(true, MemoryOrder::Release);
+        for (auto& reader : readers) { reader.join(); }
+        // nothing is protected anymore, a single scan frees everything
+        domain.reclaim();
+        EXPECT_EQ(domain.pending(), 0ull);
+        EXPECT_EQ(destroyed.load(), updates);
+
+        // a protected object survives reclamation until the protection is dropped
+        auto hazard = domain.make_hazard_pointer();
+        Node* held  = hazard.protect(shared);
+        domain.retire(shared.exchange(nullptr));
+        EXPECT_EQ(domain.reclaim(), 0ull);
+        EXPECT_EQ(held->value, updates);
+        hazard.reset_protection();
+        EXPECT_EQ(domain.reclaim(), 1ull);
+    }
+    EXPECT_FALSE(bad_read.load());
+    EXPECT_EQ(destroyed.load(), updates + 1);
+}
 TEST(ARLibTests, EventLoop) {
     auto func = [](int val, String help) {
         EXPECT_EQ(val, 30);
@@ -629,6 +916,1113 @@ TEST(ARLibTests, JSONTest) {
     auto err2 = error_double_obj.to_error();
     EXPECT_EQ(err2->message(), "End of json reached but end of buffer not reached"_s);
 }
+TEST(ARLibTests, JSONStructuralParserTest) {
+    // long enough to cross a few 64 byte blocks, with a string and an escape straddling the block boundaries
+    const auto source =
+    R"({"hello world": 10, "array": [1, 2.5, -3, 4e2], "nested": {"a": [true, false, null], "b": {}},)"
+    R"( "escapes": "quote \" backslash \\ tab \t unicode \u00e9\ud83d\ude00", "padding": "0123456789012345678901",)"
+    R"( "last": [[], [{}], "\\"]})"_sv;
+    auto index_or_error = JSON::StructuralIndex::build(source);
+    EXPECT_TRUE(index_or_error.is_ok());
+    auto index = index_or_error.to_ok();
+    EXPECT_EQ(source[index[0]], '{');
+    EXPECT_EQ(source[index[index.size() - 1]], '}');
+    EXPECT_EQ(index.indices()[index.size()], source.size());
+
+    auto maybe_doc = JSON::StructuralParser::parse(index);
+    EXPECT_TRUE(maybe_doc.is_ok());
+    auto doc        = maybe_doc.to_ok();
+    const auto& obj = doc.root();
+    EXPECT_EQ(obj["hello world"_s], 10);
+    const auto& arr = obj["array"_s].as<JSON::Type::JArray>();
+    EXPECT_EQ(arr.size(), 4);
+    EXPECT_EQ(arr[0], 1);
+    EXPECT_EQ(arr[1], 2.5);
+    EXPECT_EQ(arr[2], -3);
+    EXPECT_EQ(arr[3], 400.0);
+    EXPECT_EQ(obj["nested"_s]["a"_s][0], true);
+    EXPECT_EQ(obj["nested"_s]["a"_s][2], nullptr);
+    EXPECT_EQ(obj["nested"_s]["b"_s].as<JSON::Type::JObject>().size(), 0);
+    EXPECT_EQ(obj["escapes"_s], "quote \" backslash \\ tab \t unicode \xC3\xA9\xF0\x9F\x98\x80"_s);
+    EXPECT_EQ(obj["last"_s][2], "\\"_s);
+
+    // without escapes both parsers have to agree
+    const auto plain = R"([{"id": 1, "name": "first", "tags": ["a", "b"]}, {"id": 2, "ratio": 0.25, "ok": false}])"_sv;
+    auto reference   = JSON::Parser::parse(plain).to_ok();
+    auto two_stage   = JSON::StructuralParser::parse(plain).to_ok();
+    EXPECT_EQ(JSON::dump_json_compact(reference.root()), JSON::dump_json_compact(two_stage.root()));
+
+    auto unterminated = JSON::StructuralParser::parse(R"({"hello world": 10, "array: [1, 2, 3, 4]})"_sv);
+    EXPECT_TRUE(unterminated.is_error());
+    auto err = unterminated.to_error();
+    EXPECT_EQ(err->message(), "Missing end of quotation on string"_s);
+    EXPECT_EQ(err->offset(), 41);
+
+    auto trailing = JSON::StructuralParser::parse(R"({} {})"_sv);
+    EXPECT_TRUE(trailing.is_error());
+    EXPECT_EQ(trailing.to_error()->message(), "End of json reached but end of buffer not reached"_s);
+    const Array invalid_inputs{ R"([1, 2,])"_sv,      R"({"a" 1})"_sv,      R"([01])"_sv,     R"(["\x"])"_sv,
+                                R"(["\ud800"])"_sv, R"([true false])"_sv, R"([1, 2] x)"_sv, ""_sv };
+    for (const auto& input : invalid_inputs) {
+        auto result = JSON::StructuralParser::parse(input);
+        EXPECT_TRUE(result.is_error());
+        if (result.is_error()) result.to_error();
+    }
+    // control characters have to be escaped, the escaped one is fine
+    auto raw_tab = JSON::StructuralParser::parse("[\"tab\there\"]"_sv);
+    EXPECT_TRUE(raw_tab.is_error());
+    EXPECT_EQ(raw_tab.to_error()->message(), "Unescaped control character in string"_s);
+    EXPECT_TRUE(JSON::StructuralParser::parse(R"(["tab\there"])"_sv).is_ok());
+}
+TEST(ARLibTests, JSONCompactDocumentTest) {
+    const auto source =
+    R"({"name": "compact", "escaped": "tab\there", "count": 3, "ratio": 0.5, "flags": [true, false, null],)"
+    R"( "nested": {"inner": [1, {"deep": "value"}]}, "empty": {}})"_sv;
+    auto maybe_doc = JSON::CompactDocument::parse(source);
+    EXPECT_TRUE(maybe_doc.is_ok());
+    auto doc  = maybe_doc.to_ok();
+    auto root = doc.root();
+    EXPECT_TRUE(root.is_object());
+    EXPECT_EQ(root.size(), 7);
+    EXPECT_EQ(root.key_at(0), "name"_sv);
+    // strings without escapes point straight into the source
+    auto name = root["name"_sv].as_string();
+    EXPECT_EQ(name, "compact"_sv);
+    EXPECT_TRUE(name.data() >= source.data() && name.data() < source.data() + source.size());
+    EXPECT_EQ(root["escaped"_sv].as_string(), "tab\there"_sv);
+    EXPECT_EQ(root["count"_sv].as_int64(), 3);
+    EXPECT_TRUE(root["ratio"_sv].is_number());
+    EXPECT_FALSE(root["ratio"_sv].is_integer());
+    EXPECT_EQ(root["ratio"_sv].as_double(), 0.5);
+    EXPECT_EQ(root["flags"_sv].size(), 3);
+    EXPECT_TRUE(root["flags"_sv][0].as_bool());
+    EXPECT_FALSE(root["flags"_sv][1].as_bool());
+    EXPECT_TRUE(root["flags"_sv][2].is_null());
+    EXPECT_EQ(root["nested"_sv]["inner"_sv][1]["deep"_sv].as_string(), "value"_sv);
+    EXPECT_EQ(root["empty"_sv].size(), 0);
+    EXPECT_TRUE(root.find("missing"_sv).empty());
+    EXPECT_EQ(doc.node_count(), 24);
+
+    // converting back to the regular dom gives the same thing the regular parser builds
+    auto reference = JSON::StructuralParser::parse(source).to_ok();
+    EXPECT_EQ(JSON::dump_json_compact(*root.to_value()), JSON::dump_json_compact(reference.root()));
+
+    // an owned source survives the string it came from going away
+    auto owned = JSON::CompactDocument::parse(String{ R"(["owned", 1])" }).to_ok();
+    EXPECT_EQ(owned.root()[0].as_string(), "owned"_sv);
+    EXPECT_EQ(owned.root()[1].as_int64(), 1);
+
+    auto invalid = JSON::CompactDocument::parse(R"({"a": [1, 2})"_sv);
+    EXPECT_TRUE(invalid.is_error());
+    EXPECT_EQ(invalid.to_error()->offset(), 11);
+}
+TEST(ARLibTests, JSONOnDemandTest) {
+    const auto source =
+    R"({"skipped": {"a": [1, 2, {"b": "}]"}], "c": null}, "name": "lazy", "escaped": "aA\n", "n": -42,)"
+    R"( "pi": 3.25, "ok": true, "none": null, "list": [10, [20, 30], {"x": 40}], "empty": []})"_sv;
+    auto maybe_doc = JSON::OnDemandDocument::parse(source);
+    EXPECT_TRUE(maybe_doc.is_ok());
+    auto doc  = maybe_doc.to_ok();
+    auto root = doc.root();
+    EXPECT_EQ(root.type().to_ok(), JSON::Type::JObject);
+    EXPECT_EQ(root["n"_sv].get_int64().to_ok(), -42);
+    EXPECT_EQ(root["n"_sv].get_double().to_ok(), -42.0);
+    EXPECT_EQ(root["pi"_sv].get_double().to_ok(), 3.25);
+    EXPECT_TRUE(root["ok"_sv].get_bool().to_ok());
+    EXPECT_TRUE(root["none"_sv].is_null());
+    EXPECT_FALSE(root["ok"_sv].is_null());
+    auto name = root["name"_sv].get_string_view().to_ok();
+    EXPECT_EQ(name, "lazy"_sv);
+    EXPECT_TRUE(name.data() >= source.data() && name.data() < source.data() + source.size());
+    EXPECT_EQ(root["escaped"_sv].get_string_view().to_ok(), "aA\n"_sv);
+    // decoded once, asking again gives back the same buffer
+    EXPECT_EQ(root["escaped"_sv].get_string_view().to_ok().data(), root["escaped"_sv].get_string_view().to_ok().data());
+    EXPECT_EQ(root["escaped"_sv].get_raw_view().to_ok(), R"(aA\n)"_sv);
+    EXPECT_EQ(root["list"_sv][1][1].get_int64().to_ok(), 30);
+    EXPECT_EQ(root["list"_sv][2]["x"_sv].get_int64().to_ok(), 40);
+    EXPECT_EQ(root["skipped"_sv]["a"_sv][2]["b"_sv].get_string().to_ok(), "}]"_sv);
+    EXPECT_EQ(root["list"_sv][1].get_raw_view().to_ok(), "[20, 30]"_sv);
+    EXPECT_EQ(root.count().to_ok(), 9);
+    EXPECT_EQ(root["empty"_sv].count().to_ok(), 0);
+    int64_t sum = 0;
+    EXPECT_TRUE(root["list"_sv][1].for_each_element([&sum](const JSON::OnDemandValue& v) {
+        sum += v.get_int64().to_ok();
+    }).is_ok());
+    EXPECT_EQ(sum, 50);
+    Vector<String> keys{};
+    EXPECT_TRUE(root["skipped"_sv].for_each_field([&keys](StringView key, const JSON::OnDemandValue&) {
+        keys.append(key.str());
+    }).is_ok());
+    EXPECT_EQ(keys.size(), 2);
+    EXPECT_EQ(keys[1], "c"_s);
+
+    // failures carry through the rest of the chain
+    auto missing = root["list"_sv][5]["x"_sv];
+    EXPECT_FALSE(missing.is_ok());
+    auto missing_value = missing.get_int64();
+    EXPECT_TRUE(missing_value.is_error());
+    missing_value.to_error();
+    auto wrong_type = root["name"_sv].get_int64();
+    EXPECT_TRUE(wrong_type.is_error());
+    wrong_type.to_error();
+    auto not_integer = root["pi"_sv].get_int64();
+    EXPECT_TRUE(not_integer.is_error());
+    not_integer.to_error();
+
+    // only what gets visited is validated
+    auto partial = JSON::OnDemandDocument::parse(R"({"good": 1, "bad": [1 2]})"_sv).to_ok();
+    EXPECT_EQ(partial.root()["good"_sv].get_int64().to_ok(), 1);
+    auto bad = partial.root()["bad"_sv].count();
+    EXPECT_TRUE(bad.is_error());
+    EXPECT_EQ(bad.to_error()->offset(), 22);
+}
+TEST(ARLibTests, JSONStreamReaderTest) {
+    struct TraceHandler : JSON::SaxHandler {
+        String trace{};
+        void on_object_start() override { trace.append('{'); }
+        void on_object_end() override { trace.append('}'); }
+        void on_array_start() override { trace.append('['); }
+        void on_array_end() override { trace.append(']'); }
+        void on_key(StringView key) override { trace.append("k:"_s + key.str() + " "_s); }
+        void on_string(StringView value) override { trace.append("s:"_s + value.str() + " "_s); }
+        void on_number(const JSON::Number& value) override {
+            trace.append(value.is_integer() ? "i:"_s + IntToStr(value.value_integer()) + " "_s : "d "_s);
+        }
+        void on_bool(bool value) override { trace.append(value ? "true "_s : "false "_s); }
+        void on_null() override { trace.append("null "_s); }
+    };
+    const auto source =
+    R"({"name": "streamé\"", "values": [12345, -6, 0.25, true, false, null], "nested": {"empty": []}})"_sv;
+    const auto expected = "{k:name s:stream\xC3\xA9\" k:values [i:12345 i:-6 d true false null ]k:nested {k:empty []}}"_sv;
+    // every chunk size has to give the same events, including splitting strings, escapes and numbers
+    for (size_t chunk_size = 1; chunk_size <= source.size(); ++chunk_size) {
+        TraceHandler handler{};
+        JSON::StreamReader reader{ handler };
+        for (size_t pos = 0; pos < source.size(); pos += chunk_size) {
+            EXPECT_TRUE(reader.feed(source.substringview_fromlen(pos, chunk_size)).is_ok());
+        }
+        EXPECT_TRUE(reader.finish().is_ok());
+        EXPECT_EQ(handler.trace, expected);
+    }
+    {
+        TraceHandler handler{};
+        StringStream stream{ source.str() };
+        EXPECT_TRUE(JSON::StreamReader::parse(stream, handler, 7).is_ok());
+        EXPECT_EQ(handler.trace, expected);
+    }
+    {
+        // a top level scalar is only complete once the input is over
+        TraceHandler handler{};
+        JSON::StreamReader reader{ handler };
+        EXPECT_TRUE(reader.feed("4"_sv).is_ok());
+        EXPECT_TRUE(reader.feed("2"_sv).is_ok());
+        EXPECT_EQ(handler.trace, ""_sv);
+        EXPECT_TRUE(reader.finish().is_ok());
+        EXPECT_EQ(handler.trace, "i:42 "_sv);
+    }
+    {
+        TraceHandler handler{};
+        StringStream stream{ R"({"a": [1, 2}})"_s };
+        auto res = JSON::StreamReader::parse(stream, handler, 4);
+        EXPECT_TRUE(res.is_error());
+        EXPECT_EQ(res.to_error()->offset(), 11);
+    }
+    {
+        TraceHandler handler{};
+        StringStream stream{ R"(["unterminated)"_s };
+        auto res = JSON::StreamReader::parse(stream, handler);
+        EXPECT_TRUE(res.is_error());
+        res.to_error();
+    }
+}
+TEST(ARLibTests, JSONLinesTest) {
+    String input{};
+    Vector<size_t> starts{};
+    for (int64_t i = 0; i < 2000; ++i) {
+        if (i % 100 == 0) input.append(" \r\n");
+        starts.append(input.size());
+        input.append(String::formatted(R"({"id": %lld, "tags": ["a\nb", %lld], "ok": true})", i, i * 2));
+        input.append(i % 2 == 0 ? "\r\n" : "\n");
+    }
+    starts.append(input.size());
+    input.append(R"({"id": 2000, "tags": [], "ok": false})");
+    ThreadPool pool{ 3 };
+    JSON::LinesOptions options{};
+    options.pool       = &pool;
+    options.chunk_size = 256;
+    {
+        // in order the records arrive one at a time, in the order of the input
+        size_t count  = 0;
+        bool in_order = true;
+        auto res = JSON::LinesParser::parse(input.view(), [&](size_t offset, JSON::CompactValue value) {
+            const bool expected = offset == starts[count] && value["id"_sv].as_int64() == static_cast<int64_t>(count);
+            in_order            = in_order && expected;
+            ++count;
+        }, options);
+        EXPECT_TRUE(res.is_ok());
+        EXPECT_EQ(count, 2001);
+        EXPECT_TRUE(in_order);
+    }
+    {
+        options.ordered = false;
+        Atomic<int64_t> sum{ 0 };
+        Atomic<size_t> count{ 0 };
+        auto res = JSON::LinesParser::parse(input.view(), [&](size_t, JSON::CompactValue value) {
+            sum.fetch_add(value["id"_sv].as_int64());
+            count.fetch_add(1);
+        }, options);
+        EXPECT_TRUE(res.is_ok());
+        EXPECT_EQ(count.load(), 2001);
+        EXPECT_EQ(sum.load(), 2001 * 2000 / 2);
+        options.ordered = true;
+    }
+    {
+        // everything before the malformed record is still delivered
+        String broken = input;
+        broken[starts[1500]] = '#';
+        size_t count = 0;
+        auto res = JSON::LinesParser::parse(broken.view(), [&](size_t, JSON::CompactValue) { ++count; }, options);
+        EXPECT_TRUE(res.is_error());
+        EXPECT_EQ(res.to_error()->offset(), starts[1500]);
+        EXPECT_EQ(count, 1500);
+    }
+}
+TEST(ARLibTests, JSONWriterTest) {
+    JSON::Writer writer{};
+    writer.begin_object().key("name"_sv).string("quote \" backslash \\ newline \n bell \x07"_sv);
+    writer.key("values"_sv).begin_array().integer(-42).number(0.1).number(1.0).number(1e300).boolean(true).null();
+    writer.end_array().key("empty"_sv).begin_object().end_object().end_object();
+    EXPECT_EQ(
+    writer.str(),
+    R"({"name":"quote \" backslash \\ newline \n bell \u0007","values":[-42,0.1,1.0,1e+300,true,null],"empty":{}})"_s
+    );
+
+    // doubles are written with the fewest digits that still read back as the same value
+    const Array doubles{ 0.1, 1.0 / 3.0, 5e-324, 1.7976931348623157e308, -2.5, 123456789012345680.0, 0.0 };
+    for (double value : doubles) {
+        JSON::Writer number_writer{};
+        number_writer.number(value);
+        auto parsed = JSON::CompactDocument::parse(number_writer.str().view()).to_ok();
+        EXPECT_FALSE(parsed.root().is_integer());
+        EXPECT_EQ(parsed.root().as_double(), value);
+    }
+    JSON::Writer special{};
+    special.begin_array().number(0.0 / 0.0).number(1e308 * 10).end_array();
+    EXPECT_EQ(special.str(), "[null,null]"_s);
+
+    // objects with a single member, so the order of the regular dom doesn't matter
+    const auto source = R"({"a": [1, 2.5, {"b": "tab\tand\u0001"}, {}, [], "\u00e9"]})"_sv;
+    auto doc          = JSON::StructuralParser::parse(source).to_ok();
+    const auto pretty = "{\n\t\"a\": [\n\t\t1,\n\t\t2.5,\n\t\t{\n\t\t\t\"b\": \"tab\\tand\\u0001\"\n\t\t},"
+                        "\n\t\t{},\n\t\t[],\n\t\t\"\xC3\xA9\"\n\t]\n}"_s;
+    EXPECT_EQ(JSON::dump_json(doc.root()), pretty);
+    const auto compact = JSON::dump_json_compact(doc.root());
+    EXPECT_EQ(compact, R"({"a":[1,2.5,{"b":"tab\tand\u0001"},{},[],"é"]})"_s);
+    // whatever gets written has to parse back to the same document, in both modes and from both doms
+    EXPECT_EQ(JSON::dump_json_compact(JSON::StructuralParser::parse(compact.view()).to_ok().root()), compact);
+    EXPECT_EQ(JSON::dump_json_compact(JSON::StructuralParser::parse(pretty.view()).to_ok().root()), compact);
+    // serialize_to_file streams the same text into the file
+    const Path json_path{ "json_writer_test.json"_p };
+    EXPECT_FALSE(doc.serialize_to_file(json_path).is_error());
+    EXPECT_EQ(MUST(File::read_all(json_path)), pretty);
+    File::remove(json_path);
+    auto compact_doc = JSON::CompactDocument::parse(source).to_ok();
+    EXPECT_EQ(JSON::to_json(compact_doc.root()), compact);
+    EXPECT_EQ(JSON::to_json(compact_doc.root(), JSON::WriteMode::Pretty), pretty);
+
+    // with a sink the output goes to the stream instead of staying in the writer
+    StringStream stream{};
+    JSON::Writer stream_writer{ stream };
+    stream_writer.begin_array();
+    for (int64_t i = 0; i < 20000; ++i) stream_writer.integer(i);
+    stream_writer.end_array();
+    EXPECT_TRUE(stream_writer.str().size() < JSON::Writer::flush_threshold);
+    EXPECT_TRUE(stream_writer.flush().is_ok());
+    EXPECT_EQ(stream_writer.str().size(), 0);
+    auto streamed = JSON::CompactDocument::parse(stream.str()).to_ok();
+    EXPECT_EQ(streamed.root().size(), 20000);
+    EXPECT_EQ(streamed.root()[19999].as_int64(), 19999);
+}
+TEST(ARLibTests, StrViewToDoubleTest) {
+    auto bits_of = [](double value) { return BitCast<uint64_t>(value); };
+    auto parse   = [](StringView str) { return StrViewToDouble(str).to_ok(); };
+    // hard cases: exact halfway points, more than 19 digits, subnormals and the edges of the range
+    EXPECT_EQ(bits_of(parse("9007199254740993"_sv)), bits_of(9007199254740992.0));
+    EXPECT_EQ(bits_of(parse("9007199254740993.0000000000001"_sv)), bits_of(9007199254740994.0));
+    EXPECT_EQ(bits_of(parse("1.00000000000000011102230246251565404236316680908203125"_sv)), bits_of(1.0));
+    EXPECT_EQ(
+    bits_of(parse("1.00000000000000011102230246251565404236316680908203126"_sv)), bits_of(1.0000000000000002)
+    );
+    EXPECT_EQ(bits_of(parse("2.2250738585072011e-308"_sv)), bits_of(2.2250738585072011e-308));
+    EXPECT_EQ(bits_of(parse("4.9406564584124654e-324"_sv)), bits_of(5e-324));
+    EXPECT_EQ(bits_of(parse("1.7976931348623157e308"_sv)), bits_of(1.7976931348623157e308));
+    EXPECT_EQ(bits_of(parse("0.000000000000000000000000000000000000000000001e45"_sv)), bits_of(1.0));
+    EXPECT_EQ(bits_of(parse("-0"_sv)), bits_of(-0.0));
+    EXPECT_EQ(parse("1e23"_sv), 1e23);
+    EXPECT_EQ(parse("12.5e"_sv), 12.5);
+    auto overflow = StrViewToDouble("1e400"_sv);
+    EXPECT_TRUE(overflow.is_error());
+    overflow.ignore_error();
+    auto invalid = StrViewToDouble("e5"_sv);
+    EXPECT_TRUE(invalid.is_error());
+    invalid.ignore_error();
+
+    // random bit patterns have to read back exactly, both from the shortest representation and from 17 digits
+    auto rng = Random::PCG::create();
+    for (size_t i = 0; i < 100000; ++i) {
+        const uint64_t bits = (static_cast<uint64_t>(rng.random()) << 32) | rng.random();
+        const double value  = BitCast<double>(bits);
+        if (value != value || value - value != 0.0) continue;
+        EXPECT_EQ(bits_of(parse(DoubleToShortestStr(value).view())), bits);
+        EXPECT_EQ(bits_of(parse(DoubleToStr<FloatFmtOpt::e>(value, 16).view())), bits);
+    }
+}
+TEST(ARLibTests, CharConvBatchTest) {
+    // lengths that go through the 16 digit, 8 digit and single digit paths, and the 20th digit of an u64
+    EXPECT_EQ(StrViewToI64("1234567890123456"_sv).to_ok(), 1234567890123456);
+    EXPECT_EQ(StrViewToI64("-123456789012345678"_sv).to_ok(), -123456789012345678);
+    EXPECT_EQ(StrViewToI64("9223372036854775807"_sv).to_ok(), NumberTraits<int64_t>::max);
+    EXPECT_EQ(StrViewToI64("-9223372036854775808"_sv).to_ok(), NumberTraits<int64_t>::min);
+    EXPECT_EQ(StrViewToU64("18446744073709551615"_sv).to_ok(), NumberTraits<uint64_t>::max);
+    EXPECT_EQ(StrViewToU64("  00000000000000000000042 "_sv).to_ok(), 42ull);
+    auto too_big = StrViewToI64("9223372036854775808"_sv);
+    EXPECT_TRUE(too_big.is_error());
+    auto too_big_unsigned = StrViewToU64("18446744073709551616"_sv);
+    EXPECT_TRUE(too_big_unsigned.is_error());
+    auto bad_sse_digit = StrViewToI64("123456789012345x"_sv);
+    EXPECT_TRUE(bad_sse_digit.is_error());
+    auto bad_swar_digit = StrViewToI64("12345678x"_sv);
+    EXPECT_TRUE(bad_swar_digit.is_error());
+    for (auto* res : { &too_big, &bad_sse_digit, &bad_swar_digit }) {
+        if (res->is_error()) res->ignore_error();
+    }
+    if (too_big_unsigned.is_error()) too_big_unsigned.ignore_error();
+
+    const Vector<StringView> column{ "12"_sv, "-7"_sv, " 42 "_sv, "123456789012345678"_sv };
+    auto integers = StrViewsToI64(column.span());
+    EXPECT_EQ(integers.to_ok(), (Vector<int64_t>{ 12, -7, 42, 123456789012345678 }));
+    auto doubles = DelimitedToDouble("0.5,-1e3,2.25,\n"_sv.substringview(0, 14), ',');
+    EXPECT_EQ(doubles.to_ok(), (Vector<double>{ 0.5, -1000.0, 2.25 }));
+    // longer than a simd block, with the values straddling the block boundaries
+    String lines{};
+    for (int64_t i = 0; i < 1000; ++i) lines.append(IntToStr(i * 1000003 - 500000) + "\n"_s);
+    auto parsed = DelimitedToI64(lines.view(), '\n').to_ok();
+    EXPECT_EQ(parsed.size(), 1000);
+    EXPECT_EQ(parsed[999], 999 * 1000003 - 500000);
+    auto broken = DelimitedToI64("1;2;;4"_sv, ';');
+    EXPECT_TRUE(broken.is_error());
+    EXPECT_TRUE(broken.to_error()->error_string().starts_with("Failed to convert value 2"_sv));
+}
+struct BindingPoint {
+    int32_t x;
+    int32_t y;
+};
+struct BindingMessage : JSON::BindingSerializable<BindingMessage> {
+    int64_t id;
+    String name;
+    double score;
+    bool active;
+    Vector<BindingPoint> points;
+    Optional<String> note;
+    uint8_t level;
+};
+template <>
+struct ARLib::JSON::Binding<BindingPoint> {
+    constexpr static auto fields = JSON::fields(JSON::field("x", &BindingPoint::x), JSON::field("y", &BindingPoint::y));
+};
+struct BindingCounter {
+    uint64_t count;
+};
+template <>
+struct ARLib::JSON::Binding<BindingCounter> {
+    constexpr static auto fields = JSON::fields(JSON::field("count", &BindingCounter::count));
+};
+template <>
+struct ARLib::JSON::Binding<BindingMessage> {
+    constexpr static auto fields = JSON::fields(
+    JSON::field("id", &BindingMessage::id), JSON::field("name", &BindingMessage::name),
+    JSON::field("score", &BindingMessage::score), JSON::field("active", &BindingMessage::active),
+    JSON::field("points", &BindingMessage::points), JSON::field("note", &BindingMessage::note),
+    JSON::field("level", &BindingMessage::level)
+    );
+};
+static_assert(JSON::Serializable<BindingMessage>);
+TEST(ARLibTests, JSONBindingTest) {
+    // unknown keys are skipped, keys can come in any order, the optional member can be missing
+    constexpr auto source = R"({"level": 3, "id": 12, "extra": [1, {"a": 2}], "name": "a\"b", "score": 1.5,
+                               "active": true, "points": [{"x": 1, "y": -2}, {"y": 3, "x": 4}]})"_sv;
+    auto parsed = JSON::from_json<BindingMessage>(source);
+    EXPECT_TRUE(parsed.is_ok());
+    auto message = parsed.to_ok();
+    EXPECT_EQ(message.id, 12);
+    EXPECT_EQ(message.name, "a\"b"_s);
+    EXPECT_EQ(message.score, 1.5);
+    EXPECT_TRUE(message.active);
+    EXPECT_EQ(message.points.size(), 2);
+    EXPECT_EQ(message.points[1].x, 4);
+    EXPECT_EQ(message.points[1].y, 3);
+    EXPECT_TRUE(message.note.empty());
+    EXPECT_EQ(message.level, 3);
+    message.note = "hi"_s;
+    const auto serialized = message.serialize();
+    EXPECT_EQ(
+    serialized,
+    R"({"id":12,"name":"a\"b","score":1.5,"active":true,)"
+    R"("points":[{"x":1,"y":-2},{"x":4,"y":3}],"note":"hi","level":3})"_s
+    );
+    auto round_trip = BindingMessage::deserialize(serialized.view());
+    EXPECT_TRUE(round_trip.is_ok());
+    EXPECT_EQ(round_trip.to_ok().note.value(), "hi"_s);
+
+    auto out_of_range = JSON::from_json<BindingMessage>(R"({"level": 300})"_sv);
+    EXPECT_EQ(out_of_range.to_error()->error_string(), "Integer out of range for the member"_sv);
+    auto missing = JSON::from_json<BindingMessage>(R"({"id": 1, "level": 1})"_sv);
+    EXPECT_EQ(missing.to_error()->error_string(), "Missing key name"_sv);
+    auto wrong_type = JSON::from_json<BindingMessage>(R"({"points": [{"x": "1"}]})"_sv);
+    EXPECT_TRUE(wrong_type.is_error());
+    if (wrong_type.is_error()) wrong_type.ignore_error();
+    // unsigned 64 bit members use their whole range
+    const BindingCounter counter{ 18446744073709551615ull };
+    const auto counter_json = JSON::to_json(counter);
+    EXPECT_EQ(counter_json, R"({"count":18446744073709551615})"_s);
+    EXPECT_EQ(JSON::from_json<BindingCounter>(counter_json.view()).to_ok().count, counter.count);
+    auto too_big = JSON::from_json<BindingCounter>(R"({"count": 18446744073709551616})"_sv);
+    EXPECT_TRUE(too_big.to_error()->error_string().starts_with("Integer out of range"_sv));
+    auto negative = JSON::from_json<BindingCounter>(R"({"count": -1})"_sv);
+    EXPECT_TRUE(negative.to_error()->error_string().starts_with("Expected an unsigned integer"_sv));
+}
+TEST(ARLibTests, JSONQueryTest) {
+    constexpr auto source = R"({"store": {"books": [{"title": "a", "price": 8}, {"title": "b", "price": 12},
+                               {"title": "c", "price": 9}], "a/b": {"m~n": 1}, "10": true}})"_sv;
+    auto document  = JSON::StructuralParser::parse(source).to_ok();
+    auto on_demand = JSON::OnDemandDocument::parse(source).to_ok();
+    auto check_single = [&](StringView text, bool pointer, int64_t expected) {
+        auto query = pointer ? JSON::Query::pointer(text).to_ok() : JSON::Query::path(text).to_ok();
+        EXPECT_TRUE(query.is_single());
+        const auto* found = query.find(document.root());
+        EXPECT_NE(found, nullptr);
+        if (found) { EXPECT_EQ(found->as<JSON::Type::JNumber>().value_integer(), expected); }
+        EXPECT_EQ(query.find(on_demand.root()).get_int64().to_ok(), expected);
+    };
+    check_single("/store/books/1/price"_sv, true, 12);
+    check_single("/store/a~1b/m~0n"_sv, true, 1);
+    check_single("$.store.books[-1].price"_sv, false, 9);
+    check_single("$['store'][\"a/b\"]['m~n']"_sv, false, 1);
+    // "10" is a member name here, not an index
+    auto member = JSON::Query::pointer("/store/10"_sv).to_ok();
+    EXPECT_TRUE(member.find(document.root())->as<JSON::Type::JBool>().value());
+    EXPECT_EQ(JSON::Query::pointer(""_sv).to_ok().find(document.root()), &document.root());
+
+    auto missing = JSON::Query::path("$.store.books[3].price"_sv).to_ok();
+    EXPECT_EQ(missing.find(document.root()), nullptr);
+    EXPECT_TRUE(missing.find(on_demand.root()).is_missing());
+    EXPECT_EQ(missing.find(on_demand.root()).get_int64().to_error()->message(), "Index out of bounds"_s);
+    auto wrong_type = JSON::Query::pointer("/store/books/title"_sv).to_ok();
+    EXPECT_EQ(wrong_type.find(document.root()), nullptr);
+
+    auto collect = [&](StringView path) {
+        auto query = JSON::Query::path(path).to_ok();
+        EXPECT_FALSE(query.is_single());
+        Vector<String> dom_titles{};
+        query.for_each(document.root(), [&dom_titles](const JSON::ValueObj& value) {
+            dom_titles.append(value.as<JSON::Type::JString>());
+        });
+        Vector<String> on_demand_titles{};
+        auto res = query.for_each(on_demand.root(), [&on_demand_titles](const JSON::OnDemandValue& value) {
+            on_demand_titles.append(value.get_string().to_ok());
+        });
+        EXPECT_TRUE(res.is_ok());
+        EXPECT_EQ(dom_titles, on_demand_titles);
+        return dom_titles;
+    };
+    EXPECT_EQ(collect("$.store.books[*].title"_sv), (Vector<String>{ "a"_s, "b"_s, "c"_s }));
+    EXPECT_EQ(collect("$.store.books[1:].title"_sv), (Vector<String>{ "b"_s, "c"_s }));
+    EXPECT_EQ(collect("$.store.books[::-2].title"_sv), (Vector<String>{ "c"_s, "a"_s }));
+    EXPECT_EQ(collect("$.store.books[-2:-1].title"_sv), (Vector<String>{ "b"_s }));
+    EXPECT_EQ(collect("$.store.books[5:].title"_sv), (Vector<String>{}));
+
+    const Array invalid{ "store"_sv, "$..books"_sv, "$.books[?(@.price)]"_sv, "$.books[0,1]"_sv, "$.books[::0]"_sv,
+                         "$.books['a]"_sv };
+    for (const auto& path : invalid) {
+        auto res = JSON::Query::path(path);
+        EXPECT_TRUE(res.is_error());
+        if (res.is_error()) res.ignore_error();
+    }
+    auto bad_escape = JSON::Query::pointer("/a~2"_sv);
+    EXPECT_EQ(bad_escape.to_error()->offset(), 2ull);
+}
+TEST(ARLibTests, CSVReaderTest) {
+    const auto source = "id,name,notes\r\n"
+                        "1,plain,\"quoted, with a comma\"\r\n"
+                        "\r\n"
+                        "2,\"two\nlines\",\"say \"\"hi\"\"\"  \n"
+                        "\n"
+                        "3,,\"\""_s;
+    CSVReader reader{ source.view() };
+    EXPECT_TRUE(reader.read_header().is_ok());
+    EXPECT_EQ(reader.header(), (Vector<String>{ "id"_s, "name"_s, "notes"_s }));
+    EXPECT_EQ(reader.column_index("notes"_sv), 2ull);
+    EXPECT_EQ(reader.column_index("missing"_sv), npos_);
+    Vector<Vector<String>> rows{};
+    auto res = reader.for_each_row([&rows](Span<const StringView> row) {
+        Vector<String> fields{};
+        for (const auto& field : row) { fields.append(field.str()); }
+        rows.append(move(fields));
+    });
+    EXPECT_TRUE(res.is_ok());
+    EXPECT_EQ(rows.size(), 3ull);
+    EXPECT_EQ(rows[0], (Vector<String>{ "1"_s, "plain"_s, "quoted, with a comma"_s }));
+    EXPECT_EQ(rows[1], (Vector<String>{ "2"_s, "two\nlines"_s, "say \"hi\""_s }));
+    EXPECT_EQ(rows[2], (Vector<String>{ "3"_s, ""_s, ""_s }));
+    auto eof = reader.read_row();
+    EXPECT_TRUE(eof.is_error() && eof.to_error()->is_eof());
+
+    // quoted fields and escapes that straddle the 64 byte blocks the input is scanned in
+    String long_field{};
+    for (size_t i = 0; i < 150; ++i) { long_field.append(i % 7 == 0 ? ',' : static_cast<char>('a' + i % 26)); }
+    const auto straddling = "x;\""_s + long_field + "\"\"\";" + long_field + "\n;last"_s;
+    CSVReader semicolons{ straddling.view(), ';' };
+    auto first = semicolons.read_row();
+    EXPECT_TRUE(first.is_ok());
+    if (first.is_ok()) {
+        const auto row = first.to_ok();
+        EXPECT_EQ(row.size(), 3ull);
+        EXPECT_EQ(row[1], (long_field + "\""_s).view());
+        EXPECT_EQ(row[2], long_field.view());
+    }
+    auto second = semicolons.read_row();
+    EXPECT_TRUE(second.is_ok());
+    if (second.is_ok()) { EXPECT_EQ(second.to_ok()[1], "last"_sv); }
+
+    const Array invalid{ "a,b\"c\n"_sv, "\"a\"b,c\n"_sv, "\"a\"b\"\n"_sv, "a,\"never closed\n"_sv };
+    for (const auto& csv : invalid) {
+        CSVReader bad{ csv };
+        auto row = bad.read_row();
+        EXPECT_TRUE(row.is_error() && !row.to_error()->is_eof());
+    }
+}
+TEST(ARLibTests, CSVParallelTest) {
+    String input{};
+    for (size_t i = 0; i < 2000; ++i) {
+        if (i % 100 == 0) input.append("\r\n");
+        input.append(String::formatted("%zu,", i));
+        // quoted newlines and separators make a lot of the fixed size pieces start inside a quoted field
+        if (i % 3 == 0) {
+            input.append("\"multi\nline, \"\"quoted\"\"\nfield\"");
+        } else {
+            input.append("plain");
+        }
+        input.append(i % 2 == 0 ? ",end\r\n"_sv : ",end\n"_sv);
+    }
+    input.append("2000,\"last\",end");
+    Vector<size_t> offsets{};
+    Vector<Vector<String>> expected{};
+    CSVReader reader{ input.view() };
+    auto sequential = reader.for_each_row([&](Span<const StringView> row) {
+        offsets.append(reader.row_offset());
+        Vector<String> fields{};
+        for (const auto& field : row) { fields.append(field.str()); }
+        expected.append(move(fields));
+    });
+    EXPECT_TRUE(sequential.is_ok());
+    EXPECT_EQ(expected.size(), 2001ull);
+    ThreadPool pool{ 3 };
+    CSVParallelOptions options{};
+    options.pool       = &pool;
+    options.chunk_size = 64;
+    {
+        size_t count  = 0;
+        bool in_order = true;
+        auto res      = CSVParallelParser::parse(input.view(), [&](size_t offset, Span<const StringView> row) {
+            bool same = count < expected.size() && offset == offsets[count] && row.size() == expected[count].size();
+            for (size_t i = 0; same && i < row.size(); ++i) { same = row[i] == expected[count][i].view(); }
+            in_order = in_order && same;
+            ++count;
+        }, options);
+        EXPECT_TRUE(res.is_ok());
+        EXPECT_EQ(count, 2001ull);
+        EXPECT_TRUE(in_order);
+    }
+    {
+        options.ordered = false;
+        Atomic<size_t> sum{ 0 };
+        Atomic<size_t> count{ 0 };
+        auto res = CSVParallelParser::parse(input.view(), [&](size_t, Span<const StringView> row) {
+            sum.fetch_add(StrViewToU64(row[0]).to_ok());
+            count.fetch_add(1);
+        }, options);
+        EXPECT_TRUE(res.is_ok());
+        EXPECT_EQ(count.load(), 2001ull);
+        EXPECT_EQ(sum.load(), 2001ull * 2000ull / 2ull);
+        options.ordered = true;
+    }
+    {
+        // everything before the malformed row is still delivered
+        String broken             = input;
+        broken[offsets[1501] + 5] = '"';
+        size_t count              = 0;
+        auto res = CSVParallelParser::parse(broken.view(), [&](size_t, Span<const StringView>) { ++count; }, options);
+        EXPECT_TRUE(res.is_error());
+        if (res.is_error()) { EXPECT_FALSE(res.to_error()->is_eof()); }
+        EXPECT_EQ(count, 1501ull);
+    }
+    EXPECT_EQ(detail::complete_rows("a,\"b\nc\"\nd,\"e\n"_sv), 8ull);
+    EXPECT_EQ(detail::complete_rows("a,\"b\nc"_sv), 0ull);
+}
+TEST(ARLibTests, CSVColumnsTest) {
+    const auto source = "id,price,active,city,seen\n"
+                        "1,2.5,true,Rome,2024-02-29\n"
+                        "2,,false,\"Paris, France\",1969-12-31T23:59:59Z\n"
+                        "3,4,TRUE,Rome,2000-03-01 12:30:15.5+02:00\n"_s;
+    auto parsed = CSVTable::parse(source.view());
+    EXPECT_TRUE(parsed.is_ok());
+    if (parsed.is_error()) return;
+    const auto table = parsed.to_ok();
+    EXPECT_EQ(table.rows(), 3ull);
+    EXPECT_EQ(table.column_count(), 5ull);
+    EXPECT_EQ(table.column_index("missing"_sv), npos_);
+    const auto& id = table.column(table.column_index("id"_sv));
+    EXPECT_EQ(id.type(), CSVColumnType::Int64);
+    EXPECT_EQ(id.integers()[2], 3);
+    const auto& price = table.column(table.column_index("price"_sv));
+    EXPECT_EQ(price.type(), CSVColumnType::Double);
+    EXPECT_EQ(price.doubles()[0], 2.5);
+    EXPECT_TRUE(price.is_null(1));
+    EXPECT_FALSE(price.is_null(2));
+    const auto& active = table.column(table.column_index("active"_sv));
+    EXPECT_EQ(active.type(), CSVColumnType::Bool);
+    EXPECT_EQ(active.bools()[1], 0);
+    EXPECT_EQ(active.bools()[2], 1);
+    // every distinct string is stored once
+    const auto& city = table.column(table.column_index("city"_sv));
+    EXPECT_EQ(city.type(), CSVColumnType::String);
+    EXPECT_EQ(city.dictionary().size(), 2ull);
+    EXPECT_EQ(city.codes()[0], city.codes()[2]);
+    EXPECT_EQ(city.string_at(1), "Paris, France"_sv);
+    const auto& seen = table.column(table.column_index("seen"_sv));
+    EXPECT_EQ(seen.type(), CSVColumnType::Timestamp);
+    EXPECT_EQ(seen.integers()[0], 1709164800000000);
+    EXPECT_EQ(seen.integers()[1], -1000000);
+    EXPECT_EQ(seen.integers()[2], 951906615500000);
+
+    // a schema can pick and type just some of the columns
+    const Vector<CSVColumnSpec> schema{ CSVColumnSpec{ "city"_s, CSVColumnType::String },
+                                        CSVColumnSpec{ "id"_s, CSVColumnType::Double } };
+    auto projected = CSVTable::parse(source.view(), schema);
+    EXPECT_TRUE(projected.is_ok());
+    if (projected.is_ok()) {
+        const auto picked   = projected.to_ok();
+        const auto& columns = picked.columns();
+        EXPECT_EQ(columns.size(), 2ull);
+        EXPECT_EQ(columns[0].string_at(0), "Rome"_sv);
+        EXPECT_EQ(columns[1].doubles()[1], 2.0);
+    }
+    CSVTableOptions no_header{};
+    no_header.has_header = false;
+    auto headerless      = CSVTable::parse("1,a\n2,b\n"_sv, no_header);
+    EXPECT_TRUE(headerless.is_ok());
+    if (headerless.is_ok()) { EXPECT_EQ(headerless.to_ok().column_index("1"_sv), 1ull); }
+
+    auto missing = CSVTable::parse(source.view(), Vector{ CSVColumnSpec{ "nope"_s, CSVColumnType::Int64 } });
+    EXPECT_TRUE(missing.is_error());
+    if (missing.is_error()) missing.ignore_error();
+    // the first row says integer, the last one disagrees
+    CSVTableOptions short_inference{};
+    short_inference.inference_rows = 1;
+    auto mismatch                  = CSVTable::parse("a\n1\nx\n"_sv, short_inference);
+    EXPECT_TRUE(mismatch.is_error());
+    if (mismatch.is_error()) { EXPECT_EQ(mismatch.to_error()->offset(), 4ull); }
+    EXPECT_TRUE(parse_iso8601_timestamp("2023-02-29"_sv).empty());
+    EXPECT_TRUE(parse_iso8601_timestamp("2023-01-01T25:00"_sv).empty());
+}
+TEST(ARLibTests, CSVWriterTest) {
+    CSVWriter writer{};
+    writer.row("plain"_sv, "with, comma"_s, "say \"hi\"", -42, 18446744073709551615ull, 0.1, true);
+    writer.field("two\nlines"_sv).null().number(1e300).end_row();
+    writer.null().end_row();
+    EXPECT_EQ(writer.str(), "plain,\"with, comma\",\"say \"\"hi\"\"\",-42,18446744073709551615,0.1,true\n"
+                            "\"two\nlines\",,1e+300\n"
+                            "\"\"\n"_s);
+    // what the writer produces reads back as the same fields
+    CSVReader reader{ writer.str().view() };
+    auto first = reader.read_row();
+    EXPECT_TRUE(first.is_ok());
+    if (first.is_ok()) { EXPECT_EQ(first.to_ok()[2], "say \"hi\""_sv); }
+    auto second = reader.read_row();
+    EXPECT_TRUE(second.is_ok());
+    if (second.is_ok()) { EXPECT_EQ(second.to_ok()[0], "two\nlines"_sv); }
+    auto third = reader.read_row();
+    EXPECT_TRUE(third.is_ok());
+    if (third.is_ok()) { EXPECT_EQ(third.to_ok().size(), 1ull); }
+
+    CSVWriterOptions options{};
+    options.separator = ';';
+    options.crlf      = true;
+    CSVWriter semicolons{ options };
+    semicolons.row("a,b"_sv, "c;d"_sv);
+    EXPECT_EQ(semicolons.str(), "a,b;\"c;d\"\r\n"_s);
+
+    // a table written out and read back is the same table
+    const auto source = "id,price,city,seen\n"
+                        "1,2.5,\"Rome, Italy\",2024-02-29T10:00:00Z\n"
+                        "2,,Paris,1969-12-31T23:59:59.250Z\n"_s;
+    const auto table  = CSVTable::parse(source.view()).to_ok();
+    CSVWriter table_writer{};
+    table_writer.table(table);
+    EXPECT_EQ(table_writer.str(), "id,price,city,seen\n"
+                                  "1,2.5,\"Rome, Italy\",2024-02-29T10:00:00Z\n"
+                                  "2,,Paris,1969-12-31T23:59:59.250000Z\n"_s);
+
+    // with a sink the output goes to the stream once the buffer is big enough and on flush
+    StringStream stream{};
+    CSVWriter stream_writer{ stream };
+    for (int64_t i = 0; i < 200000; ++i) { stream_writer.row(i, "value"_sv); }
+    EXPECT_TRUE(stream_writer.str().size() < CSVWriter::flush_threshold);
+    EXPECT_TRUE(stream_writer.flush().is_ok());
+    EXPECT_EQ(stream_writer.str().size(), 0ull);
+    size_t rows     = 0;
+    const auto data = stream.str();
+    CSVReader streamed{ data.view() };
+    auto res = streamed.for_each_row([&rows](Span<const StringView> row) {
+        if (row[0] == IntToStr(rows).view()) ++rows;
+    });
+    EXPECT_TRUE(res.is_ok());
+    EXPECT_EQ(rows, 200000ull);
+}
+TEST(ARLibTests, RegexTest) {
+    auto date = "(\\d{4})-(\\d\\d)-(\\d\\d)"_re;
+    EXPECT_TRUE(date.match("2024-02-29"_sv));
+    EXPECT_FALSE(date.match("2024-02-29 "_sv));
+    EXPECT_TRUE(date.contains("released on 2024-02-29, fixed later"_sv));
+    EXPECT_FALSE(date.contains("released on 2024-02, fixed later"_sv));
+    auto found = date.captures("released on 2024-02-29, fixed later"_sv);
+    EXPECT_TRUE(found.has_value());
+    if (found) {
+        EXPECT_EQ(found->begin(), 12ull);
+        EXPECT_EQ(found->str(), "2024-02-29"_sv);
+        EXPECT_EQ(found->group_count(), 3ull);
+        EXPECT_EQ(found->group(1), "2024"_sv);
+        EXPECT_EQ(found->group(3), "29"_sv);
+    }
+
+    // the first alternative that matches wins, greedy and lazy repeats take as much and as little as they can
+    EXPECT_EQ("a|ab"_re.search("xab"_sv)->str(), "a"_sv);
+    EXPECT_TRUE("a|ab"_re.match("ab"_sv));
+    EXPECT_EQ("<.+>"_re.search("<a><b>"_sv)->str(), "<a><b>"_sv);
+    EXPECT_EQ("<.+?>"_re.search("<a><b>"_sv)->str(), "<a>"_sv);
+    EXPECT_EQ("x{2,}"_re.search("axxxxb"_sv)->size(), 4ull);
+    EXPECT_EQ("x{1,3}?y"_re.search("xxxxy"_sv)->begin(), 1ull);
+    EXPECT_EQ("[^0-9\\s]+"_re.search("12 ab3"_sv)->str(), "ab"_sv);
+    EXPECT_EQ("\\S+\\D"_re.search("  k9x"_sv)->str(), "k9x"_sv);
+    EXPECT_TRUE("^a.c$"_re.match("abc"_sv));
+    EXPECT_FALSE("^b"_re.contains("ab"_sv));
+    EXPECT_FALSE("a.c"_re.contains("a\nc"_sv));
+    EXPECT_TRUE("a\\nc"_re.match("a\nc"_sv));
+    auto optional = "(a)|(b)"_re.captures("b"_sv);
+    EXPECT_FALSE(optional->has_group(1));
+    EXPECT_EQ(optional->group(2), "b"_sv);
+    // groups of a match that ends before a higher priority alternative could have
+    const auto stopped = "(a.*b|a)(x*)"_re.captures("axxxaxxx"_sv);
+    EXPECT_EQ(stopped->group(1), "a"_sv);
+    EXPECT_EQ(stopped->group(2), "xxx"_sv);
+
+    Vector<String> words{};
+    const auto word_regex = "\\w+"_re;
+    for (const auto& word : word_regex.find_all("one, two  three"_sv)) { words.append(word.str().str()); }
+    EXPECT_EQ(words.size(), 3ull);
+    if (words.size() == 3) { EXPECT_EQ(words[2], "three"_s); }
+    size_t empty_matches   = 0;
+    const auto empty_regex = "x*"_re;
+    for (const auto& match : empty_regex.find_all("ab"_sv)) { empty_matches += match.size() == 0; }
+    EXPECT_EQ(empty_matches, 3ull);
+
+    // nested repeats that make a backtracking engine take exponential time
+    String as{};
+    for (size_t i = 0; i < 10000; ++i) as.append('a');
+    EXPECT_FALSE("(a*)*b"_re.contains(as.view()));
+    EXPECT_TRUE("(a|aa)+$"_re.match(as.view()));
+    // far more DFA states than fit in the cache, the search goes on with the PikeVM
+    String ab{};
+    for (size_t i = 0; i < 20000; ++i) ab.append(((i * 2654435761u) >> 13) & 1 ? 'a' : 'b');
+    ab.append("a0123456789abcdefc"_sv);
+    auto blowup = "(a|b)*a[0-9a-f]{16}c"_re;
+    EXPECT_EQ(blowup.search(ab.view())->end(), ab.size());
+
+    const Array invalid_patterns{ "*a"_sv, "a{3,1}"_sv, "[z-a]"_sv, "(ab"_sv, "a**"_sv };
+    for (const auto& pattern : invalid_patterns) {
+        auto result = Regex::create(pattern);
+        EXPECT_TRUE(result.is_error());
+        if (result.is_error()) result.to_error();
+    }
+}
+TEST(ARLibTests, RegexPrefilterTest) {
+    // a long haystack with the literal of every pattern only in a few places
+    String logs{};
+    for (size_t i = 0; i < 2000; ++i) logs.append("12:00:01 INFO all good here, code=0 took 3 ms\n"_sv);
+    const size_t error_at = logs.size();
+    logs.append("12:00:02 ERROR disk full code=28\n"_sv);
+    for (size_t i = 0; i < 100; ++i) logs.append("12:00:03 INFO ERROR was a false alarm\n"_sv);
+
+    // literal prefix
+    const auto prefix = "ERROR .* code=[0-9]+"_re;
+    auto found        = prefix.search(logs.view());
+    EXPECT_TRUE(found.has_value());
+    if (found) {
+        EXPECT_EQ(found->begin(), error_at + 9);
+        EXPECT_EQ(found->str(), "ERROR disk full code=28"_sv);
+    }
+    EXPECT_FALSE(prefix.search(logs.view(), found->end()).has_value());
+    // required literal a bounded number of bytes into the match
+    const auto bounded = "[0-9]{2}:[0-9]{2} ERROR"_re;
+    EXPECT_EQ(bounded.search(logs.view())->begin(), error_at + 3);
+    size_t errors = 0;
+    for (const auto& match : bounded.find_all(logs.view())) errors += match.size() == 11;
+    EXPECT_EQ(errors, 1ull);
+    // required literal with no bound, the match starts before it
+    const auto unbounded = "\\w+ full code=\\d+"_re;
+    EXPECT_EQ(unbounded.search(logs.view())->str(), "disk full code=28"_sv);
+    EXPECT_FALSE("\\w+ code=29"_re.contains(logs.view()));
+    EXPECT_TRUE("^12:00:01 INFO.*3 ms"_re.contains(logs.view()));
+    EXPECT_EQ("took (3|4) ms"_re.search(logs.view())->begin(), 36ull);
+    EXPECT_EQ("(was|wasn't) a"_re.captures(logs.view())->group(1), "was"_sv);
+
+    // candidates that overlap each other and the literal at the very end of the input
+    EXPECT_EQ("aab"_re.search("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab"_sv)->begin(), 38ull);
+    EXPECT_EQ("x[ab]*yz"_re.search("xaxbxyxaby zxabbbbbbbbbbbbbbbbbbbbbbbbbbbbbyz"_sv)->begin(), 12ull);
+    EXPECT_FALSE("abc"_re.contains("abababababababababababababababababababab"_sv));
+}
+TEST(ARLibTests, AhoCorasickTest) {
+    const Array patterns{ "he"_sv, "she"_sv, "his"_sv, "hers"_sv, ""_sv, "he"_sv };
+    AhoCorasick matcher{ patterns.span() };
+    EXPECT_EQ(matcher.pattern_count(), 6ull);
+    const auto matches = matcher.find_all("ushers and this"_sv);
+    // the empty pattern at the start, she and both copies of he ending at 4, hers, then his
+    EXPECT_EQ(matches.size(), 6ull);
+    if (matches.size() == 6) {
+        EXPECT_EQ(matches[0].pattern, 4ull);
+        EXPECT_EQ(matches[1].pattern, 1ull);
+        EXPECT_EQ(matches[1].begin, 1ull);
+        EXPECT_EQ(matches[4].pattern, 3ull);
+        EXPECT_EQ(matches[4].end, 6ull);
+        EXPECT_EQ(matches[5].pattern, 2ull);
+        EXPECT_EQ(matches[5].begin, 12ull);
+    }
+    Vector<size_t> found{};
+    matcher.which("this"_sv, found);
+    EXPECT_EQ(found.size(), 2ull);
+    if (found.size() == 2) {
+        EXPECT_EQ(found[0], 4ull);
+        EXPECT_EQ(found[1], 2ull);
+    }
+
+    // first bytes far apart in a long text, the search skips from the root
+    const Array keywords{ "timeout"_sv, "refused"_sv };
+    AhoCorasick errors{ keywords.span() };
+    String text{};
+    for (size_t i = 0; i < 1000; ++i) text.append("all requests done "_sv);
+    EXPECT_FALSE(errors.contains(text.view()));
+    text.append("connection refused"_sv);
+    EXPECT_TRUE(errors.contains(text.view()));
+    const auto refused = errors.find_all(text.view());
+    EXPECT_EQ(refused.size(), 1ull);
+    if (refused.size() == 1) { EXPECT_EQ(refused[0].end, text.size()); }
+}
+TEST(ARLibTests, RegexSetTest) {
+    const Array patterns{ "ERROR .* code=[0-9]+"_sv, "^\\d{4}-"_sv, "timeout|refused"_sv, "done$"_sv, "(a|b)+c"_sv };
+    auto set = MUST(RegexSet::create(patterns.span()));
+    EXPECT_EQ(set.size(), 5ull);
+    auto matched = set.matches("2024-01-01 ERROR connection refused code=111"_sv);
+    EXPECT_EQ(matched.size(), 3ull);
+    if (matched.size() == 3) {
+        EXPECT_EQ(matched[0], 0ull);
+        EXPECT_EQ(matched[1], 1ull);
+        EXPECT_EQ(matched[2], 2ull);
+    }
+    set.matches("x 2024-01-01 abababc done"_sv, matched);
+    EXPECT_EQ(matched.size(), 2ull);
+    if (matched.size() == 2) {
+        EXPECT_EQ(matched[0], 3ull);
+        EXPECT_EQ(matched[1], 4ull);
+    }
+    EXPECT_TRUE(set.contains("request done"_sv));
+    EXPECT_FALSE(set.contains("request finished"_sv));
+    EXPECT_TRUE(set.matches(""_sv).empty());
+
+    // plain literals run on Aho-Corasick, with the same results
+    const Array literals{ "disk"_sv, "full"_sv, "\\(x\\)"_sv };
+    auto literal_set = MUST(RegexSet::create(literals.span()));
+    EXPECT_EQ(literal_set.matches("(x) the disk is full"_sv).size(), 3ull);
+    EXPECT_EQ(literal_set.matches("the disk is fine"_sv).size(), 1ull);
+
+    const Array invalid{ "ok"_sv, "(broken"_sv };
+    auto result = RegexSet::create(invalid.span());
+    EXPECT_TRUE(result.is_error());
+    if (result.is_error()) result.to_error();
+}
+#ifdef STRINGLITERAL_AVAILABLE
+TEST(ARLibTests, CompileTimeRegexTest) {
+    static_assert(cx_regex<"\\d{4}-\\d{2}-\\d{2}">.match("2024-05-17"));
+    static_assert(!cx_regex<"\\d{4}-\\d{2}-\\d{2}">.match("2024-05-1"));
+    static_assert(cx_regex<"(cat|dog)s?">.contains("hot dogs"));
+    constexpr auto& email = cx_regex<"([a-z.]+)@(\\w+)\\.(com|org)">;
+    static_assert(email.group_count == 3);
+    const StringView text{ "mail john.doe@example.org or admin@site.com" };
+    const auto first = email.captures(text);
+    EXPECT_TRUE(first.has_value());
+    EXPECT_EQ(first->str(), "john.doe@example.org"_sv);
+    EXPECT_EQ(first->group(1), "john.doe"_sv);
+    EXPECT_EQ(first->group(2), "example"_sv);
+    EXPECT_EQ(first->group(3), "org"_sv);
+    const auto second = email.search(text, first->end());
+    EXPECT_TRUE(second.has_value());
+    EXPECT_EQ(second->str(), "admin@site.com"_sv);
+    // same priorities as Regex: first alternative, greedy and lazy repeats
+    const StringView html{ "<b>bold</b>" };
+    EXPECT_EQ(cx_regex<"<.+>">.search(html)->str(), "<b>bold</b>"_sv);
+    EXPECT_EQ(cx_regex<"<.+?>">.search(html)->str(), "<b>"_sv);
+    EXPECT_EQ(cx_regex<"a|ab">.search("xab")->str(), "a"_sv);
+    const auto optional = cx_regex<"(a)|b">.captures("b");
+    EXPECT_FALSE(optional->has_group(1));
+    // an optional group that matches nothing still takes part
+    const auto empty_group = cx_regex<"(a?)?b">.captures("b");
+    EXPECT_TRUE(empty_group->has_group(1));
+    EXPECT_EQ(empty_group->group(1), ""_sv);
+    EXPECT_TRUE("(a?)?b"_re.captures("b")->has_group(1));
+    // without an upper bound the empty iteration is dropped, in both
+    EXPECT_EQ(cx_regex<"(a?)*b">.captures("b")->has_group(1), "(a?)*b"_re.captures("b")->has_group(1));
+    EXPECT_FALSE(cx_regex<"^abc">.contains("xabc"));
+    EXPECT_TRUE(cx_regex<"c$">.contains("abc"));
+    EXPECT_FALSE(cx_regex<"[^a-z]">.contains("abc"));
+    EXPECT_FALSE(cx_regex<"x">.search("abc").has_value());
+    // agrees with Regex
+    const auto regex = "([a-c]+?)(b*)c"_re;
+    const Array texts{ "abcbc"_sv, "cc"_sv, "bbb"_sv, "aabbc"_sv, ""_sv };
+    for (const auto& sample : texts) {
+        const auto expected = regex.captures(sample);
+        const auto found    = cx_regex<"([a-c]+?)(b*)c">.captures(sample);
+        EXPECT_EQ(expected.has_value(), found.has_value());
+        if (!expected) continue;
+        EXPECT_EQ(expected->str(), found->str());
+        EXPECT_EQ(expected->group(1), found->group(1));
+        EXPECT_EQ(expected->group(2), found->group(2));
+    }
+}
+#endif
+TEST(ARLibTests, MappedFileTest) {
+    const Path path{ "mapped_file_test.csv"_p };
+    String contents{ "name,count\n"_s };
+    for (size_t i = 0; i < 5000; ++i) contents.append(String::formatted("item%zu,%zu\n", i, i * 3));
+    EXPECT_FALSE(File::write_all(path, contents).is_error());
+    {
+        const auto file = MUST(MappedFile::open(path));
+        EXPECT_EQ(file.size(), contents.size());
+        EXPECT_EQ(file.view(), contents.view());
+        EXPECT_EQ(file.bytes()[0], static_cast<uint8_t>('n'));
+        // the mapping doesn't move with the object
+        const char* begin = file.view().data();
+        auto moved        = MappedFile::open(path, { .access = MappedFileAccess::Random, .populate = true }).to_ok();
+        auto other        = move(moved);
+        EXPECT_EQ(other.view(), contents.view());
+        other = MUST(MappedFile::open(path, { .will_need = true, .huge_pages = true }));
+        EXPECT_EQ(other.view(), contents.view());
+        EXPECT_EQ(file.view().data(), begin);
+    }
+    // the parsers read straight from the mapping
+    const auto table = MUST(CSVTable::from_file(path));
+    EXPECT_EQ(table.rows(), 5000ull);
+    auto reader = MUST(CSVReader::from_file(path));
+    EXPECT_FALSE(reader.read_header().is_error());
+    size_t rows = 0;
+    EXPECT_FALSE(reader.for_each_row([&](Span<const StringView>) { ++rows; }).is_error());
+    EXPECT_EQ(rows, 5000ull);
+    File::remove(path);
+    const Path empty{ "mapped_file_empty.txt"_p };
+    EXPECT_FALSE(File::write_all(empty, ""_s).is_error());
+    const auto empty_file = MUST(MappedFile::open(empty));
+    EXPECT_TRUE(empty_file.empty());
+    EXPECT_EQ(empty_file.view(), ""_sv);
+    File::remove(empty);
+    auto missing = MappedFile::open("mapped_file_missing.txt"_p);
+    EXPECT_TRUE(missing.is_error());
+    EXPECT_FALSE(missing.to_error()->error_string().is_empty());
+}
+#ifndef DISABLE_THREADING
+TEST(ARLibTests, AsyncFileIOTest) {
+    Vector<Path> paths{};
+    Vector<String> expected{};
+    for (size_t i = 0; i < 150; ++i) {
+        paths.append(Path{ String::formatted("async_io_test_%zu.txt", i) });
+        String contents{};
+        for (size_t j = 0; j < i * 7; ++j) contents.append(static_cast<char>('a' + (i + j) % 26));
+        EXPECT_FALSE(File::write_all(paths[i], contents).is_error());
+        expected.append(move(contents));
+    }
+    for (bool force_thread_pool : { false, true }) {
+        AsyncFileIO io{ { .queue_depth = 16, .force_thread_pool = force_thread_pool } };
+        if (force_thread_pool) { EXPECT_EQ(io.backend(), AsyncIOBackendKind::ThreadPool); }
+        const auto contents = MUST(io.read_files(Span<const Path>{ paths.data(), paths.size() }));
+        EXPECT_EQ(contents.size(), expected.size());
+        for (size_t i = 0; i < contents.size(); ++i) EXPECT_EQ(contents[i], expected[i]);
+        // a batch of writes out of a registered buffer, read back into it through the fixed file
+        uint8_t buffer[4096]{};
+        for (size_t i = 0; i < 2048; ++i) buffer[i] = static_cast<uint8_t>(i * 31);
+        Span<uint8_t> registered[]{ Span<uint8_t>{ buffer, sizeof(buffer) } };
+        io.register_buffers(Span<const Span<uint8_t>>{ registered, 1 });
+        const Path path{ "async_io_test_rw.bin"_p };
+        const auto file = MUST(io.open(path, OpenFileMode::ReadWrite));
+        size_t completed = 0;
+        size_t bytes     = 0;
+        io.on_completion([&](const AsyncIOCompletion& completion) {
+            EXPECT_TRUE(completion.ok());
+            ++completed;
+            bytes += completion.bytes;
+        });
+        for (size_t i = 0; i < 32; ++i) io.write(file, i * 64, Span<const uint8_t>{ buffer + i * 64, 64 }, i);
+        EXPECT_EQ(io.outstanding(), 32ull);
+        io.drain();
+        EXPECT_EQ(completed, 32ull);
+        EXPECT_EQ(bytes, 2048ull);
+        EXPECT_EQ(io.size(file), 2048ull);
+        io.read(file, 0, Span<uint8_t>{ buffer + 2048, 2048 }, 0);
+        // past the end of the file a read completes with nothing
+        io.read(file, 4096, Span<uint8_t>{ buffer, 16 }, 1);
+        EXPECT_EQ(io.wait(2), 2ull);
+        EXPECT_EQ(bytes, 4096ull);
+        EXPECT_EQ(ARLib::memcmp(buffer, buffer + 2048, 2048), 0);
+        io.close(file);
+        File::remove(path);
+        // completions can run on an event loop instead
+        EventLoop loop{};
+        Atomic<size_t> delivered{ 0 };
+        io.deliver_to(loop);
+        io.on_completion([&](const AsyncIOCompletion& completion) {
+            if (completion.ok()) delivered.fetch_add(1);
+        });
+        Vector<String> targets{};
+        targets.resize(paths.size());
+        Vector<AsyncFileHandle> files{};
+        for (size_t i = 0; i < paths.size(); ++i) {
+            files.append(MUST(io.open(paths[i], OpenFileMode::Read)));
+            targets[i].resize(expected[i].size());
+            auto* target = reinterpret_cast<uint8_t*>(targets[i].rawptr());
+            io.read(files[i], 0, Span<uint8_t>{ target, targets[i].size() }, i);
+        }
+        io.drain();
+        loop.join();
+        EXPECT_EQ(delivered.load(), paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) {
+            EXPECT_EQ(targets[i], expected[i]);
+            io.close(files[i]);
+        }
+        // a file that isn't there fails the whole batch
+        Path missing[]{ paths[0], "async_io_test_missing.txt"_p };
+        auto result = io.read_files(Span<const Path>{ missing, 2 });
+        EXPECT_TRUE(result.is_error());
+        EXPECT_FALSE(result.to_error()->error_string().is_empty());
+    }
+    for (const auto& path : paths) File::remove(path);
+}
+#endif
 TEST(ARLibTests, RandomTest) {
     EXPECT_EQ(Random::PCG::random_s(), 355248013);
     auto pcg = Random::PCG::create();
@@ -1162,6 +2556,77 @@ TEST(ARLibTests, SortingTest) {
     Vector<String> v2{};
     sort(v2);    // shouldn't crash
 }
+TEST(ARLibTests, SortAlgorithmsTests) {
+    constexpr int count = 50000;
+    auto is_sorted      = [](const auto& cont, auto cmp) {
+        for (size_t i = 1; i < cont.size(); ++i) {
+            if (cmp(cont[i], cont[i - 1])) return false;
+        }
+        return true;
+    };
+    auto ascending = [](const auto& a, const auto& b) { return a < b; };
+    // patterns that make a naive quicksort go quadratic
+    for (int pattern = 0; pattern < 5; ++pattern) {
+        Vector<int> values{};
+        values.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            switch (pattern) {
+                case 0: values.append(i); break;
+                case 1: values.append(count - i); break;
+                case 2: values.append(i < count / 2 ? i : count - i); break;
+                case 3: values.append(42); break;
+                default: values.append((i * 7919) % 16); break;
+            }
+        }
+        sort(values);
+        EXPECT_TRUE(is_sorted(values, ascending));
+    }
+    Vector<int> values{};
+    uint32_t state = 1;
+    for (int i = 0; i < count; ++i) {
+        state = state * 1664525u + 1013904223u;
+        values.append(static_cast<int>(state >> 1) - (1 << 30));
+    }
+    Vector<int> radixed = values;
+    sort(values, [](const int& a, const int& b) { return b <=> a; });
+    EXPECT_TRUE(is_sorted(values, [](int a, int b) { return a > b; }));
+    radix_sort(radixed);
+    EXPECT_TRUE(is_sorted(radixed, ascending));
+    EXPECT_EQ(radixed[0], values[values.size() - 1]);
+
+    Vector<double> doubles{ 3.5, -0.5, 0.0, -100.25, 1e300, -1e-300, 2.0, -2.0 };
+    radix_sort(doubles);
+    EXPECT_TRUE(is_sorted(doubles, ascending));
+    EXPECT_EQ(doubles[0], -100.25);
+
+    struct Entry {
+        int key;
+        int order;
+    };
+    Vector<Entry> entries{};
+    Vector<Entry> by_radix{};
+    for (int i = 0; i < 1000; ++i) {
+        entries.append(Entry{ (i * 37) % 10, i });
+        by_radix.append(Entry{ (i * 37) % 10, i });
+    }
+    stable_sort(entries, [](const Entry& a, const Entry& b) { return a.key <=> b.key; });
+    radix_sort(by_radix, [](const Entry& e) { return e.key; });
+    bool stable = true;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        stable = stable && entries[i].key == by_radix[i].key && entries[i].order == by_radix[i].order;
+        if (i > 0 && entries[i].key == entries[i - 1].key) {
+            stable = stable && entries[i].order > entries[i - 1].order;
+        }
+    }
+    EXPECT_TRUE(stable);
+
+    Array words{ "pear"_sv, "apple"_sv, "fig"_sv, "apricot"_sv, "banana"_sv, "app"_sv };
+    radix_sort_strings(words, 8);
+    EXPECT_EQ(words[0], "app"_sv);
+    EXPECT_EQ(words[1], "apple"_sv);
+    EXPECT_EQ(words[2], "apricot"_sv);
+    EXPECT_EQ(words[5], "pear"_sv);
+}
 TEST(ARLibTests, SpanTests) {
     Vector<int> vec = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
     Array arr       = { "Hello"_sv, "World"_sv, "How"_sv, "Are"_sv, "You"_sv };
@@ -1,11 +1,18 @@
 #pragma once
+#include "AhoCorasick.hpp"
+#include "AsyncFileIO.hpp"
 #include "Algorithm.hpp"
 #include "Array.hpp"
 #include "Async.hpp"
 #include "BigInt.hpp"
 #include "CharConv.hpp"
 #include "Chrono.hpp"
+#include "CompileTimeRegex.hpp"
+#include "CSVColumns.hpp"
+#include "CSVParallel.hpp"
 #include "CSVParser.hpp"
+#include "CSVReader.hpp"
+#include "CSVWriter.hpp"
 #include "Enumerate.hpp"
 #include "EventLoop.hpp"
 #include "FixedMatrix.hpp"
@@ -14,18 +21,31 @@
 #include "GenericView.hpp"
 #include "Graph.hpp"
 #include "Hash.hpp"
+#include "JSONBinding.hpp"
+#include "JSONCompact.hpp"
+#include "JSONLines.hpp"
+#include "JSONOnDemand.hpp"
 #include "JSONParser.hpp"
+#include "JSONQuery.hpp"
+#include "JSONStreamReader.hpp"
+#include "JSONStructural.hpp"
+#include "JSONWriter.hpp"
 #include "LinkedSet.hpp"
 #include "List.hpp"
 #include "Map.hpp"
+#include "MappedFile.hpp"
 #include "Matrix.hpp"
 #include "Optional.hpp"
+#include "Parallel.hpp"
 #include "Printer.hpp"
 #include "PriorityQueue.hpp"
 #include "Process.hpp"
 #include "Random.hpp"
+#include "Reclamation.hpp"
+#include "Regex.hpp"
 #include "SSOVector.hpp"
 #include "Set.hpp"
+#include "Sort.hpp"
 #include "SortedVector.hpp"
 #include "Stack.hpp"
 #include "Stream.hpp"
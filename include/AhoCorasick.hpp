@@ -0,0 +1,67 @@
+#pragma once
+#include "Span.hpp"
+#include "StringView.hpp"
+#include "Vector.hpp"
+/*
+    multi-literal matcher.
+
+    the patterns go in a trie and every node gets the failure link of the usual Aho-Corasick construction, then the
+    failure links are compiled away: every state gets a transition for every byte class (bytes no pattern contains
+    all share one class), so a search is one table lookup per byte whatever the input looks like. transitions hold
+    the row of the next state (state * stride) with a flag for states where a pattern ends, the hot loop only stops
+    on those.
+
+    the patterns that end in a state are the ones that end exactly there plus the ones reached by following the
+    dictionary links (the closest failure state that has any), so nothing is copied between states.
+
+    when every pattern starts with one of at most 3 bytes, transitions back to the root are flagged as well and the
+    search jumps from the root to the next byte that can start a pattern, looking at 32 bytes at a time.
+
+    which() keeps scratch space between calls, a matcher can't be shared between threads.
+*/
+namespace ARLib {
+struct AhoCorasickMatch {
+    // index of the pattern in the list the matcher was built from
+    size_t pattern;
+    size_t begin;
+    size_t end;
+};
+class AhoCorasick {
+    constexpr static uint32_t match_flag   = 1u << 31;
+    constexpr static uint32_t root_flag    = 1u << 30;
+    constexpr static uint32_t special_mask = match_flag | root_flag;
+    constexpr static uint32_t none         = 0xFFFFFFFF;
+
+    uint8_t m_byte_class[256]{};
+    size_t m_stride = 0;
+    Vector<uint32_t> m_transitions;
+    // patterns that end exactly in state i are m_outputs[m_output_begin[i], m_output_begin[i + 1])
+    Vector<uint32_t> m_output_begin;
+    Vector<uint32_t> m_outputs;
+    // closest state on the failure path that has outputs of its own, none if there isn't one
+    Vector<uint32_t> m_dictionary;
+    Vector<uint32_t> m_sizes;
+    // empty patterns, they match right at the start of the text
+    Vector<uint32_t> m_empty;
+    uint8_t m_first_bytes[3]{};
+    size_t m_first_byte_count = 0;
+    // patterns which() has already found, all 0 between calls
+    mutable Vector<uint8_t> m_seen;
+
+    size_t skip(const uint8_t* bytes, size_t pos, size_t size) const;
+    template <typename Func>
+    void search(StringView text, Func&& on_match) const;
+
+    public:
+    AhoCorasick() = default;
+    explicit AhoCorasick(Span<const StringView> patterns);
+    size_t pattern_count() const { return m_sizes.size(); }
+    // true if any of the patterns occurs in text
+    bool contains(StringView text) const;
+    // every occurrence of every pattern, overlapping ones included, in the order they end in
+    Vector<AhoCorasickMatch> find_all(StringView text) const;
+    // every pattern that occurs in text, in the order they're first found. patterns can be reused between calls so
+    // looking at line after line doesn't allocate
+    void which(StringView text, Vector<size_t>& patterns) const;
+};
+}    // namespace ARLib
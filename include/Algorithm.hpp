@@ -5,6 +5,7 @@
 #include "Utility.hpp"
 #include "cmath_compat.hpp"
 #include "Ordering.hpp"
+#include "Sort.hpp"
 namespace ARLib {
 
 template <typename T>
@@ -185,45 +186,6 @@ auto transform(const C& cont, Functor func) {
     for (auto& i : cont) { copy.push_back(move(func(i))); }
     return copy;
 }
-// follows very naive quicksort implementation
-template <IteratorConcept Iter, typename Functor>
-requires CopyConstructible<RemoveReferenceT<IteratorOutputType<Iter>>>
-Iter partition(Iter lo, Iter hi, Functor&& func) {
-    // FIXME: find a way to avoid this copy of the pivot
-    auto pivot = *(lo + ((hi - lo) / 2));
-    auto i     = lo - 1;
-    auto j     = hi + 1;
-    for (;;) {
-        do { ++i; } while (func(*i, pivot) == less);
-        do { --j; } while (func(*j, pivot) == greater);
-        if (i > j || i == j) return j;
-        swap(*i, *j);
-    }
-}
-template <IteratorConcept Iter, typename Functor>
-requires CallableWithRes<Functor, Ordering, IteratorOutputType<Iter>, IteratorOutputType<Iter>>
-void quicksort_internal(Iter lo, Iter hi, Functor&& functor) {
-    if (lo < hi) {
-        auto p = partition(lo, hi, functor);
-        quicksort_internal(lo, p, functor);
-        quicksort_internal(p + 1, hi, functor);
-    }
-}
-// in-place sorting
-template <Iterable C>
-void sort(C& cont) {
-    auto begin = cont.begin();
-    auto end   = cont.end();
-    if (begin == end) return;    // empty
-    quicksort_internal(begin, end - 1, [](const auto& a, const auto& b) { return a <=> b; });
-}
-template <Iterable C, typename Functor>
-void sort(C& cont, Functor&& func) {
-    auto begin = cont.begin();
-    auto end   = cont.end();
-    if (begin == end) return;    // empty
-    quicksort_internal(begin, end - 1, func);
-}
 template <Iterable C>
 constexpr auto begin(C& cont) {
     return cont.begin();
@@ -0,0 +1,137 @@
+#pragma once
+#ifndef DISABLE_THREADING
+    #include "EventLoop.hpp"
+    #include "File.hpp"
+    #include "Functional.hpp"
+    #include "Span.hpp"
+    #include "UniquePtr.hpp"
+    #include "Vector.hpp"
+/*
+    asynchronous positional reads and writes on files.
+
+    requests are queued with read()/write() and don't cost anything until submit() (or wait()) hands the whole batch
+    over at once. on linux the batch goes into an io_uring submission queue and the kernel gets it in a single
+    io_uring_enter, completions are picked up from the completion queue without a syscall when they're already
+    there. when io_uring isn't there (old kernel, seccomp filters, other OSes) a thread pool runs the requests as
+    blocking pread/pwrite (ReadFile/WriteFile on windows) instead, the interface is the same.
+
+    - queue_depth: requests that are in the kernel (or the pool) at the same time, the rest wait in the engine and
+      go in as earlier ones complete
+    - fixed files: files opened through open() are put in a table that's registered with the ring once, requests
+      on them skip the fd lookup and reference counting the kernel does per request otherwise
+    - registered buffers: register_buffers() pins memory once, a request whose buffer lies inside one of them
+      skips mapping the pages per request (READ_FIXED/WRITE_FIXED). the thread pool backend ignores both
+    - completions go to the handler set with on_completion(), on the thread that calls wait()/poll() or, after
+      deliver_to(), as callbacks on an EventLoop. nothing completes unless someone calls wait()/poll()/drain().
+      a handler that runs on the loop gets the completion only, it must not touch the engine (no follow-up reads
+      from there), that would race with the thread reaping the completions
+
+    there are no coroutines in the library, an awaiter can be built on top of the handler by resuming the
+    coroutine that's waiting on the request's user_data.
+    an engine is meant to be used from a single thread, buffers must stay alive until their request completes.
+*/
+namespace ARLib {
+enum class AsyncIOBackendKind { IoUring, ThreadPool };
+enum class AsyncIOOp : uint8_t { Read, Write };
+struct AsyncIOOptions {
+    uint32_t queue_depth = 64;
+    // size of the fixed file table, how many files can be open in the engine at the same time
+    uint32_t max_files = 1024;
+    // threads of the fallback backend, 0 picks min(queue_depth, 4 * cores)
+    size_t thread_count = 0;
+    // don't even try io_uring
+    bool force_thread_pool = false;
+};
+struct AsyncFileHandle {
+    uint32_t index;
+};
+struct AsyncIOCompletion {
+    uint64_t user_data;
+    // bytes read or written, can be less than requested anywhere in the file (io_uring returns short reads e.g.
+    // when part of the range isn't in the page cache), the rest takes another request. a read of 0 bytes is the end
+    // of the file
+    size_t bytes;
+    // 0 on success, errno (GetLastError() on windows) otherwise
+    int error;
+    bool ok() const { return error == 0; }
+};
+namespace detail {
+    struct AsyncIORequest {
+        AsyncIOOp op;
+        // index in the fixed file table, the registered one when registered is true
+        uint32_t file;
+        bool registered;
+        // index of the registered buffer data lies in, -1 if it isn't in one
+        int32_t buffer_index;
+        int64_t handle;
+        uint64_t offset;
+        uint8_t* data;
+        size_t size;
+        uint64_t user_data;
+    };
+    class AsyncIOBackend;
+}    // namespace detail
+class AsyncFileIO {
+    UniquePtr<detail::AsyncIOBackend> m_backend;
+    Vector<detail::AsyncIORequest> m_pending;
+    size_t m_pending_head = 0;
+    size_t m_in_flight    = 0;
+    uint32_t m_queue_depth;
+    uint32_t m_max_files;
+    // native handles, -1 for free slots
+    Vector<int64_t> m_files;
+    Vector<uint8_t> m_registered;
+    Vector<uint32_t> m_free_files;
+    Vector<Span<uint8_t>> m_buffers;
+    Vector<AsyncIOCompletion> m_completed;
+    Function<void(const AsyncIOCompletion&)> m_handler;
+    EventLoop* m_loop = nullptr;
+
+    Result<AsyncFileHandle, FileError> open_file(const Path& path, OpenFileMode mode, bool registered);
+    void queue(AsyncIOOp op, AsyncFileHandle file, uint64_t offset, uint8_t* data, size_t size, uint64_t user_data);
+    void flush_pending();
+    size_t complete(size_t min_completions);
+
+    public:
+    explicit AsyncFileIO(const AsyncIOOptions& options = {});
+    ~AsyncFileIO();
+    AsyncFileIO(const AsyncFileIO&)            = delete;
+    AsyncFileIO& operator=(const AsyncFileIO&) = delete;
+    AsyncFileIO(AsyncFileIO&&)                 = delete;
+    AsyncFileIO& operator=(AsyncFileIO&&)      = delete;
+    AsyncIOBackendKind backend() const;
+    uint32_t queue_depth() const { return m_queue_depth; }
+    // requests queued or in flight
+    size_t outstanding() const { return m_in_flight + m_pending.size() - m_pending_head; }
+    Result<AsyncFileHandle, FileError> open(const Path& path, OpenFileMode mode);
+    // requests on the file must have completed
+    void close(AsyncFileHandle file);
+    // size of the file right now, 0 if it can't be determined
+    uint64_t size(AsyncFileHandle file) const;
+    // replaces the registered buffers, nothing can be in flight. false if the kernel refused (e.g. over the
+    // RLIMIT_MEMLOCK limit), the requests then go through the normal path
+    bool register_buffers(Span<const Span<uint8_t>> buffers);
+    void unregister_buffers();
+    void read(AsyncFileHandle file, uint64_t offset, Span<uint8_t> into, uint64_t user_data) {
+        queue(AsyncIOOp::Read, file, offset, into.data(), into.size(), user_data);
+    }
+    void write(AsyncFileHandle file, uint64_t offset, Span<const uint8_t> from, uint64_t user_data) {
+        queue(AsyncIOOp::Write, file, offset, const_cast<uint8_t*>(from.data()), from.size(), user_data);
+    }
+    void on_completion(Function<void(const AsyncIOCompletion&)> handler) { m_handler = move(handler); }
+    // the handler runs on the loop's thread instead of the one reaping the completions, with its own copy of the
+    // handler so the engine can be destroyed before the loop gets to it. it must not call into the engine
+    void deliver_to(EventLoop& loop) { m_loop = &loop; }
+    // hands the queued requests to the backend, as many as the queue depth allows. returns how many went in
+    size_t submit();
+    // delivers the completions that are already there without blocking, returns how many
+    size_t poll();
+    // submits, then blocks until at least min_completions requests completed (fewer if fewer are outstanding)
+    size_t wait(size_t min_completions = 1);
+    // waits for everything outstanding
+    void drain();
+    // reads every file whole, queue_depth of them at a time. completions of earlier requests are delivered first
+    Result<Vector<String>, FileError> read_files(Span<const Path> paths);
+};
+}    // namespace ARLib
+#endif
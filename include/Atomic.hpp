@@ -3,10 +3,23 @@
 #include "XNative/atomic/xnative_atomic_merge.hpp"
 #include "Concepts.hpp"
 namespace ARLib {
-// Atomic class made around memory_order_seq_cst
+// Atomic class, every operation defaults to MemoryOrder::SeqCst
+// weaker orderings can be passed explicitly, same rules as the corresponding std::memory_order apply
+// e.g. a store can't be Acquire and a load can't be Release
 template <typename T>
 concept AtomicRequirements =
 (IsTriviallyCopiableV<T> && CopyConstructibleV<T> && MoveConstructibleV<T> && CopyAssignableV<T> && MoveAssignableV<T>);
+// the failure ordering of a compare exchange can't have release semantics
+constexpr MemoryOrder cas_failure_order(MemoryOrder order) noexcept {
+    switch (order) {
+        case MemoryOrder::AcqRel:
+            return MemoryOrder::Acquire;
+        case MemoryOrder::Release:
+            return MemoryOrder::Relaxed;
+        default:
+            return order;
+    }
+}
 template <AtomicRequirements T>
 class AtomicBase {
     protected:
@@ -21,17 +34,23 @@ class AtomicBase {
     }
     AtomicBase& operator=(const AtomicBase&) = delete;
     bool is_lock_free() const noexcept { return m_storage.is_lock_free(); }
-    void store(T val) noexcept { m_storage.store(val); }
-    T load() const noexcept { return m_storage.load(); }
+    void store(T val, MemoryOrder order = MemoryOrder::SeqCst) noexcept { m_storage.store(val, order); }
+    T load(MemoryOrder order = MemoryOrder::SeqCst) const noexcept { return m_storage.load(order); }
     operator T() const noexcept { return m_storage.load(); }
-    T exchange(T val) noexcept { return m_storage.exchange(val); }
-    bool compare_exchange_weak(T& expected, T desired) noexcept {
-        return m_storage.compare_exchange_strong(expected, desired);
+    T exchange(T val, MemoryOrder order = MemoryOrder::SeqCst) noexcept { return m_storage.exchange(val, order); }
+    bool compare_exchange_weak(T& expected, T desired, MemoryOrder success, MemoryOrder failure) noexcept {
+        return m_storage.compare_exchange_weak(expected, desired, success, failure);
+    }
+    bool compare_exchange_weak(T& expected, T desired, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return m_storage.compare_exchange_weak(expected, desired, order, cas_failure_order(order));
+    }
+    bool compare_exchange_strong(T& expected, T desired, MemoryOrder success, MemoryOrder failure) noexcept {
+        return m_storage.compare_exchange_strong(expected, desired, success, failure);
     }
-    bool compare_exchange_strong(T& expected, T desired) noexcept {
-        return m_storage.compare_exchange_strong(expected, desired);
+    bool compare_exchange_strong(T& expected, T desired, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return m_storage.compare_exchange_strong(expected, desired, order, cas_failure_order(order));
     }
-    void wait(T old) const noexcept { m_storage.wait(old); }
+    void wait(T old, MemoryOrder order = MemoryOrder::SeqCst) const noexcept { m_storage.wait(old, order); }
     void notify_all() noexcept { m_storage.notify_all(); }
     void notify_one() noexcept { m_storage.notify_one(); }
 };
@@ -51,24 +70,46 @@ class IntegralAtomicBase {
     }
     IntegralAtomicBase& operator=(const IntegralAtomicBase&) = delete;
     bool is_lock_free() const noexcept { return this->m_storage.is_lock_free(); }
-    void store(T val) noexcept { this->m_storage.store(val); }
-    T load() const noexcept { return this->m_storage.load(); }
+    void store(T val, MemoryOrder order = MemoryOrder::SeqCst) noexcept { this->m_storage.store(val, order); }
+    T load(MemoryOrder order = MemoryOrder::SeqCst) const noexcept { return this->m_storage.load(order); }
     operator T() const noexcept { return this->m_storage.load(); }
-    T exchange(T val) noexcept { return this->m_storage.exchange(val); }
-    bool compare_exchange_weak(T& expected, T desired) noexcept {
-        return this->m_storage.compare_exchange_strong(expected, desired);
+    T exchange(T val, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return this->m_storage.exchange(val, order);
+    }
+    bool compare_exchange_weak(T& expected, T desired, MemoryOrder success, MemoryOrder failure) noexcept {
+        return this->m_storage.compare_exchange_weak(expected, desired, success, failure);
+    }
+    bool compare_exchange_weak(T& expected, T desired, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return this->m_storage.compare_exchange_weak(expected, desired, order, cas_failure_order(order));
+    }
+    bool compare_exchange_strong(T& expected, T desired, MemoryOrder success, MemoryOrder failure) noexcept {
+        return this->m_storage.compare_exchange_strong(expected, desired, success, failure);
     }
-    bool compare_exchange_strong(T& expected, T desired) noexcept {
-        return this->m_storage.compare_exchange_strong(expected, desired);
+    bool compare_exchange_strong(T& expected, T desired, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return this->m_storage.compare_exchange_strong(expected, desired, order, cas_failure_order(order));
     }
-    void wait(T old) const noexcept { this->m_storage.wait(old); }
+    void wait(T old, MemoryOrder order = MemoryOrder::SeqCst) const noexcept { this->m_storage.wait(old, order); }
     void notify_all() noexcept { this->m_storage.notify_all(); }
     void notify_one() noexcept { this->m_storage.notify_one(); }
-    T fetch_add(T arg) noexcept { return m_storage.fetch_add(arg); }
-    T fetch_sub(T arg) noexcept { return m_storage.fetch_add(negate(arg)); }
-    T fetch_and(T arg) noexcept { return m_storage.fetch_and(arg); }
-    T fetch_or(T arg) noexcept { return m_storage.fetch_or(arg); }
-    T fetch_xor(T arg) noexcept { return m_storage.fetch_xor(arg); }
+    T fetch_add(T arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept { return m_storage.fetch_add(arg, order); }
+    T fetch_sub(T arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return m_storage.fetch_add(negate(arg), order);
+    }
+    T fetch_and(T arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept { return m_storage.fetch_and(arg, order); }
+    T fetch_or(T arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept { return m_storage.fetch_or(arg, order); }
+    T fetch_xor(T arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept { return m_storage.fetch_xor(arg, order); }
+    // there's no single instruction for these on x86, so they're a cas loop that bails out
+    // as soon as the stored value already satisfies the condition, in which case nothing gets written
+    T fetch_max(T arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        T current = m_storage.load(MemoryOrder::Relaxed);
+        while (current < arg && !m_storage.compare_exchange_weak(current, arg, order, MemoryOrder::Relaxed)) {}
+        return current;
+    }
+    T fetch_min(T arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        T current = m_storage.load(MemoryOrder::Relaxed);
+        while (arg < current && !m_storage.compare_exchange_weak(current, arg, order, MemoryOrder::Relaxed)) {}
+        return current;
+    }
     T operator++() noexcept { return m_storage++; }
     T operator++(int) noexcept { return ++m_storage; }
     T operator--() noexcept { return m_storage--; }
@@ -84,9 +125,11 @@ class PointerAtomicBase {
     using Ptr = T*;
     protected:
     AtomicIntegralStorage<uintptr_t> m_storage;
-    static uintptr_t negate(const ptrdiff_t val) noexcept {
-        return static_cast<uintptr_t>(0U - static_cast<MakeUnsignedT<uintptr_t>>(val));
+    // pointer arithmetic is in elements, like on a regular pointer
+    static uintptr_t to_offset(const ptrdiff_t val) noexcept {
+        return static_cast<uintptr_t>(val) * static_cast<uintptr_t>(sizeof(T));
     }
+    static uintptr_t negate(const ptrdiff_t val) noexcept { return 0U - to_offset(val); }
     static uintptr_t to_uintptr(Ptr val) { return reinterpret_cast<uintptr_t>(val); }
     static Ptr from_uintptr(uintptr_t val) { return reinterpret_cast<Ptr>(val); }
     public:
@@ -99,30 +142,61 @@ class PointerAtomicBase {
     }
     PointerAtomicBase& operator=(const PointerAtomicBase&) = delete;
     bool is_lock_free() const noexcept { return this->m_storage.is_lock_free(); }
-    void store(Ptr val) noexcept { this->m_storage.store(to_uintptr(val)); }
-    Ptr load() const noexcept { return from_uintptr(this->m_storage.load()); }
+    void store(Ptr val, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        this->m_storage.store(to_uintptr(val), order);
+    }
+    Ptr load(MemoryOrder order = MemoryOrder::SeqCst) const noexcept {
+        return from_uintptr(this->m_storage.load(order));
+    }
     operator Ptr() const noexcept { return from_uintptr(this->m_storage.load()); }
-    Ptr exchange(Ptr val) noexcept { return from_uintptr(this->m_storage.exchange(to_uintptr(val))); }
-    bool compare_exchange_weak(T& expected, T desired) noexcept {
-        return this->m_storage.compare_exchange_strong(expected, desired);
+    Ptr exchange(Ptr val, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return from_uintptr(this->m_storage.exchange(to_uintptr(val), order));
     }
-    bool compare_exchange_strong(T& expected, T desired) noexcept {
-        return this->m_storage.compare_exchange_strong(expected, desired);
+    bool compare_exchange_weak(Ptr& expected, Ptr desired, MemoryOrder success, MemoryOrder failure) noexcept {
+        uintptr_t expected_val = to_uintptr(expected);
+        const bool result = this->m_storage.compare_exchange_weak(expected_val, to_uintptr(desired), success, failure);
+        expected          = from_uintptr(expected_val);
+        return result;
+    }
+    bool compare_exchange_weak(Ptr& expected, Ptr desired, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return compare_exchange_weak(expected, desired, order, cas_failure_order(order));
+    }
+    bool compare_exchange_strong(Ptr& expected, Ptr desired, MemoryOrder success, MemoryOrder failure) noexcept {
+        uintptr_t expected_val = to_uintptr(expected);
+        const bool result =
+        this->m_storage.compare_exchange_strong(expected_val, to_uintptr(desired), success, failure);
+        expected = from_uintptr(expected_val);
+        return result;
+    }
+    bool compare_exchange_strong(Ptr& expected, Ptr desired, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return compare_exchange_strong(expected, desired, order, cas_failure_order(order));
+    }
+    void wait(Ptr old, MemoryOrder order = MemoryOrder::SeqCst) const noexcept {
+        this->m_storage.wait(to_uintptr(old), order);
     }
-    void wait(Ptr old) const noexcept { this->m_storage.wait(to_uintptr(old)); }
     void notify_all() noexcept { this->m_storage.notify_all(); }
     void notify_one() noexcept { this->m_storage.notify_one(); }
-    Ptr fetch_add(ptrdiff_t arg) noexcept { return from_uintptr(m_storage.fetch_add(arg)); }
-    Ptr fetch_sub(ptrdiff_t arg) noexcept { return from_uintptr(m_storage.fetch_add(negate(arg))); }
-    Ptr fetch_and(ptrdiff_t arg) noexcept { return from_uintptr(m_storage.fetch_and(arg)); }
-    Ptr fetch_or(ptrdiff_t arg) noexcept { return from_uintptr(m_storage.fetch_or(arg)); }
-    Ptr fetch_xor(ptrdiff_t arg) noexcept { return from_uintptr(m_storage.fetch_xor(arg)); }
-    Ptr operator++() noexcept { return from_uintptr(m_storage++); }
-    Ptr operator++(int) noexcept { return from_uintptr(++m_storage); }
-    Ptr operator--() noexcept { return from_uintptr(m_storage--); }
-    Ptr operator--(int) noexcept { return from_uintptr(--m_storage); }
-    Ptr operator+=(ptrdiff_t arg) noexcept { return from_uintptr(m_storage.fetch_add(arg) + arg); }
-    Ptr operator-=(ptrdiff_t arg) noexcept { return from_uintptr(m_storage.fetch_add(negate(arg)) - arg); }
+    Ptr fetch_add(ptrdiff_t arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return from_uintptr(m_storage.fetch_add(to_offset(arg), order));
+    }
+    Ptr fetch_sub(ptrdiff_t arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return from_uintptr(m_storage.fetch_add(negate(arg), order));
+    }
+    Ptr fetch_and(uintptr_t arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return from_uintptr(m_storage.fetch_and(arg, order));
+    }
+    Ptr fetch_or(uintptr_t arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return from_uintptr(m_storage.fetch_or(arg, order));
+    }
+    Ptr fetch_xor(uintptr_t arg, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
+        return from_uintptr(m_storage.fetch_xor(arg, order));
+    }
+    Ptr operator++() noexcept { return fetch_add(1) + 1; }
+    Ptr operator++(int) noexcept { return fetch_add(1); }
+    Ptr operator--() noexcept { return fetch_sub(1) - 1; }
+    Ptr operator--(int) noexcept { return fetch_sub(1); }
+    Ptr operator+=(ptrdiff_t arg) noexcept { return fetch_add(arg) + arg; }
+    Ptr operator-=(ptrdiff_t arg) noexcept { return fetch_sub(arg) - arg; }
 };
 template <AtomicRequirements T>
 class Atomic : public AtomicBase<T> {
@@ -159,9 +233,9 @@ class Atomic<P*> : public PointerAtomicBase<P> {
     Atomic(P* value) noexcept : Base{ value } {}
     Atomic(const Atomic&) = delete;
     P* operator=(P* val) noexcept {
-        this->m_storage.store(val);
+        Base::store(val);
         return val;
     }
     Atomic& operator=(const Atomic&) = delete;
 };
-}    // namespace ARLib
\ No newline at end of file
+}    // namespace ARLib
@@ -0,0 +1,48 @@
+#pragma once
+#include "Types.hpp"
+#ifdef COMPILER_MSVC
+    #include <intrin.h>
+#endif
+namespace ARLib {
+namespace internal {
+    // index of the lowest set bit, val can't be 0. these are in the hot loops of every SIMD scanner, they have to
+    // be inlined
+    inline uint32_t trailing_zeros(uint32_t val) {
+#ifdef COMPILER_MSVC
+        unsigned long result = 0;
+        _BitScanForward(&result, val);
+        return result;
+#else
+        return static_cast<uint32_t>(__builtin_ctz(val));
+#endif
+    }
+    inline uint32_t trailing_zeros(uint64_t val) {
+#ifdef COMPILER_MSVC
+        unsigned long result = 0;
+        _BitScanForward64(&result, val);
+        return result;
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(val));
+#endif
+    }
+    // index of the highest set bit counted from the top, val can't be 0
+    inline uint32_t leading_zeros(uint32_t val) {
+#ifdef COMPILER_MSVC
+        unsigned long result = 0;
+        _BitScanReverse(&result, val);
+        return 31 - result;
+#else
+        return static_cast<uint32_t>(__builtin_clz(val));
+#endif
+    }
+    inline uint32_t leading_zeros(uint64_t val) {
+#ifdef COMPILER_MSVC
+        unsigned long result = 0;
+        _BitScanReverse64(&result, val);
+        return 63 - result;
+#else
+        return static_cast<uint32_t>(__builtin_clzll(val));
+#endif
+    }
+}    // namespace internal
+}    // namespace ARLib
@@ -0,0 +1,96 @@
+#pragma once
+#include "CSVReader.hpp"
+#include "FlatMap.hpp"
+/*
+    columnar csv.
+
+    CSVTable reads a whole csv into one typed, contiguous buffer per column (struct of arrays) instead of a row of
+    Strings per line, so code that aggregates over a column walks a Vector<int64_t> or Vector<double> directly.
+
+    the schema is either given or inferred from the first inference_rows rows: a column is Bool if every value is
+    true / false, Int64 if they're all integers, Double if they're all numbers, Timestamp if they're all ISO 8601
+    dates or date-times and String otherwise. a value further down that doesn't fit the inferred type is an error,
+    pass a schema when the first rows aren't representative.
+
+    String columns are dictionary encoded, every distinct value is stored once and the column holds a code per row.
+    timestamps are microseconds since the unix epoch (UTC), an offset like +02:00 is applied, no offset means UTC.
+    empty fields are null in every column but String ones, where they're empty strings; the value of a null is 0.
+
+    with a header the columns of the schema are looked up by name, so a schema can pick just the columns it needs,
+    column names are resolved to an index once when the table is built.
+*/
+namespace ARLib {
+enum class CSVColumnType : uint8_t { Int64, Double, Bool, String, Timestamp };
+struct CSVColumnSpec {
+    String name;
+    CSVColumnType type;
+};
+struct CSVTableOptions {
+    char separator = ',';
+    // without a header the columns are named after their index and the schema applies in order
+    bool has_header = true;
+    // rows looked at to infer the schema
+    size_t inference_rows = 1000;
+};
+class CSVColumn {
+    friend class CSVTable;
+    String m_name;
+    CSVColumnType m_type;
+    // only the buffer of the column's type is used, Timestamp columns use m_integers
+    Vector<int64_t> m_integers;
+    Vector<double> m_doubles;
+    Vector<uint8_t> m_bools;
+    Vector<uint32_t> m_codes;
+    Vector<String> m_dictionary;
+    // 1 for every null row, stays empty until the first null shows up
+    Vector<uint8_t> m_nulls;
+    size_t m_size = 0;
+
+    CSVColumn(String name, CSVColumnType type) : m_name(move(name)), m_type(type) {}
+    // false if the field doesn't fit the type of the column, String columns are filled by CSVTable
+    bool append(StringView field);
+    void append_code(uint32_t code);
+
+    public:
+    const String& name() const { return m_name; }
+    CSVColumnType type() const { return m_type; }
+    size_t size() const { return m_size; }
+    bool is_null(size_t row) const { return row < m_nulls.size() && m_nulls[row] != 0; }
+    // the values of an Int64 or Timestamp column
+    Span<const int64_t> integers() const { return m_integers.span(); }
+    Span<const double> doubles() const { return m_doubles.span(); }
+    // 0 or 1 for every row
+    Span<const uint8_t> bools() const { return m_bools.span(); }
+    // the dictionary code of every row, an index in dictionary()
+    Span<const uint32_t> codes() const { return m_codes.span(); }
+    const Vector<String>& dictionary() const { return m_dictionary; }
+    StringView string_at(size_t row) const { return m_dictionary[m_codes[row]].view(); }
+};
+class CSVTable {
+    Vector<CSVColumn> m_columns;
+    FlatMap<String, size_t> m_column_index;
+    size_t m_rows = 0;
+
+    CSVTable() = default;
+
+    public:
+    static Result<Vector<CSVColumnSpec>, CSVParseError> infer_schema(StringView source,
+                                                                    const CSVTableOptions& options = {});
+    static Result<CSVTable, CSVParseError> parse(StringView source, const CSVTableOptions& options = {});
+    static Result<CSVTable, CSVParseError>
+    parse(StringView source, const Vector<CSVColumnSpec>& schema, const CSVTableOptions& options = {});
+    static Result<CSVTable, CSVParseError> from_file(const Path& filename, const CSVTableOptions& options = {});
+    size_t rows() const { return m_rows; }
+    size_t column_count() const { return m_columns.size(); }
+    // npos_ if there's no such column
+    size_t column_index(StringView name) const;
+    const CSVColumn& column(size_t index) const { return m_columns[index]; }
+    const Vector<CSVColumn>& columns() const { return m_columns; }
+};
+// microseconds since the unix epoch for an ISO 8601 date or date-time, empty if it isn't one
+Optional<int64_t> parse_iso8601_timestamp(StringView value);
+// buffer size needed by write_iso8601_timestamp
+constexpr inline size_t iso8601_timestamp_chars = 32;
+// writes microseconds since the unix epoch as YYYY-MM-DDTHH:MM:SS[.ffffff]Z, returns the length
+size_t write_iso8601_timestamp(int64_t micros, char* buffer);
+}    // namespace ARLib
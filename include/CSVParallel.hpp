@@ -0,0 +1,152 @@
+#pragma once
+#ifndef DISABLE_THREADING
+    #include "CSVReader.hpp"
+    #include "File.hpp"
+    #include "Parallel.hpp"
+/*
+    parallel csv parsing.
+
+    the input is cut in chunks of about chunk_size bytes that are parsed by the workers of a ThreadPool, each one
+    with its own CSVReader. a chunk can only start at the beginning of a row, which means a newline that isn't inside
+    a quoted field, so before cutting the workers count the quotes of every fixed size piece of the input (with SIMD,
+    only the parity matters). the quotes before a piece tell whether it starts inside a quoted field, from there the
+    first real row boundary is a short scan away.
+
+    rows are handed to the callback as func(offset, row), where offset is where the row starts in the input and
+    row is a Span<const StringView> like the one CSVReader::read_row gives, only valid for the duration of the call.
+    blank lines are skipped, the first malformed row stops the parsing. there's no header handling, read it with a
+    CSVReader first and parse what comes after reader.offset().
+*/
+namespace ARLib {
+struct CSVParallelOptions {
+    char separator = ',';
+    // bytes of input handled by a single task, rounded up to the end of the row
+    size_t chunk_size = 4 * 1024 * 1024;
+    // in order, the callback is never called concurrently and sees the rows in the order of the input,
+    // and the error returned is the one of the first malformed row.
+    // out of order, the callback is called by every worker as soon as a row is parsed, so it has to be thread
+    // safe, and parsing stops at whichever malformed row is found first.
+    bool ordered = true;
+    // bytes read at a time by from_file, has to hold at least one full row
+    size_t read_size = 64 * 1024 * 1024;
+    // pool to run on, nullptr means ThreadPool::global()
+    ThreadPool* pool = nullptr;
+};
+// with ordered delivery the whole chunk is parsed before its turn comes, this keeps all of its rows around
+class CSVRowArena {
+    Vector<StringView> m_fields;
+    // index in m_fields one past the last field of every row
+    Vector<size_t> m_row_ends;
+    Vector<size_t> m_offsets;
+    // the fields that were unescaped, (field, offset in m_unescaped) until the chunk is complete
+    String m_unescaped;
+    Vector<Pair<size_t, size_t>> m_escaped;
+
+    public:
+    CSVRowArena() = default;
+    // chunk is the part of the input the row was read from, fields that don't point into it are copied
+    void add_row(Span<const StringView> row, size_t offset, StringView chunk);
+    // has to be called after the last row of the chunk is added and before any row is looked at
+    void complete();
+    void reset();
+    size_t size() const { return m_offsets.size(); }
+    size_t offset_at(size_t index) const { return m_offsets[index]; }
+    Span<const StringView> row_at(size_t index) const {
+        const size_t begin = index == 0 ? 0 : m_row_ends[index - 1];
+        return m_fields.span().subspan(begin, m_row_ends[index] - begin);
+    }
+};
+namespace detail {
+    // true if there's an odd number of double quotes in [begin, end)
+    bool odd_quotes(const char* begin, const char* end);
+    // where the first row that starts after from begins, in_quotes says if from is inside a quoted field.
+    // buffer.size() if there's no such row
+    size_t find_row_start(StringView buffer, size_t from, bool in_quotes);
+    // length of the part of the buffer that's made of complete rows, the buffer has to start at a row
+    size_t complete_rows(StringView buffer);
+    // offsets where each chunk starts plus one final entry for the end of the buffer
+    Vector<size_t> split_rows(StringView buffer, size_t chunk_size, ThreadPool& pool);
+    // parses every row of the chunk, calls func(offset, row) for each one when emit_each is set, otherwise keeps
+    // them all in the arena. on failure the arena holds the rows that came before the malformed one
+    template <typename Func>
+    DiscardResult<CSVParseError>
+    parse_csv_chunk(CSVRowArena& arena, StringView chunk, size_t offset, char separator, bool emit_each, Func& func) {
+        arena.reset();
+        CSVReader reader{ chunk, separator };
+        while (true) {
+            auto row = reader.read_row();
+            if (row.is_error()) {
+                arena.complete();
+                auto error = row.to_error();
+                if (error->is_eof()) return {};
+                return CSVParseError{ error->error_string(), error->offset() + offset };
+            }
+            if (emit_each) {
+                func(offset + reader.row_offset(), row.to_ok());
+            } else {
+                arena.add_row(row.to_ok(), offset + reader.row_offset(), chunk);
+            }
+        }
+    }
+    template <typename Func>
+    DiscardResult<CSVParseError>
+    parse_csv_rows(StringView buffer, size_t base, Func& func, const CSVParallelOptions& options) {
+        ThreadPool& pool   = options.pool ? *options.pool : ThreadPool::global();
+        const auto bounds  = split_rows(buffer, options.chunk_size, pool);
+        const bool ordered = options.ordered;
+        Vector<CSVRowArena> arenas{};
+        auto deliver = [&func](const CSVRowArena& arena) {
+            for (size_t i = 0; i < arena.size(); ++i) { func(arena.offset_at(i), arena.row_at(i)); }
+        };
+        auto parse = [&](CSVRowArena& arena, size_t chunk) {
+            const StringView view{ buffer.data() + bounds[chunk], bounds[chunk + 1] - bounds[chunk] };
+            return parse_csv_chunk(arena, view, base + bounds[chunk], options.separator, !ordered, func);
+        };
+        return parallel::run_chunks<CSVParseError>(pool, bounds.size() - 1, ordered, arenas, parse, deliver);
+    }
+    // reads the file read_size bytes at a time and calls func(rows, base) with the part of what's been read that is
+    // made of complete rows, base is where it starts in the file. the rest waits for the next block, at the end of
+    // the file it's handed over as it is. the first error stops the reading.
+    // memory use only depends on read_size and on the longest row, not on the size of the file
+    template <typename Func>
+    DiscardResult<CSVParseError> read_row_blocks(const Path& filename, size_t read_size, Func&& func) {
+        File f{ filename };
+        if (auto err = f.open(OpenFileMode::Read); err.is_error()) {
+            return CSVParseError{ err.to_error()->error_string(), 0 };
+        }
+        String pending{};
+        size_t base = 0;
+        while (true) {
+            auto block = f.read_some(read_size);
+            if (block.is_error()) return CSVParseError{ block.to_error()->error_string(), base };
+            const String& data = block.to_ok();
+            const bool at_end  = data.size() == 0;
+            pending.append(data.view());
+            const size_t length = at_end ? pending.size() : complete_rows(pending.view());
+            if (length == 0 && !at_end) continue;
+            TRY(func(pending.view().substringview_fromlen(0, length), base));
+            if (at_end) return {};
+            base += length;
+            pending = pending.substring(length);
+        }
+    }
+}    // namespace detail
+class CSVParallelParser {
+    public:
+    // func is called as func(size_t offset, Span<const StringView> row) for every row
+    template <typename Func>
+    static DiscardResult<CSVParseError>
+    parse(StringView buffer, Func&& func, const CSVParallelOptions& options = {}) {
+        return detail::parse_csv_rows(buffer, 0, func, options);
+    }
+    // reads the file read_size bytes at a time, memory use doesn't depend on the size of the file
+    template <typename Func>
+    static DiscardResult<CSVParseError>
+    from_file(const Path& filename, Func&& func, const CSVParallelOptions& options = {}) {
+        return detail::read_row_blocks(filename, options.read_size, [&](StringView rows, size_t base) {
+            return detail::parse_csv_rows(rows, base, func, options);
+        });
+    }
+};
+}    // namespace ARLib
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+#include "CSVParser.hpp"
+#include "MappedFile.hpp"
+#include "Span.hpp"
+#include "StringView.hpp"
+/*
+    zero copy csv reader.
+
+    works over a buffer that holds the whole input (or over a file mapped into memory), the input is looked at 64
+    bytes at a time with SIMD to find quotes, separators and newlines, a prefix xor of the quotes tells which of
+    them are inside a quoted field so the reader can jump straight from one field boundary to the next.
+
+    rows are handed out as a Span<const StringView>, the views point into the buffer, quoted fields lose their
+    quotes and only the fields that contain escaped quotes ("") are copied to be unescaped. the span and the
+    unescaped fields are only valid until the next row is read, views into the buffer as long as the buffer.
+
+    rows end on '\n' or "\r\n", a newline inside a quoted field is kept as it is. blank lines are skipped.
+    spaces and tabs between a closing quote and the next separator are allowed and dropped.
+*/
+namespace ARLib {
+class CSVReader {
+    StringView m_view;
+    // the file when the reader was made by from_file, moving the mapping doesn't move the contents
+    MappedFile m_storage;
+    char m_separator;
+    // start of the next row and of the last one that was read
+    size_t m_pos       = 0;
+    size_t m_row_begin = 0;
+    // the block being walked, events are the bits of it that haven't been consumed yet
+    size_t m_block_base = 0;
+    size_t m_next_block = 0;
+    uint64_t m_events   = 0;
+    // all ones if the last scanned block ended inside a quoted field
+    uint64_t m_in_quotes = 0;
+    Vector<StringView> m_fields;
+    // unescaped contents of the fields of the current row that needed it, m_escaped has (field, offset) pairs
+    String m_unescaped;
+    Vector<Pair<size_t, size_t>> m_escaped;
+    Vector<String> m_header;
+
+    bool next_block();
+    DiscardResult<CSVParseError> add_field(size_t begin, size_t end, size_t quotes, bool last);
+
+    public:
+    explicit CSVReader(StringView view, char separator = ',') : m_view(view), m_separator(separator) {}
+    static Result<CSVReader, CSVParseError> from_file(const Path& filename, char separator = ',');
+    // reads the next row as the header, fields can be looked up by name afterwards
+    DiscardResult<CSVParseError> read_header();
+    const Vector<String>& header() const { return m_header; }
+    // index of the column with that name in the header, npos_ if there's no such column
+    size_t column_index(StringView name) const;
+    // fails with a CSVEndOfFileError once there are no more rows
+    Result<Span<const StringView>, CSVParseError> read_row();
+    // calls func(Span<const StringView>) for every remaining row
+    template <typename Func>
+    DiscardResult<CSVParseError> for_each_row(Func&& func) {
+        while (true) {
+            auto row = read_row();
+            if (row.is_error()) {
+                auto error = row.to_error();
+                if (error->is_eof()) return {};
+                return *error;
+            }
+            func(row.to_ok());
+        }
+    }
+    // offset in the input where the next row starts
+    size_t offset() const { return m_pos; }
+    // offset in the input where the last row that was read starts
+    size_t row_offset() const { return m_row_begin; }
+    StringView view() const { return m_view; }
+};
+}    // namespace ARLib
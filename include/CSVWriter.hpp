@@ -0,0 +1,90 @@
+#pragma once
+#include "CSVColumns.hpp"
+#include "Stream.hpp"
+/*
+    csv serializer.
+
+    fields are written straight into one big output buffer: a field only gets quoted if it contains the separator,
+    a quote or a line break (looked for 32 bytes at a time), quotes inside of it are doubled by copying the runs
+    between them, integers are formatted in place and doubles use the shortest representation that reads back as
+    the same value.
+
+    rows are written a field at a time (field / integer / number / boolean / null, then end_row), all at once with
+    row(...) or a whole CSVTable at a time. the output either stays in the writer until it's taken out with
+    str() / release(), or goes to a BaseStream every time a row ends with more than flush_threshold bytes buffered
+    and when flush() is called, so a FileStream sink sees one write per megabyte of output.
+*/
+namespace ARLib {
+struct CSVWriterOptions {
+    char separator = ',';
+    // end rows with "\r\n" instead of '\n'
+    bool crlf = false;
+};
+class CSVWriter {
+    BufferedSink m_out;
+    CSVWriterOptions m_options;
+    // no field has been written in the current row yet
+    bool m_row_empty = true;
+    // where the current row starts in the buffer
+    size_t m_row_begin = 0;
+
+    void separate() {
+        if (!m_row_empty) m_out.append(m_options.separator);
+        m_row_empty = false;
+    }
+    void write_field(StringView value, bool quoted);
+
+    public:
+    constexpr static size_t flush_threshold = 1024 * 1024;
+    explicit CSVWriter(CSVWriterOptions options = {}) : m_options(options) {}
+    explicit CSVWriter(BaseStream& sink, CSVWriterOptions options = {}) :
+        m_out(sink, flush_threshold, flush_threshold + flush_threshold / 8), m_options(options) {}
+    CSVWriter& field(StringView value);
+    CSVWriter& integer(int64_t value);
+    CSVWriter& unsigned_integer(uint64_t value);
+    CSVWriter& number(double value);
+    CSVWriter& boolean(bool value);
+    // timestamps as CSVTable stores them, microseconds since the unix epoch
+    CSVWriter& timestamp(int64_t micros);
+    // an empty field
+    CSVWriter& null();
+    // a row that's nothing but an empty field is written as "" so it doesn't read back as a blank line
+    CSVWriter& end_row();
+    // writes every value with the function that fits its type and ends the row
+    template <typename... Args>
+    CSVWriter& row(const Args&... values) {
+        (value(values), ...);
+        return end_row();
+    }
+    CSVWriter& row(Span<const StringView> fields) {
+        for (const auto& value : fields) { field(value); }
+        return end_row();
+    }
+    template <typename T>
+    CSVWriter& value(const T& value) {
+        if constexpr (SameAs<T, bool>) {
+            return boolean(value);
+        } else if constexpr (Integral<T> && IsSigned<T>) {
+            return integer(static_cast<int64_t>(value));
+        } else if constexpr (Integral<T>) {
+            return unsigned_integer(static_cast<uint64_t>(value));
+        } else if constexpr (FloatingPoint<T>) {
+            return number(static_cast<double>(value));
+        } else if constexpr (SameAs<T, String>) {
+            return field(value.view());
+        } else {
+            return field(StringView{ value });
+        }
+    }
+    // the header (if asked for) and then every row of the table, nulls are written as empty fields
+    CSVWriter& table(const CSVTable& table, bool with_header = true);
+    // what has been written so far, not counting what already went to the sink
+    const String& str() const { return m_out.str(); }
+    String release() {
+        m_row_begin = 0;
+        return m_out.release();
+    }
+    // hands whatever is buffered to the sink, also reports an error from an earlier automatic flush
+    DiscardResult<Error> flush() { return m_out.flush(); }
+};
+}    // namespace ARLib
@@ -1,20 +1,33 @@
 #pragma once
 #include "CharConvHelpers.hpp"
+#include "Vector.hpp"
 namespace ARLib {
 
 enum class SupportedBase { Decimal, Hexadecimal, Binary, Octal };
 
-// FIXME: make this more efficient
 Result<double> StrViewToDouble(const StringView str);
 Result<float> StrViewToFloat(const StringView str);
 Result<double> StrToDouble(const String& str);
 Result<float> StrToFloat(const String& str);
+// batch conversions for whole columns of numbers, each value follows the same rules as StrViewToI64 (base 10)
+// and StrViewToDouble, the first value that fails to convert stops the conversion and the error says which one it was
+Result<Vector<int64_t>> StrViewsToI64(Span<const StringView> views);
+Result<Vector<double>> StrViewsToDouble(Span<const StringView> views);
+// same, for the fields of a buffer separated by delimiter, a trailing delimiter doesn't start an empty field
+Result<Vector<int64_t>> DelimitedToI64(StringView buffer, char delimiter);
+Result<Vector<double>> DelimitedToDouble(StringView buffer, char delimiter);
 
 enum class FloatFmtOpt : uint8_t { f, F, g, G, e, E };
 
 String DoubleToStrImpl(double value, const char* fmt, int precision);
 String LongDoubleToStrImpl(long double value, const char* fmt, int precision);
 String FloatToStrImpl(float value, const char* fmt, int precision);
+// buffer size needed by DoubleToCharsShortest
+constexpr inline size_t shortest_double_chars = 32;
+// writes the shortest representation that reads back as exactly value, in fixed or scientific notation,
+// whichever is shorter, returns the number of characters written
+size_t DoubleToCharsShortest(double value, char* buffer);
+String DoubleToShortestStr(double value);
 template <FloatFmtOpt Format = FloatFmtOpt::f>
 String DoubleToStr(double value, int precision = 6) {
     // e = scientific
@@ -1,6 +1,7 @@
 #pragma once
 #include "Assertion.hpp"
 #include "Concepts.hpp"
+#include "NumberTraits.hpp"
 #include "PrintInfo.hpp"
 #include "StringView.hpp"
 #include "cmath_compat.hpp"
@@ -48,6 +49,9 @@ namespace detail {
                                                            100000000000000000,
                                                            1000000000000000000,
                                                            10000000000000000000ull };
+    // parses exactly len digits (len <= 19, so it always fits), 16 at a time with sse, 8 at a time with swar and
+    // one at a time for the rest, returns false if any of them isn't a digit
+    bool ParseDecimalDigits(const char* ptr, size_t len, uint64_t& value);
 }    // namespace detail
 #ifdef COMPILER_GCC
     #pragma GCC diagnostic push
@@ -68,8 +72,6 @@ Result<RetType> StrViewTo64Decimal(const StringView str) {
         start_idx += (maybe_sign == '-' || maybe_sign == '+');
     }
 
-    RetType result = 0;
-
     // skip leading zeros
     while (start_idx < end_idx) {
         if (str[start_idx] != '0') break;
@@ -79,39 +81,33 @@ Result<RetType> StrViewTo64Decimal(const StringView str) {
     if (start_idx == end_idx) return RetType{ 0 };
     constexpr size_t max_uint64_size = strlen("18446744073709551615");
     constexpr size_t max_int64_size  = strlen("9223372036854775807");
+    constexpr size_t max_size        = Signed ? max_int64_size : max_uint64_size;
 
     // out of range check
-    auto get_max_size = [&]() {
-        if (Signed)
-            return max_int64_size;
-        else
-            return max_uint64_size;
-    };
-
-    constexpr auto max_size = get_max_size();
-
-    if (end_idx - start_idx > max_size) return "Failed to convert string to integer, out of range"_s;
-
-    constexpr auto get_values_table = [&]() -> const RetType(&)[max_size] {
-        if constexpr (Signed)
-            return detail::values_table_i64;
-        else
-            return detail::value_table_u64;
-    };
-
-    constexpr const RetType(&values_table)[max_size] = get_values_table();
-
-    // 0-9 => 48-57
-    for (size_t idx = end_idx - 1, tbl_idx = 0; idx >= start_idx; idx--, tbl_idx++) {
-        auto c = str[idx];
+    const size_t len = end_idx - start_idx;
+    if (len > max_size) return "Failed to convert string to integer, out of range"_s;
+
+    // 19 digits always fit, only a 20th one can overflow
+    const size_t safe_len = len > 19 ? 19 : len;
+    uint64_t magnitude    = 0;
+    if (!detail::ParseDecimalDigits(str.data() + start_idx, safe_len, magnitude)) {
+        return "Failed to convert string to integer, invalid decimal character"_s;
+    }
+    if (len > safe_len) {
+        const char c = str[end_idx - 1];
         if (c < '0' || c > '9') { return "Failed to convert string to integer, invalid decimal character"_s; }
-        result += static_cast<RetType>(c - '0') * values_table[tbl_idx];
-        if (idx == 0) break;
+        const auto digit = static_cast<uint64_t>(c - '0');
+        if (magnitude > (NumberTraits<uint64_t>::max - digit) / 10) {
+            return "Failed to convert string to integer, out of range"_s;
+        }
+        magnitude = magnitude * 10 + digit;
     }
-    if constexpr (Signed)
-        return result * (neg ? -1 : 1);
-    else
-        return result;
+    if constexpr (Signed) {
+        const uint64_t limit = static_cast<uint64_t>(NumberTraits<int64_t>::max) + (neg ? 1 : 0);
+        if (magnitude > limit) return "Failed to convert string to integer, out of range"_s;
+        return neg ? static_cast<RetType>(0 - magnitude) : static_cast<RetType>(magnitude);
+    } else
+        return magnitude;
 }
 template <bool Signed = true, typename RetType = ConditionalT<Signed, int64_t, uint64_t>>
 Result<RetType> StrViewTo64Binary(const StringView str) {
@@ -0,0 +1,544 @@
+#pragma once
+#include "Optional.hpp"
+#include "Pair.hpp"
+#include "StringLiteral.hpp"
+#include "StringView.hpp"
+#include "Types.hpp"
+/*
+    regex where the pattern is a template parameter, e.g. cx_regex<"[a-z]+@\\w+">.
+
+    the pattern is parsed while compiling into a tree of nodes (same syntax and same errors as Regex, a bad pattern
+    is a static_assert instead of a RegexParseError) and every node of the tree becomes its own matcher, a template
+    that calls the matcher of the next node through a lambda when it matches. the whole pattern ends up as one
+    function with no parse, no allocation and nothing to interpret, so plain literals turn into a few compares and
+    repeats of a single byte or set into a loop the compiler can unroll.
+
+    matching is backtracking in the same order Regex uses (the first alternative that matches wins, greedy repeats
+    match as much as they can, lazy ones as little), so search() finds the same match Regex does as long as no
+    repeated part of the pattern can match nothing. when one can, an iteration that matched nothing is thrown away
+    and the repeat backtracks into it for one that matches something (with an upper bound it's kept and ends the
+    loop). that's neither Regex (see Regex::search) nor std::regex, which keeps the empty iteration and stops there:
+    on "aaa" (a*?)* matches "aaa" here, "a" with Regex and "" with std::regex, and b{1,2}(a*?.*?)*?$ on "\nabbaac"
+    puts "c" in group 1 here and "ac" with Regex.
+
+    unlike Regex there's no bound on how long matching takes, a pattern like (a|aa)*b on a long run of a's
+    backtracks a lot, and a repeat of anything longer than a single byte recurses once per iteration. patterns that
+    run on text nobody controls are better off as a Regex.
+
+    match() and contains() are constexpr, they work in a static_assert as well.
+*/
+namespace ARLib {
+#ifdef STRINGLITERAL_AVAILABLE
+namespace detail {
+    enum class CxRegexKind : uint8_t { Empty, Literal, Set, Begin, End, Concat, Alternate, Repeat, Group };
+    struct CxRegexNode {
+        CxRegexKind kind = CxRegexKind::Empty;
+        // Literal: literals[begin, begin + size) of the tree
+        size_t begin = 0;
+        size_t size  = 0;
+        // Set: one bit per byte
+        uint64_t set[4]{};
+        // Concat and Alternate: both sides, Repeat and Group: what's repeated or grouped
+        size_t left  = 0;
+        size_t right = 0;
+        // Repeat, max is npos_ without an upper bound
+        size_t min = 0;
+        size_t max = 0;
+        bool lazy  = false;
+        // Group, numbered from 1 like in the pattern
+        size_t group = 0;
+
+        constexpr void add(uint8_t c) { set[c / 64] |= uint64_t{ 1 } << (c % 64); }
+        constexpr void add_range(uint8_t lo, uint8_t hi) {
+            for (size_t c = lo; c <= hi; ++c) add(static_cast<uint8_t>(c));
+        }
+        constexpr void add_set(const CxRegexNode& other) {
+            for (size_t i = 0; i < 4; ++i) set[i] |= other.set[i];
+        }
+        constexpr void negate() {
+            for (auto& word : set) word = ~word;
+        }
+        constexpr bool contains(uint8_t c) const { return (set[c / 64] >> (c % 64)) & 1; }
+        // the bytes of a set that's one range, lo > hi when it isn't
+        constexpr Pair<size_t, size_t> range() const {
+            size_t lo = 0;
+            while (lo < 256 && !contains(static_cast<uint8_t>(lo))) ++lo;
+            size_t hi = lo;
+            while (hi < 256 && contains(static_cast<uint8_t>(hi))) ++hi;
+            for (size_t c = hi; c < 256; ++c) {
+                if (contains(static_cast<uint8_t>(c))) return { 1, 0 };
+            }
+            return { lo, hi - 1 };
+        }
+    };
+    // a pattern of N - 1 characters never needs more nodes than this, every character adds at most 2 (a piece and
+    // the concatenation or alternation that joins it to the rest) and an empty pattern still has its Empty node
+    template <size_t N>
+    struct CxRegexTree {
+        CxRegexNode nodes[2 * N + 1]{};
+        char literals[N]{};
+        size_t node_count    = 0;
+        size_t literal_count = 0;
+        size_t root          = 0;
+        size_t group_count   = 0;
+        const char* error    = nullptr;
+        size_t error_offset  = 0;
+    };
+    // anything past this in a {m,n} count is refused, like Regex does
+    constexpr static size_t cx_regex_max_repeat_count = 1000;
+    template <size_t N>
+    class CxRegexParser {
+        const char (&m_pattern)[N];
+        constexpr static size_t m_size = N - 1;
+        size_t m_pos                   = 0;
+        CxRegexTree<N> m_tree{};
+
+        constexpr size_t add(const CxRegexNode& node) {
+            m_tree.nodes[m_tree.node_count] = node;
+            return m_tree.node_count++;
+        }
+        constexpr size_t fail(const char* message) {
+            if (m_tree.error == nullptr) {
+                m_tree.error        = message;
+                m_tree.error_offset = m_pos;
+            }
+            return 0;
+        }
+        constexpr bool at(char c) const { return m_pos < m_size && m_pattern[m_pos] == c; }
+        constexpr static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+        constexpr static bool is_escaped_set(char c) {
+            return c == 's' || c == 'w' || c == 'W' || c == 'd' || c == 'S' || c == 'D';
+        }
+        constexpr static CxRegexNode escaped_set(char c) {
+            CxRegexNode node{ .kind = CxRegexKind::Set };
+            if (c == 's' || c == 'S') {
+                for (char space : { ' ', '\t', '\n', '\r', '\f', '\v' }) node.add(static_cast<uint8_t>(space));
+            } else if (c == 'w' || c == 'W') {
+                node.add_range('a', 'z');
+                node.add_range('A', 'Z');
+                node.add_range('0', '9');
+                node.add('_');
+            } else {
+                node.add_range('0', '9');
+            }
+            if (c == 'S' || c == 'W' || c == 'D') node.negate();
+            return node;
+        }
+        constexpr static char escaped_char(char c) {
+            if (c == 'n') return '\n';
+            if (c == 't') return '\t';
+            if (c == 'r') return '\r';
+            return c;
+        }
+        constexpr size_t literal(char c) {
+            m_tree.literals[m_tree.literal_count] = c;
+            return add(CxRegexNode{ .kind = CxRegexKind::Literal, .begin = m_tree.literal_count++, .size = 1 });
+        }
+        constexpr size_t char_group() {
+            CxRegexNode node{ .kind = CxRegexKind::Set };
+            // [^...]
+            const bool negated = at('^');
+            if (negated) ++m_pos;
+            while (m_pos < m_size && m_pattern[m_pos] != ']') {
+                char lo = m_pattern[m_pos++];
+                if (lo == '\\') {
+                    if (m_pos == m_size) break;
+                    const char escaped = m_pattern[m_pos++];
+                    if (is_escaped_set(escaped)) {
+                        node.add_set(escaped_set(escaped));
+                        continue;
+                    }
+                    lo = escaped_char(escaped);
+                }
+                if (!at('-') || m_pos + 1 >= m_size || m_pattern[m_pos + 1] == ']') {
+                    node.add(static_cast<uint8_t>(lo));
+                    continue;
+                }
+                ++m_pos;
+                char hi = m_pattern[m_pos++];
+                if (hi == '\\') {
+                    if (m_pos == m_size) break;
+                    const char escaped = m_pattern[m_pos++];
+                    if (is_escaped_set(escaped)) {
+                        // not a range after all, [a-\d] is a, - and the digits
+                        node.add(static_cast<uint8_t>(lo));
+                        node.add('-');
+                        node.add_set(escaped_set(escaped));
+                        continue;
+                    }
+                    hi = escaped_char(escaped);
+                }
+                if (static_cast<uint8_t>(hi) < static_cast<uint8_t>(lo)) {
+                    return fail("Invalid range in character group");
+                }
+                node.add_range(static_cast<uint8_t>(lo), static_cast<uint8_t>(hi));
+            }
+            if (!at(']')) return fail("Unclosed group or character group");
+            ++m_pos;
+            if (negated) node.negate();
+            return add(node);
+        }
+        constexpr size_t atom() {
+            const char c = m_pattern[m_pos++];
+            switch (c) {
+                case '(':
+                    {
+                        const size_t group = ++m_tree.group_count;
+                        const size_t inner = alternation();
+                        if (m_tree.error != nullptr) return 0;
+                        if (!at(')')) return fail("Unclosed group at end");
+                        ++m_pos;
+                        return add(CxRegexNode{ .kind = CxRegexKind::Group, .left = inner, .group = group });
+                    }
+                case '[':
+                    return char_group();
+                case ']':
+                    return fail("Unmatched square parenthesis");
+                case '}':
+                    return fail("Unmatched close count group");
+                case '*':
+                case '+':
+                case '?':
+                case '{':
+                    return fail("Nothing to repeat");
+                case '^':
+                    return add(CxRegexNode{ .kind = CxRegexKind::Begin });
+                case '$':
+                    return add(CxRegexNode{ .kind = CxRegexKind::End });
+                case '.':
+                    {
+                        CxRegexNode node{ .kind = CxRegexKind::Set };
+                        node.add('\n');
+                        node.negate();
+                        return add(node);
+                    }
+                case '\\':
+                    {
+                        if (m_pos == m_size) return fail("Nothing to escape");
+                        const char escaped = m_pattern[m_pos++];
+                        if (is_escaped_set(escaped)) return add(escaped_set(escaped));
+                        return literal(escaped_char(escaped));
+                    }
+                default:
+                    return literal(c);
+            }
+        }
+        constexpr size_t count(size_t& value) {
+            if (m_pos == m_size || !is_digit(m_pattern[m_pos])) return fail("Invalid count");
+            value = 0;
+            while (m_pos < m_size && is_digit(m_pattern[m_pos])) {
+                value = value * 10 + static_cast<size_t>(m_pattern[m_pos++] - '0');
+                if (value > cx_regex_max_repeat_count) return fail("Count is too large");
+            }
+            return 0;
+        }
+        constexpr size_t piece() {
+            size_t node = atom();
+            if (m_tree.error != nullptr || m_pos == m_size) return node;
+            size_t min = 1;
+            size_t max = 1;
+            switch (m_pattern[m_pos]) {
+                case '*':
+                    min = 0;
+                    max = npos_;
+                    break;
+                case '+':
+                    max = npos_;
+                    break;
+                case '?':
+                    min = 0;
+                    break;
+                case '{':
+                    ++m_pos;
+                    count(min);
+                    max = min;
+                    if (m_tree.error == nullptr && at(',')) {
+                        ++m_pos;
+                        // {n,} has no upper bound
+                        if (at('}')) {
+                            max = npos_;
+                        } else {
+                            count(max);
+                        }
+                    }
+                    if (m_tree.error != nullptr) return 0;
+                    if (!at('}')) return fail("Invalid count");
+                    if (min > max) return fail("Invalid count");
+                    break;
+                default:
+                    return node;
+            }
+            ++m_pos;
+            // a ? after a quantifier makes it lazy
+            const bool lazy = at('?');
+            if (lazy) ++m_pos;
+            return add(CxRegexNode{ .kind = CxRegexKind::Repeat, .left = node, .min = min, .max = max, .lazy = lazy });
+        }
+        constexpr size_t sequence() {
+            size_t pieces[N]{};
+            size_t piece_count = 0;
+            while (m_pos < m_size && m_pattern[m_pos] != '|' && m_pattern[m_pos] != ')') {
+                const size_t node = piece();
+                if (m_tree.error != nullptr) return 0;
+                // characters next to each other become one literal, their bytes are already next to each other
+                const auto& added = m_tree.nodes[node];
+                if (piece_count != 0 && added.kind == CxRegexKind::Literal) {
+                    auto& last = m_tree.nodes[pieces[piece_count - 1]];
+                    if (last.kind == CxRegexKind::Literal && last.begin + last.size == added.begin) {
+                        ++last.size;
+                        continue;
+                    }
+                }
+                pieces[piece_count++] = node;
+            }
+            if (piece_count == 0) return add(CxRegexNode{ .kind = CxRegexKind::Empty });
+            size_t node = pieces[piece_count - 1];
+            for (size_t i = piece_count - 1; i > 0; --i) {
+                node = add(CxRegexNode{ .kind = CxRegexKind::Concat, .left = pieces[i - 1], .right = node });
+            }
+            return node;
+        }
+        constexpr size_t alternation() {
+            size_t node = sequence();
+            while (m_tree.error == nullptr && at('|')) {
+                ++m_pos;
+                const size_t right = sequence();
+                node               = add(CxRegexNode{ .kind = CxRegexKind::Alternate, .left = node, .right = right });
+            }
+            return node;
+        }
+
+        public:
+        constexpr CxRegexParser(const char (&pattern)[N]) : m_pattern(pattern) {}
+        constexpr CxRegexTree<N> parse() {
+            m_tree.root = alternation();
+            if (m_tree.error == nullptr && m_pos != m_size) fail("Unmatched group parenthesis");
+            return m_tree;
+        }
+    };
+    template <StringLiteral Pattern>
+    struct CxRegexParsed {
+        constexpr static auto tree = CxRegexParser{ Pattern._m_str }.parse();
+    };
+    template <bool Captures, size_t Groups>
+    struct CxRegexState {
+        constexpr static bool captures = Captures;
+        const char* text;
+        size_t size;
+        // begin and end of every group, like the slots of Regex, only there when captures are
+        size_t slots[Captures ? Groups * 2 + 2 : 1];
+    };
+    template <typename Parsed, size_t Index>
+    struct CxRegexMatcher {
+        constexpr static const auto& tree = Parsed::tree;
+        constexpr static CxRegexNode node = tree.nodes[Index];
+        using Left                        = CxRegexMatcher<Parsed, node.left>;
+        using Right                       = CxRegexMatcher<Parsed, node.right>;
+
+        // a node that's always exactly one byte, a repeat of it is a loop instead of a recursion
+        constexpr static bool single_byte =
+        node.kind == CxRegexKind::Set || (node.kind == CxRegexKind::Literal && node.size == 1);
+        constexpr static Pair<size_t, size_t> range = node.range();
+        constexpr static bool matches_byte(char c) {
+            if constexpr (node.kind == CxRegexKind::Literal) {
+                return c == tree.literals[node.begin];
+            } else if constexpr (range.first() <= range.second()) {
+                // \d, [a-z] and the like are one compare instead of a lookup
+                return static_cast<uint8_t>(static_cast<uint8_t>(c) - range.first()) <= range.second() - range.first();
+            } else {
+                return node.contains(static_cast<uint8_t>(c));
+            }
+        }
+        template <typename State, typename Cont>
+        constexpr static bool repeat(State& state, size_t pos, size_t count, const Cont& cont) {
+            // an iteration that matched nothing ends the loop once min is reached, it'd go on forever otherwise.
+            // with an upper bound the iteration itself still counts and sets its groups, without one it's dropped.
+            // Regex unrolls e{,n} the same way, its e* can pick a different match, see the comment at the top
+            auto again = [&](size_t next) {
+                if (next == pos && count >= node.min) return node.max != npos_ && cont(next);
+                return repeat(state, next, count + 1, cont);
+            };
+            if constexpr (node.lazy) {
+                if (count >= node.min && cont(pos)) return true;
+                return count < node.max && Left::match(state, pos, again);
+            } else {
+                if (count < node.max && Left::match(state, pos, again)) return true;
+                return count >= node.min && cont(pos);
+            }
+        }
+        // calls cont with where the match of this node ends, for every way it can match in order of priority, until
+        // one of the calls returns true
+        template <typename State, typename Cont>
+        constexpr static bool match(State& state, size_t pos, const Cont& cont) {
+            if constexpr (node.kind == CxRegexKind::Empty) {
+                return cont(pos);
+            } else if constexpr (node.kind == CxRegexKind::Literal) {
+                if (state.size - pos < node.size) return false;
+                for (size_t i = 0; i < node.size; ++i) {
+                    if (state.text[pos + i] != tree.literals[node.begin + i]) return false;
+                }
+                return cont(pos + node.size);
+            } else if constexpr (node.kind == CxRegexKind::Set) {
+                return pos < state.size && matches_byte(state.text[pos]) && cont(pos + 1);
+            } else if constexpr (node.kind == CxRegexKind::Begin) {
+                return pos == 0 && cont(pos);
+            } else if constexpr (node.kind == CxRegexKind::End) {
+                return pos == state.size && cont(pos);
+            } else if constexpr (node.kind == CxRegexKind::Concat) {
+                return Left::match(state, pos, [&](size_t next) { return Right::match(state, next, cont); });
+            } else if constexpr (node.kind == CxRegexKind::Alternate) {
+                return Left::match(state, pos, cont) || Right::match(state, pos, cont);
+            } else if constexpr (node.kind == CxRegexKind::Group) {
+                if constexpr (!State::captures) {
+                    return Left::match(state, pos, cont);
+                } else {
+                    return Left::match(state, pos, [&](size_t end) {
+                        const size_t old_begin          = state.slots[node.group * 2];
+                        const size_t old_end            = state.slots[node.group * 2 + 1];
+                        state.slots[node.group * 2]     = pos;
+                        state.slots[node.group * 2 + 1] = end;
+                        if (cont(end)) return true;
+                        state.slots[node.group * 2]     = old_begin;
+                        state.slots[node.group * 2 + 1] = old_end;
+                        return false;
+                    });
+                }
+            } else if constexpr (Left::single_byte) {
+                const size_t limit = node.max < state.size - pos ? node.max : state.size - pos;
+                size_t count       = 0;
+                if constexpr (node.lazy) {
+                    for (; count < node.min; ++count) {
+                        if (count == limit || !Left::matches_byte(state.text[pos + count])) return false;
+                    }
+                    for (;; ++count) {
+                        if (cont(pos + count)) return true;
+                        if (count == limit || !Left::matches_byte(state.text[pos + count])) return false;
+                    }
+                } else {
+                    while (count < limit && Left::matches_byte(state.text[pos + count])) ++count;
+                    if (count < node.min) return false;
+                    for (;; --count) {
+                        if (cont(pos + count)) return true;
+                        if (count == node.min) return false;
+                    }
+                }
+            } else {
+                return repeat(state, pos, 0, cont);
+            }
+        }
+    };
+    // walks down the start of the pattern, to where every match has to begin
+    template <typename Parsed>
+    consteval size_t cx_regex_first_node() {
+        const auto& tree = Parsed::tree;
+        size_t index     = tree.root;
+        for (;;) {
+            const auto& node = tree.nodes[index];
+            if (node.kind == CxRegexKind::Concat || node.kind == CxRegexKind::Group ||
+                (node.kind == CxRegexKind::Repeat && node.min != 0)) {
+                index = node.left;
+            } else {
+                return index;
+            }
+        }
+    }
+}    // namespace detail
+template <size_t Groups>
+class CompileTimeRegexMatch {
+    StringView m_text;
+    size_t m_slots[Groups * 2 + 2];
+
+    public:
+    constexpr CompileTimeRegexMatch(StringView text, const size_t* slots) : m_text(text) {
+        for (size_t i = 0; i < Groups * 2 + 2; ++i) m_slots[i] = slots[i];
+    }
+    constexpr size_t begin() const { return m_slots[0]; }
+    constexpr size_t end() const { return m_slots[1]; }
+    constexpr size_t size() const { return end() - begin(); }
+    constexpr StringView str() const { return m_text.substringview(begin(), end()); }
+    constexpr size_t group_count() const { return Groups; }
+    // groups are numbered from 1 like in the pattern, 0 is the whole match
+    constexpr bool has_group(size_t group) const { return group <= Groups && m_slots[group * 2] != npos_; }
+    constexpr StringView group(size_t group) const {
+        if (!has_group(group)) return {};
+        return m_text.substringview(m_slots[group * 2], m_slots[group * 2 + 1]);
+    }
+};
+template <StringLiteral Pattern>
+class CompileTimeRegex {
+    using Parsed                      = detail::CxRegexParsed<Pattern>;
+    constexpr static const auto& tree = Parsed::tree;
+    static_assert(tree.error == nullptr, "invalid regex pattern");
+    using Root = detail::CxRegexMatcher<Parsed, tree.root>;
+
+    constexpr static const auto& first = tree.nodes[detail::cx_regex_first_node<Parsed>()];
+    // ^ at the start, a match can only begin at 0
+    constexpr static bool anchored = first.kind == detail::CxRegexKind::Begin;
+    // every match starts with this literal, search() only tries where its first byte is
+    constexpr static bool has_first_byte = first.kind == detail::CxRegexKind::Literal;
+
+    // finds the leftmost match at or after from, begin and end are where it is
+    template <typename State>
+    constexpr static bool search_from(State& state, size_t from, size_t& begin, size_t& end) {
+        for (begin = from; begin <= state.size; ++begin) {
+            if constexpr (anchored) {
+                if (begin != 0) return false;
+            } else if constexpr (has_first_byte) {
+                while (begin < state.size && state.text[begin] != tree.literals[first.begin]) ++begin;
+                if (begin == state.size) return false;
+            }
+            if constexpr (State::captures) {
+                for (auto& slot : state.slots) slot = npos_;
+            }
+            const bool found = Root::match(state, begin, [&](size_t match_end) {
+                end = match_end;
+                return true;
+            });
+            if (found) return true;
+        }
+        return false;
+    }
+    template <bool Captures>
+    constexpr static auto state_for(StringView text) {
+        return detail::CxRegexState<Captures, tree.group_count>{ text.data(), text.size(), {} };
+    }
+
+    public:
+    constexpr static size_t group_count = tree.group_count;
+    constexpr CompileTimeRegex()        = default;
+    // true if the whole text matches
+    constexpr bool match(StringView text) const {
+        auto state = state_for<false>(text);
+        return Root::match(state, 0, [&](size_t end) { return end == state.size; });
+    }
+    // true if there's a match anywhere in the text
+    constexpr bool contains(StringView text) const {
+        auto state   = state_for<false>(text);
+        size_t begin = 0;
+        size_t end   = 0;
+        return search_from(state, 0, begin, end);
+    }
+    // the leftmost match that starts at or after from, the same one Regex::search finds except for the repeats
+    // described at the top
+    Optional<CompileTimeRegexMatch<0>> search(StringView text, size_t from = 0) const {
+        // the groups are only looked at by captures(), keeping track of them costs a bit
+        auto state      = state_for<false>(text);
+        size_t slots[2] = {};
+        if (!search_from(state, from, slots[0], slots[1])) return {};
+        return CompileTimeRegexMatch<0>{ text, slots };
+    }
+    // like search but with the capture groups filled in
+    Optional<CompileTimeRegexMatch<group_count>> captures(StringView text, size_t from = 0) const {
+        auto state   = state_for<true>(text);
+        size_t begin = 0;
+        size_t end   = 0;
+        if (!search_from(state, from, begin, end)) return {};
+        state.slots[0] = begin;
+        state.slots[1] = end;
+        return CompileTimeRegexMatch<group_count>{ text, state.slots };
+    }
+};
+template <StringLiteral Pattern>
+constexpr inline CompileTimeRegex<Pattern> cx_regex{};
+#endif
+}    // namespace ARLib
@@ -105,6 +105,18 @@ class File {
         if (line.size() != count) return FileError{ "Couldn't read requested size"_s, m_filename };
         return line;
     }
+    // like read_n but a short read isn't an error, an empty string means the end of the file was reached
+    ReadResult read_some(size_t count) {
+        if (m_mode != OpenFileMode::Read) {
+            return FileError{ "Can't read from a file not open in read mode"_s, m_filename };
+        }
+        String chunk{ count, '\0' };
+        const size_t read = ARLib::fread(chunk.rawptr(), sizeof(char), count, m_ptr);
+        // a failed read would look like the end of the file otherwise. on windows the failure comes back as EOF
+        if (read > count || ARLib::ferror(m_ptr)) return FileError{ "Failed to read from the file"_s, m_filename };
+        chunk.set_size(read);
+        return chunk;
+    }
     ReadResult read_line(bool& eof_reached);
     ReadResult read_all() {
         if (m_mode != OpenFileMode::Read) {
@@ -73,6 +73,12 @@ class FlatMap {
     auto find(O&& value) const {
         return m_table.template find<O, OHashCls>(Forward<O>(value));
     }
+    // heterogeneous lookup with the hash of the key already computed, e.g. for keys that are looked up over and over
+    template <typename O>
+    requires(EqualityComparableWith<O, Key>)
+    auto find_hashed(const O& value, size_t hash) const {
+        return m_table.find_hashed(value, hash);
+    }
     auto begin() const { return m_table.begin(); }
     auto end() const { return m_table.end(); }
     bool contains(const Key& value) const { return find(value) != end(); }
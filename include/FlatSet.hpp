@@ -1,6 +1,7 @@
 #pragma once
 
 #include "HashBase.hpp"
+#include "BitOps.hpp"
 #include "Concepts.hpp"
 #include "Vector.hpp"
 #include "Printer.hpp"
@@ -18,9 +19,6 @@ design notes/algorithms taken from:
 */
 
 namespace ARLib {
-namespace internal {
-    uint32_t trailing_zeros(uint32_t val);
-}
 template <typename T>
 class BitMask {
     T m_mask;
@@ -33,7 +31,7 @@ class BitMask {
     }
     BitMask begin() const { return *this; }
     BitMask end() const { return BitMask{ 0 }; };
-    uint32_t lowest_bit_set() const { return static_cast<uint32_t>(internal::trailing_zeros(m_mask)); }
+    uint32_t lowest_bit_set() const { return internal::trailing_zeros(static_cast<uint32_t>(m_mask)); }
     uint32_t operator*() const { return lowest_bit_set(); }
     private:
     friend bool operator==(const BitMask& a, const BitMask& b) { return a.m_mask == b.m_mask; }
@@ -314,9 +312,13 @@ class FlatSet {
     template <typename O, typename OHashCls = Hash<O>>
     requires(Hashable<O, OHashCls> && (EqualityComparableWith<O, T> || CanBeCompared<O>))
     auto find(const O& value) const {
-        const auto hasher       = OHashCls{};
+        return find_hashed(value, OHashCls{}(value));
+    }
+    // lookup with a hash computed beforehand, it has to match what HashCls would give for an equal element
+    template <typename O>
+    requires(EqualityComparableWith<O, T> || CanBeCompared<O>)
+    auto find_hashed(const O& value, size_t hash) const {
         const size_t num_groups = m_buckets.size();
-        const size_t hash       = hasher(value);
         size_t group            = h1(hash) % num_groups;
         while (true) {
             const Bucket& b = m_buckets[group];
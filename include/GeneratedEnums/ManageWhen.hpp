@@ -0,0 +1,13 @@
+#pragma once
+#include "Types.hpp"
+#include "EnumHelpers.hpp"
+namespace ARLib {
+	enum class ManageWhen : uint8_t {
+		None = 0,
+		AtExit = 1,
+		AtEnter = 2,
+		OnFailure = 4,
+		OnSuccess = 8,
+	};
+	MAKE_BITFIELD_ENUM(ManageWhen)
+}
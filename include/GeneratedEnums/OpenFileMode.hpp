@@ -0,0 +1,12 @@
+#pragma once
+#include "Types.hpp"
+#include "EnumHelpers.hpp"
+namespace ARLib {
+	enum class OpenFileMode : uint8_t {
+		None = 0,
+		Read = 1,
+		Write = 2,
+		ReadWrite = 4,
+		Append = 8,
+	};
+}
@@ -0,0 +1,300 @@
+#pragma once
+#include "JSONOnDemand.hpp"
+#include "JSONWriter.hpp"
+#include "NumberTraits.hpp"
+#include "Tuple.hpp"
+/*
+    compile time binding between json objects and plain structs.
+
+    a struct is bound by specializing Binding with one field descriptor per member:
+
+        template <>
+        struct ARLib::JSON::Binding<Message> {
+            constexpr static auto fields = JSON::fields(
+                JSON::field("id", &Message::id),
+                JSON::field("name", &Message::name)
+            );
+        };
+
+    from_json() then decodes straight into the members while walking the on-demand tape, no Document is ever built,
+    and to_json() writes the members through a Writer. keys are matched with a perfect hash table that's built at
+    compile time from the member names, so finding the member for a key costs one hash and one comparison.
+
+    members can be bool, integers (that fit in an int64_t), floating point, String, Vector, Optional and other bound
+    structs. unknown keys are skipped, missing keys are an error unless the member is an Optional, which is left
+    empty (and written as null). keys are matched as they appear in the source, escaped keys never match.
+*/
+namespace ARLib {
+namespace JSON {
+    // specialize with a `constexpr static auto fields = fields(...)` member
+    template <typename T>
+    struct Binding;
+    template <typename T>
+    concept Bound = requires { Binding<T>::fields; };
+    template <typename Class, typename Member>
+    struct FieldBinding {
+        using MemberType = Member;
+        StringView name;
+        Member Class::*member;
+    };
+    template <typename Class, typename Member>
+    constexpr FieldBinding<Class, Member> field(StringView name, Member Class::*member) {
+        return FieldBinding<Class, Member>{ name, member };
+    }
+    template <typename... Fields>
+    constexpr Tuple<Fields...> fields(Fields... descriptors) {
+        return Tuple<Fields...>{ descriptors... };
+    }
+    // how a single member type is read and written, specialized below for everything that's supported
+    template <typename T>
+    struct ValueBinding {
+        static_assert(AlwaysFalse<T>, "This type can't be bound to json");
+    };
+    namespace detail {
+        template <typename T>
+        constexpr inline bool IsOptional = false;
+        template <typename T>
+        constexpr inline bool IsOptional<Optional<T>> = true;
+        constexpr uint32_t field_hash(StringView key, uint32_t seed) {
+            uint32_t hash = 2166136261u ^ seed;
+            for (size_t i = 0; i < key.size(); ++i) {
+                hash = (hash ^ static_cast<uint8_t>(key[i])) * 16777619u;
+            }
+            hash ^= hash >> 16;
+            hash *= 0x85EBCA6Bu;
+            return hash ^ (hash >> 13);
+        }
+        template <size_t N>
+        struct FieldTable {
+            constexpr static size_t capacity = BitCeil(N) * 16;
+            // field index + 1 for every slot, 0 marks an empty one
+            ARLib::Array<uint8_t, capacity> slots{};
+            uint32_t seed = 0;
+            uint32_t mask = 0;
+        };
+        // tries increasingly sparse tables until a seed puts every name in its own slot
+        template <size_t N>
+        consteval FieldTable<N> make_field_table(const ARLib::Array<StringView, N>& names) {
+            for (size_t size = BitCeil(N) * 2; size <= FieldTable<N>::capacity; size *= 2) {
+                for (uint32_t seed = 0; seed < 256; ++seed) {
+                    FieldTable<N> table{};
+                    table.seed   = seed;
+                    table.mask   = static_cast<uint32_t>(size - 1);
+                    bool perfect = true;
+                    for (size_t i = 0; i < N && perfect; ++i) {
+                        auto& slot = table.slots[field_hash(names[i], seed) & table.mask];
+                        perfect    = slot == 0;
+                        slot       = static_cast<uint8_t>(i + 1);
+                    }
+                    if (perfect) return table;
+                }
+            }
+            CONSTEVAL_STATIC_ASSERT(false, "Couldn't build a perfect hash for the field names, are they unique?");
+            return {};
+        }
+        template <typename T>
+        using FieldsOf = RemoveCvRefT<decltype(Binding<T>::fields)>;
+        template <typename T, size_t I>
+        using MemberOf = typename RemoveCvRefT<decltype(get<I>(Binding<T>::fields))>::MemberType;
+        template <typename T>
+        struct BoundFields {
+            constexpr static size_t count = FieldsOf<T>::size;
+            static_assert(count > 0 && count <= 64, "A bound struct needs between 1 and 64 fields");
+            template <size_t... I>
+            constexpr static ARLib::Array<StringView, count> names_of(IndexSequence<I...>) {
+                return ARLib::Array<StringView, count>{ get<I>(Binding<T>::fields).name... };
+            }
+            template <size_t... I>
+            constexpr static uint64_t required_of(IndexSequence<I...>) {
+                return ((IsOptional<MemberOf<T, I>> ? 0ull : (1ull << I)) | ...);
+            }
+            constexpr static ARLib::Array<StringView, count> names = names_of(MakeIndexSequence<count>{});
+            constexpr static FieldTable<count> table        = make_field_table(names);
+            // bit I is set if field I has to be in the json
+            constexpr static uint64_t required = required_of(MakeIndexSequence<count>{});
+            constexpr static size_t npos       = static_cast<size_t>(-1);
+            static size_t find(StringView key) {
+                const uint8_t slot = table.slots.data()[field_hash(key, table.seed) & table.mask];
+                if (slot == 0 || names.data()[slot - 1] != key) return npos;
+                return slot - 1;
+            }
+        };
+        template <typename T, size_t I>
+        DiscardResult<ParseError> read_member(const OnDemandValue& value, T& out) {
+            return ValueBinding<MemberOf<T, I>>::read(value, out.*(get<I>(Binding<T>::fields).member));
+        }
+        template <typename T>
+        using MemberReader = DiscardResult<ParseError> (*)(const OnDemandValue&, T&);
+        template <typename T, size_t... I>
+        constexpr ARLib::Array<MemberReader<T>, sizeof...(I)> make_readers(IndexSequence<I...>) {
+            return ARLib::Array<MemberReader<T>, sizeof...(I)>{ &read_member<T, I>... };
+        }
+        template <typename T, size_t... I>
+        void write_members(Writer& writer, const T& value, IndexSequence<I...>) {
+            ((writer.key(get<I>(Binding<T>::fields).name),
+              ValueBinding<MemberOf<T, I>>::write(writer, value.*(get<I>(Binding<T>::fields).member))),
+             ...);
+        }
+    }    // namespace detail
+    template <Bound T>
+    struct ValueBinding<T> {
+        using Fields = detail::BoundFields<T>;
+        constexpr static auto readers = detail::make_readers<T>(MakeIndexSequence<Fields::count>{});
+        static DiscardResult<ParseError> read(const OnDemandValue& value, T& out) {
+            Optional<ParseError> error{};
+            uint64_t seen = 0;
+            auto walk     = value.for_each_field([&](StringView key, const OnDemandValue& member) {
+                if (!error.empty()) return;
+                const size_t index = Fields::find(key);
+                if (index == Fields::npos) return;
+                seen |= 1ull << index;
+                auto res = readers.data()[index](member, out);
+                if (res.is_error()) error = *res.to_error();
+            });
+            TRY(detail::first_error(error, walk));
+            if ((seen & Fields::required) != Fields::required) {
+                for (size_t i = 0; i < Fields::count; ++i) {
+                    if ((Fields::required >> i & 1) != 0 && (seen >> i & 1) == 0) {
+                        return ParseError{ "Missing key "_s + Fields::names[i].str(), value.offset() };
+                    }
+                }
+            }
+            return {};
+        }
+        static void write(Writer& writer, const T& value) {
+            writer.begin_object();
+            detail::write_members(writer, value, MakeIndexSequence<Fields::count>{});
+            writer.end_object();
+        }
+    };
+    template <>
+    struct ValueBinding<bool> {
+        static DiscardResult<ParseError> read(const OnDemandValue& value, bool& out) {
+            TRY_SET(result, value.get_bool());
+            out = result;
+            return {};
+        }
+        static void write(Writer& writer, bool value) { writer.boolean(value); }
+    };
+    template <Integral T>
+    requires(!SameAs<T, bool>)
+    struct ValueBinding<T> {
+        static DiscardResult<ParseError> read(const OnDemandValue& value, T& out) {
+            if constexpr (IsSigned<T>) {
+                TRY_SET(result, value.get_int64());
+                if constexpr (sizeof(T) < sizeof(int64_t)) {
+                    if (result < static_cast<int64_t>(NumberTraits<T>::min) ||
+                        result > static_cast<int64_t>(NumberTraits<T>::max)) {
+                        return ParseError{ "Integer out of range for the member"_s, value.offset() };
+                    }
+                }
+                out = static_cast<T>(result);
+            } else {
+                // unsigned members go through uint64_t, anything above the max of int64_t still fits
+                TRY_SET(result, value.get_uint64());
+                if (result > NumberTraits<T>::max) {
+                    return ParseError{ "Integer out of range for the member"_s, value.offset() };
+                }
+                out = static_cast<T>(result);
+            }
+            return {};
+        }
+        static void write(Writer& writer, T value) {
+            if constexpr (IsSigned<T>) {
+                writer.integer(static_cast<int64_t>(value));
+            } else {
+                writer.unsigned_integer(static_cast<uint64_t>(value));
+            }
+        }
+    };
+    template <FloatingPoint T>
+    struct ValueBinding<T> {
+        static DiscardResult<ParseError> read(const OnDemandValue& value, T& out) {
+            TRY_SET(result, value.get_double());
+            out = static_cast<T>(result);
+            return {};
+        }
+        static void write(Writer& writer, T value) { writer.number(static_cast<double>(value)); }
+    };
+    template <>
+    struct ValueBinding<String> {
+        static DiscardResult<ParseError> read(const OnDemandValue& value, String& out) {
+            TRY_SET(result, value.get_string_view());
+            out = result.str();
+            return {};
+        }
+        static void write(Writer& writer, const String& value) { writer.string(value.view()); }
+    };
+    template <typename T>
+    struct ValueBinding<Vector<T>> {
+        static DiscardResult<ParseError> read(const OnDemandValue& value, Vector<T>& out) {
+            out.clear();
+            Optional<ParseError> error{};
+            auto walk = value.for_each_element([&](const OnDemandValue& element) {
+                if (!error.empty()) return;
+                T item{};
+                auto res = ValueBinding<T>::read(element, item);
+                if (res.is_error()) {
+                    error = *res.to_error();
+                    return;
+                }
+                out.append(move(item));
+            });
+            return detail::first_error(error, walk);
+        }
+        static void write(Writer& writer, const Vector<T>& value) {
+            writer.begin_array();
+            for (const auto& item : value) { ValueBinding<T>::write(writer, item); }
+            writer.end_array();
+        }
+    };
+    template <typename T>
+    struct ValueBinding<Optional<T>> {
+        static DiscardResult<ParseError> read(const OnDemandValue& value, Optional<T>& out) {
+            if (value.is_null()) {
+                out = Optional<T>{};
+                return {};
+            }
+            T item{};
+            TRY(ValueBinding<T>::read(value, item));
+            out = move(item);
+            return {};
+        }
+        static void write(Writer& writer, const Optional<T>& value) {
+            if (value.empty()) {
+                writer.null();
+            } else {
+                ValueBinding<T>::write(writer, *value);
+            }
+        }
+    };
+    template <Bound T>
+    DiscardResult<ParseError> from_json(const OnDemandValue& value, T& out) {
+        return ValueBinding<T>::read(value, out);
+    }
+    template <Bound T>
+    requires DefaultConstructible<T>
+    Parsed<T> from_json(StringView source) {
+        TRY_SET(document, OnDemandDocument::parse(source));
+        T result{};
+        TRY(ValueBinding<T>::read(document.root(), result));
+        return result;
+    }
+    template <Bound T>
+    void to_json(Writer& writer, const T& value) {
+        ValueBinding<T>::write(writer, value);
+    }
+    template <Bound T>
+    String to_json(const T& value, WriteMode mode = WriteMode::Compact) {
+        Writer writer{ mode };
+        ValueBinding<T>::write(writer, value);
+        return writer.release();
+    }
+    // gives a bound struct the deserialize() / serialize() pair that Serializable asks for
+    template <typename T>
+    struct BindingSerializable {
+        static Parsed<T> deserialize(StringView view) { return from_json<T>(view); }
+        String serialize() const { return to_json(static_cast<const T&>(*this)); }
+    };
+}    // namespace JSON
+}    // namespace ARLib
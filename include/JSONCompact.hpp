@@ -0,0 +1,135 @@
+#pragma once
+#include "JSONStructural.hpp"
+#include "MappedFile.hpp"
+#include "Optional.hpp"
+/*
+    compact, read-only json dom.
+
+    every node is 16 bytes and all of them live in one vector: the elements of an array and the members of an object
+    (key, value, key, value, ...) are stored next to each other, so a container is just an offset and a count.
+    strings without escapes aren't copied, they point back into the source buffer, the ones that need unescaping get
+    decoded into a single buffer owned by the document. a document is a handful of allocations no matter how many
+    nodes it has, which also makes destroying it O(1).
+
+    documents created from a StringView or a StructuralIndex don't own the source, it has to outlive them.
+*/
+namespace ARLib {
+namespace JSON {
+    namespace detail {
+        struct CompactNode {
+            Type type;
+            // numbers: holds a double instead of an integer, strings: lives in the decoded buffer instead of the source
+            bool flag;
+            // string length, array elements or object members
+            uint32_t size;
+            union {
+                int64_t integer;
+                double floating;
+                bool boolean;
+                // strings: byte offset, containers: index of the first child node
+                uint64_t offset;
+            };
+        };
+        static_assert(sizeof(CompactNode) == 16);
+    }    // namespace detail
+    class CompactDocument;
+    // a view of a single node, only valid as long as the document it came from
+    class CompactValue {
+        const CompactDocument* m_document;
+        const detail::CompactNode* m_node;
+
+        const detail::CompactNode& child(size_t index) const;
+
+        public:
+        CompactValue(const CompactDocument* document, const detail::CompactNode* node) :
+            m_document(document), m_node(node) {}
+        Type type() const { return m_node->type; }
+        bool is_object() const { return m_node->type == Type::JObject; }
+        bool is_array() const { return m_node->type == Type::JArray; }
+        bool is_string() const { return m_node->type == Type::JString; }
+        bool is_number() const { return m_node->type == Type::JNumber; }
+        bool is_integer() const { return is_number() && !m_node->flag; }
+        bool is_bool() const { return m_node->type == Type::JBool; }
+        bool is_null() const { return m_node->type == Type::JNull; }
+        bool as_bool() const {
+            HARD_ASSERT(is_bool(), "Type must be bool when this is called")
+            return m_node->boolean;
+        }
+        int64_t as_int64() const {
+            HARD_ASSERT(is_integer(), "Type must be integer when this is called")
+            return m_node->integer;
+        }
+        // integers are converted
+        double as_double() const {
+            HARD_ASSERT(is_number(), "Type must be number when this is called")
+            return m_node->flag ? m_node->floating : static_cast<double>(m_node->integer);
+        }
+        StringView as_string() const;
+        // number of elements of an array or members of an object
+        size_t size() const {
+            HARD_ASSERT(is_array() || is_object(), "Type must be array or object when this is called")
+            return m_node->size;
+        }
+        CompactValue operator[](size_t index) const {
+            HARD_ASSERT(is_array(), "Type must be array when this is called")
+            HARD_ASSERT(index < m_node->size, "Index out of bounds")
+            return CompactValue{ m_document, &child(index) };
+        }
+        // object members, in the order they appear in the source
+        StringView key_at(size_t index) const;
+        CompactValue value_at(size_t index) const {
+            HARD_ASSERT(is_object(), "Type must be object when this is called")
+            HARD_ASSERT(index < m_node->size, "Index out of bounds")
+            return CompactValue{ m_document, &child(index * 2 + 1) };
+        }
+        // linear scan, objects are usually small enough that this beats hashing every key while parsing
+        Optional<CompactValue> find(StringView key) const;
+        CompactValue operator[](StringView key) const {
+            auto value = find(key);
+            HARD_ASSERT(!value.empty(), "Key not found in object")
+            return move(value).value();
+        }
+        // copies this subtree into a regular, mutable dom
+        Value to_value() const;
+    };
+    class CompactDocument {
+        String m_owned_source;
+        StringView m_source;
+        bool m_owns_source = false;
+        // documents made by from_file keep the file mapped, moving the mapping doesn't move the contents
+        MappedFile m_mapping;
+        String m_decoded;
+        Vector<detail::CompactNode> m_nodes;
+        detail::CompactNode m_root{};
+        // only used while parsing, kept around so reparsing doesn't have to allocate it again
+        Vector<detail::CompactNode> m_stack;
+
+        StringView source() const { return m_owns_source ? m_owned_source.view() : m_source; }
+
+        friend class CompactValue;
+        friend class CompactBuilder;
+
+        public:
+        // an empty document, meant to be reparsed
+        CompactDocument()                                      = default;
+        CompactDocument(const CompactDocument&)                = delete;
+        CompactDocument& operator=(const CompactDocument&)     = delete;
+        CompactDocument(CompactDocument&&) noexcept            = default;
+        CompactDocument& operator=(CompactDocument&&) noexcept = default;
+        CompactValue root() const { return CompactValue{ this, &m_root }; }
+        size_t node_count() const { return m_nodes.size() + 1; }
+        static Parsed<CompactDocument> parse(StringView source);
+        static Parsed<CompactDocument> parse(const StructuralIndex& index);
+        // the document takes ownership of the source
+        static Parsed<CompactDocument> parse(String&& source);
+        // maps the file instead of reading it, the mapping lives as long as the document
+        static Parsed<CompactDocument> from_file(const Path& filename);
+        // replaces the contents of this document, keeping the memory it already has,
+        // on failure the document is unusable until it's reparsed successfully
+        DiscardResult<ParseError> reparse(const StructuralIndex& index);
+    };
+    inline const detail::CompactNode& CompactValue::child(size_t index) const {
+        return m_document->m_nodes.index_unchecked(m_node->offset + index);
+    }
+}    // namespace JSON
+}    // namespace ARLib
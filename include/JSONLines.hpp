@@ -0,0 +1,107 @@
+#pragma once
+#ifndef DISABLE_THREADING
+    #include "JSONCompact.hpp"
+    #include "Parallel.hpp"
+/*
+    parallel parsing of newline delimited json (ndjson / json lines), one document per line.
+
+    the input is cut in chunks that always end right after a newline, so no record is ever split between two
+    chunks, and the chunks are parsed by the workers of a ThreadPool. every worker has its own LinesArena which
+    holds the structural index and the documents it parses into, they're reused from one record to the next so once
+    the buffers have grown to fit the biggest records parsing doesn't allocate anymore.
+
+    records are handed to the callback as func(offset, value), where offset is where the line starts in the input,
+    the value (and everything reachable from it) is only valid for the duration of the call.
+    blank lines are skipped, the first malformed record stops the parsing.
+*/
+namespace ARLib {
+namespace JSON {
+    struct LinesOptions {
+        // bytes of input handled by a single task, rounded up to the end of the line
+        size_t chunk_size = 1024 * 1024;
+        // in order, the callback is never called concurrently and sees the records in the order of the input,
+        // and the error returned is the one of the first malformed record.
+        // out of order, the callback is called by every worker as soon as a record is parsed, so it has to be thread
+        // safe, and parsing stops at whichever malformed record is found first.
+        bool ordered = true;
+        // pool to run on, nullptr means ThreadPool::global()
+        ThreadPool* pool = nullptr;
+    };
+    class LinesArena {
+        StructuralIndex m_index;
+        // with ordered delivery the whole chunk is parsed before its turn comes, one document per record
+        Vector<CompactDocument> m_documents;
+        Vector<size_t> m_offsets;
+        size_t m_count = 0;
+
+        public:
+        LinesArena() = default;
+        // parses the line that starts at offset into the next free document, error offsets are absolute
+        DiscardResult<ParseError> parse(StringView line, size_t offset);
+        void reset() { m_count = 0; }
+        size_t size() const { return m_count; }
+        size_t offset_at(size_t index) const { return m_offsets[index]; }
+        CompactValue value_at(size_t index) const { return m_documents[index].root(); }
+    };
+    namespace detail {
+        const char* find_newline(const char* begin, const char* end);
+        bool is_blank_line(const char* begin, const char* end);
+        // offsets where each chunk starts plus one final entry for the end of the buffer
+        Vector<size_t> split_lines(StringView buffer, size_t chunk_size);
+        // parses every line of the chunk, calls func(arena) after each record when emit_each is set, otherwise keeps
+        // them all in the arena. on failure the arena holds the records that came before the malformed one
+        template <typename Func>
+        DiscardResult<ParseError>
+        parse_chunk(LinesArena& arena, StringView chunk, size_t offset, bool emit_each, Func&& func) {
+            arena.reset();
+            const char* begin = chunk.data();
+            const char* end   = begin + chunk.size();
+            while (begin != end) {
+                const char* line_end = find_newline(begin, end);
+                if (!is_blank_line(begin, line_end)) {
+                    TRY(arena.parse(StringView{ begin, line_end }, offset + static_cast<size_t>(begin - chunk.data())));
+                    if (emit_each) {
+                        func(arena);
+                        arena.reset();
+                    }
+                }
+                begin = line_end == end ? end : line_end + 1;
+            }
+            return {};
+        }
+        template <typename Func>
+        DiscardResult<ParseError> parse_lines(StringView buffer, size_t base, Func& func, const LinesOptions& options) {
+            ThreadPool& pool   = options.pool ? *options.pool : ThreadPool::global();
+            const auto bounds  = split_lines(buffer, options.chunk_size);
+            const bool ordered = options.ordered;
+            Vector<LinesArena> arenas{};
+            auto deliver = [&func](const LinesArena& arena) {
+                for (size_t i = 0; i < arena.size(); ++i) { func(arena.offset_at(i), arena.value_at(i)); }
+            };
+            auto parse = [&](LinesArena& arena, size_t chunk) {
+                const StringView view{ buffer.data() + bounds[chunk], bounds[chunk + 1] - bounds[chunk] };
+                return parse_chunk(arena, view, base + bounds[chunk], !ordered, deliver);
+            };
+            return parallel::run_chunks<ParseError>(pool, bounds.size() - 1, ordered, arenas, parse, deliver);
+        }
+    }    // namespace detail
+    class LinesParser {
+        public:
+        // func is called as func(size_t offset, CompactValue value) for every record
+        template <typename Func>
+        static DiscardResult<ParseError> parse(StringView buffer, Func&& func, const LinesOptions& options = {}) {
+            return detail::parse_lines(buffer, 0, func, options);
+        }
+        // maps the file and parses it in place, the records point straight into the mapping
+        template <typename Func>
+        static DiscardResult<ParseError>
+        from_file(const Path& filename, Func&& func, const LinesOptions& options = {}) {
+            auto file_or_err = MappedFile::open(filename, MappedFile::sequential);
+            if (file_or_err.is_error()) { return ParseError{ file_or_err.to_error()->error_string(), 0 }; }
+            const auto file = file_or_err.to_ok();
+            return detail::parse_lines(file.view(), 0, func, options);
+        }
+    };
+}    // namespace JSON
+}    // namespace ARLib
+#endif
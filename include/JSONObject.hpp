@@ -97,6 +97,7 @@ namespace JSON {
         constexpr Number(detail::NumberTag, double val) : m_double_value(val), m_type(NumberType::Double) {}
         constexpr Number(detail::NumberTag, int64_t val) : m_int_value(val), m_type(NumberType::Integer) {}
         constexpr Number(detail::NumberTag, int val) : m_int_value(val), m_type(NumberType::Integer) {}
+        constexpr bool is_integer() const { return m_type == NumberType::Integer; }
         constexpr double value_double() const {
             HARD_ASSERT(m_type == NumberType::Double, "Type must be double when this is called");
             return m_double_value;
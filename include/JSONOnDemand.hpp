@@ -0,0 +1,164 @@
+#pragma once
+#include "JSONStructural.hpp"
+/*
+    on-demand json access.
+
+    parsing only runs stage one of the two-stage parser, nothing gets materialized until it's asked for:
+    navigating with operator[] walks the structural tape and jumps over the subtrees it doesn't need, and values
+    are only converted when one of the get_* functions is called on them.
+
+    lookups can be chained without checking every step, a failed lookup produces a value that remembers the error
+    and hands it out from every getter, so doc.root()["a"]["b"][3].get_int64() either has the number or says
+    which step went wrong.
+
+    only the parts of the document that are actually visited get validated, skipped subtrees are just checked for
+    balanced brackets. the source buffer has to outlive the document, and values point into the document so it
+    mustn't be moved while they're in use.
+*/
+namespace ARLib {
+namespace JSON {
+    class OnDemandDocument;
+    class Query;
+    namespace detail {
+        // for the for_each_* callbacks that can fail: the first error reported from inside the callback wins over a
+        // malformed container found later by the walk
+        inline DiscardResult<ParseError> first_error(Optional<ParseError>& inner, DiscardResult<ParseError>& walk) {
+            if (!inner.empty()) {
+                walk.ignore_error();
+                return move(inner).value();
+            }
+            if (walk.is_error()) return *walk.to_error();
+            return {};
+        }
+    }    // namespace detail
+    class OnDemandValue {
+        OnDemandDocument* m_document;
+        // position on the tape of the first structural of this value
+        size_t m_pos;
+        bool m_ok;
+        // the value doesn't exist, as opposed to the document being malformed
+        bool m_missing = false;
+        // why a missing value is missing, the message only becomes a String when someone asks for the error,
+        // lookups that miss all the time (query wildcards and filters) don't allocate
+        const char* m_missing_reason = nullptr;
+        ErrorInfo m_error;
+
+        OnDemandValue(OnDemandDocument* document, size_t pos) :
+            m_document(document), m_pos(pos), m_ok(true), m_error() {}
+        OnDemandValue(OnDemandDocument* document, ErrorInfo error) :
+            m_document(document), m_pos(0), m_ok(false), m_error(move(error)) {}
+        OnDemandValue(OnDemandDocument* document, const char* missing_reason, size_t offset) :
+            m_document(document), m_pos(0), m_ok(false), m_missing(true), m_missing_reason(missing_reason),
+            m_error{ String{}, offset } {}
+        OnDemandValue fail(const char* message) const;
+        ErrorInfo error_info() const {
+            if (m_missing_reason) return ErrorInfo{ String{ m_missing_reason }, m_error.error_offset };
+            return m_error;
+        }
+        Parsed<StringView> scalar_view() const;
+
+        friend class OnDemandDocument;
+        friend class Query;
+
+        public:
+        bool is_ok() const { return m_ok; }
+        // the lookup failed only because the key or the index isn't there, lookups on it stay missing
+        bool is_missing() const { return m_missing; }
+        // where the value starts in the source, for a failed value where the error is
+        size_t offset() const;
+        Parsed<Type> type() const;
+        bool is_null() const;
+        // lookups on a failed value just carry the failure forward
+        OnDemandValue operator[](StringView key) const;
+        OnDemandValue operator[](size_t index) const;
+        Parsed<int64_t> get_int64() const;
+        // the whole range of uint64_t, negative numbers are an error
+        Parsed<uint64_t> get_uint64() const;
+        // integers are converted
+        Parsed<double> get_double() const;
+        Parsed<bool> get_bool() const;
+        // points into the source if the string has no escapes, otherwise into a buffer owned by the document
+        Parsed<StringView> get_string_view() const;
+        Parsed<String> get_string() const;
+        // the raw text of the value, for strings without the quotes and with escapes left as they are
+        Parsed<StringView> get_raw_view() const;
+        // the number of elements of an array or members of an object, walks the whole container
+        Parsed<size_t> count() const;
+        // calls func(OnDemandValue) for each element, stops at the first malformed element
+        template <typename Func>
+        DiscardResult<ParseError> for_each_element(Func&& func) const;
+        // calls func(StringView key, OnDemandValue) for each member, the key is raw like with get_raw_view
+        template <typename Func>
+        DiscardResult<ParseError> for_each_field(Func&& func) const;
+    };
+    class OnDemandDocument {
+        StructuralIndex m_index;
+        // strings that needed unescaping, each one has its own allocation so views into it stay valid
+        Vector<UniquePtr<String>> m_decoded;
+        // tape position of the string -> index in m_decoded, a string is only decoded the first time it's asked for
+        FlatMap<size_t, size_t> m_decoded_at;
+
+        OnDemandDocument(StructuralIndex&& index) : m_index(move(index)) {}
+        char char_at(size_t pos) const { return m_index.view()[m_index[pos]]; }
+        bool at_end(size_t pos) const { return pos >= m_index.size(); }
+        ErrorInfo error_at(size_t pos, const char* message) const;
+        // returns the position right after the value that starts at pos
+        Parsed<size_t> skip_value(size_t pos) const;
+        // checks the separator after an element, returns true if the container continues
+        Parsed<bool> next_element(size_t& pos, char close) const;
+
+        friend class OnDemandValue;
+
+        public:
+        OnDemandDocument(const OnDemandDocument&)                = delete;
+        OnDemandDocument& operator=(const OnDemandDocument&)     = delete;
+        OnDemandDocument(OnDemandDocument&&) noexcept            = default;
+        OnDemandDocument& operator=(OnDemandDocument&&) noexcept = default;
+        // only builds the structural index, fails only if that does
+        static Parsed<OnDemandDocument> parse(StringView source);
+        OnDemandValue root();
+    };
+    template <typename Func>
+    DiscardResult<ParseError> OnDemandValue::for_each_element(Func&& func) const {
+        if (!m_ok) return ParseError{ error_info() };
+        const auto& doc = *m_document;
+        if (doc.at_end(m_pos) || doc.char_at(m_pos) != '[') {
+            return ParseError{ doc.error_at(m_pos, "Expected an array") };
+        }
+        size_t pos = m_pos + 1;
+        if (!doc.at_end(pos) && doc.char_at(pos) == ']') return {};
+        while (true) {
+            func(OnDemandValue{ m_document, pos });
+            TRY_SET(end, doc.skip_value(pos));
+            pos = end;
+            TRY_SET(more, doc.next_element(pos, ']'));
+            if (!more) return {};
+        }
+    }
+    template <typename Func>
+    DiscardResult<ParseError> OnDemandValue::for_each_field(Func&& func) const {
+        if (!m_ok) return ParseError{ error_info() };
+        const auto& doc = *m_document;
+        if (doc.at_end(m_pos) || doc.char_at(m_pos) != '{') {
+            return ParseError{ doc.error_at(m_pos, "Expected an object") };
+        }
+        size_t pos = m_pos + 1;
+        if (!doc.at_end(pos) && doc.char_at(pos) == '}') return {};
+        while (true) {
+            if (doc.at_end(pos) || doc.char_at(pos) != '"') {
+                return ParseError{ doc.error_at(pos, "Expected a string key") };
+            }
+            const auto view = doc.m_index.view();
+            const StringView key{ view.data() + doc.m_index[pos] + 1, view.data() + doc.m_index[pos + 1] };
+            pos += 2;
+            if (doc.at_end(pos) || doc.char_at(pos) != ':') return ParseError{ doc.error_at(pos, "Expected ':'") };
+            ++pos;
+            func(key, OnDemandValue{ m_document, pos });
+            TRY_SET(end, doc.skip_value(pos));
+            pos = end;
+            TRY_SET(more, doc.next_element(pos, '}'));
+            if (!more) return {};
+        }
+    }
+}    // namespace JSON
+}    // namespace ARLib
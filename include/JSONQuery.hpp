@@ -0,0 +1,169 @@
+#pragma once
+#include "JSONOnDemand.hpp"
+#include "NumberTraits.hpp"
+/*
+    precompiled json queries.
+
+    a query is compiled once from either a json pointer (RFC 6901, "/statuses/0/user") or a small subset of
+    jsonpath ("$.statuses[*].user['screen_name']", "$.items[1:-1:2]") and can then be evaluated against any
+    number of documents, both a Document and an OnDemandValue. compiling does all the work that doesn't depend on
+    the document: pointer escapes are decoded, array indices are parsed and the hash of every key is computed up
+    front, so looking a key up in a Document is a single probe of its FlatMap with no String built along the way.
+
+    supported jsonpath: the root $, .name, ['name'] / ["name"], [index] (negative counts from the end), .* / [*]
+    and [start:end:step] slices with the same rules as python. recursive descent, filters and unions aren't.
+    a pointer token that's an array index selects the element when the value is an array and the member otherwise.
+
+    find() gives the first match, which for a query without wildcards or slices is the only one. for_each()
+    visits all of them, in document order for arrays and in storage order for the members of a Document object.
+*/
+namespace ARLib {
+namespace JSON {
+    class Query {
+        public:
+        struct Step {
+            enum class Kind : uint8_t { Member, Index, Wildcard, Slice };
+            Kind kind = Kind::Member;
+            // Member: the decoded key and its hash as the Document's FlatMap computes it
+            String key{};
+            size_t hash = 0;
+            // Member: the key as an array index, -1 if it isn't one. Index: the index, negative counts from the end
+            int64_t index = 0;
+            // Slice: the bounds as written, has_* is false where they were left out
+            int64_t start  = 0;
+            int64_t end    = 0;
+            int64_t step   = 1;
+            bool has_start = false;
+            bool has_end   = false;
+        };
+
+        private:
+        Vector<Step> m_steps;
+        bool m_single = true;
+
+        Query() = default;
+        void add_member(String&& key, bool index_allowed);
+        static const ValueObj* step_into(const ValueObj& value, const Step& step);
+        static OnDemandValue step_into(const OnDemandValue& value, const Step& step);
+        const ValueObj* find_from(const ValueObj& value, size_t step) const;
+        template <typename Func>
+        void walk(const ValueObj& value, size_t step, Func& func) const;
+        template <typename Func>
+        DiscardResult<ParseError> walk(const OnDemandValue& value, size_t step, Func& func) const;
+
+        public:
+        static Parsed<Query> pointer(StringView pointer);
+        static Parsed<Query> path(StringView path);
+        // true if the query can match at most one value
+        bool is_single() const { return m_single; }
+        const Vector<Step>& steps() const { return m_steps; }
+        // nullptr if nothing matches
+        const ValueObj* find(const ValueObj& root) const { return find_from(root, 0); }
+        // a failed value says why if nothing matches
+        OnDemandValue find(const OnDemandValue& root) const;
+        // calls func(const ValueObj&) for every match
+        template <typename Func>
+        void for_each(const ValueObj& root, Func&& func) const {
+            walk(root, 0, func);
+        }
+        // calls func(const OnDemandValue&) for every match, stops at the first malformed part of the document
+        template <typename Func>
+        DiscardResult<ParseError> for_each(const OnDemandValue& root, Func&& func) const {
+            return walk(root, 0, func);
+        }
+    };
+    namespace detail {
+        // the indices a slice selects in an array of size len, as begin, end (exclusive) and step
+        struct SliceBounds {
+            int64_t begin;
+            int64_t end;
+            int64_t step;
+            bool contains(int64_t index) const {
+                if (step > 0) return index >= begin && index < end && (index - begin) % step == 0;
+                return index <= begin && index > end && (begin - index) % (-step) == 0;
+            }
+        };
+        SliceBounds slice_bounds(const Query::Step& step, size_t len);
+        // an index that can count from the end resolved against len, size_t(-1) if it's out of bounds
+        size_t resolve_index(int64_t index, size_t len);
+    }    // namespace detail
+    template <typename Func>
+    void Query::walk(const ValueObj& value, size_t step, Func& func) const {
+        if (step == m_steps.size()) {
+            func(value);
+            return;
+        }
+        const Step& current = m_steps[step];
+        if (current.kind == Step::Kind::Member || current.kind == Step::Kind::Index) {
+            if (const auto* next = step_into(value, current); next) walk(*next, step + 1, func);
+            return;
+        }
+        if (value.type() == Type::JArray) {
+            const auto& array = value.as<Type::JArray>();
+            if (current.kind == Step::Kind::Wildcard) {
+                for (const auto& item : array) { walk(*item, step + 1, func); }
+                return;
+            }
+            const auto bounds = detail::slice_bounds(current, array.size());
+            for (int64_t i = bounds.begin; bounds.step > 0 ? i < bounds.end : i > bounds.end; i += bounds.step) {
+                walk(array[static_cast<size_t>(i)], step + 1, func);
+            }
+        } else if (value.type() == Type::JObject && current.kind == Step::Kind::Wildcard) {
+            for (const auto& entry : value.as<Type::JObject>()) { walk(*entry.val(), step + 1, func); }
+        }
+    }
+    template <typename Func>
+    DiscardResult<ParseError> Query::walk(const OnDemandValue& value, size_t step, Func& func) const {
+        if (step == m_steps.size()) {
+            func(value);
+            return {};
+        }
+        const Step& current = m_steps[step];
+        if (current.kind == Step::Kind::Member || current.kind == Step::Kind::Index) {
+            const auto next = step_into(value, current);
+            if (next.is_missing()) return {};
+            if (!next.is_ok()) return ParseError{ next.error_info() };
+            return walk(next, step + 1, func);
+        }
+        TRY_SET(type, value.type());
+        Optional<ParseError> error{};
+        auto visit = [&](const OnDemandValue& item) {
+            if (!error.empty()) return;
+            auto res = walk(item, step + 1, func);
+            if (res.is_error()) error = *res.to_error();
+        };
+        if (type == Type::JObject && current.kind == Step::Kind::Wildcard) {
+            auto res = value.for_each_field([&visit](StringView, const OnDemandValue& item) { visit(item); });
+            return detail::first_error(error, res);
+        }
+        if (type != Type::JArray) return {};
+        if (current.kind == Step::Kind::Wildcard) {
+            auto res = value.for_each_element(visit);
+            return detail::first_error(error, res);
+        }
+        // bounds that count from the end need the size of the array first, which means walking it one more time
+        const bool from_start = current.step > 0 && current.start >= 0 && (!current.has_end || current.end >= 0);
+        size_t len            = static_cast<size_t>(NumberTraits<int64_t>::max);
+        if (!from_start) {
+            TRY_SET(count, value.count());
+            len = count;
+        }
+        const auto bounds = detail::slice_bounds(current, len);
+        if (bounds.step < 0) {
+            // the tape can only be walked forwards, the elements are found in one pass and visited backwards after
+            Vector<OnDemandValue> elements{};
+            elements.reserve(len);
+            TRY(value.for_each_element([&elements](const OnDemandValue& item) { elements.append(item); }));
+            for (int64_t i = bounds.begin; i > bounds.end; i += bounds.step) {
+                TRY(walk(elements[static_cast<size_t>(i)], step + 1, func));
+            }
+            return {};
+        }
+        int64_t index = 0;
+        auto res      = value.for_each_element([&](const OnDemandValue& item) {
+            if (bounds.contains(index++)) visit(item);
+        });
+        return detail::first_error(error, res);
+    }
+}    // namespace JSON
+}    // namespace ARLib
@@ -0,0 +1,81 @@
+#pragma once
+#include "JSONStructural.hpp"
+#include "Stream.hpp"
+/*
+    streaming, sax style json reader.
+
+    the input is pushed in chunks of any size with feed() and the events are delivered to a SaxHandler as soon as
+    each value is complete, nothing of the document is kept around once it has been reported. values that are split
+    across two or more chunks are collected in a small buffer until they're complete, so memory use is bounded by
+    the longest single string or number in the input plus one byte per nesting level, not by the size of the document.
+
+    views passed to the handler are only valid for the duration of the call.
+    grammar, escapes and numbers follow the same rules as StructuralParser.
+*/
+namespace ARLib {
+namespace JSON {
+    struct SaxHandler {
+        virtual void on_object_start() {}
+        virtual void on_object_end() {}
+        virtual void on_array_start() {}
+        virtual void on_array_end() {}
+        virtual void on_key(StringView) {}
+        virtual void on_string(StringView) {}
+        virtual void on_number(const Number&) {}
+        virtual void on_bool(bool) {}
+        virtual void on_null() {}
+        virtual ~SaxHandler() = default;
+    };
+    class StreamReader {
+        enum class State : uint8_t {
+            Value,
+            // right after '[', where ']' is also fine
+            FirstValue,
+            Key,
+            // right after '{', where '}' is also fine
+            FirstKey,
+            Colon,
+            Separator,
+            String,
+            Scalar,
+            Done
+        };
+        SaxHandler& m_handler;
+        State m_state = State::Value;
+        // '{' or '[' for every open container
+        Vector<char> m_containers;
+        // the part of a string or scalar seen so far, if it didn't fit in a single chunk
+        String m_token;
+        String m_decoded;
+        // bytes fed before the current chunk
+        size_t m_offset       = 0;
+        size_t m_token_offset = 0;
+        bool m_in_key         = false;
+        // the last chunk ended in the middle of an escape sequence
+        bool m_escaped = false;
+
+        ParseError unexpected(char c, const char* expected, size_t offset) const;
+        DiscardResult<ParseError> structural(char c, size_t offset);
+        DiscardResult<ParseError> scan_string(const char* data, size_t size, size_t& pos);
+        DiscardResult<ParseError> scan_scalar(const char* data, size_t size, size_t& pos);
+        DiscardResult<ParseError> finish_string(const char* begin, const char* end);
+        DiscardResult<ParseError> finish_scalar(const char* begin, const char* end);
+        void close_container();
+        void end_value() { m_state = m_containers.size() == 0 ? State::Done : State::Separator; }
+
+        public:
+        constexpr static size_t default_chunk_size = 64 * 1024;
+        StreamReader(SaxHandler& handler) : m_handler(handler) {}
+        // the reader can't be used anymore after either of these fails
+        DiscardResult<ParseError> feed(StringView chunk);
+        // to be called once the input is over, reports a pending scalar and checks that the document is complete
+        DiscardResult<ParseError> finish();
+        // total number of bytes fed so far
+        size_t offset() const { return m_offset; }
+        static DiscardResult<ParseError>
+        parse(CharacterStream& stream, SaxHandler& handler, size_t chunk_size = default_chunk_size);
+        static DiscardResult<ParseError>
+        from_file(const Path& filename, SaxHandler& handler, size_t chunk_size = default_chunk_size);
+    };
+}    // namespace JSON
+}    // namespace ARLib
@@ -0,0 +1,63 @@
+#pragma once
+#include "JSONObject.hpp"
+#include "JSONParser.hpp"
+#include "StringView.hpp"
+#include "Vector.hpp"
+/*
+    two-stage json parser.
+
+    stage one (StructuralIndex) looks at the input 64 bytes at a time with SIMD and finds every quote, backslash and
+    structural character ({}[]:,) outside of strings, plus the first character of every scalar (numbers, true, false,
+    null). the result is a tape with the offset of each of those characters, strings get both the opening and the
+    closing quote on the tape so their extent is known without scanning them again.
+
+    stage two (StructuralParser) walks that tape to build the same Document that Parser builds,
+    without ever looking at whitespace or at the bytes between two structurals more than once.
+
+    unlike Parser it follows the grammar strictly: escapes are decoded per RFC 8259 (including \uXXXX), control
+    characters in strings have to be escaped, numbers have to be valid json numbers and the only whitespace allowed
+    is space, tab, newline and carriage return.
+*/
+namespace ARLib {
+namespace JSON {
+    namespace detail {
+        // building blocks shared by the parsers that work off a StructuralIndex,
+        // error offsets are relative to base
+        // first backslash or raw control character (below 0x20) in [begin, end), a string without either is
+        // already decoded
+        const char* find_escape_or_control(const char* begin, const char* end);
+        // decodes the escapes in [begin, end) and appends the result to str, raw control characters are an error
+        DiscardResult<ParseError> unescape_string(String& str, const char* begin, const char* end, const char* base);
+        // [begin, end) has to be exactly one json number, integers that fit in an int64_t stay integers
+        Parsed<Number> parse_number(const char* begin, const char* end, const char* base);
+    }    // namespace detail
+    class StructuralIndex {
+        StringView m_view;
+        // offsets into m_view, always terminated by a sentinel equal to m_view.size()
+        Vector<uint32_t> m_indices;
+
+        public:
+        // an empty index, meant to be rebuilt
+        StructuralIndex() { m_indices.append(0); }
+        StructuralIndex(const StructuralIndex&)                = default;
+        StructuralIndex(StructuralIndex&&) noexcept            = default;
+        StructuralIndex& operator=(const StructuralIndex&)     = default;
+        StructuralIndex& operator=(StructuralIndex&&) noexcept = default;
+        // fails only if a string is never closed or the input doesn't fit in 32 bit offsets
+        static Parsed<StructuralIndex> build(StringView view);
+        // indexes view reusing the memory of this index, which is unusable until it's rebuilt again if this fails
+        DiscardResult<ParseError> rebuild(StringView view);
+        StringView view() const { return m_view; }
+        const Vector<uint32_t>& indices() const { return m_indices; }
+        // number of structurals, not counting the sentinel
+        size_t size() const { return m_indices.size() - 1; }
+        uint32_t operator[](size_t index) const { return m_indices[index]; }
+    };
+    class StructuralParser {
+        public:
+        static ParseResult parse(StringView view);
+        static ParseResult parse(const StructuralIndex& index);
+        static ParseResult from_file(const Path& filename);
+    };
+}    // namespace JSON
+}    // namespace ARLib
@@ -0,0 +1,67 @@
+#pragma once
+#include "JSONCompact.hpp"
+#include "Stream.hpp"
+/*
+    json serializer.
+
+    everything is written straight into a single output buffer: no temporary strings per value, strings are
+    escaped by copying the runs between the characters that need an escape (found 32 bytes at a time) and doubles
+    use the shortest representation that reads back as the same value.
+
+    values can be written from a dom (ValueObj or CompactValue) or one at a time with the begin_ / end_ functions,
+    key and the scalar functions, commas, colons and indentation are taken care of by the writer.
+    the output either stays in the writer until it's taken out with str() / release(), or goes to a BaseStream
+    every time the buffer grows past flush_threshold and when flush() is called.
+*/
+namespace ARLib {
+namespace JSON {
+    enum class WriteMode : uint8_t { Compact, Pretty };
+    class Writer {
+        BufferedSink m_out;
+        WriteMode m_mode;
+        // pretty mode indents by one tab per level, starting from m_base_indent for the top level value
+        size_t m_base_indent = 0;
+        size_t m_open        = 0;
+        // no element has been written in the innermost open container yet
+        bool m_first = true;
+        // a key was just written, the value that follows takes no separator
+        bool m_after_key = false;
+
+        void newline_and_indent(size_t level);
+        void separate();
+        void write_escaped(StringView str);
+
+        public:
+        constexpr static size_t flush_threshold = 64 * 1024;
+        explicit Writer(WriteMode mode = WriteMode::Compact, size_t base_indent = 0) :
+            m_mode(mode), m_base_indent(base_indent) {}
+        explicit Writer(BaseStream& sink, WriteMode mode = WriteMode::Compact) :
+            m_out(sink, flush_threshold, flush_threshold), m_mode(mode) {}
+        Writer& begin_object();
+        Writer& end_object();
+        Writer& begin_array();
+        Writer& end_array();
+        Writer& key(StringView key);
+        Writer& string(StringView value);
+        Writer& integer(int64_t value);
+        Writer& unsigned_integer(uint64_t value);
+        // nan and infinities have no json representation and are written as null
+        Writer& number(double value);
+        Writer& number(const Number& value);
+        Writer& boolean(bool value);
+        Writer& null();
+        Writer& value(const ValueObj& value);
+        Writer& value(const Object& value);
+        Writer& value(const Array& value);
+        Writer& value(CompactValue value);
+        // what has been written so far, not counting what already went to the sink
+        const String& str() const { return m_out.str(); }
+        String release() { return m_out.release(); }
+        // hands whatever is buffered to the sink, also reports an error from an earlier automatic flush
+        DiscardResult<Error> flush() { return m_out.flush(); }
+    };
+    // serializes a single value into a new string
+    String to_json(const ValueObj& value, WriteMode mode = WriteMode::Compact);
+    String to_json(CompactValue value, WriteMode mode = WriteMode::Compact);
+}    // namespace JSON
+}    // namespace ARLib
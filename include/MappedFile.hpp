@@ -0,0 +1,54 @@
+#pragma once
+#include "File.hpp"
+#include "FileSystem.hpp"
+#include "Span.hpp"
+#include "StringView.hpp"
+/*
+    read-only file that's mapped into memory instead of read.
+
+    the contents are the pages of the OS file cache, nothing is copied, so a parser can run over a big file that
+    costs its size in memory once instead of twice (cache and a String). pages are read in the first time they're
+    touched, the options tell the kernel what to expect so it can read ahead of the parser instead:
+    - access: Sequential reads ahead aggressively and drops pages behind the reader, Random turns read-ahead off
+    - will_need: starts reading the whole file in the background right away
+    - populate: reads the whole file in before open() returns, no page faults afterwards (MAP_POPULATE)
+    - huge_pages: puts the mapping at a 2 MiB boundary and asks for transparent huge pages, fewer TLB misses on a
+      big file. only does something when the kernel can back file mappings with huge pages (read-only THP for
+      files), otherwise it's ignored
+
+    on windows access and huge_pages are ignored, will_need and populate prefetch the whole view.
+    the file is assumed not to change while it's mapped, a file that's truncated meanwhile crashes the reader.
+*/
+namespace ARLib {
+enum class MappedFileAccess { Normal, Sequential, Random };
+struct MappedFileOptions {
+    MappedFileAccess access = MappedFileAccess::Normal;
+    bool will_need          = false;
+    bool populate           = false;
+    bool huge_pages         = false;
+};
+class MappedFile {
+    NativeMappedFile m_native;
+
+    explicit MappedFile(NativeMappedFile&& native) : m_native(move(native)) {}
+
+    public:
+    MappedFile() = default;
+    // parsers read front to back once, this is what they use
+    constexpr static MappedFileOptions sequential{ .access = MappedFileAccess::Sequential, .will_need = true };
+    static Result<MappedFile, FileError> open(const Path& path, const MappedFileOptions& options = {});
+    // the mapping stays where it is, views taken before a move are still valid afterwards
+    MappedFile(MappedFile&&) noexcept            = default;
+    MappedFile& operator=(MappedFile&&) noexcept = default;
+    size_t size() const { return m_native.size(); }
+    bool empty() const { return m_native.size() == 0; }
+    const uint8_t* data() const { return m_native.data(); }
+    Span<const uint8_t> bytes() const { return Span<const uint8_t>{ m_native.data(), m_native.size() }; }
+    StringView view() const { return StringView{ reinterpret_cast<const char*>(m_native.data()), m_native.size() }; }
+    // how the rest of the file is going to be read
+    void advise(MappedFileAccess access);
+    // starts reading [offset, offset + size) in the background
+    void will_need(size_t offset, size_t size) { m_native.will_need(offset, size); }
+    void close() { m_native.unmap(); }
+};
+}    // namespace ARLib
@@ -0,0 +1,346 @@
+#pragma once
+#ifndef DISABLE_THREADING
+    #include "Algorithm.hpp"
+    #include "Allocator.hpp"
+    #include "Optional.hpp"
+    #include "ThreadPool.hpp"
+    #include "Vector.hpp"
+namespace ARLib {
+namespace parallel {
+    struct Options {
+        // number of elements handled by a single task, 0 lets the algorithm pick one
+        size_t grain_size = 0;
+        // when set, chunk boundaries only depend on grain_size (never on the number of threads) and partial results
+        // are combined in index order, so non-associative operations (e.g. floating point sums) are reproducible
+        bool deterministic = false;
+        // pool to run on, nullptr means ThreadPool::global()
+        ThreadPool* pool = nullptr;
+    };
+    template <typename Iter>
+    concept RandomAccessIter = ForwardIterator<Iter> && requires(Iter it, Iter other, size_t offset) {
+        { it + offset };
+        { it - other };
+    };
+    namespace detail {
+        constexpr size_t default_grain_size = 4096;
+        // ARLib's iterators only have non-const operator+, taking the iterator by value sidesteps that
+        template <typename Iter>
+        Iter advance(Iter it, size_t offset) {
+            return it + offset;
+        }
+        template <typename Iter>
+        size_t distance(Iter first, Iter last) {
+            return static_cast<size_t>(last - first);
+        }
+        struct ChunkPlan {
+            size_t total;
+            size_t chunk_size;
+            size_t chunk_count;
+            size_t begin(size_t chunk) const { return chunk * chunk_size; }
+            size_t end(size_t chunk) const { return min_bt(total, (chunk + 1) * chunk_size); }
+        };
+        inline ThreadPool& pool_from(const Options& options) {
+            return options.pool ? *options.pool : ThreadPool::global();
+        }
+        inline ChunkPlan plan_chunks(size_t total, const Options& options, const ThreadPool& pool) {
+            size_t chunk_size = options.grain_size;
+            if (chunk_size == 0) {
+                if (options.deterministic) {
+                    chunk_size = default_grain_size;
+                } else {
+                    // a few chunks per thread, so the threads that finish early can pick up the slack
+                    const size_t target_chunks = (pool.size() + 1) * 4;
+                    const size_t even_split    = (total + target_chunks - 1) / target_chunks;
+                    chunk_size                 = max_bt(even_split, default_grain_size);
+                }
+            }
+            return { total, chunk_size, (total + chunk_size - 1) / chunk_size };
+        }
+        // number of elements of a that come before the first `diagonal` elements of the stable merge of a and b
+        template <typename Src, typename Less>
+        size_t merge_path(Src a, size_t a_len, Src b, size_t b_len, size_t diagonal, Less& lt) {
+            size_t lo = diagonal > b_len ? diagonal - b_len : 0;
+            size_t hi = min_bt(diagonal, a_len);
+            while (lo < hi) {
+                const size_t mid = lo + (hi - lo) / 2;
+                if (lt(*advance(b, diagonal - 1 - mid), *advance(a, mid))) {
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            return lo;
+        }
+        template <typename T, typename Dst>
+        void emit(Dst out, T&& value, bool construct) {
+            if (construct) {
+                new (addressof(*out)) RemoveCvRefT<T>{ move(value) };
+            } else {
+                *out = move(value);
+            }
+        }
+        template <typename Src, typename Dst, typename Less>
+        void merge_into(Src a, Src a_end, Src b, Src b_end, Dst out, bool construct, Less& lt) {
+            while (a != a_end && b != b_end) {
+                // ties are taken from the left run, this keeps the merge stable
+                if (lt(*b, *a)) {
+                    emit(out, move(*b), construct);
+                    ++b;
+                } else {
+                    emit(out, move(*a), construct);
+                    ++a;
+                }
+                ++out;
+            }
+            for (; a != a_end; ++a, ++out) { emit(out, move(*a), construct); }
+            for (; b != b_end; ++b, ++out) { emit(out, move(*b), construct); }
+        }
+        // merges every pair of adjacent sorted runs of length `width` from src into dst
+        // the output is cut in chunk_size pieces, each piece finds its inputs with merge_path and merges independently
+        template <typename Src, typename Dst, typename Less>
+        void merge_pass(
+        ThreadPool& pool, const ChunkPlan& plan, size_t width, Src src, Dst dst, bool construct, Less& lt
+        ) {
+            Vector<size_t> splits{};
+            splits.resize(plan.chunk_count + 1);
+            // the split points have to be computed before anything is moved out of src
+            pool.run_indexed(plan.chunk_count + 1, [&](size_t piece) {
+                const size_t start = min_bt(piece * plan.chunk_size, plan.total);
+                const size_t base  = start == plan.total ? plan.total : (start / (2 * width)) * (2 * width);
+                const size_t mid   = min_bt(base + width, plan.total);
+                const size_t end   = min_bt(base + 2 * width, plan.total);
+                splits[piece] =
+                base + merge_path(advance(src, base), mid - base, advance(src, mid), end - mid, start - base, lt);
+            });
+            pool.run_indexed(plan.chunk_count, [&](size_t piece) {
+                const size_t start = plan.begin(piece);
+                const size_t stop  = plan.end(piece);
+                const size_t base  = (start / (2 * width)) * (2 * width);
+                const size_t mid   = min_bt(base + width, plan.total);
+                const size_t a_lo  = splits[piece];
+                // the next piece might belong to the next pair of runs, in which case this one takes all of a
+                const size_t a_hi = stop - base >= 2 * width || stop == plan.total ? mid : splits[piece + 1];
+                const size_t b_lo = mid + (start - base) - (a_lo - base);
+                const size_t b_hi = mid + (stop - base) - (a_hi - base);
+                merge_into(
+                advance(src, a_lo), advance(src, a_hi), advance(src, b_lo), advance(src, b_hi), advance(dst, start),
+                construct, lt
+                );
+            });
+        }
+    }    // namespace detail
+    template <RandomAccessIter Iter, typename Func>
+    requires CallableWith<Func, IteratorOutputType<Iter>>
+    void for_each(Iter first, Iter last, Func&& func, const Options& options = {}) {
+        ThreadPool& pool = detail::pool_from(options);
+        const auto plan  = detail::plan_chunks(detail::distance(first, last), options, pool);
+        pool.run_indexed(plan.chunk_count, [&](size_t chunk) {
+            Iter it = detail::advance(first, plan.begin(chunk));
+            for (size_t i = plan.begin(chunk); i < plan.end(chunk); ++i, ++it) { func(*it); }
+        });
+    }
+    template <Iterable C, typename Func>
+    void for_each(C& cont, Func&& func, const Options& options = {}) {
+        parallel::for_each(cont.begin(), cont.end(), Forward<Func>(func), options);
+    }
+    template <RandomAccessIter Iter, typename T, typename Reduce, typename Transform>
+    requires CallableWith<Transform, IteratorOutputType<Iter>> && CallableWith<Reduce, T, T>
+    T transform_reduce(
+    Iter first, Iter last, T init, Reduce&& reduce, Transform&& transform, const Options& options = {}
+    ) {
+        ThreadPool& pool = detail::pool_from(options);
+        const auto plan  = detail::plan_chunks(detail::distance(first, last), options, pool);
+        auto reduce_chunk = [&](size_t chunk) {
+            Iter it = detail::advance(first, plan.begin(chunk));
+            T partial{ transform(*it) };
+            ++it;
+            for (size_t i = plan.begin(chunk) + 1; i < plan.end(chunk); ++i, ++it) {
+                partial = reduce(move(partial), transform(*it));
+            }
+            return partial;
+        };
+        if (options.deterministic) {
+            Vector<Optional<T>> partials{};
+            partials.resize(plan.chunk_count);
+            pool.run_indexed(plan.chunk_count, [&](size_t chunk) { partials[chunk] = reduce_chunk(chunk); });
+            for (auto& partial : partials) { init = reduce(move(init), move(*partial)); }
+            return init;
+        }
+        // chunks get folded in whatever order they complete, only the pool-sized handful of partials is serialized
+        Mutex mutex{};
+        Optional<T> total{};
+        pool.run_indexed(plan.chunk_count, [&](size_t chunk) {
+            T partial = reduce_chunk(chunk);
+            ScopedLock lock{ mutex };
+            if (total) {
+                total = reduce(move(*total), move(partial));
+            } else {
+                total = move(partial);
+            }
+        });
+        if (total) { init = reduce(move(init), move(*total)); }
+        return init;
+    }
+    template <Iterable C, typename T, typename Reduce, typename Transform>
+    T transform_reduce(const C& cont, T init, Reduce&& reduce, Transform&& transform, const Options& options = {}) {
+        return parallel::transform_reduce(
+        cont.begin(), cont.end(), move(init), Forward<Reduce>(reduce), Forward<Transform>(transform), options
+        );
+    }
+    // out[i] = in[0] op in[1] op ... op in[i], out may be the same range as in
+    template <RandomAccessIter Iter, RandomAccessIter OutIter, typename Op>
+    requires CallableWith<Op, IteratorOutputType<Iter>, IteratorOutputType<Iter>>
+    void inclusive_scan(Iter first, Iter last, OutIter out, Op&& op, const Options& options = {}) {
+        using T          = RemoveCvRefT<IteratorOutputType<Iter>>;
+        ThreadPool& pool = detail::pool_from(options);
+        const auto plan  = detail::plan_chunks(detail::distance(first, last), options, pool);
+        if (plan.chunk_count == 0) return;
+        // first pass reduces every chunk, then a serial pass over the (few) chunk totals computes each chunk's offset
+        Vector<Optional<T>> offsets{};
+        offsets.resize(plan.chunk_count);
+        pool.run_indexed(plan.chunk_count - 1, [&](size_t chunk) {
+            Iter it = detail::advance(first, plan.begin(chunk));
+            T partial{ *it };
+            ++it;
+            for (size_t i = plan.begin(chunk) + 1; i < plan.end(chunk); ++i, ++it) { partial = op(partial, *it); }
+            offsets[chunk + 1] = move(partial);
+        });
+        for (size_t chunk = 2; chunk < plan.chunk_count; ++chunk) {
+            offsets[chunk] = op(*offsets[chunk - 1], *offsets[chunk]);
+        }
+        pool.run_indexed(plan.chunk_count, [&](size_t chunk) {
+            Iter it     = detail::advance(first, plan.begin(chunk));
+            OutIter dst = detail::advance(out, plan.begin(chunk));
+            T running   = offsets[chunk] ? T{ op(*offsets[chunk], *it) } : T{ *it };
+            *dst        = running;
+            ++it;
+            ++dst;
+            for (size_t i = plan.begin(chunk) + 1; i < plan.end(chunk); ++i, ++it, ++dst) {
+                running = op(running, *it);
+                *dst    = running;
+            }
+        });
+    }
+    template <RandomAccessIter Iter, RandomAccessIter OutIter>
+    void inclusive_scan(Iter first, Iter last, OutIter out, const Options& options = {}) {
+        parallel::inclusive_scan(first, last, out, [](const auto& a, const auto& b) { return a + b; }, options);
+    }
+    template <Iterable C>
+    void inclusive_scan(C& cont, const Options& options = {}) {
+        parallel::inclusive_scan(cont.begin(), cont.end(), cont.begin(), options);
+    }
+    // sorts every chunk on its own, then merges the sorted runs in rounds of doubling width through a scratch buffer
+    // the merge itself is split across threads, so the last rounds (which only have a couple of big runs) still scale
+    template <RandomAccessIter Iter, typename Functor>
+    requires CallableWithRes<Functor, Ordering, IteratorOutputType<Iter>, IteratorOutputType<Iter>>
+    void sort(Iter first, Iter last, Functor&& cmp, const Options& options = {}) {
+        using T          = RemoveCvRefT<IteratorOutputType<Iter>>;
+        ThreadPool& pool = detail::pool_from(options);
+        const auto plan  = detail::plan_chunks(detail::distance(first, last), options, pool);
+        if (plan.total < 2) return;
+        pool.run_indexed(plan.chunk_count, [&](size_t chunk) {
+            ARLib::sort(detail::advance(first, plan.begin(chunk)), detail::advance(first, plan.end(chunk)), cmp);
+        });
+        if (plan.chunk_count == 1) return;
+        auto lt               = ARLib::detail::less_from<T>(cmp);
+        T* buffer             = allocate_uninitialized<T>(plan.total);
+        bool result_in_buffer = false;
+        bool buffer_is_live   = false;
+        for (size_t width = plan.chunk_size; width < plan.total; width *= 2) {
+            if (result_in_buffer) {
+                detail::merge_pass(pool, plan, width, buffer, first, false, lt);
+            } else {
+                detail::merge_pass(pool, plan, width, first, buffer, !buffer_is_live, lt);
+                buffer_is_live = true;
+            }
+            result_in_buffer = !result_in_buffer;
+        }
+        if (result_in_buffer) {
+            pool.run_indexed(plan.chunk_count, [&](size_t chunk) {
+                Iter it = detail::advance(first, plan.begin(chunk));
+                for (size_t i = plan.begin(chunk); i < plan.end(chunk); ++i, ++it) { *it = move(buffer[i]); }
+            });
+        }
+        if constexpr (!IsTriviallyDestructibleV<T>) {
+            pool.run_indexed(plan.chunk_count, [&](size_t chunk) {
+                for (size_t i = plan.begin(chunk); i < plan.end(chunk); ++i) { buffer[i].~T(); }
+            });
+        }
+        deallocate<T, DeallocType::Multiple>(buffer);
+    }
+    template <RandomAccessIter Iter>
+    void sort(Iter first, Iter last, const Options& options = {}) {
+        parallel::sort(first, last, ARLib::detail::DefaultSortCompare{}, options);
+    }
+    template <Iterable C, typename Functor>
+    requires(!SameAs<RemoveCvRefT<Functor>, Options>)
+    void sort(C& cont, Functor&& cmp, const Options& options = {}) {
+        parallel::sort(cont.begin(), cont.end(), Forward<Functor>(cmp), options);
+    }
+    template <Iterable C>
+    void sort(C& cont, const Options& options = {}) {
+        parallel::sort(cont.begin(), cont.end(), options);
+    }
+    // runs parse(scratch, chunk) for every chunk in [0, chunk_count) on the pool. scratch is resized to one entry per
+    // worker and a worker always gets its own, so it can hold buffers that are reused from one chunk to the next.
+    // parse returns DiscardResult<Error>, Error has to have an offset().
+    // in order, deliver(scratch) is called after every chunk, one chunk at a time and in the order of the input, and
+    // the error returned is the one of the first chunk that failed, delivered up to where it failed.
+    // out of order, parse has to hand out its results itself, deliver isn't called, and everything stops at whichever
+    // error is found first
+    template <typename Error, typename Scratch, typename Parse, typename Deliver>
+    DiscardResult<Error> run_chunks(
+    ThreadPool& pool, size_t chunk_count, bool ordered, Vector<Scratch>& scratch, Parse&& parse, Deliver&& deliver
+    ) {
+        const size_t worker_count = min_bt(chunk_count, pool.size() + 1);
+        scratch.resize(worker_count);
+        struct SharedState {
+            Atomic<size_t> next_chunk{ 0 };
+            Atomic<bool> failed{ false };
+            // next chunk that gets delivered, only used when ordered
+            size_t turn = 0;
+            Mutex mutex{};
+            ConditionVariable cv{};
+            Optional<Error> error{};
+        } state{};
+        auto fail = [&state](Error error) {
+            LockGuard guard{ state.mutex };
+            if (state.error.empty() || error.offset() < state.error->offset()) { state.error = move(error); }
+            state.failed.store(true);
+            state.cv.notify_all();
+        };
+        pool.run_indexed(worker_count, [&](size_t worker) {
+            Scratch& own = scratch[worker];
+            // chunks are claimed in increasing order, so the one whose turn it is has always been claimed
+            // already and waiting for it can't deadlock
+            for (size_t chunk = state.next_chunk.fetch_add(1, MemoryOrder::Relaxed);
+                 chunk < chunk_count && !state.failed.load();
+                 chunk = state.next_chunk.fetch_add(1, MemoryOrder::Relaxed)) {
+                auto res = parse(own, chunk);
+                if (!ordered) {
+                    if (res.is_error()) fail(*res.to_error());
+                    continue;
+                }
+                UniqueLock lock{ state.mutex };
+                while (state.turn != chunk && !state.failed.load()) { state.cv.wait(lock); }
+                if (state.failed.load()) {
+                    if (res.is_error()) res.ignore_error();
+                    return;
+                }
+                lock.unlock();
+                deliver(own);
+                if (res.is_error()) {
+                    fail(*res.to_error());
+                    return;
+                }
+                lock.lock();
+                ++state.turn;
+                state.cv.notify_all();
+            }
+        });
+        if (!state.error.empty()) return move(state.error).value();
+        return {};
+    }
+}    // namespace parallel
+}    // namespace ARLib
+#endif
@@ -0,0 +1,221 @@
+#pragma once
+#ifndef DISABLE_THREADING
+    #include "Atomic.hpp"
+    #include "Threading.hpp"
+    #include "Vector.hpp"
+/*
+    safe memory reclamation for lock-free data structures: a node that has been unlinked from a structure can't be
+    freed right away because other threads may still be reading it, so it's retired instead and the domain frees it
+    once no reader can be holding a reference anymore.
+
+    EpochDomain is epoch-based reclamation: readers pin the current epoch for the duration of an operation, which
+    is just a couple of stores, and objects get freed two epochs after they were retired. cheapest for readers,
+    but a reader that stays pinned forever stops all reclamation.
+
+    HazardDomain is hazard pointers: readers publish every pointer they're about to dereference, objects are freed
+    as soon as nobody publishes them. a bit more expensive per access, but memory usage stays bounded no matter what
+    the readers do.
+
+    neither ever makes a reader wait for a writer.
+*/
+namespace ARLib {
+namespace detail {
+    struct RetiredObject {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+        void reclaim() const { deleter(ptr); }
+    };
+    template <typename T>
+    void delete_retired(void* ptr) {
+        delete static_cast<T*>(ptr);
+    }
+}    // namespace detail
+class EpochParticipant;
+class EpochGuard;
+class EpochDomain {
+    struct Record {
+        // (epoch << 1) | pinned
+        Atomic<uint64_t> state{ 0 };
+        Atomic<bool> in_use{ true };
+        Record* next = nullptr;
+    };
+    Atomic<uint64_t> m_epoch{ 0 };
+    Atomic<Record*> m_records{ nullptr };
+    // objects retired by participants that unregistered before they could be freed
+    Mutex m_orphans_mutex;
+    Vector<detail::RetiredObject> m_orphans;
+
+    Record* acquire_record();
+    void try_advance();
+    size_t collect_orphans(uint64_t epoch);
+    void adopt(Vector<detail::RetiredObject>& retired);
+
+    friend class EpochParticipant;
+
+    public:
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&)            = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+    EpochDomain(EpochDomain&&)                 = delete;
+    EpochDomain& operator=(EpochDomain&&)      = delete;
+    // every participant has to be gone by now, whatever is still retired gets freed
+    ~EpochDomain();
+    // every thread that reads or retires needs its own participant
+    EpochParticipant register_thread();
+    uint64_t epoch() const { return m_epoch.load(MemoryOrder::Relaxed); }
+    static EpochDomain& global();
+};
+// a thread's registration in an EpochDomain, it must only ever be used by one thread at a time
+class EpochParticipant {
+    EpochDomain* m_domain         = nullptr;
+    EpochDomain::Record* m_record = nullptr;
+    size_t m_pin_depth            = 0;
+    Vector<detail::RetiredObject> m_retired;
+    constexpr static size_t collect_threshold = 64;
+
+    EpochParticipant(EpochDomain* domain, EpochDomain::Record* record) : m_domain(domain), m_record(record) {}
+    void release();
+    void enter();
+    void exit();
+
+    friend class EpochDomain;
+    friend class EpochGuard;
+
+    public:
+    EpochParticipant(const EpochParticipant&)            = delete;
+    EpochParticipant& operator=(const EpochParticipant&) = delete;
+    EpochParticipant(EpochParticipant&& other) noexcept;
+    EpochParticipant& operator=(EpochParticipant&& other) noexcept;
+    ~EpochParticipant() { release(); }
+    // pins the current epoch until the guard is destroyed, guards can be nested
+    EpochGuard pin();
+    bool is_pinned() const { return m_pin_depth != 0; }
+    // ptr must already be unreachable for new readers, it's deleted once every reader that could have seen it is gone
+    template <typename T>
+    void retire(T* ptr) {
+        retire(static_cast<void*>(ptr), &detail::delete_retired<T>);
+    }
+    void retire(void* ptr, void (*deleter)(void*));
+    // tries to advance the epoch and frees whatever became safe to free, returns how many objects were freed
+    size_t collect();
+    size_t pending() const { return m_retired.size(); }
+};
+class EpochGuard {
+    EpochParticipant* m_participant;
+
+    public:
+    explicit EpochGuard(EpochParticipant& participant) : m_participant(&participant) { m_participant->enter(); }
+    EpochGuard(const EpochGuard&)            = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+    EpochGuard(EpochGuard&& other) noexcept : m_participant(other.m_participant) { other.m_participant = nullptr; }
+    EpochGuard& operator=(EpochGuard&&) = delete;
+    ~EpochGuard() {
+        if (m_participant) m_participant->exit();
+    }
+    // the pointee stays alive at least until this guard is destroyed
+    template <typename T>
+    T* protect(const Atomic<T*>& source) const {
+        return source.load(MemoryOrder::Acquire);
+    }
+};
+inline EpochGuard EpochParticipant::pin() {
+    return EpochGuard{ *this };
+}
+class HazardPointer;
+class HazardDomain {
+    struct Record {
+        Atomic<uintptr_t> protected_ptr{ 0 };
+        Atomic<bool> in_use{ true };
+        Record* next = nullptr;
+    };
+    struct RetiredNode {
+        detail::RetiredObject object;
+        RetiredNode* next;
+    };
+    Atomic<Record*> m_records{ nullptr };
+    Atomic<size_t> m_record_count{ 0 };
+    Atomic<RetiredNode*> m_retired{ nullptr };
+    Atomic<size_t> m_retired_count{ 0 };
+    constexpr static size_t reclaim_threshold = 64;
+
+    Record* acquire_record();
+    void push_retired(RetiredNode* first, RetiredNode* last);
+
+    friend class HazardPointer;
+
+    public:
+    HazardDomain() = default;
+    HazardDomain(const HazardDomain&)            = delete;
+    HazardDomain& operator=(const HazardDomain&) = delete;
+    HazardDomain(HazardDomain&&)                 = delete;
+    HazardDomain& operator=(HazardDomain&&)      = delete;
+    // every hazard pointer has to be gone by now, whatever is still retired gets freed
+    ~HazardDomain();
+    HazardPointer make_hazard_pointer();
+    // ptr must already be unreachable for new readers, it's deleted once no hazard pointer protects it
+    template <typename T>
+    void retire(T* ptr) {
+        retire(static_cast<void*>(ptr), &detail::delete_retired<T>);
+    }
+    void retire(void* ptr, void (*deleter)(void*));
+    // frees every retired object that isn't protected right now, returns how many were freed
+    size_t reclaim();
+    size_t pending() const { return m_retired_count.load(MemoryOrder::Relaxed); }
+    static HazardDomain& global();
+};
+// a single hazard slot, it must only ever be used by one thread at a time
+class HazardPointer {
+    HazardDomain::Record* m_record = nullptr;
+
+    explicit HazardPointer(HazardDomain::Record* record) : m_record(record) {}
+
+    friend class HazardDomain;
+
+    public:
+    HazardPointer() = default;
+    HazardPointer(const HazardPointer&)            = delete;
+    HazardPointer& operator=(const HazardPointer&) = delete;
+    HazardPointer(HazardPointer&& other) noexcept : m_record(other.m_record) { other.m_record = nullptr; }
+    HazardPointer& operator=(HazardPointer&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_record       = other.m_record;
+            other.m_record = nullptr;
+        }
+        return *this;
+    }
+    ~HazardPointer() { release(); }
+    bool empty() const { return m_record == nullptr; }
+    // loads source and protects the result, the pointee stays alive until the protection is reset or moved on
+    template <typename T>
+    T* protect(const Atomic<T*>& source) {
+        T* ptr = source.load(MemoryOrder::Relaxed);
+        while (!try_protect(ptr, source)) {}
+        return ptr;
+    }
+    // protects ptr if source still holds it, otherwise ptr is updated to the new value of source and false returned
+    template <typename T>
+    bool try_protect(T*& ptr, const Atomic<T*>& source) {
+        T* expected = ptr;
+        reset_protection(ptr);
+        ptr = source.load(MemoryOrder::Acquire);
+        if (ptr == expected) return true;
+        reset_protection();
+        return false;
+    }
+    // publishes ptr as protected, the caller has to validate that it's still reachable afterwards
+    template <typename T>
+    void reset_protection(const T* ptr) {
+        m_record->protected_ptr.store(reinterpret_cast<uintptr_t>(ptr), MemoryOrder::SeqCst);
+    }
+    void reset_protection() { m_record->protected_ptr.store(0, MemoryOrder::Release); }
+    void release() {
+        if (!m_record) return;
+        m_record->protected_ptr.store(0, MemoryOrder::Release);
+        m_record->in_use.store(false, MemoryOrder::Release);
+        m_record = nullptr;
+    }
+};
+}    // namespace ARLib
+#endif
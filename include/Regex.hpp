@@ -1,22 +1,25 @@
 #pragma once
+#include "AhoCorasick.hpp"
 #include "PrintInfo.hpp"
 #include "Types.hpp"
 #include "Concepts.hpp"
 #include "String.hpp"
 #include "EnumHelpers.hpp"
+#include "RegexEngine.hpp"
 #include "Result.hpp"
 #include "Variant.hpp"
 #include "Vector.hpp"
 #include "SSOVector.hpp"
 #include "UniquePtr.hpp"
-#include "Unimplemented.hpp"
 namespace ARLib {
 
 MAKE_FANCY_ENUM(
 RegexToken, size_t, Dot, GroupOpen, GroupClose, SquareOpen, SquareClose, Or, StartString, EndString, Lazy, Asterisk,
 Plus, OpenCurly, CloseCurly
 );
-MAKE_FANCY_ENUM(EscapedRegexToken, size_t, WhiteSpace, WordChar, NotWordChar, NumberChar);
+MAKE_FANCY_ENUM(
+EscapedRegexToken, size_t, WhiteSpace, WordChar, NotWordChar, NumberChar, NotWhiteSpace, NotNumberChar
+);
 struct RegexErrorInfo {
     String error_string{};
     size_t error_offset{};
@@ -33,6 +36,37 @@ class RegexParseError : public ErrorBase {
     StringView error_string() const { return m_info.error_string; }
     size_t offset() const { return m_info.error_offset; }
 };
+class RegexMatch {
+    StringView m_text;
+    size_t m_begin;
+    size_t m_end;
+    // begin and end of every group, npos_ for the ones that didn't take part in the match.
+    // only filled in by Regex::captures
+    Vector<size_t> m_groups;
+
+    public:
+    RegexMatch(StringView text, size_t begin, size_t end, Vector<size_t> groups = {}) :
+        m_text(text), m_begin(begin), m_end(end), m_groups(move(groups)) {}
+    size_t begin() const { return m_begin; }
+    size_t end() const { return m_end; }
+    size_t size() const { return m_end - m_begin; }
+    StringView str() const { return m_text.substringview(m_begin, m_end); }
+    size_t group_count() const { return m_groups.size() / 2; }
+    // groups are numbered from 1 like in the pattern, 0 is the whole match
+    bool has_group(size_t group) const {
+        return group == 0 || (group <= group_count() && m_groups[group * 2 - 2] != npos_);
+    }
+    StringView group(size_t group) const {
+        if (group == 0) return str();
+        if (!has_group(group)) return {};
+        return m_text.substringview(m_groups[group * 2 - 2], m_groups[group * 2 - 1]);
+    }
+};
+class RegexMatches;
+/*
+    the matching functions are const but they fill in the lazy DFAs' state caches and reuse the PikeVM's scratch
+    space, a Regex can't be shared between threads. every thread needs its own, created from the same pattern.
+*/
 class Regex {
     public:
     struct Group;
@@ -53,12 +87,32 @@ class Regex {
         size_t m_min;
         size_t m_max;
     };
+    // memory every lazy DFA of a Regex can use for its cache
+    constexpr static size_t dfa_memory_limit = 2 * 1024 * 1024;
     private:
     friend struct PrintInfo<Regex>;
+    friend class RegexCompiler;
+    friend class RegexSet;
     ReTokVector m_regex;
+    detail::RegexProgram m_program{};
+    // the same program with everything in reverse order, finds where a match starts from where it ends
+    detail::RegexProgram m_reverse{};
+    // a literal every match contains, lets the forward DFA skip what can't be part of a match
+    detail::RegexPrefilter m_prefilter{};
+    // leftmost-first, finds where a match ends
+    mutable detail::RegexLazyDFA m_forward_dfa{ true, dfa_memory_limit };
+    // longest match, for match() which needs to know if a match can end at the end of the input
+    mutable detail::RegexLazyDFA m_longest_dfa{ false, dfa_memory_limit };
+    mutable detail::RegexLazyDFA m_reverse_dfa{ false, dfa_memory_limit };
+    mutable detail::RegexPikeVM m_pikevm{};
+    mutable Vector<size_t> m_slots{};
 
     static Result<Regex, RegexParseError> parse_regex(String&&);
     Regex(ReTokVector&& vec) : m_regex{ Forward<ReTokVector>(vec) } {}
+    DiscardResult<RegexParseError> compile();
+    Optional<RegexMatch> search_with_pikevm(
+    StringView text, size_t from, bool anchored, bool with_groups, size_t stop = npos_
+    ) const;
     public:
     template <typename StringLike>
     requires Constructible<String, StringLike>
@@ -68,12 +122,83 @@ class Regex {
     static auto create(StringLike&& regex) {
         return parse_regex(String{ regex });
     }
-    template <typename... Args>
-    Unimplemented match(Args&&... args) {
-        UnusedArgument arg{ args... };
-        arg.remove_warning();
-        return { "regex_match" };
+    // true if the whole text matches
+    bool match(StringView text) const;
+    // true if there's a match anywhere in the text, stops at the first byte where one is known to exist
+    bool contains(StringView text) const;
+    // the leftmost match that starts at or after from. the first alternative that matches wins, greedy repeats match
+    // as much as they can, lazy ones as little, which is what a backtracking engine picks as long as no repeated part
+    // of the pattern can match nothing. when one can, the rules are RE2's and not std::regex's: all the ways of
+    // matching run side by side and only the first one to reach a given point of the pattern at a given position
+    // goes on, so an unbounded repeat never loops back without consuming anything. the match and the groups can
+    // differ from a backtracking engine then, (a*|[^a])* matches all of "bab" where std::regex matches "", and
+    // b{1,2}(a*?.*?)*?$ on "\nabbaac" puts "ac" in group 1 where std::regex and cx_regex put "c"
+    Optional<RegexMatch> search(StringView text, size_t from = 0) const;
+    // like search but with the capture groups filled in
+    Optional<RegexMatch> captures(StringView text, size_t from = 0) const;
+    // every match that doesn't overlap with the one before, the regex has to outlive the range
+    RegexMatches find_all(StringView text) const;
+};
+/*
+    many patterns matched in a single pass over the text.
+
+    every pattern is parsed like a Regex, then they're all compiled into one program where each pattern ends in its
+    own Match. a lazy DFA that keeps every thread around runs it over the whole text once and collects the patterns
+    of every matching state it goes through. when every pattern is nothing but plain characters the set is an
+    Aho-Corasick automaton instead. like Regex, a set can't be shared between threads.
+*/
+class RegexSet {
+    Vector<Regex> m_regexes;
+    detail::RegexProgram m_program{};
+    mutable detail::RegexLazyDFA m_dfa{ false, dfa_memory_limit };
+    // only when every pattern is a plain literal
+    Optional<AhoCorasick> m_literals;
+    // patterns the current scan has already found, all 0 between calls
+    mutable Vector<uint8_t> m_seen;
+
+    RegexSet() = default;
+
+    public:
+    // a set has more states than a single Regex, the cache gets more room
+    constexpr static size_t dfa_memory_limit = 4 * Regex::dfa_memory_limit;
+    static Result<RegexSet, RegexParseError> create(Span<const StringView> patterns);
+    size_t size() const { return m_regexes.size(); }
+    const Regex& regex(size_t index) const { return m_regexes[index]; }
+    // true if any pattern matches somewhere in the text
+    bool contains(StringView text) const;
+    // indices of the patterns that match somewhere in the text, in increasing order. matched can be reused between
+    // calls so matching line after line doesn't allocate
+    void matches(StringView text, Vector<size_t>& matched) const;
+    Vector<size_t> matches(StringView text) const;
+};
+class RegexMatchIterator {
+    const Regex* m_regex = nullptr;
+    StringView m_text;
+    size_t m_next = 0;
+    Optional<RegexMatch> m_current;
+
+    void advance();
+
+    public:
+    RegexMatchIterator() = default;
+    RegexMatchIterator(const Regex& regex, StringView text) : m_regex(&regex), m_text(text) { advance(); }
+    const RegexMatch& operator*() const { return *m_current.operator->(); }
+    const RegexMatch* operator->() const { return m_current.operator->(); }
+    RegexMatchIterator& operator++() {
+        advance();
+        return *this;
     }
+    // only meant to be compared to the end iterator
+    bool operator==(const RegexMatchIterator& other) const { return m_current.empty() && other.m_current.empty(); }
+};
+class RegexMatches {
+    const Regex& m_regex;
+    StringView m_text;
+
+    public:
+    RegexMatches(const Regex& regex, StringView text) : m_regex(regex), m_text(text) {}
+    RegexMatchIterator begin() const { return RegexMatchIterator{ m_regex, m_text }; }
+    RegexMatchIterator end() const { return RegexMatchIterator{}; }
 };
 inline Regex operator""_re(const char* regex, size_t len) {
     return MUST(Regex::create(StringView{ regex, len }));
@@ -0,0 +1,210 @@
+#pragma once
+#include "Optional.hpp"
+#include "String.hpp"
+#include "StringView.hpp"
+#include "Vector.hpp"
+/*
+    regex matching engine.
+
+    a Regex is compiled to a Thompson NFA, a flat program of instructions where Split is the only thing that
+    branches (x is the preferred branch, y the other one). nothing ever backtracks, so matching is linear in the
+    size of the input whatever the pattern looks like.
+
+    the NFA is run by a lazy DFA: every DFA state is the ordered list of NFA threads alive at a position, states are
+    built the first time a transition is taken and kept in a cache, so after warming up matching is one table lookup
+    per byte. bytes that no instruction tells apart share a column of the transition table. the cache has a fixed
+    memory budget, when it's full it's thrown away and built again from the current state, if that keeps happening
+    the DFA gives up and the search runs on the PikeVM instead.
+
+    the PikeVM simulates the NFA thread by thread carrying the capture slots around, it's the slow path and is only
+    used to get capture groups (on the exact span the DFAs found) or when the DFA gave up.
+
+    most patterns have a literal that every match contains, found by looking at the token tree before compiling.
+    the forward DFA marks its start state, when a scan gets back to it (no match in progress) the prefilter looks
+    for the next occurrence of the literal 32 bytes at a time and the scan skips to the first position a match could
+    start from, which is the occurrence itself for a literal prefix or at most max_offset bytes before it otherwise.
+    with no occurrence left the scan is over.
+
+    the DFA and PikeVM keep their scratch state between calls, none of this is safe to share between threads.
+*/
+namespace ARLib {
+namespace detail {
+    enum class RegexOp : uint8_t {
+        // consumes a byte that's in m_sets[x]
+        ByteSet,
+        Split,
+        Jump,
+        // stores the position in capture slot x
+        Save,
+        // x is the pattern that matched in a RegexSet program, 0 otherwise
+        Match,
+        // position is where the scan started from the start of the input (end of the input when reversed)
+        AssertBegin,
+        // position is the end of the input (the start when reversed)
+        AssertEnd
+    };
+    struct RegexInst {
+        RegexOp op;
+        uint32_t x;
+        uint32_t y;
+    };
+    struct RegexByteSet {
+        uint64_t bits[4]{};
+        void add(uint8_t c) { bits[c >> 6] |= 1ull << (c & 63); }
+        void add_range(uint8_t lo, uint8_t hi) {
+            for (size_t c = lo; c <= hi; ++c) add(static_cast<uint8_t>(c));
+        }
+        void add_set(const RegexByteSet& other) {
+            for (size_t i = 0; i < 4; ++i) bits[i] |= other.bits[i];
+        }
+        void negate() {
+            for (auto& word : bits) word = ~word;
+        }
+        bool contains(uint8_t c) const { return (bits[c >> 6] >> (c & 63)) & 1; }
+    };
+    struct RegexProgram {
+        Vector<RegexInst> insts;
+        Vector<RegexByteSet> sets;
+        // equivalence class of every byte, bytes in the same class are in exactly the same sets
+        uint8_t byte_class[256]{};
+        // a byte of every class, to look the class up in a set
+        uint8_t class_byte[256]{};
+        size_t class_count = 0;
+        // capture slots, 2 for the whole match plus 2 for every group
+        size_t slot_count = 2;
+        // start of the program when matching has to start at the current position
+        uint32_t anchored_start = 0;
+        // start of the lazy .*? loop that tries the program at every position
+        uint32_t unanchored_start = 0;
+        void compute_byte_classes();
+    };
+    class RegexPrefilter {
+        String m_literal;
+        // the most bytes a match can have before the literal, npos_ if there's no limit. 0 for a literal prefix
+        size_t m_max_offset = npos_;
+
+        public:
+        RegexPrefilter() = default;
+        RegexPrefilter(String literal, size_t max_offset) : m_literal(move(literal)), m_max_offset(max_offset) {}
+        bool empty() const { return m_literal.size() == 0; }
+        const String& literal() const { return m_literal; }
+        size_t max_offset() const { return m_max_offset; }
+        // first occurrence of the literal at or after from, npos_ if there's none
+        size_t find(StringView text, size_t from) const;
+        // first position at or after from where a match could start, npos_ if no match can start after from.
+        // found caches the last occurrence between calls, it has to start out as 0
+        size_t next_candidate(StringView text, size_t from, size_t& found) const;
+    };
+    // patterns of a set found by a scan, seen has an entry for every pattern and matched lists the ones that are set
+    struct RegexSetOutput {
+        Vector<uint8_t>& seen;
+        Vector<size_t>& matched;
+    };
+    // outcome of a DFA scan, gave_up means the scan was abandoned and the PikeVM has to be used instead
+    struct RegexScan {
+        bool gave_up = false;
+        Optional<size_t> match;
+    };
+    class RegexLazyDFA {
+        constexpr static uint32_t match_flag   = 1u << 31;
+        constexpr static uint32_t dead_flag    = 1u << 30;
+        // the unanchored start state, only marked when a prefilter is used
+        constexpr static uint32_t start_flag   = 1u << 29;
+        constexpr static uint32_t special_mask = match_flag | dead_flag | start_flag;
+        constexpr static uint32_t unknown      = 0xFFFFFFFF;
+
+        // false means every thread is kept after a match is found (longest match), true means the threads with
+        // less priority than the match are dropped (leftmost-first, the same match the PikeVM picks)
+        bool m_leftmost_first;
+        size_t m_memory_limit;
+        bool m_skipping       = false;
+        size_t m_stride       = 0;
+        // index of the state marked with start_flag
+        uint32_t m_skip_state = unknown;
+        // ordered NFA threads of every state, state i is m_threads[m_state_begin[i], m_state_begin[i + 1])
+        Vector<uint32_t> m_threads;
+        Vector<uint32_t> m_state_begin;
+        Vector<uint8_t> m_state_match;
+        // m_stride entries per state (one per byte class plus end of input), each one is the row of the next state
+        // with the flags of that state or unknown
+        Vector<uint32_t> m_transitions;
+        // open addressing table of state index + 1
+        Vector<uint32_t> m_table;
+        // start states, indexed by [anchored][at the boundary of the input], unknown if not built yet
+        uint32_t m_start[2][2]{};
+        // scratch space for building states
+        Vector<uint32_t> m_scratch;
+        Vector<uint32_t> m_stack;
+        Vector<uint32_t> m_visited;
+        uint32_t m_generation = 0;
+        size_t m_resets       = 0;
+        // set scans: the last scan every state was reported in and how many patterns haven't matched yet
+        Vector<uint32_t> m_reported;
+        uint32_t m_set_scan = 0;
+        size_t m_set_left   = 0;
+
+        void reset(const RegexProgram& program);
+        size_t memory_used() const;
+        uint32_t find_or_add_state(const RegexProgram& program, bool& full);
+        bool add_closure(const RegexProgram& program, uint32_t pc, bool at_begin, bool at_end);
+        uint32_t start_state(const RegexProgram& program, bool anchored, bool at_boundary, bool& full);
+        // at_begin is only set for the end of an empty input, where ^ holds as well
+        uint32_t next_state(const RegexProgram& program, uint32_t row, size_t byte_class, bool at_begin, bool& full);
+        bool report(const RegexProgram& program, uint32_t state, RegexSetOutput& output);
+        template <bool Reverse>
+        RegexScan scan(const RegexProgram& program, StringView text, size_t from, size_t to, bool anchored,
+                       bool earliest, const RegexPrefilter* prefilter, RegexSetOutput* output);
+
+        public:
+        RegexLazyDFA(bool leftmost_first, size_t memory_limit) :
+            m_leftmost_first(leftmost_first), m_memory_limit(memory_limit) {}
+        // has to be called before the first scan if the unanchored scans will be given a prefilter
+        void enable_skipping() { m_skipping = true; }
+        // scans text[from, text.size()) and gives back where the match ends (the first place a match ends if
+        // earliest is set). the prefilter is only used by unanchored scans
+        RegexScan scan_forward(const RegexProgram& program, StringView text, size_t from, bool anchored,
+                               bool earliest, const RegexPrefilter* prefilter = nullptr);
+        // scans text[from, to) backwards with a reversed program and gives back where the match starts
+        RegexScan scan_reverse(const RegexProgram& program, StringView text, size_t from, size_t to);
+        // scans all of text for a program with a Match for every pattern of a set (x is the index of the pattern)
+        // and adds every pattern that matches somewhere to the output. stops once they all have, false if it gave
+        // up. only makes sense on a longest match DFA, leftmost-first would drop the lower priority patterns
+        bool scan_set(const RegexProgram& program, StringView text, RegexSetOutput& output);
+        // how many times the cache was thrown away, for tests and tuning
+        size_t resets() const { return m_resets; }
+    };
+    class RegexPikeVM {
+        struct ThreadList {
+            // sparse set of pcs, dense keeps the priority order
+            Vector<uint32_t> sparse;
+            Vector<uint32_t> dense;
+            // slot_count slots for every dense entry
+            Vector<size_t> slots;
+            size_t size = 0;
+            bool contains(uint32_t pc) const { return sparse[pc] < size && dense[sparse[pc]] == pc; }
+        };
+        struct Frame {
+            uint32_t pc;
+            // restores slot to value when pc is npos
+            uint32_t slot;
+            size_t value;
+        };
+        ThreadList m_current;
+        ThreadList m_next;
+        Vector<Frame> m_stack;
+        Vector<size_t> m_slots;
+
+        void prepare(const RegexProgram& program);
+        void add_thread(const RegexProgram& program, ThreadList& list, uint32_t pc, size_t pos, StringView text);
+
+        public:
+        RegexPikeVM() = default;
+        // leftmost-first match in text starting at or after from (exactly at from if anchored), slots gets the
+        // capture slots of the match, npos_ for groups that didn't take part in it. with to_end only a match that
+        // ends at the end of the text counts. nothing is looked at past stop, when the DFAs already know where the
+        // match ends the threads that would keep going after it don't have to
+        bool search(const RegexProgram& program, StringView text, size_t from, bool anchored, bool to_end,
+                    Vector<size_t>& slots, size_t stop = npos_);
+    };
+}    // namespace detail
+}    // namespace ARLib
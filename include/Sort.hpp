@@ -0,0 +1,591 @@
+#pragma once
+#include "Allocator.hpp"
+#include "Concepts.hpp"
+#include "IteratorInspection.hpp"
+#include "Memory.hpp"
+#include "Ordering.hpp"
+#include "Utility.hpp"
+/*
+    sort() is a pattern-defeating quicksort (Orson Peters, https://github.com/orlp/pdqsort):
+    median-of-3/ninther pivots, insertion sort for small ranges, a heapsort fallback after too many unbalanced
+    partitions (so the worst case stays O(n log n)) and branchless block partitioning for arithmetic types
+    sorted with the default comparator.
+    stable_sort() is a bottom-up merge sort with a buffer of at most n / 2 elements.
+    radix_sort() is an LSD radix sort for integer, floating point and fixed-width string keys.
+
+    all of these work on contiguous ranges, which covers every container in ARLib that has random access iterators.
+*/
+namespace ARLib {
+namespace detail {
+    constexpr size_t insertion_sort_threshold = 24;
+    constexpr size_t ninther_threshold        = 128;
+    constexpr size_t partial_insertion_limit  = 8;
+    constexpr size_t partition_block_size     = 64;
+    constexpr size_t stable_sort_run          = 32;
+    // comparator used when none is given, recognizing it lets the algorithms use a plain operator< instead of
+    // going through Ordering (whose conversion from std::strong_ordering isn't inlined) for every comparison
+    struct DefaultSortCompare {
+        template <typename T>
+        auto operator()(const T& a, const T& b) const {
+            return a <=> b;
+        }
+    };
+    template <typename Functor>
+    constexpr inline bool is_default_compare = SameAs<RemoveCvRefT<Functor>, DefaultSortCompare>;
+    template <typename T, typename Functor>
+    auto less_from(Functor& cmp) {
+        if constexpr (is_default_compare<Functor> && LessComparable<T>) {
+            return [](const T& a, const T& b) { return a < b; };
+        } else {
+            return [&cmp](const T& a, const T& b) { return cmp(a, b) == less; };
+        }
+    }
+    template <typename T, typename Less>
+    void insertion_sort(T* first, T* last, Less& lt) {
+        if (first == last) return;
+        for (T* cur = first + 1; cur != last; ++cur) {
+            T* sift   = cur;
+            T* sift_1 = cur - 1;
+            if (lt(*sift, *sift_1)) {
+                T tmp = move(*sift);
+                do { *sift-- = move(*sift_1); } while (sift != first && lt(tmp, *--sift_1));
+                *sift = move(tmp);
+            }
+        }
+    }
+    // same as insertion_sort, but *(first - 1) must be no greater than any element in the range
+    template <typename T, typename Less>
+    void unguarded_insertion_sort(T* first, T* last, Less& lt) {
+        if (first == last) return;
+        for (T* cur = first + 1; cur != last; ++cur) {
+            T* sift   = cur;
+            T* sift_1 = cur - 1;
+            if (lt(*sift, *sift_1)) {
+                T tmp = move(*sift);
+                do { *sift-- = move(*sift_1); } while (lt(tmp, *--sift_1));
+                *sift = move(tmp);
+            }
+        }
+    }
+    // gives up (returning false) as soon as more than partial_insertion_limit elements had to be moved
+    template <typename T, typename Less>
+    bool partial_insertion_sort(T* first, T* last, Less& lt) {
+        if (first == last) return true;
+        size_t moved = 0;
+        for (T* cur = first + 1; cur != last; ++cur) {
+            T* sift   = cur;
+            T* sift_1 = cur - 1;
+            if (lt(*sift, *sift_1)) {
+                T tmp = move(*sift);
+                do { *sift-- = move(*sift_1); } while (sift != first && lt(tmp, *--sift_1));
+                *sift = move(tmp);
+                moved += static_cast<size_t>(cur - sift);
+            }
+            if (moved > partial_insertion_limit) return false;
+        }
+        return true;
+    }
+    template <typename T, typename Less>
+    void sift_down(T* heap, size_t root, size_t size, Less& lt) {
+        T value = move(heap[root]);
+        for (size_t child = 2 * root + 1; child < size; child = 2 * root + 1) {
+            if (child + 1 < size && lt(heap[child], heap[child + 1])) ++child;
+            if (!lt(value, heap[child])) break;
+            heap[root] = move(heap[child]);
+            root       = child;
+        }
+        heap[root] = move(value);
+    }
+    template <typename T, typename Less>
+    void heap_sort(T* first, T* last, Less& lt) {
+        const size_t size = static_cast<size_t>(last - first);
+        for (size_t i = size / 2; i-- > 0;) { sift_down(first, i, size, lt); }
+        for (size_t end = size - 1; end > 0; --end) {
+            swap(first[0], first[end]);
+            sift_down(first, 0, end, lt);
+        }
+    }
+    template <typename T, typename Less>
+    void sort2(T* a, T* b, Less& lt) {
+        if (lt(*b, *a)) swap(*a, *b);
+    }
+    template <typename T, typename Less>
+    void sort3(T* a, T* b, T* c, Less& lt) {
+        sort2(a, b, lt);
+        sort2(b, c, lt);
+        sort2(a, b, lt);
+    }
+    template <typename T>
+    struct PartitionResult {
+        T* pivot;
+        bool already_partitioned;
+    };
+    // partitions [first, last) around *first, elements equal to the pivot end up on the right
+    template <typename T, typename Less>
+    PartitionResult<T> partition_right(T* first, T* last, Less& lt) {
+        T pivot = move(*first);
+        T* l    = first;
+        T* r    = last;
+        while (lt(*++l, pivot));
+        if (l - 1 == first) {
+            while (l < r && !lt(*--r, pivot));
+        } else {
+            while (!lt(*--r, pivot));
+        }
+        const bool already_partitioned = l >= r;
+        while (l < r) {
+            swap(*l, *r);
+            while (lt(*++l, pivot));
+            while (!lt(*--r, pivot));
+        }
+        T* pivot_pos = l - 1;
+        *first       = move(*pivot_pos);
+        *pivot_pos   = move(pivot);
+        return { pivot_pos, already_partitioned };
+    }
+    template <typename T>
+    void swap_offsets(
+    T* first, T* last, const unsigned char* offsets_l, const unsigned char* offsets_r, size_t count, bool use_swaps
+    ) {
+        if (use_swaps) {
+            // a cyclic permutation would leave some elements in the wrong place when both sides have the same count
+            for (size_t i = 0; i < count; ++i) { swap(first[offsets_l[i]], *(last - offsets_r[i])); }
+        } else if (count > 0) {
+            T* l  = first + offsets_l[0];
+            T* r  = last - offsets_r[0];
+            T tmp = move(*l);
+            *l    = move(*r);
+            for (size_t i = 1; i < count; ++i) {
+                l  = first + offsets_l[i];
+                *r = move(*l);
+                r  = last - offsets_r[i];
+                *l = move(*r);
+            }
+            *r = move(tmp);
+        }
+    }
+    // same contract as partition_right, but comparisons only produce offsets into small buffers
+    // and the actual swapping happens afterwards, this removes the unpredictable branches from the hot loop
+    template <typename T, typename Less>
+    PartitionResult<T> partition_right_branchless(T* first, T* last, Less& lt) {
+        T pivot = move(*first);
+        T* l    = first;
+        T* r    = last;
+        while (lt(*++l, pivot));
+        if (l - 1 == first) {
+            while (l < r && !lt(*--r, pivot));
+        } else {
+            while (!lt(*--r, pivot));
+        }
+        const bool already_partitioned = l >= r;
+        if (!already_partitioned) {
+            swap(*l, *r);
+            ++l;
+            alignas(64) unsigned char offsets_l[partition_block_size];
+            alignas(64) unsigned char offsets_r[partition_block_size];
+            T* offsets_l_base = l;
+            T* offsets_r_base = r;
+            size_t num_l      = 0;
+            size_t num_r      = 0;
+            size_t start_l    = 0;
+            size_t start_r    = 0;
+            while (l < r) {
+                const size_t unknown = static_cast<size_t>(r - l);
+                const size_t split_l = num_l == 0 ? (num_r == 0 ? unknown / 2 : unknown) : 0;
+                const size_t split_r = num_r == 0 ? unknown - split_l : 0;
+                const size_t block_l = split_l < partition_block_size ? split_l : partition_block_size;
+                const size_t block_r = split_r < partition_block_size ? split_r : partition_block_size;
+                for (size_t i = 0; i < block_l; ++i, ++l) {
+                    offsets_l[num_l] = static_cast<unsigned char>(i);
+                    num_l += !lt(*l, pivot);
+                }
+                for (size_t i = 0; i < block_r; ++i) {
+                    offsets_r[num_r] = static_cast<unsigned char>(i + 1);
+                    num_r += lt(*--r, pivot);
+                }
+                const size_t count = num_l < num_r ? num_l : num_r;
+                swap_offsets(
+                offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, count, num_l == num_r
+                );
+                num_l -= count;
+                num_r -= count;
+                start_l += count;
+                start_r += count;
+                if (num_l == 0) {
+                    start_l        = 0;
+                    offsets_l_base = l;
+                }
+                if (num_r == 0) {
+                    start_r        = 0;
+                    offsets_r_base = r;
+                }
+            }
+            // at most one side has leftover misplaced elements, move them next to the boundary
+            if (num_l) {
+                while (num_l--) { swap(offsets_l_base[offsets_l[start_l + num_l]], *--r); }
+                l = r;
+            }
+            if (num_r) {
+                while (num_r--) {
+                    swap(*(offsets_r_base - offsets_r[start_r + num_r]), *l);
+                    ++l;
+                }
+                r = l;
+            }
+        }
+        T* pivot_pos = l - 1;
+        *first       = move(*pivot_pos);
+        *pivot_pos   = move(pivot);
+        return { pivot_pos, already_partitioned };
+    }
+    // partitions [first, last) around *first, elements equal to the pivot end up on the left
+    // used when the pivot equals the element preceding the range, so everything equal to it is already in place
+    template <typename T, typename Less>
+    T* partition_left(T* first, T* last, Less& lt) {
+        T pivot = move(*first);
+        T* l    = first;
+        T* r    = last;
+        while (lt(pivot, *--r));
+        if (r + 1 == last) {
+            while (l < r && !lt(pivot, *++l));
+        } else {
+            while (!lt(pivot, *++l));
+        }
+        while (l < r) {
+            swap(*l, *r);
+            while (lt(pivot, *--r));
+            while (!lt(pivot, *++l));
+        }
+        *first = move(*r);
+        *r     = move(pivot);
+        return r;
+    }
+    template <bool Branchless, typename T, typename Less>
+    void pdqsort_loop(T* first, T* last, Less& lt, int bad_allowed, bool leftmost) {
+        while (true) {
+            const size_t size = static_cast<size_t>(last - first);
+            if (size < insertion_sort_threshold) {
+                if (leftmost) {
+                    insertion_sort(first, last, lt);
+                } else {
+                    unguarded_insertion_sort(first, last, lt);
+                }
+                return;
+            }
+            const size_t half = size / 2;
+            if (size > ninther_threshold) {
+                sort3(first, first + half, last - 1, lt);
+                sort3(first + 1, first + (half - 1), last - 2, lt);
+                sort3(first + 2, first + (half + 1), last - 3, lt);
+                sort3(first + (half - 1), first + half, first + (half + 1), lt);
+                swap(*first, first[half]);
+            } else {
+                sort3(first + half, first, last - 1, lt);
+            }
+            // the pivot is equal to the element before the range (that isn't part of it),
+            // so there's no element smaller than the pivot here: put all the equal ones on the left and skip them
+            if (!leftmost && !lt(*(first - 1), *first)) {
+                first = partition_left(first, last, lt) + 1;
+                continue;
+            }
+            const auto [pivot_pos, already_partitioned] =
+            Branchless ? partition_right_branchless(first, last, lt) : partition_right(first, last, lt);
+            const size_t l_size = static_cast<size_t>(pivot_pos - first);
+            const size_t r_size = static_cast<size_t>(last - (pivot_pos + 1));
+            if (l_size < size / 8 || r_size < size / 8) {
+                if (--bad_allowed == 0) {
+                    heap_sort(first, last, lt);
+                    return;
+                }
+                // shuffle some elements around to break up whatever pattern produced the bad pivot
+                if (l_size >= insertion_sort_threshold) {
+                    swap(*first, first[l_size / 4]);
+                    swap(*(pivot_pos - 1), *(pivot_pos - l_size / 4));
+                    if (l_size > ninther_threshold) {
+                        swap(first[1], first[l_size / 4 + 1]);
+                        swap(first[2], first[l_size / 4 + 2]);
+                        swap(*(pivot_pos - 2), *(pivot_pos - (l_size / 4 + 1)));
+                        swap(*(pivot_pos - 3), *(pivot_pos - (l_size / 4 + 2)));
+                    }
+                }
+                if (r_size >= insertion_sort_threshold) {
+                    swap(pivot_pos[1], pivot_pos[1 + r_size / 4]);
+                    swap(*(last - 1), *(last - r_size / 4));
+                    if (r_size > ninther_threshold) {
+                        swap(pivot_pos[2], pivot_pos[2 + r_size / 4]);
+                        swap(pivot_pos[3], pivot_pos[3 + r_size / 4]);
+                        swap(*(last - 2), *(last - (1 + r_size / 4)));
+                        swap(*(last - 3), *(last - (2 + r_size / 4)));
+                    }
+                }
+            } else if (
+            already_partitioned && partial_insertion_sort(first, pivot_pos, lt) &&
+            partial_insertion_sort(pivot_pos + 1, last, lt)
+            ) {
+                // the partition didn't swap anything and both halves were (nearly) sorted, we're done
+                return;
+            }
+            pdqsort_loop<Branchless>(first, pivot_pos, lt, bad_allowed, leftmost);
+            first    = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+    template <typename T, typename Functor>
+    void pdqsort(T* first, T* last, Functor& cmp) {
+        if (last - first < 2) return;
+        auto lt         = less_from<T>(cmp);
+        int bad_allowed = 0;
+        for (size_t size = static_cast<size_t>(last - first); size > 1; size >>= 1) { ++bad_allowed; }
+        // like upstream pdqsort the block partition is only used when comparisons are known to be cheap
+        constexpr bool branchless = is_default_compare<Functor> && (IsArithmeticV<T> || IsPointerV<T>);
+        pdqsort_loop<branchless>(first, last, lt, bad_allowed, true);
+    }
+    // uninitialized scratch memory, elements are constructed lazily the first time something is moved into them
+    template <typename T>
+    class SortBuffer {
+        T* m_data     = nullptr;
+        size_t m_live = 0;
+
+        public:
+        explicit SortBuffer(size_t capacity) : m_data(allocate_uninitialized<T>(capacity)) {}
+        SortBuffer(const SortBuffer&)            = delete;
+        SortBuffer& operator=(const SortBuffer&) = delete;
+        ~SortBuffer() {
+            if constexpr (!IsTriviallyDestructibleV<T>) {
+                for (size_t i = 0; i < m_live; ++i) { m_data[i].~T(); }
+            }
+            deallocate<T, DeallocType::Multiple>(m_data);
+        }
+        T* data() { return m_data; }
+        void put(size_t index, T&& value) {
+            if (index < m_live) {
+                m_data[index] = move(value);
+            } else {
+                new (m_data + index) T{ move(value) };
+                ++m_live;
+            }
+        }
+    };
+    // merges the sorted runs [first, mid) and [mid, last), the shorter run is moved into the buffer
+    template <typename T, typename Less>
+    void merge_adjacent(T* first, T* mid, T* last, SortBuffer<T>& buffer, Less& lt) {
+        const size_t l_size = static_cast<size_t>(mid - first);
+        const size_t r_size = static_cast<size_t>(last - mid);
+        T* buf              = buffer.data();
+        if (l_size <= r_size) {
+            for (size_t i = 0; i < l_size; ++i) { buffer.put(i, move(first[i])); }
+            T* a     = buf;
+            T* a_end = buf + l_size;
+            T* b     = mid;
+            T* out   = first;
+            // on ties the element from the left run goes first, this is what makes the sort stable
+            while (a != a_end && b != last) { *out++ = lt(*b, *a) ? move(*b++) : move(*a++); }
+            while (a != a_end) { *out++ = move(*a++); }
+        } else {
+            for (size_t i = 0; i < r_size; ++i) { buffer.put(i, move(mid[i])); }
+            T* a   = mid;
+            T* b   = buf + r_size;
+            T* out = last;
+            while (a != first && b != buf) { *--out = lt(*(b - 1), *(a - 1)) ? move(*--a) : move(*--b); }
+            while (b != buf) { *--out = move(*--b); }
+        }
+    }
+    template <typename T, typename Functor>
+    void merge_sort(T* first, T* last, Functor& cmp) {
+        const size_t size = static_cast<size_t>(last - first);
+        auto lt           = less_from<T>(cmp);
+        for (size_t lo = 0; lo < size; lo += stable_sort_run) {
+            insertion_sort(first + lo, first + (size - lo < stable_sort_run ? size : lo + stable_sort_run), lt);
+        }
+        if (size <= stable_sort_run) return;
+        SortBuffer<T> buffer{ size / 2 };
+        for (size_t width = stable_sort_run; width < size; width *= 2) {
+            for (size_t lo = 0; lo + width < size; lo += 2 * width) {
+                T* mid      = first + lo + width;
+                T* last_run = first + (size - lo < 2 * width ? size : lo + 2 * width);
+                if (!lt(*mid, *(mid - 1))) continue;    // the two runs are already in order
+                merge_adjacent(first + lo, mid, last_run, buffer, lt);
+            }
+        }
+    }
+    template <typename T>
+    concept RadixSortableKey = Integral<T> || FloatingPoint<T>;
+    template <typename T>
+    struct RadixBitsFor {
+        using type = MakeUnsignedT<T>;
+    };
+    template <>
+    struct RadixBitsFor<float> {
+        using type = uint32_t;
+    };
+    template <>
+    struct RadixBitsFor<double> {
+        using type = uint64_t;
+    };
+    // maps a key to an unsigned integer with the same ordering
+    template <RadixSortableKey T>
+    constexpr auto radix_bits(T key) {
+        using U             = typename RadixBitsFor<T>::type;
+        constexpr U top_bit = static_cast<U>(U{ 1 } << (sizeof(U) * 8 - 1));
+        if constexpr (FloatingPoint<T>) {
+            // negative floats have to be flipped completely, positive ones just need the sign bit set
+            const U bits = BitCast<U>(key);
+            return (bits & top_bit) ? static_cast<U>(~bits) : static_cast<U>(bits | top_bit);
+        } else if constexpr (SignedIntegral<T>) {
+            return static_cast<U>(static_cast<U>(key) ^ top_bit);
+        } else {
+            return static_cast<U>(key);
+        }
+    }
+    // one stable counting sort pass per byte (pass 0 being the least significant one) ping-ponging between
+    // data and scratch, passes where every element has the same byte are skipped. returns where the result ended up
+    template <typename R, typename ByteOf>
+    R* lsd_radix_passes(R* data, R* scratch, size_t count, size_t passes, ByteOf&& byte_of) {
+        size_t offsets[256];
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (auto& offset : offsets) { offset = 0; }
+            for (size_t i = 0; i < count; ++i) { ++offsets[byte_of(data[i], pass)]; }
+            if (offsets[byte_of(data[0], pass)] == count) continue;
+            size_t total = 0;
+            for (auto& offset : offsets) {
+                const size_t bucket = offset;
+                offset              = total;
+                total += bucket;
+            }
+            for (size_t i = 0; i < count; ++i) { scratch[offsets[byte_of(data[i], pass)]++] = data[i]; }
+            swap(data, scratch);
+        }
+        return data;
+    }
+    template <typename U>
+    struct RadixRecord {
+        U bits;
+        size_t index;
+    };
+    template <typename U>
+    size_t index_of(const RadixRecord<U>& record) {
+        return record.index;
+    }
+    inline size_t index_of(size_t index) {
+        return index;
+    }
+    // moves the elements of [first, first + count) so that position i holds the element that was at index_of(order[i])
+    template <typename T, typename Record>
+    void apply_order(T* first, const Record* order, size_t count) {
+        SortBuffer<T> buffer{ count };
+        for (size_t i = 0; i < count; ++i) { buffer.put(i, move(first[index_of(order[i])])); }
+        for (size_t i = 0; i < count; ++i) { first[i] = move(buffer.data()[i]); }
+    }
+    template <typename Iter>
+    auto* contiguous_base(Iter first) {
+        return addressof(*first);
+    }
+}    // namespace detail
+template <IteratorConcept Iter, typename Functor>
+requires CallableWithRes<Functor, Ordering, IteratorOutputType<Iter>, IteratorOutputType<Iter>>
+void sort(Iter first, Iter last, Functor&& cmp) {
+    if (first == last) return;
+    auto* base = detail::contiguous_base(first);
+    detail::pdqsort(base, base + (last - first), cmp);
+}
+template <IteratorConcept Iter>
+void sort(Iter first, Iter last) {
+    sort(first, last, detail::DefaultSortCompare{});
+}
+// in-place sorting
+template <Iterable C>
+void sort(C& cont) {
+    sort(cont.begin(), cont.end());
+}
+template <Iterable C, typename Functor>
+void sort(C& cont, Functor&& func) {
+    sort(cont.begin(), cont.end(), func);
+}
+// like sort, but elements that compare equal keep their relative order
+template <IteratorConcept Iter, typename Functor>
+requires CallableWithRes<Functor, Ordering, IteratorOutputType<Iter>, IteratorOutputType<Iter>>
+void stable_sort(Iter first, Iter last, Functor&& cmp) {
+    if (first == last) return;
+    auto* base = detail::contiguous_base(first);
+    detail::merge_sort(base, base + (last - first), cmp);
+}
+template <IteratorConcept Iter>
+void stable_sort(Iter first, Iter last) {
+    stable_sort(first, last, detail::DefaultSortCompare{});
+}
+template <Iterable C>
+void stable_sort(C& cont) {
+    stable_sort(cont.begin(), cont.end());
+}
+template <Iterable C, typename Functor>
+void stable_sort(C& cont, Functor&& func) {
+    stable_sort(cont.begin(), cont.end(), func);
+}
+// ascending radix sort of a range of integers or floating point numbers
+// NaNs are ordered by their bit pattern, negative ones before everything else and positive ones after +inf
+template <IteratorConcept Iter>
+requires detail::RadixSortableKey<RemoveCvRefT<IteratorOutputType<Iter>>>
+void radix_sort(Iter first, Iter last) {
+    using T            = RemoveCvRefT<IteratorOutputType<Iter>>;
+    const size_t count = static_cast<size_t>(last - first);
+    if (count < 2) return;
+    T* base    = detail::contiguous_base(first);
+    T* scratch = allocate_uninitialized<T>(count);
+    T* result  = detail::lsd_radix_passes(base, scratch, count, sizeof(T), [](T value, size_t pass) {
+        return static_cast<size_t>((detail::radix_bits(value) >> (pass * 8)) & 0xFF);
+    });
+    if (result != base) { ConditionalBitCopy(base, result, count); }
+    deallocate<T, DeallocType::Multiple>(scratch);
+}
+// stable radix sort of arbitrary elements by an integer or floating point key, key is called once per element
+template <IteratorConcept Iter, typename KeyFunc>
+requires detail::RadixSortableKey<RemoveCvRefT<InvokeResultT<KeyFunc, IteratorOutputType<Iter>>>>
+void radix_sort(Iter first, Iter last, KeyFunc&& key) {
+    using T            = RemoveCvRefT<IteratorOutputType<Iter>>;
+    using K            = RemoveCvRefT<InvokeResultT<KeyFunc, IteratorOutputType<Iter>>>;
+    using Record       = detail::RadixRecord<typename detail::RadixBitsFor<K>::type>;
+    const size_t count = static_cast<size_t>(last - first);
+    if (count < 2) return;
+    T* base         = detail::contiguous_base(first);
+    Record* records = allocate_uninitialized<Record>(2 * count);
+    for (size_t i = 0; i < count; ++i) { records[i] = Record{ detail::radix_bits(key(base[i])), i }; }
+    auto byte_of    = [](const Record& r, size_t pass) { return static_cast<size_t>((r.bits >> (pass * 8)) & 0xFF); };
+    detail::apply_order(base, detail::lsd_radix_passes(records, records + count, count, sizeof(K), byte_of), count);
+    deallocate<Record, DeallocType::Multiple>(records);
+}
+template <Iterable C>
+void radix_sort(C& cont) {
+    radix_sort(cont.begin(), cont.end());
+}
+template <Iterable C, typename KeyFunc>
+void radix_sort(C& cont, KeyFunc&& key) {
+    radix_sort(cont.begin(), cont.end(), Forward<KeyFunc>(key));
+}
+// stable radix sort by a string key (anything with size() and operator[], e.g. String or StringView),
+// only the first `width` bytes take part in the comparison and shorter keys are padded with '\0'
+// this makes it a plain lexicographic byte-wise sort when width is at least as big as the longest key
+template <IteratorConcept Iter, typename KeyFunc>
+void radix_sort_strings(Iter first, Iter last, size_t width, KeyFunc&& key) {
+    using T            = RemoveCvRefT<IteratorOutputType<Iter>>;
+    const size_t count = static_cast<size_t>(last - first);
+    if (count < 2 || width == 0) return;
+    T* base         = detail::contiguous_base(first);
+    size_t* indices = allocate_uninitialized<size_t>(2 * count);
+    for (size_t i = 0; i < count; ++i) { indices[i] = i; }
+    auto byte_of = [&](size_t index, size_t pass) {
+        const auto& str  = key(base[index]);
+        const size_t pos = width - 1 - pass;
+        return pos < str.size() ? static_cast<size_t>(static_cast<uint8_t>(str[pos])) : size_t{ 0 };
+    };
+    detail::apply_order(base, detail::lsd_radix_passes(indices, indices + count, count, width, byte_of), count);
+    deallocate<size_t, DeallocType::Multiple>(indices);
+}
+template <IteratorConcept Iter>
+void radix_sort_strings(Iter first, Iter last, size_t width) {
+    radix_sort_strings(first, last, width, [](const auto& str) -> const auto& { return str; });
+}
+template <Iterable C, typename... Args>
+void radix_sort_strings(C& cont, size_t width, Args&&... key) {
+    radix_sort_strings(cont.begin(), cont.end(), width, Forward<Args>(key)...);
+}
+}    // namespace ARLib
@@ -1,4 +1,5 @@
 #pragma once
+#include "Optional.hpp"
 #include "Result.hpp"
 #include "Span.hpp"
 #include "String.hpp"
@@ -22,7 +23,11 @@ struct CharacterStream : public BaseStream {
     virtual Result<size_t> write_string(StringView buffer) = 0;
     virtual Result<String> read_string()                   = 0;
     virtual Result<String> read_line(bool& eof_reached)    = 0;
-    virtual ~CharacterStream()                             = default;
+    // read at most n characters, an empty string means the end of the stream.
+    // the default is for streams that can't read a piece at a time, it hands out the rest of the stream in one go
+    // (read_string) and ignores n, so callers have to cope with getting more than they asked for
+    virtual Result<String> read_some([[maybe_unused]] size_t n) { return read_string(); }
+    virtual ~CharacterStream() = default;
 };
 class FileStream : public CharacterStream {
     protected:
@@ -37,6 +42,7 @@ class FileStream : public CharacterStream {
     Result<size_t> write_string(StringView buffer) override;
     Result<String> read_string() override;
     Result<String> read_line(bool& eof_reached) override;
+    Result<String> read_some(size_t n) override;
     size_t pos() const override;
     size_t seek(size_t) override;
     virtual ~FileStream() = default;
@@ -76,6 +82,7 @@ class StringStream : public CharacterStream {
     Result<size_t> write_string(StringView buffer) override;
     Result<String> read_string() override;
     Result<String> read_line(bool& eof_reached) override;
+    Result<String> read_some(size_t n) override;
     size_t pos() const override { return m_pos; }
     size_t seek(size_t pos) override {
         m_pos = pos;
@@ -84,4 +91,39 @@ class StringStream : public CharacterStream {
     String str() const { return m_buffer; }
     virtual ~StringStream() = default;
 };
+// output buffer of a serializer. without a stream everything stays in it until it's taken out with str() / release(),
+// with one it's written out once it holds threshold bytes (checked by maybe_flush, the serializer decides where a
+// write can happen) and when flush() is called
+class BufferedSink {
+    String m_buffer;
+    BaseStream* m_stream = nullptr;
+    size_t m_threshold   = 0;
+    // message of the first failed write to the stream, nothing is written to it after that
+    Optional<String> m_error;
+
+    void write_out();
+
+    public:
+    BufferedSink() = default;
+    BufferedSink(BaseStream& stream, size_t threshold, size_t capacity) : m_stream(&stream), m_threshold(threshold) {
+        m_buffer.reserve(capacity);
+    }
+    // room for count more bytes, commit() with the end of what was written into it
+    char* reserve(size_t count) {
+        m_buffer.reserve(m_buffer.size() + count);
+        return m_buffer.rawptr() + m_buffer.size();
+    }
+    void commit(char* end) { m_buffer.set_size(static_cast<size_t>(end - m_buffer.rawptr())); }
+    void append(char c) { m_buffer.append(c); }
+    void append(StringView str) { m_buffer.append(str); }
+    size_t size() const { return m_buffer.size(); }
+    void maybe_flush() {
+        if (m_stream && m_buffer.size() >= m_threshold) write_out();
+    }
+    // hands whatever is buffered to the stream, also reports an error from an earlier automatic flush
+    DiscardResult<Error> flush();
+    // what has been written so far, not counting what already went to the stream
+    const String& str() const { return m_buffer; }
+    String release() { return move(m_buffer); }
+};
 }    // namespace ARLib
\ No newline at end of file
@@ -26,11 +26,15 @@ namespace ARLib {
 // this means that you can use return values in static_asserts without issues
 // additionally, to be able to use some of this class' API
 // you'll need to declare the variable as static (and constexpr) to guarantee storage pointer stability.
+// it can also be a template parameter, e.g. template <StringLiteral Str>, which is then written as Thing<"hello">
 template <size_t N>
 struct StringLiteral {
-    const char _m_str[N];
+    char _m_str[N]{};
     constexpr static inline size_t npos   = static_cast<size_t>(-1);
     constexpr static inline size_t m_size = N - 1;
+    consteval StringLiteral(const char (&str)[N]) {
+        for (size_t i = 0; i < N; ++i) _m_str[i] = str[i];
+    }
     consteval const char* ptr() const { return _m_str; }
     consteval size_t size() const { return m_size; }
     consteval char operator[](const size_t index) const { return _m_str[index]; }
@@ -0,0 +1,79 @@
+#pragma once
+#ifndef DISABLE_THREADING
+    #include "Algorithm.hpp"
+    #include "Functional.hpp"
+    #include "Threading.hpp"
+    #include "Vector.hpp"
+namespace ARLib {
+// fixed-size pool of worker threads, tasks are run in fifo order
+// a thread that has to wait for work it queued on the pool runs other queued tasks in the meantime
+// instead of blocking, this way a task can itself use the pool (e.g. nested parallel algorithms) without deadlocking
+class ThreadPool {
+    Vector<Thread> m_workers;
+    Vector<Function<void()>> m_tasks;
+    size_t m_head = 0;
+    Mutex m_mutex;
+    ConditionVariable m_cv;
+    bool m_stopping = false;
+
+    void worker_loop();
+    bool pop_task(Function<void()>& task);
+
+    public:
+    explicit ThreadPool(size_t thread_count);
+    ThreadPool() : ThreadPool(Thread::hardware_concurrency()) {}
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&)                 = delete;
+    ThreadPool& operator=(ThreadPool&&)      = delete;
+    size_t size() const noexcept { return m_workers.size(); }
+    void submit(Function<void()> task);
+    // pops one queued task and runs it on the calling thread, returns false if the queue was empty
+    bool run_pending_task();
+    // calls func(index) for every index in [0, count), both on the workers and on the calling thread
+    // indices are handed out dynamically so uneven chunks still balance, returns once every call has returned
+    template <typename Func>
+    requires CallableWith<Func, size_t>
+    void run_indexed(size_t count, Func&& func) {
+        if (count == 0) return;
+        const size_t helper_count = min_bt(count - 1, size());
+        if (helper_count == 0) {
+            for (size_t i = 0; i < count; ++i) { func(i); }
+            return;
+        }
+        struct SharedState {
+            Atomic<size_t> next{ 0 };
+            size_t helpers_left;
+            Mutex mutex{};
+            ConditionVariable cv{};
+        } state{};
+        state.helpers_left = helper_count;
+        auto work          = [&state, &func, count]() {
+            for (size_t i = state.next.fetch_add(1, MemoryOrder::Relaxed); i < count;
+                 i        = state.next.fetch_add(1, MemoryOrder::Relaxed)) {
+                func(i);
+            }
+        };
+        for (size_t i = 0; i < helper_count; ++i) {
+            submit([&state, &work]() {
+                work();
+                // notify while holding the lock, the state lives on the waiting thread's stack
+                LockGuard guard{ state.mutex };
+                if (--state.helpers_left == 0) { state.cv.notify_all(); }
+            });
+        }
+        work();
+        UniqueLock lock{ state.mutex };
+        while (state.helpers_left != 0) {
+            lock.unlock();
+            const bool ran_task = run_pending_task();
+            lock.lock();
+            if (!ran_task && state.helpers_left != 0) { state.cv.wait(lock); }
+        }
+    }
+    // pool shared by the parallel algorithms, sized to the number of cores available to the process
+    static ThreadPool& global();
+};
+}    // namespace ARLib
+#endif
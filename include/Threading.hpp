@@ -74,6 +74,187 @@ class RecursiveMutex : private detail::RecursiveMutexBase {
     HandleType native_handle() noexcept { return &m_mutex; }
     ConstHandleType native_handle() const noexcept { return &m_mutex; }
 };
+// 4-byte mutex built directly on the futex (WaitOnAddress on windows) wait/wake primitives
+// the uncontended path is a single CAS, contended lockers spin for a bit before parking the thread
+class AdaptiveMutex {
+    constexpr static uint32_t unlocked  = 0;
+    constexpr static uint32_t locked    = 1;
+    constexpr static uint32_t contended = 2;
+    constexpr static size_t spin_count  = 100;
+    Atomic<uint32_t> m_state{ unlocked };
+    void lock_contended() noexcept;
+
+    public:
+    using HandleType         = Atomic<uint32_t>*;
+    using ConstHandleType    = const Atomic<uint32_t>*;
+    AdaptiveMutex() noexcept = default;
+    ~AdaptiveMutex()         = default;
+
+    AdaptiveMutex(const AdaptiveMutex&)            = delete;
+    AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+    AdaptiveMutex(AdaptiveMutex&&)                 = delete;
+    AdaptiveMutex& operator=(AdaptiveMutex&&)      = delete;
+    void lock() noexcept {
+        uint32_t expected = unlocked;
+        if (!m_state.compare_exchange_strong(expected, locked, MemoryOrder::Acquire)) { lock_contended(); }
+    }
+    bool try_lock() noexcept {
+        uint32_t expected = unlocked;
+        return m_state.compare_exchange_strong(expected, locked, MemoryOrder::Acquire);
+    }
+    void unlock() noexcept {
+        if (m_state.exchange(unlocked, MemoryOrder::Release) == contended) { m_state.notify_one(); }
+    }
+    HandleType native_handle() noexcept { return &m_state; }
+    ConstHandleType native_handle() const noexcept { return &m_state; }
+};
+// reader-writer lock that prefers writers: as soon as a writer is waiting new readers will block
+// the layout of the state word is [writers waiting : 1][readers waiting : 1][reader count or write locked : 30]
+class SharedMutex {
+    constexpr static uint32_t read_locked     = 1;
+    constexpr static uint32_t mask            = (1u << 30) - 1;
+    constexpr static uint32_t write_locked    = mask;
+    constexpr static uint32_t max_readers     = mask - 1;
+    constexpr static uint32_t readers_waiting = 1u << 30;
+    constexpr static uint32_t writers_waiting = 1u << 31;
+    constexpr static size_t spin_count        = 100;
+    Atomic<uint32_t> m_state{ 0 };
+    Atomic<uint32_t> m_writer_notify{ 0 };
+    Atomic<uint32_t> m_writers_sleeping{ 0 };
+
+    static bool is_unlocked(uint32_t state) noexcept { return (state & mask) == 0; }
+    static bool is_write_locked(uint32_t state) noexcept { return (state & mask) == write_locked; }
+    static bool has_readers_waiting(uint32_t state) noexcept { return (state & readers_waiting) != 0; }
+    static bool has_writers_waiting(uint32_t state) noexcept { return (state & writers_waiting) != 0; }
+    static bool is_read_lockable(uint32_t state) noexcept {
+        return (state & mask) < max_readers && !has_readers_waiting(state) && !has_writers_waiting(state);
+    }
+    uint32_t spin_read() noexcept;
+    uint32_t spin_write() noexcept;
+    void lock_shared_contended() noexcept;
+    void lock_contended() noexcept;
+    void wake_writer_or_readers(uint32_t state) noexcept;
+    bool wake_writer() noexcept;
+
+    public:
+    SharedMutex() noexcept = default;
+    ~SharedMutex()         = default;
+
+    SharedMutex(const SharedMutex&)            = delete;
+    SharedMutex& operator=(const SharedMutex&) = delete;
+    SharedMutex(SharedMutex&&)                 = delete;
+    SharedMutex& operator=(SharedMutex&&)      = delete;
+    void lock() noexcept {
+        uint32_t expected = 0;
+        if (!m_state.compare_exchange_strong(expected, write_locked, MemoryOrder::Acquire)) { lock_contended(); }
+    }
+    bool try_lock() noexcept {
+        uint32_t state = m_state.load(MemoryOrder::Relaxed);
+        while (is_unlocked(state)) {
+            if (m_state.compare_exchange_weak(state, state + write_locked, MemoryOrder::Acquire)) { return true; }
+        }
+        return false;
+    }
+    void unlock() noexcept {
+        const uint32_t state = m_state.fetch_sub(write_locked, MemoryOrder::Release) - write_locked;
+        if (has_readers_waiting(state) || has_writers_waiting(state)) { wake_writer_or_readers(state); }
+    }
+    void lock_shared() noexcept {
+        uint32_t state = m_state.load(MemoryOrder::Relaxed);
+        if (!is_read_lockable(state) ||
+            !m_state.compare_exchange_strong(state, state + read_locked, MemoryOrder::Acquire)) {
+            lock_shared_contended();
+        }
+    }
+    bool try_lock_shared() noexcept {
+        uint32_t state = m_state.load(MemoryOrder::Relaxed);
+        while (is_read_lockable(state)) {
+            if (m_state.compare_exchange_weak(state, state + read_locked, MemoryOrder::Acquire)) { return true; }
+        }
+        return false;
+    }
+    void unlock_shared() noexcept {
+        const uint32_t state = m_state.fetch_sub(read_locked, MemoryOrder::Release) - read_locked;
+        // readers can only be waiting on a read-locked lock if there's also a writer waiting
+        if (is_unlocked(state) && has_writers_waiting(state)) { wake_writer_or_readers(state); }
+    }
+};
+using RWLock = SharedMutex;
+// test-and-test-and-set lock, meant only for critical sections that are a handful of instructions long
+class SpinLock {
+    Atomic<bool> m_locked{ false };
+
+    public:
+    SpinLock() noexcept = default;
+    ~SpinLock()         = default;
+
+    SpinLock(const SpinLock&)            = delete;
+    SpinLock& operator=(const SpinLock&) = delete;
+    SpinLock(SpinLock&&)                 = delete;
+    SpinLock& operator=(SpinLock&&)      = delete;
+    void lock() noexcept {
+        while (m_locked.exchange(true, MemoryOrder::Acquire)) {
+            while (m_locked.load(MemoryOrder::Relaxed)) { pause_sync(); }
+        }
+    }
+    bool try_lock() noexcept {
+        return !m_locked.load(MemoryOrder::Relaxed) && !m_locked.exchange(true, MemoryOrder::Acquire);
+    }
+    void unlock() noexcept { m_locked.store(false, MemoryOrder::Release); }
+};
+// sequence lock for read-mostly data: readers never write to shared memory and retry if a writer raced them
+// writers are serialized among themselves by moving the sequence number from even to odd
+template <typename T>
+requires IsTriviallyCopiableV<T>
+class SeqLock {
+    Atomic<uint32_t> m_sequence{ 0 };
+    T m_value;
+
+    uint32_t begin_write() noexcept {
+        uint32_t seq = m_sequence.load(MemoryOrder::Relaxed);
+        while (true) {
+            if ((seq & 1) == 0 && m_sequence.compare_exchange_weak(seq, seq + 1, MemoryOrder::Acquire)) { break; }
+            pause_sync();
+            seq = m_sequence.load(MemoryOrder::Relaxed);
+        }
+        // keeps the writes to the value from becoming visible before the odd sequence number
+        atomic_thread_fence(MemoryOrder::Release);
+        return seq;
+    }
+    void end_write(uint32_t seq) noexcept { m_sequence.store(seq + 2, MemoryOrder::Release); }
+
+    public:
+    SeqLock() noexcept(NothrowDefaultConstructibleV<T>) : m_value{} {}
+    explicit SeqLock(const T& value) noexcept : m_value{ value } {}
+    SeqLock(const SeqLock&)            = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+    T load() const noexcept {
+        while (true) {
+            uint32_t before = m_sequence.load(MemoryOrder::Acquire);
+            if ((before & 1) != 0) {
+                pause_sync();
+                continue;
+            }
+            T copy{ m_value };
+            // keeps the reads of the value from sinking below the second load of the sequence number
+            atomic_thread_fence(MemoryOrder::Acquire);
+            if (m_sequence.load(MemoryOrder::Relaxed) == before) { return copy; }
+        }
+    }
+    void store(const T& value) noexcept {
+        const uint32_t seq = begin_write();
+        m_value            = value;
+        end_write(seq);
+    }
+    template <typename Func>
+    requires CallableWith<Func, T&>
+    void update(Func&& func) noexcept {
+        const uint32_t seq = begin_write();
+        func(m_value);
+        end_write(seq);
+    }
+    uint32_t sequence() const noexcept { return m_sequence.load(MemoryOrder::Acquire); }
+};
 struct DeferLock {
     explicit DeferLock() = default;
 };
@@ -184,6 +365,66 @@ class UniqueLock {
     explicit operator bool() const noexcept { return owns_lock(); }
     MutexType* mutex() const noexcept { return m_device; }
 };
+template <typename Mutex>
+class SharedLock {
+    Mutex* m_device;
+    bool m_owns;
+
+    public:
+    using MutexType = Mutex;
+    SharedLock() noexcept : m_device(nullptr), m_owns(false) {}
+    explicit SharedLock(MutexType& m) : m_device(addressof(m)), m_owns(false) {
+        lock();
+        m_owns = true;
+    }
+    SharedLock(MutexType& m, DeferLock) noexcept : m_device(addressof(m)), m_owns(false) {}
+    SharedLock(MutexType& m, TryToLock) : m_device(addressof(m)), m_owns(m_device->try_lock_shared()) {}
+    SharedLock(MutexType& m, AdoptLock) noexcept : m_device(addressof(m)), m_owns(true) {}
+    ~SharedLock() {
+        if (m_owns) unlock();
+    }
+    SharedLock(const SharedLock&)            = delete;
+    SharedLock& operator=(const SharedLock&) = delete;
+    SharedLock(SharedLock&& u) noexcept : m_device(u.m_device), m_owns(u.m_owns) {
+        u.m_device = nullptr;
+        u.m_owns   = false;
+    }
+    SharedLock& operator=(SharedLock&& u) noexcept {
+        if (m_owns) unlock();
+        SharedLock(move(u)).swap(*this);
+        return *this;
+    }
+    void lock() {
+        if (!m_device || m_owns) arlib_terminate();
+        m_device->lock_shared();
+        m_owns = true;
+    }
+    bool try_lock() {
+        if (!m_device || m_owns) arlib_terminate();
+        m_owns = m_device->try_lock_shared();
+        return m_owns;
+    }
+    void unlock() {
+        if (!m_owns) arlib_terminate();
+        if (m_device) {
+            m_device->unlock_shared();
+            m_owns = false;
+        }
+    }
+    void swap(SharedLock& u) noexcept {
+        ARLib::swap(m_device, u.m_device);
+        ARLib::swap(m_owns, u.m_owns);
+    }
+    MutexType* release() noexcept {
+        MutexType* ret = m_device;
+        m_device       = nullptr;
+        m_owns         = false;
+        return ret;
+    }
+    bool owns_lock() const noexcept { return m_owns; }
+    explicit operator bool() const noexcept { return owns_lock(); }
+    MutexType* mutex() const noexcept { return m_device; }
+};
 template <typename Lock>
 inline UniqueLock<Lock> try_to_lock_(Lock& l) {
     return UniqueLock<Lock>{ l, try_to_lock };
@@ -341,6 +582,7 @@ class Thread {
         m_thread = {};
     }
     void swap(Thread& other) { ThreadNative::swap(m_thread, other.m_thread); }
+    static unsigned int hardware_concurrency() { return ThreadNative::hardware_concurrency(); }
     ~Thread() {
         if (joinable()) { arlib_terminate(); }
     }
@@ -359,25 +601,27 @@ class LockedPointer {
     LockedPointer(const LockedPointer&)            = delete;
     LockedPointer& operator=(const LockedPointer&) = delete;
     T* lock_and_load() noexcept {
-        uintptr_t rep = m_storage.load();
+        uintptr_t rep = m_storage.load(MemoryOrder::Relaxed);
         while (true) {
             switch (rep & lock_mask) {
                 case not_locked:
-                    if (m_storage.compare_exchange_weak(rep, rep | locked_notify_not_needed)) {
+                    if (m_storage.compare_exchange_weak(rep, rep | locked_notify_not_needed, MemoryOrder::Acquire)) {
                         return reinterpret_cast<T*>(rep);
                     }
                     pause_sync();
                     break;
                 case locked_notify_not_needed:
-                    if (!m_storage.compare_exchange_weak(rep, (rep & ptr_value_mask) | locked_notify_needed)) {
+                    if (!m_storage.compare_exchange_weak(
+                        rep, (rep & ptr_value_mask) | locked_notify_needed, MemoryOrder::Relaxed
+                        )) {
                         pause_sync();
                         break;
                     }
                     rep = (rep & ptr_value_mask) | locked_notify_needed;
                     [[fallthrough]];
                 case locked_notify_needed:
-                    m_storage.wait(rep);
-                    rep = m_storage.load();
+                    m_storage.wait(rep, MemoryOrder::Relaxed);
+                    rep = m_storage.load(MemoryOrder::Relaxed);
                     break;
                 default:
                     ASSERT_NOT_REACHED("Invalid bit pattern in LockedPointer");
@@ -386,7 +630,7 @@ class LockedPointer {
         }
     }
     void store_and_unlock(const T* value) noexcept {
-        const auto rep = m_storage.exchange(reinterpret_cast<uintptr_t>(value));
+        const auto rep = m_storage.exchange(reinterpret_cast<uintptr_t>(value), MemoryOrder::Release);
         if ((rep & lock_mask) == locked_notify_needed) { m_storage.notify_all(); }
     }
     T* unsafe_load() const noexcept { return reinterpret_cast<T*>(m_storage.load()); }
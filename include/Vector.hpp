@@ -162,7 +162,7 @@ class Vector {
         return true;
     }
     void reserve(size_t capacity) {
-        if (capacity < m_capacity) return;
+        if (capacity <= m_capacity) return;
         round_to_capacity_(capacity);
     }
     void resize(size_t size)
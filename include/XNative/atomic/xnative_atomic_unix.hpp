@@ -68,31 +68,84 @@ template <typename Int, class T1, class T2>
 auto storage_and_bytes(T1& storage, T2 value) {
     return Pair{ addressof_atomic<Int>(storage), reinterpret_cast_atomic<Int>(value) };
 }
-void atomic_store_nolock(volatile char* addend, char value);
-void atomic_store_nolock(volatile short* addend, short value);
-void atomic_store_nolock(volatile int* addend, int value);
-void atomic_store_nolock(volatile long long* addend, long long value);
-
-char atomic_load_nolock(const volatile char* addr);
-short atomic_load_nolock(const volatile short* addr);
-int atomic_load_nolock(const volatile int* addr);
-long long atomic_load_nolock(const volatile long long* addr);
-
-char atomic_exchange_nolock(volatile char* addr, char value);
-short atomic_exchange_nolock(volatile short* addr, short value);
-int atomic_exchange_nolock(volatile int* addr, int value);
-long long atomic_exchange_nolock(volatile long long* addr, long long value);
-
-char atomic_compare_exchange_nolock(volatile char* addr, char value, char comparand);
-short atomic_compare_exchange_nolock(volatile short* addr, short value, short comparand);
-int atomic_compare_exchange_nolock(volatile int* addr, int value, int comparand);
-long long atomic_compare_exchange_nolock(volatile long long* addr, long long value, long long comparand);
-
+enum class MemoryOrder { Relaxed, Consume, Acquire, Release, AcqRel, SeqCst };
+constexpr int builtin_memory_order(MemoryOrder order) noexcept {
+    switch (order) {
+        case MemoryOrder::Relaxed:
+            return __ATOMIC_RELAXED;
+        case MemoryOrder::Consume:
+            return __ATOMIC_CONSUME;
+        case MemoryOrder::Acquire:
+            return __ATOMIC_ACQUIRE;
+        case MemoryOrder::Release:
+            return __ATOMIC_RELEASE;
+        case MemoryOrder::AcqRel:
+            return __ATOMIC_ACQ_REL;
+        case MemoryOrder::SeqCst:
+            return __ATOMIC_SEQ_CST;
+    }
+    return __ATOMIC_SEQ_CST;
+}
+// these are kept inline on purpose, the ordering has to be a constant by the time the builtin gets expanded
+// otherwise gcc falls back to seq_cst, this is also what lets a relaxed fetch_add become a single lock xadd
+template <Integral Int>
+inline void atomic_store_nolock(volatile Int* addend, Int value, MemoryOrder order) noexcept {
+    __atomic_store_n(addend, value, builtin_memory_order(order));
+}
+template <Integral Int>
+inline Int atomic_load_nolock(const volatile Int* addr, MemoryOrder order) noexcept {
+    return __atomic_load_n(addr, builtin_memory_order(order));
+}
+template <Integral Int>
+inline Int atomic_exchange_nolock(volatile Int* addr, Int value, MemoryOrder order) noexcept {
+    return __atomic_exchange_n(addr, value, builtin_memory_order(order));
+}
+template <bool Weak, Integral Int>
+inline bool atomic_compare_exchange_nolock(
+volatile Int* addr, Int& comparand, Int value, MemoryOrder success, MemoryOrder failure
+) noexcept {
+    return __atomic_compare_exchange_n(
+    addr, &comparand, value, Weak, builtin_memory_order(success), builtin_memory_order(failure)
+    );
+}
+#ifdef __x86_64__
+// -msse4.1 is a baseline requirement of the library and every cpu with sse4.1 has cmpxchg16b
+// gcc won't emit it on its own for __atomic builtins (it goes through libatomic), so we do it by hand
+inline unsigned char atomic_compare_exchange_nolock(
+volatile long long* addr, long long value_high, long long value_low, long long* comparand
+) noexcept {
+    bool result;
+    __asm__ __volatile__("lock cmpxchg16b %1"
+                         : "=@ccz"(result), "+m"(*addr), "+a"(comparand[0]), "+d"(comparand[1])
+                         : "b"(value_low), "c"(value_high)
+                         : "memory");
+    return result ? 1 : 0;
+}
+#endif
 enum class AtomicIntegralOp { ExchAdd, And, Or, Xor, Inc, Dec };
-char atomic_integral_op_nolock(volatile char* addr, char value, AtomicIntegralOp op_type);
-short atomic_integral_op_nolock(volatile short* addr, short value, AtomicIntegralOp op_type);
-int atomic_integral_op_nolock(volatile int* addr, int value, AtomicIntegralOp op_type);
-long long atomic_integral_op_nolock(volatile long long* addr, long long value, AtomicIntegralOp op_type);
+template <Integral Int>
+inline Int
+atomic_integral_op_nolock(volatile Int* addr, Int value, AtomicIntegralOp op_type, MemoryOrder order) noexcept {
+    const int builtin_order = builtin_memory_order(order);
+    switch (op_type) {
+        case AtomicIntegralOp::ExchAdd:
+            return __atomic_fetch_add(addr, value, builtin_order);
+        case AtomicIntegralOp::And:
+            return __atomic_fetch_and(addr, value, builtin_order);
+        case AtomicIntegralOp::Or:
+            return __atomic_fetch_or(addr, value, builtin_order);
+        case AtomicIntegralOp::Xor:
+            return __atomic_fetch_xor(addr, value, builtin_order);
+        case AtomicIntegralOp::Inc:
+            return __atomic_fetch_add(addr, 1, builtin_order);
+        case AtomicIntegralOp::Dec:
+            return __atomic_fetch_sub(addr, 1, builtin_order);
+    }
+    arlib_unreachable;
+}
+inline void atomic_thread_fence(MemoryOrder order) noexcept {
+    __atomic_thread_fence(builtin_memory_order(order));
+}
 
 void memory_barrier();
 void pause_sync();
@@ -116,23 +169,26 @@ struct AtomicStorage {
     AtomicStorage() = default;
     constexpr AtomicStorage(ConditionalT<IsReference<T>::value, T, const Val> value) noexcept :
         m_storage(value), m_lock{} {}
-    void store(const Val value) noexcept {
+    // the lock already acts as a full barrier, so the requested ordering is irrelevant here
+    void store(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         GuardType lock{ m_lock };
         m_storage = value;
     }
-    Val load() const noexcept {
+    Val load(MemoryOrder = MemoryOrder::SeqCst) const noexcept {
         GuardType lock{ m_lock };
         Val local{ m_storage };
         return local;
     }
-    Val exchange(const Val value) noexcept {
+    Val exchange(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         GuardType lock{ m_lock };
         Val result{ m_storage };
         m_storage = value;
         return result;
     }
     bool is_lock_free() const noexcept { return false; }
-    bool compare_exchange_strong(Val& expected, const Val desired) noexcept {
+    bool compare_exchange_strong(
+    Val& expected, const Val desired, MemoryOrder = MemoryOrder::SeqCst, MemoryOrder = MemoryOrder::SeqCst
+    ) noexcept {
         const auto storage_ptr  = addressof(m_storage);
         const auto expected_ptr = addressof(expected);
         bool result;
@@ -145,7 +201,13 @@ struct AtomicStorage {
         }
         return result;
     }
-    void wait(Val expected) const noexcept {
+    bool compare_exchange_weak(
+    Val& expected, const Val desired, MemoryOrder success = MemoryOrder::SeqCst,
+    MemoryOrder failure = MemoryOrder::SeqCst
+    ) noexcept {
+        return compare_exchange_strong(expected, desired, success, failure);
+    }
+    void wait(Val expected, MemoryOrder = MemoryOrder::SeqCst) const noexcept {
         const auto storage_ptr  = addressof(m_storage);
         const auto expected_ptr = addressof(expected);
         while (true) {
@@ -183,93 +245,176 @@ struct AtomicStorage<T> {
     using Val  = RemoveReferenceT<T>;
     T m_storage;
 
+    template <bool Weak>
+    bool compare_exchange(Val& expected, const Val desired, MemoryOrder success, MemoryOrder failure) noexcept {
+        const auto [mem, bytes] = storage_and_bytes<Conv>(m_storage, desired);
+        Conv expected_bytes     = reinterpret_cast_atomic<Conv>(expected);
+        if (atomic_compare_exchange_nolock<Weak>(mem, expected_bytes, bytes, success, failure)) return true;
+        reinterpret_cast<Conv&>(expected) = expected_bytes;
+        return false;
+    }
+
     public:
     AtomicStorage() = default;
     constexpr AtomicStorage(ConditionalT<IsReference<T>::value, T, const Val> value) noexcept : m_storage(value) {}
-    void store(const Val value) noexcept {
+    void store(const Val value, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
         const auto [mem, bytes] = storage_and_bytes<Conv>(m_storage, value);
-        atomic_store_nolock(mem, bytes);
+        atomic_store_nolock(mem, bytes, order);
     }
-    Val load() const noexcept {
-        const auto mem = addressof_atomic<Conv>(m_storage);
-        Conv bytes     = atomic_load_nolock(mem);
-        memory_barrier();
+    Val load(MemoryOrder order = MemoryOrder::SeqCst) const noexcept {
+        Conv bytes = atomic_load_nolock(addressof_atomic<Conv>(m_storage), order);
         return reinterpret_cast<Val&>(bytes);
     }
-    Val exchange(const Val value) noexcept {
+    Val exchange(const Val value, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
         const auto [mem, bytes] = storage_and_bytes<Conv>(m_storage, value);
-        Conv result             = atomic_exchange_nolock(mem, bytes);
+        Conv result             = atomic_exchange_nolock(mem, bytes, order);
         return reinterpret_cast<Val&>(result);
     }
     bool is_lock_free() const noexcept { return true; }
-    bool compare_exchange_strong(Val& expected, const Val desired) noexcept {
-        const auto [mem, bytes] = storage_and_bytes<Conv>(m_storage, desired);
-        Conv expected_bytes     = reinterpret_cast_atomic<Conv>(expected);
-        Conv prev_bytes         = atomic_compare_exchange_nolock(mem, bytes, expected_bytes);
-        if (prev_bytes == expected_bytes) return true;
-        reinterpret_cast<Conv&>(expected) = prev_bytes;
-        return false;
+    bool compare_exchange_strong(
+    Val& expected, const Val desired, MemoryOrder success = MemoryOrder::SeqCst,
+    MemoryOrder failure = MemoryOrder::SeqCst
+    ) noexcept {
+        return compare_exchange<false>(expected, desired, success, failure);
+    }
+    bool compare_exchange_weak(
+    Val& expected, const Val desired, MemoryOrder success = MemoryOrder::SeqCst,
+    MemoryOrder failure = MemoryOrder::SeqCst
+    ) noexcept {
+        return compare_exchange<true>(expected, desired, success, failure);
     }
-    void wait(Val expected) const noexcept {
+    void wait(Val expected, MemoryOrder order = MemoryOrder::SeqCst) const noexcept {
         auto storage        = addressof(m_storage);
         auto expected_bytes = reinterpret_cast_atomic<Conv>(expected);
         while (true) {
-            const Conv observed_bytes = reinterpret_cast_atomic<Conv>(load());
+            const Conv observed_bytes = reinterpret_cast_atomic<Conv>(load(order));
             if (expected_bytes != observed_bytes) { return; }
-            atomic_wait_nolock(const_cast<T*>(storage), &expected_bytes, 0xFFFFFFFF);
+            if constexpr (TYPE_SIZE == sizeof(int)) {
+                atomic_wait_nolock(const_cast<T*>(storage), &expected_bytes, 0xFFFFFFFF);
+            } else {
+                // futexes only operate on 32-bit words, other sizes can only spin
+                pause_sync();
+            }
         }
     }
     void notify_one() noexcept { atomic_notify_one_nolock(addressof(m_storage)); }
     void notify_all() noexcept { atomic_notify_all_nolock(addressof(m_storage)); }
 };
+#ifdef __x86_64__
+template <typename T>
+requires(sizeof(T) == 16)
+struct AtomicStorage<T> {
+    using Val = RemoveReferenceT<T>;
+    alignas(16) T m_storage;
+    struct Int128 {
+        alignas(16) long long low;
+        long long high;
+    };
+
+    public:
+    AtomicStorage() = default;
+    constexpr AtomicStorage(ConditionalT<IsReference<T&>::value, T&, const Val> value) noexcept : m_storage(value) {}
+    // cmpxchg16b is a full barrier no matter what, the orderings are only accepted for api parity
+    void store(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept { exchange(value); }
+    Val load(MemoryOrder = MemoryOrder::SeqCst) const noexcept {
+        // there's no 16 byte atomic load, a cas with a zero comparand either fails or writes back the same zero
+        auto storage_ptr = const_cast<long long*>(addressof_atomic<const long long>(m_storage));
+        Int128 result{};
+        atomic_compare_exchange_nolock(storage_ptr, 0, 0, &result.low);
+        return reinterpret_cast<Val&>(result);
+    }
+    Val exchange(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept {
+        Val result{ value };
+        while (!compare_exchange_strong(result, value)) {}
+        return result;
+    }
+    bool is_lock_free() const noexcept { return true; }
+    bool compare_exchange_strong(
+    Val& expected, const Val desired, MemoryOrder = MemoryOrder::SeqCst, MemoryOrder = MemoryOrder::SeqCst
+    ) noexcept {
+        Int128 desired_bytes{};
+        ARLib::memcpy(&desired_bytes, addressof(desired), sizeof(Val));
+        Int128 expected_temp{};
+        ARLib::memcpy(&expected_temp, addressof(expected), sizeof(Val));
+        unsigned char result = atomic_compare_exchange_nolock(
+        addressof_atomic<long long>(m_storage), desired_bytes.high, desired_bytes.low, &expected_temp.low
+        );
+        if (result == 0) { ARLib::memcpy(addressof(expected), &expected_temp, sizeof(Val)); }
+        return result != 0;
+    }
+    bool compare_exchange_weak(
+    Val& expected, const Val desired, MemoryOrder success = MemoryOrder::SeqCst,
+    MemoryOrder failure = MemoryOrder::SeqCst
+    ) noexcept {
+        return compare_exchange_strong(expected, desired, success, failure);
+    }
+    void wait(Val expected, MemoryOrder = MemoryOrder::SeqCst) const noexcept {
+        const auto storage_ptr  = addressof(m_storage);
+        const auto expected_ptr = addressof(expected);
+        Int128 expected_bytes   = reinterpret_cast<const Int128&>(expected);
+        for (;;) {
+            const Val observed    = load();
+            Int128 observed_bytes = reinterpret_cast<const Int128&>(observed);
+            if (observed_bytes.low != expected_bytes.low || observed_bytes.high != expected_bytes.high) { return; }
+            atomic_wait_for(storage_ptr, expected_ptr, sizeof(Val), nullptr, &atomic_wait_compare_16, 0xFFFF'FFFF);
+        }
+    }
+    void notify_one() noexcept { atomic_notify_one(addressof(m_storage)); }
+    void notify_all() noexcept { atomic_notify_all(addressof(m_storage)); }
+};
+#endif
 template <Integral T>
 struct AtomicIntegralStorage : public AtomicStorage<T> {
     using Base = AtomicStorage<T>;
     using Val  = typename AtomicStorage<T>::Val;
     using Conv = typename AtomicStorage<T>::Conv;
-    Val fetch_add(const Val operand) noexcept {
+    Val fetch_add(const Val operand, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
         Conv result = atomic_integral_op_nolock(
-        addressof_atomic<Conv>(this->m_storage), static_cast<Conv>(operand), AtomicIntegralOp::ExchAdd
+        addressof_atomic<Conv>(this->m_storage), static_cast<Conv>(operand), AtomicIntegralOp::ExchAdd, order
         );
         return static_cast<Val>(result);
     }
-    Val fetch_and(const Val operand) noexcept {
+    Val fetch_and(const Val operand, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
         Conv result = atomic_integral_op_nolock(
-        addressof_atomic<Conv>(this->m_storage), static_cast<Conv>(operand), AtomicIntegralOp::And
+        addressof_atomic<Conv>(this->m_storage), static_cast<Conv>(operand), AtomicIntegralOp::And, order
         );
         return static_cast<Val>(result);
     }
-    Val fetch_or(const Val operand) noexcept {
+    Val fetch_or(const Val operand, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
         Conv result = atomic_integral_op_nolock(
-        addressof_atomic<Conv>(this->m_storage), static_cast<Conv>(operand), AtomicIntegralOp::Or
+        addressof_atomic<Conv>(this->m_storage), static_cast<Conv>(operand), AtomicIntegralOp::Or, order
         );
         return static_cast<Val>(result);
     }
-    Val fetch_xor(const Val operand) noexcept {
+    Val fetch_xor(const Val operand, MemoryOrder order = MemoryOrder::SeqCst) noexcept {
         Conv result = atomic_integral_op_nolock(
-        addressof_atomic<Conv>(this->m_storage), static_cast<Conv>(operand), AtomicIntegralOp::Xor
+        addressof_atomic<Conv>(this->m_storage), static_cast<Conv>(operand), AtomicIntegralOp::Xor, order
         );
         return static_cast<Val>(result);
     }
     Val operator++(int) noexcept {
-        Conv after = atomic_integral_op_nolock(addressof_atomic<Conv>(this->m_storage), 1, AtomicIntegralOp::Inc);
+        Conv after = atomic_integral_op_nolock(
+        addressof_atomic<Conv>(this->m_storage), Conv{ 1 }, AtomicIntegralOp::Inc, MemoryOrder::SeqCst
+        );
         ++after;
         return static_cast<Val>(after);
     }
     Val operator++() noexcept {
-        return static_cast<Val>(
-        atomic_integral_op_nolock(addressof_atomic<Conv>(this->m_storage), 1, AtomicIntegralOp::Inc)
-        );
+        return static_cast<Val>(atomic_integral_op_nolock(
+        addressof_atomic<Conv>(this->m_storage), Conv{ 1 }, AtomicIntegralOp::Inc, MemoryOrder::SeqCst
+        ));
     }
     Val operator--(int) noexcept {
-        Conv after = atomic_integral_op_nolock(addressof_atomic<Conv>(this->m_storage), -1, AtomicIntegralOp::Dec);
+        Conv after = atomic_integral_op_nolock(
+        addressof_atomic<Conv>(this->m_storage), Conv{ -1 }, AtomicIntegralOp::Dec, MemoryOrder::SeqCst
+        );
         --after;
         return static_cast<Val>(after);
     }
     Val operator--() noexcept {
-        return static_cast<Val>(
-        atomic_integral_op_nolock(addressof_atomic<Conv>(this->m_storage), -1, AtomicIntegralOp::Dec)
-        );
+        return static_cast<Val>(atomic_integral_op_nolock(
+        addressof_atomic<Conv>(this->m_storage), Conv{ -1 }, AtomicIntegralOp::Dec, MemoryOrder::SeqCst
+        ));
     }
 };
 }    // namespace ARLib
@@ -27,12 +27,12 @@ struct AtomicTypeProvider {
 template <typename T>
 struct AtomicTypeProvider<T&> {
     using Storage = T&;
-    using Lock    = SharedMutex;
+    using Lock    = SharedMutexHandle;
 };
 void atomic_lock_acquire(long& lock);
-void atomic_lock_acquire(SharedMutex* lock);
+void atomic_lock_acquire(SharedMutexHandle* lock);
 void atomic_lock_release(long& lock);
-void atomic_lock_release(SharedMutex* lock);
+void atomic_lock_release(SharedMutexHandle* lock);
 template <typename Lock>
 bool __stdcall atomic_wait_compare(const void* storage, void* cmp, size_t size, void* raw) {
     Lock& lock = *static_cast<Lock*>(raw);
@@ -106,6 +106,10 @@ short atomic_integral_op_nolock(volatile short* addr, short value, AtomicIntegra
 int atomic_integral_op_nolock(volatile int* addr, int value, AtomicIntegralOp op_type);
 long long atomic_integral_op_nolock(volatile long long* addr, long long value, AtomicIntegralOp op_type);
 
+// the interlocked intrinsics are all full barriers, so the only orderings that make a difference here
+// are relaxed loads (no compiler barrier) and fences
+enum class MemoryOrder { Relaxed, Consume, Acquire, Release, AcqRel, SeqCst };
+void atomic_thread_fence(MemoryOrder order);
 void memory_barrier();
 void pause_sync();
 template <typename Lock>
@@ -128,23 +132,25 @@ struct AtomicStorage {
     AtomicStorage() = default;
     constexpr AtomicStorage(ConditionalT<IsReference<T>::value, T, const Val> value) noexcept :
         m_storage(value), m_lock{} {}
-    void store(const Val value) noexcept {
+    void store(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         GuardType lock{ m_lock };
         m_storage = value;
     }
-    Val load() const noexcept {
+    Val load(MemoryOrder = MemoryOrder::SeqCst) const noexcept {
         GuardType lock{ m_lock };
         Val local{ m_storage };
         return local;
     }
-    Val exchange(const Val value) noexcept {
+    Val exchange(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         GuardType lock{ m_lock };
         Val result{ m_storage };
         m_storage = value;
         return result;
     }
     bool is_lock_free() const noexcept { return false; }
-    bool compare_exchange_strong(Val& expected, const Val desired) noexcept {
+    bool compare_exchange_strong(
+    Val& expected, const Val desired, MemoryOrder = MemoryOrder::SeqCst, MemoryOrder = MemoryOrder::SeqCst
+    ) noexcept {
         const auto storage_ptr  = addressof(m_storage);
         const auto expected_ptr = addressof(expected);
         bool result;
@@ -157,7 +163,13 @@ struct AtomicStorage {
         }
         return result;
     }
-    void wait(Val expected) const noexcept {
+    bool compare_exchange_weak(
+    Val& expected, const Val desired, MemoryOrder success = MemoryOrder::SeqCst,
+    MemoryOrder failure = MemoryOrder::SeqCst
+    ) noexcept {
+        return compare_exchange_strong(expected, desired, success, failure);
+    }
+    void wait(Val expected, MemoryOrder = MemoryOrder::SeqCst) const noexcept {
         const auto storage_ptr  = addressof(m_storage);
         const auto expected_ptr = addressof(expected);
         while (true) {
@@ -198,23 +210,25 @@ struct AtomicStorage<T> {
     public:
     AtomicStorage() = default;
     constexpr AtomicStorage(ConditionalT<IsReference<T>::value, T, const Val> value) noexcept : m_storage(value) {}
-    void store(const Val value) noexcept {
+    void store(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         const auto [mem, bytes] = storage_and_bytes<Conv>(m_storage, value);
         atomic_store_nolock(mem, bytes);
     }
-    Val load() const noexcept {
+    Val load(MemoryOrder order = MemoryOrder::SeqCst) const noexcept {
         const auto mem = addressof_atomic<Conv>(m_storage);
         Conv bytes     = atomic_load_nolock(mem);
-        memory_barrier();
+        if (order != MemoryOrder::Relaxed) { memory_barrier(); }
         return reinterpret_cast<Val&>(bytes);
     }
-    Val exchange(const Val value) noexcept {
+    Val exchange(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         const auto [mem, bytes] = storage_and_bytes<Conv>(m_storage, value);
         Conv result             = atomic_exchange_nolock(mem, bytes);
         return reinterpret_cast<Val&>(result);
     }
     bool is_lock_free() const noexcept { return true; }
-    bool compare_exchange_strong(Val& expected, const Val desired) noexcept {
+    bool compare_exchange_strong(
+    Val& expected, const Val desired, MemoryOrder = MemoryOrder::SeqCst, MemoryOrder = MemoryOrder::SeqCst
+    ) noexcept {
         const auto [mem, bytes] = storage_and_bytes<Conv>(m_storage, desired);
         Conv expected_bytes     = reinterpret_cast_atomic<Conv>(expected);
         Conv prev_bytes         = atomic_compare_exchange_nolock(mem, bytes, expected_bytes);
@@ -222,11 +236,17 @@ struct AtomicStorage<T> {
         reinterpret_cast<Conv&>(expected) = prev_bytes;
         return false;
     }
-    void wait(Val expected) const noexcept {
+    bool compare_exchange_weak(
+    Val& expected, const Val desired, MemoryOrder success = MemoryOrder::SeqCst,
+    MemoryOrder failure = MemoryOrder::SeqCst
+    ) noexcept {
+        return compare_exchange_strong(expected, desired, success, failure);
+    }
+    void wait(Val expected, MemoryOrder order = MemoryOrder::SeqCst) const noexcept {
         const auto storage  = addressof(m_storage);
         auto expected_bytes = reinterpret_cast_atomic<Conv>(expected);
         while (true) {
-            const Conv observed_bytes = reinterpret_cast_atomic<Conv>(load());
+            const Conv observed_bytes = reinterpret_cast_atomic<Conv>(load(order));
             if (expected_bytes != observed_bytes) { return; }
             atomic_wait_nolock(
             reinterpret_cast<volatile void*>(const_cast<T*>(storage)), &expected_bytes, sizeof(Conv), 0xFFFFFFFF
@@ -240,7 +260,7 @@ template <typename T>
 requires(sizeof(T) == 16)
 struct AtomicStorage<T> {
     using Val = RemoveReferenceT<T>;
-    T m_storage;
+    alignas(16) T m_storage;
     struct Int128 {
         alignas(16) long long low;
         long long high;
@@ -249,20 +269,22 @@ struct AtomicStorage<T> {
     public:
     AtomicStorage() = default;
     constexpr AtomicStorage(ConditionalT<IsReference<T&>::value, T&, const Val> value) noexcept : m_storage(value) {}
-    void store(const Val value) noexcept { exchange(value); }
-    Val load() const noexcept {
+    void store(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept { exchange(value); }
+    Val load(MemoryOrder = MemoryOrder::SeqCst) const noexcept {
         auto storage_ptr = const_cast<long long*>(addressof_atomic<const long long>(m_storage));
         Int128 result{};
         atomic_compare_exchange_nolock(storage_ptr, 0, 0, &result.low);
         return reinterpret_cast<Val&>(result);
     }
-    Val exchange(const Val value) noexcept {
+    Val exchange(const Val value, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         Val result{ value };
         while (!compare_exchange_strong(result, value)) {}
         return result;
     }
     bool is_lock_free() const noexcept { return true; }
-    bool compare_exchange_strong(Val& expected, const Val desired) noexcept {
+    bool compare_exchange_strong(
+    Val& expected, const Val desired, MemoryOrder = MemoryOrder::SeqCst, MemoryOrder = MemoryOrder::SeqCst
+    ) noexcept {
         Int128 desired_bytes{};
         ARLib::memcpy(&desired_bytes, addressof(desired), sizeof(Val));
         Int128 expected_temp{};
@@ -273,7 +295,13 @@ struct AtomicStorage<T> {
         if (result == 0) { ARLib::memcpy(addressof(expected), &expected_temp, sizeof(Val)); }
         return result != 0;
     }
-    void wait(Val expected) const noexcept {
+    bool compare_exchange_weak(
+    Val& expected, const Val desired, MemoryOrder success = MemoryOrder::SeqCst,
+    MemoryOrder failure = MemoryOrder::SeqCst
+    ) noexcept {
+        return compare_exchange_strong(expected, desired, success, failure);
+    }
+    void wait(Val expected, MemoryOrder = MemoryOrder::SeqCst) const noexcept {
         const auto storage_ptr  = addressof(m_storage);
         const auto expected_ptr = addressof(expected);
         Int128 expected_bytes   = reinterpret_cast<const Int128&>(expected);
@@ -292,21 +320,21 @@ struct AtomicIntegralStorage : public AtomicStorage<T> {
     using Base = AtomicStorage<T>;
     using Val  = typename AtomicStorage<T>::Val;
     using Conv = typename AtomicStorage<T>::Conv;
-    Val fetch_add(const Val operand) noexcept {
+    Val fetch_add(const Val operand, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         Conv result =
         atomic_integral_op_nolock(addressof_atomic<Conv>(this->m_storage), operand, AtomicIntegralOp::ExchAdd);
         return static_cast<Val>(result);
     }
-    Val fetch_and(const Val operand) noexcept {
+    Val fetch_and(const Val operand, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         Conv result =
         atomic_integral_op_nolock(addressof_atomic<Conv>(this->m_storage), operand, AtomicIntegralOp::And);
         return static_cast<Val>(result);
     }
-    Val fetch_or(const Val operand) noexcept {
+    Val fetch_or(const Val operand, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         Conv result = atomic_integral_op_nolock(addressof_atomic<Conv>(this->m_storage), operand, AtomicIntegralOp::Or);
         return static_cast<Val>(result);
     }
-    Val fetch_xor(const Val operand) noexcept {
+    Val fetch_xor(const Val operand, MemoryOrder = MemoryOrder::SeqCst) noexcept {
         Conv result =
         atomic_integral_op_nolock(addressof_atomic<Conv>(this->m_storage), operand, AtomicIntegralOp::Xor);
         return static_cast<Val>(result);
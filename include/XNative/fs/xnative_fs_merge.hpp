@@ -14,9 +14,11 @@ namespace ARLib {
 using NativeDirectoryIterator = UnixDirectoryIterator;
 using NativeDirectoryIterate  = UnixDirectoryIterate;
 using NativeFileInfo          = UnixFileInfo;
+using NativeMappedFile        = UnixMappedFile;
 #else
 using NativeDirectoryIterator = Win32DirectoryIterator;
 using NativeDirectoryIterate  = Win32DirectoryIterate;
 using NativeFileInfo          = Win32FileInfo;
+using NativeMappedFile        = Win32MappedFile;
 #endif
 }    // namespace ARLib
\ No newline at end of file
@@ -111,5 +111,30 @@ class UnixDirectoryIterator {
     UnixDirectoryIterator& operator++();
     ~UnixDirectoryIterator();
 };
+// a whole file mapped read-only, see MappedFile
+class UnixMappedFile {
+    void* m_address = nullptr;
+    size_t m_size   = 0;
+
+    public:
+    UnixMappedFile()                                 = default;
+    UnixMappedFile(const UnixMappedFile&)            = delete;
+    UnixMappedFile& operator=(const UnixMappedFile&) = delete;
+    UnixMappedFile(UnixMappedFile&& other) noexcept : m_address(other.m_address), m_size(other.m_size) {
+        other.m_address = nullptr;
+        other.m_size    = 0;
+    }
+    UnixMappedFile& operator=(UnixMappedFile&& other) noexcept;
+    // false when the file can't be opened or mapped, last_error() has the reason
+    bool map(const Path& path, bool populate, bool huge_pages);
+    void advise_normal();
+    void advise_sequential();
+    void advise_random();
+    void will_need(size_t offset, size_t size);
+    void unmap();
+    const uint8_t* data() const { return static_cast<const uint8_t*>(m_address); }
+    size_t size() const { return m_size; }
+    ~UnixMappedFile() { unmap(); }
+};
 }    // namespace ARLib
 #endif
@@ -175,5 +175,30 @@ struct PrintInfo<Win32DirectoryIterator> {
         return (*m_iter).path().narrow();
     }
 };
+// a whole file mapped read-only, see MappedFile
+class Win32MappedFile {
+    void* m_address = nullptr;
+    size_t m_size   = 0;
+
+    public:
+    Win32MappedFile()                                  = default;
+    Win32MappedFile(const Win32MappedFile&)            = delete;
+    Win32MappedFile& operator=(const Win32MappedFile&) = delete;
+    Win32MappedFile(Win32MappedFile&& other) noexcept : m_address(other.m_address), m_size(other.m_size) {
+        other.m_address = nullptr;
+        other.m_size    = 0;
+    }
+    Win32MappedFile& operator=(Win32MappedFile&& other) noexcept;
+    // false when the file can't be opened or mapped, last_error() has the reason
+    bool map(const Path& path, bool populate, bool huge_pages);
+    void advise_normal();
+    void advise_sequential();
+    void advise_random();
+    void will_need(size_t offset, size_t size);
+    void unmap();
+    const uint8_t* data() const { return static_cast<const uint8_t*>(m_address); }
+    size_t size() const { return m_size; }
+    ~Win32MappedFile() { unmap(); }
+};
 }    // namespace ARLib
 #endif
@@ -65,6 +65,7 @@ class ThreadNative {
     static void set_id(ThreadT&, ThreadId);
     static void swap(ThreadT&, ThreadT&);
     static void sleep(Micros micros);
+    static unsigned int hardware_concurrency();
     TEMPLATE
     static RetVal retval_create(ARGS_DECL) {
     #ifdef UNIX_OR_MINGW
@@ -213,6 +213,7 @@ enum class PthreadCancelType { DEFERRED, ASYNCHRONOUS };
         #define ARLIB_PTHREAD_CANCELED (void*)(-1)
 
 int pthread_sleep(int64_t millis);
+unsigned int pthread_hardware_concurrency();
 int pthread_attr_destroy(PthreadAttr*);
 int pthread_attr_getdetachstate(const PthreadAttr*, int*);
         #ifndef ON_MINGW
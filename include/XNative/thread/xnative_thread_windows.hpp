@@ -31,7 +31,7 @@ using MutexHandle = mutex_internal_imp_t*;
 
 using CondHandle = cnd_internal_imp_t*;
 
-using SharedMutex = void*;
+using SharedMutexHandle = void*;
 
 enum class ThreadState { Success, Nomem, Timeout, Busy, Error };
 enum class MutexType { None = 0x00, Plain = 0x01, Try = 0x02, Timed = 0x04, Recursive = 0x100 };
@@ -58,12 +58,12 @@ void* __cdecl mutex_getconcrtcs(MutexHandle);
 void __cdecl mutex_clear_owner(MutexHandle);
 void __cdecl mutex_reset_owner(MutexHandle);
 
-void __cdecl sharedmutex_lock_exclusive(SharedMutex*);
-void __cdecl sharedmutex_lock_shared(SharedMutex*);
-int __cdecl sharedmutex_try_lock_exclusive(SharedMutex*);
-int __cdecl sharedmutex_try_lock_shared(SharedMutex*);
-void __cdecl sharedmutex_unlock_exclusive(SharedMutex*);
-void __cdecl sharedmutex_unlock_shared(SharedMutex*);
+void __cdecl sharedmutex_lock_exclusive(SharedMutexHandle*);
+void __cdecl sharedmutex_lock_shared(SharedMutexHandle*);
+int __cdecl sharedmutex_try_lock_exclusive(SharedMutexHandle*);
+int __cdecl sharedmutex_try_lock_shared(SharedMutexHandle*);
+void __cdecl sharedmutex_unlock_exclusive(SharedMutexHandle*);
+void __cdecl sharedmutex_unlock_shared(SharedMutexHandle*);
 
 ThreadState __cdecl cond_init(CondHandle*);
 void __cdecl cond_destroy(CondHandle);
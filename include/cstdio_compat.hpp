@@ -72,6 +72,8 @@ int fclose(FILE* fp);
 int fseek(FILE* fp, long off, int whence);
 size_t ftell(FILE* fp);
 size_t fread(void* buffer, size_t size, size_t count, FILE* fp);
+// nonzero if a read or write on fp failed
+int ferror(FILE* fp);
 size_t fwrite(const void* buffer, size_t size, size_t count, FILE* fp);
 int puts(const char* buf);
 int fputs(const char* buf, FILE* fp);
@@ -0,0 +1,199 @@
+#include "AhoCorasick.hpp"
+#include "BitOps.hpp"
+#include <immintrin.h>
+namespace ARLib {
+AhoCorasick::AhoCorasick(Span<const StringView> patterns) {
+    // every byte that's in a pattern gets its own class, class 0 is everything else. when all 256 bytes show up the
+    // last one gets class 0, there's nothing else left in it
+    bool seen[256]{};
+    size_t class_count = 1;
+    for (const auto& pattern : patterns) {
+        for (char c : pattern) {
+            const auto byte = static_cast<uint8_t>(c);
+            if (seen[byte]) continue;
+            seen[byte]         = true;
+            m_byte_class[byte] = static_cast<uint8_t>(class_count++);
+        }
+    }
+    m_stride = class_count > 256 ? 256 : class_count;
+    // the trie, transitions are state indices while building
+    m_transitions.resize(m_stride);
+    for (auto& next : m_transitions) next = none;
+    size_t states = 1;
+    Vector<uint32_t> end_state{};
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        const auto& pattern = patterns[i];
+        m_sizes.append(static_cast<uint32_t>(pattern.size()));
+        if (pattern.size() == 0) {
+            m_empty.append(static_cast<uint32_t>(i));
+            end_state.append(none);
+            continue;
+        }
+        const bool new_first = [&] {
+            for (size_t j = 0; j < m_first_byte_count; ++j) {
+                if (m_first_bytes[j] == static_cast<uint8_t>(pattern[0])) return false;
+            }
+            return true;
+        }();
+        if (new_first) {
+            if (m_first_byte_count < 3) m_first_bytes[m_first_byte_count] = static_cast<uint8_t>(pattern[0]);
+            ++m_first_byte_count;
+        }
+        uint32_t state = 0;
+        for (char c : pattern) {
+            uint32_t& next = m_transitions[state * m_stride + m_byte_class[static_cast<uint8_t>(c)]];
+            if (next == none) {
+                next = static_cast<uint32_t>(states++);
+                for (size_t j = 0; j < m_stride; ++j) m_transitions.append(none);
+            }
+            state = m_transitions[state * m_stride + m_byte_class[static_cast<uint8_t>(c)]];
+        }
+        end_state.append(state);
+    }
+    if (m_first_byte_count > 3) m_first_byte_count = 0;
+    for (size_t j = m_first_byte_count; j < 3 && m_first_byte_count != 0; ++j) m_first_bytes[j] = m_first_bytes[0];
+    // the patterns that end in every state, grouped by state
+    m_output_begin.resize(states + 1);
+    for (uint32_t state : end_state) {
+        if (state != none) ++m_output_begin[state + 1];
+    }
+    for (size_t state = 0; state < states; ++state) m_output_begin[state + 1] += m_output_begin[state];
+    m_outputs.resize(m_output_begin[states]);
+    {
+        Vector<uint32_t> filled{};
+        filled.resize(states);
+        for (size_t i = 0; i < end_state.size(); ++i) {
+            const uint32_t state = end_state[i];
+            if (state == none) continue;
+            m_outputs[m_output_begin[state] + filled[state]++] = static_cast<uint32_t>(i);
+        }
+    }
+    auto has_outputs = [this](uint32_t state) { return m_output_begin[state] != m_output_begin[state + 1]; };
+    // breadth first, so the failure state of every state is complete before the state itself is looked at.
+    // a missing transition is the transition of the failure state
+    Vector<uint32_t> failure{};
+    failure.resize(states);
+    m_dictionary.resize(states);
+    m_dictionary[0] = none;
+    Vector<uint32_t> queue{};
+    for (size_t c = 0; c < m_stride; ++c) {
+        uint32_t& next = m_transitions[c];
+        if (next == none) {
+            next = 0;
+        } else {
+            m_dictionary[next] = none;
+            queue.append(next);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint32_t state = queue[head];
+        for (size_t c = 0; c < m_stride; ++c) {
+            const uint32_t fallback = m_transitions[failure[state] * m_stride + c];
+            uint32_t& next          = m_transitions[state * m_stride + c];
+            if (next == none) {
+                next = fallback;
+                continue;
+            }
+            failure[next]      = fallback;
+            m_dictionary[next] = has_outputs(fallback) ? fallback : m_dictionary[fallback];
+            queue.append(next);
+        }
+    }
+    // state indices to rows with flags
+    const bool skipping = m_first_byte_count != 0;
+    for (auto& next : m_transitions) {
+        const uint32_t state = next;
+        next                 = static_cast<uint32_t>(state * m_stride);
+        if (has_outputs(state) || m_dictionary[state] != none) next |= match_flag;
+        if (state == 0 && skipping) next |= root_flag;
+    }
+}
+size_t AhoCorasick::skip(const uint8_t* bytes, size_t pos, size_t size) const {
+    const uint8_t first  = m_first_bytes[0];
+    const uint8_t second = m_first_bytes[1];
+    const uint8_t third  = m_first_bytes[2];
+#ifdef __AVX2__
+    const auto firsts  = _mm256_set1_epi8(static_cast<char>(first));
+    const auto seconds = _mm256_set1_epi8(static_cast<char>(second));
+    const auto thirds  = _mm256_set1_epi8(static_cast<char>(third));
+    for (; pos + 32 <= size; pos += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + pos));
+        const auto found = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, firsts), _mm256_cmpeq_epi8(chunk, seconds)),
+            _mm256_cmpeq_epi8(chunk, thirds)
+        );
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(found));
+        if (mask != 0) return pos + internal::trailing_zeros(mask);
+    }
+#endif
+    for (; pos < size; ++pos) {
+        const uint8_t c = bytes[pos];
+        if (c == first || c == second || c == third) return pos;
+    }
+    return size;
+}
+// calls on_match(pattern, end) for every occurrence until it returns false
+template <typename Func>
+void AhoCorasick::search(StringView text, Func&& on_match) const {
+    for (uint32_t pattern : m_empty) {
+        if (!on_match(pattern, size_t{ 0 })) return;
+    }
+    if (m_stride == 0) return;
+    const auto* bytes      = reinterpret_cast<const uint8_t*>(text.data());
+    const size_t size      = text.size();
+    const uint32_t* table  = &m_transitions[0];
+    const uint8_t* classes = m_byte_class;
+    const bool skipping    = m_first_byte_count != 0;
+    size_t pos             = 0;
+    uint32_t row           = 0;
+    while (pos < size) {
+        if (skipping && row == 0) {
+            pos = skip(bytes, pos, size);
+            if (pos == size) return;
+        }
+        // the hot loop, one lookup per byte until a pattern ends or the root shows up again
+        uint32_t next = 0;
+        while (pos < size) {
+            next = table[row + classes[bytes[pos++]]];
+            row  = next & ~special_mask;
+            if (next & special_mask) break;
+        }
+        if (!(next & match_flag)) continue;
+        uint32_t state = static_cast<uint32_t>(row / m_stride);
+        if (m_output_begin[state] == m_output_begin[state + 1]) state = m_dictionary[state];
+        for (; state != none; state = m_dictionary[state]) {
+            for (size_t i = m_output_begin[state]; i < m_output_begin[state + 1]; ++i) {
+                if (!on_match(m_outputs[i], pos)) return;
+            }
+        }
+    }
+}
+bool AhoCorasick::contains(StringView text) const {
+    bool found = false;
+    search(text, [&](uint32_t, size_t) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+Vector<AhoCorasickMatch> AhoCorasick::find_all(StringView text) const {
+    Vector<AhoCorasickMatch> matches{};
+    search(text, [&](uint32_t pattern, size_t end) {
+        matches.append(AhoCorasickMatch{ pattern, end - m_sizes[pattern], end });
+        return true;
+    });
+    return matches;
+}
+void AhoCorasick::which(StringView text, Vector<size_t>& patterns) const {
+    patterns.clear_retain();
+    if (m_seen.size() < pattern_count()) m_seen.resize(pattern_count());
+    search(text, [&](uint32_t pattern, size_t) {
+        if (m_seen[pattern] == 0) {
+            m_seen[pattern] = 1;
+            patterns.append(pattern);
+        }
+        return patterns.size() != pattern_count();
+    });
+    for (size_t pattern : patterns) m_seen[pattern] = 0;
+}
+}    // namespace ARLib
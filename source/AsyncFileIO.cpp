@@ -0,0 +1,597 @@
+#ifndef DISABLE_THREADING
+    #include "AsyncFileIO.hpp"
+    #include "SharedPtr.hpp"
+    #include "ThreadPool.hpp"
+    #ifdef UNIX
+        #include <errno.h>
+        #include <fcntl.h>
+        #include <string.h>
+        #include <sys/stat.h>
+        #include <unistd.h>
+        #if __has_include(<linux/io_uring.h>)
+            #include <linux/io_uring.h>
+            #include <sys/mman.h>
+            #include <sys/syscall.h>
+            #include <sys/uio.h>
+            #define ARLIB_HAS_IO_URING
+        #endif
+    #elif defined(WINDOWS)
+        #include <Windows.h>
+    #endif
+namespace ARLib {
+namespace detail {
+    // what a single read(2)/write(2) moves at most on linux, bigger requests would be cut short by the kernel
+    constexpr size_t max_transfer_size = 0x7FFFF000;
+    #ifdef UNIX
+    static int64_t native_open(const Path& path, OpenFileMode mode) {
+        int flags = O_CLOEXEC;
+        switch (mode) {
+            case OpenFileMode::Write:
+                flags |= O_WRONLY | O_CREAT | O_TRUNC;
+                break;
+            case OpenFileMode::ReadWrite:
+                flags |= O_RDWR | O_CREAT;
+                break;
+            case OpenFileMode::Append:
+                flags |= O_WRONLY | O_CREAT | O_APPEND;
+                break;
+            default:
+                flags |= O_RDONLY;
+                break;
+        }
+        return ::open(path.string().data(), flags, 0644);
+    }
+    static void native_close(int64_t handle) {
+        ::close(static_cast<int>(handle));
+    }
+    static uint64_t native_size(int64_t handle) {
+        struct stat info {};
+        if (::fstat(static_cast<int>(handle), &info) != 0) return 0;
+        return static_cast<uint64_t>(info.st_size);
+    }
+    // moves the whole request unless the file ends first, returns the error
+    static int native_transfer(const AsyncIORequest& request, size_t& done) {
+        const int fd = static_cast<int>(request.handle);
+        done         = 0;
+        while (done < request.size) {
+            const auto offset = static_cast<off_t>(request.offset + done);
+            const ssize_t ret = request.op == AsyncIOOp::Read
+                              ? ::pread(fd, request.data + done, request.size - done, offset)
+                              : ::pwrite(fd, request.data + done, request.size - done, offset);
+            if (ret < 0) {
+                if (errno == EINTR) continue;
+                return errno;
+            }
+            if (ret == 0) break;
+            done += static_cast<size_t>(ret);
+        }
+        return 0;
+    }
+    static String error_message(int error) {
+        return String{ ::strerror(error) };
+    }
+    #else
+    static int64_t native_open(const Path& path, OpenFileMode mode) {
+        DWORD access      = GENERIC_READ;
+        DWORD disposition = OPEN_EXISTING;
+        switch (mode) {
+            case OpenFileMode::Write:
+                access      = GENERIC_WRITE;
+                disposition = CREATE_ALWAYS;
+                break;
+            case OpenFileMode::ReadWrite:
+                access      = GENERIC_READ | GENERIC_WRITE;
+                disposition = OPEN_ALWAYS;
+                break;
+            case OpenFileMode::Append:
+                access      = FILE_APPEND_DATA;
+                disposition = OPEN_ALWAYS;
+                break;
+            default:
+                break;
+        }
+        HANDLE file = CreateFileW(
+        path.string().data(), access, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, disposition, FILE_ATTRIBUTE_NORMAL, NULL
+        );
+        return file == INVALID_HANDLE_VALUE ? -1 : reinterpret_cast<intptr_t>(file);
+    }
+    static void native_close(int64_t handle) {
+        CloseHandle(reinterpret_cast<HANDLE>(handle));
+    }
+    static uint64_t native_size(int64_t handle) {
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(reinterpret_cast<HANDLE>(handle), &size)) return 0;
+        return static_cast<uint64_t>(size.QuadPart);
+    }
+    static int native_transfer(const AsyncIORequest& request, size_t& done) {
+        HANDLE file = reinterpret_cast<HANDLE>(request.handle);
+        done        = 0;
+        while (done < request.size) {
+            // the offset goes in the OVERLAPPED, on a handle that wasn't opened for overlapped io the call still
+            // blocks like pread does
+            const uint64_t offset = request.offset + done;
+            OVERLAPPED position{};
+            position.Offset     = static_cast<DWORD>(offset);
+            position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            const auto chunk    = static_cast<DWORD>(request.size - done);
+            DWORD moved         = 0;
+            const BOOL ok       = request.op == AsyncIOOp::Read
+                                ? ReadFile(file, request.data + done, chunk, &moved, &position)
+                                : WriteFile(file, request.data + done, chunk, &moved, &position);
+            if (!ok) {
+                const DWORD error = GetLastError();
+                if (error == ERROR_HANDLE_EOF) break;
+                return static_cast<int>(error);
+            }
+            if (moved == 0) break;
+            done += moved;
+        }
+        return 0;
+    }
+    static String error_message(int error) {
+        SetLastError(static_cast<DWORD>(error));
+        return last_error();
+    }
+    #endif
+    class AsyncIOBackend {
+        public:
+        virtual ~AsyncIOBackend() = default;
+        virtual AsyncIOBackendKind kind() const = 0;
+        // false if the file can't go in the fixed file table, its requests then use the handle
+        virtual bool file_opened(uint32_t, int64_t) { return false; }
+        virtual void file_closed(uint32_t) {}
+        virtual bool register_buffers(Span<const Span<uint8_t>>) { return true; }
+        virtual void unregister_buffers() {}
+        // false if there's no room for the request right now
+        virtual bool queue(const AsyncIORequest& request) = 0;
+        virtual void submit() = 0;
+        // submits what's queued, then appends completions until at least min_completions arrived
+        virtual void reap(size_t min_completions, Vector<AsyncIOCompletion>& completed) = 0;
+    };
+    class ThreadPoolBackend final : public AsyncIOBackend {
+        Vector<AsyncIORequest> m_queued;
+        Vector<AsyncIOCompletion> m_completed;
+        Mutex m_mutex;
+        ConditionVariable m_cv;
+        // last, the workers use the members above until they're joined
+        ThreadPool m_pool;
+
+        public:
+        explicit ThreadPoolBackend(size_t thread_count) : m_pool(thread_count) {}
+        AsyncIOBackendKind kind() const override { return AsyncIOBackendKind::ThreadPool; }
+        bool queue(const AsyncIORequest& request) override {
+            m_queued.append(request);
+            return true;
+        }
+        void submit() override {
+            for (const auto& request : m_queued) {
+                m_pool.submit([this, request]() {
+                    size_t done     = 0;
+                    const int error = native_transfer(request, done);
+                    // notify while holding the lock, the engine can be destroyed as soon as it sees the completion
+                    LockGuard guard{ m_mutex };
+                    m_completed.append(AsyncIOCompletion{ request.user_data, done, error });
+                    m_cv.notify_one();
+                });
+            }
+            m_queued.clear_retain();
+        }
+        void reap(size_t min_completions, Vector<AsyncIOCompletion>& completed) override {
+            submit();
+            UniqueLock lock{ m_mutex };
+            while (m_completed.size() < min_completions) { m_cv.wait(lock); }
+            for (const auto& completion : m_completed) { completed.append(completion); }
+            m_completed.clear_retain();
+        }
+    };
+    #ifdef ARLIB_HAS_IO_URING
+    // the raw interface, there's no liburing to depend on
+    class IoUringBackend final : public AsyncIOBackend {
+        int m_ring             = -1;
+        void* m_rings          = MAP_FAILED;
+        size_t m_ring_size     = 0;
+        io_uring_sqe* m_sqes   = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t m_sqes_size     = 0;
+        unsigned* m_sq_head    = nullptr;
+        unsigned* m_sq_tail    = nullptr;
+        unsigned* m_sq_array   = nullptr;
+        unsigned m_sq_mask     = 0;
+        unsigned m_sq_entries  = 0;
+        unsigned* m_cq_head    = nullptr;
+        unsigned* m_cq_tail    = nullptr;
+        io_uring_cqe* m_cqes   = nullptr;
+        unsigned m_cq_mask     = 0;
+        unsigned m_unsubmitted = 0;
+        bool m_fixed_files     = false;
+        bool m_fixed_buffers   = false;
+
+        int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, m_ring, to_submit, min_complete, flags, nullptr, 0));
+        }
+        int register_op(unsigned opcode, const void* arg, unsigned count) {
+            return static_cast<int>(::syscall(__NR_io_uring_register, m_ring, opcode, arg, count));
+        }
+        template <typename T>
+        T* ring_field(unsigned offset) {
+            return reinterpret_cast<T*>(static_cast<uint8_t*>(m_rings) + offset);
+        }
+        void update_file(uint32_t index, int fd) {
+            io_uring_files_update update{};
+            update.offset = index;
+            update.fds    = reinterpret_cast<uintptr_t>(&fd);
+            if (register_op(IORING_REGISTER_FILES_UPDATE, &update, 1) != 1) m_fixed_files = false;
+        }
+
+        public:
+        IoUringBackend() = default;
+        // false when the kernel doesn't have io_uring, doesn't allow it or is older than 5.6
+        bool setup(uint32_t queue_depth, uint32_t max_files) {
+            io_uring_params params{};
+            m_ring = static_cast<int>(::syscall(__NR_io_uring_setup, queue_depth, &params));
+            if (m_ring < 0) return false;
+            // IORING_OP_READ/WRITE came in 5.6 together with RW_CUR_POS, one mmap for both rings in 5.4
+            if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_RW_CUR_POS)) {
+                return false;
+            }
+            const size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            const size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            m_ring_size          = sq_size > cq_size ? sq_size : cq_size;
+            m_rings = ::mmap(nullptr, m_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, 0);
+            if (m_rings == MAP_FAILED) return false;
+            m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes  = ::mmap(
+            nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES
+            );
+            if (sqes == MAP_FAILED) return false;
+            m_sqes       = static_cast<io_uring_sqe*>(sqes);
+            m_sq_head    = ring_field<unsigned>(params.sq_off.head);
+            m_sq_tail    = ring_field<unsigned>(params.sq_off.tail);
+            m_sq_array   = ring_field<unsigned>(params.sq_off.array);
+            m_sq_mask    = *ring_field<unsigned>(params.sq_off.ring_mask);
+            m_sq_entries = params.sq_entries;
+            m_cq_head    = ring_field<unsigned>(params.cq_off.head);
+            m_cq_tail    = ring_field<unsigned>(params.cq_off.tail);
+            m_cqes       = ring_field<io_uring_cqe>(params.cq_off.cqes);
+            m_cq_mask    = *ring_field<unsigned>(params.cq_off.ring_mask);
+            // the fixed file table starts out empty (-1 everywhere) and is filled in as files are opened, if the
+            // kernel refuses it requests just use the fds
+            if (max_files != 0) {
+                Vector<int> empty{};
+                empty.reserve(max_files);
+                for (uint32_t i = 0; i < max_files; ++i) empty.append(-1);
+                m_fixed_files = register_op(IORING_REGISTER_FILES, empty.data(), max_files) == 0;
+            }
+            return true;
+        }
+        ~IoUringBackend() override {
+            if (m_sqes != MAP_FAILED) ::munmap(m_sqes, m_sqes_size);
+            if (m_rings != MAP_FAILED) ::munmap(m_rings, m_ring_size);
+            // closing the ring drops the registered files and buffers with it
+            if (m_ring >= 0) ::close(m_ring);
+        }
+        AsyncIOBackendKind kind() const override { return AsyncIOBackendKind::IoUring; }
+        bool file_opened(uint32_t index, int64_t handle) override {
+            if (!m_fixed_files) return false;
+            update_file(index, static_cast<int>(handle));
+            return m_fixed_files;
+        }
+        void file_closed(uint32_t index) override {
+            if (m_fixed_files) update_file(index, -1);
+        }
+        bool register_buffers(Span<const Span<uint8_t>> buffers) override {
+            unregister_buffers();
+            if (buffers.size() == 0) return true;
+            Vector<iovec> vecs{};
+            vecs.reserve(buffers.size());
+            for (const auto& buffer : buffers) {
+                vecs.append(iovec{ const_cast<uint8_t*>(buffer.data()), buffer.size() });
+            }
+            const auto count = static_cast<unsigned>(vecs.size());
+            m_fixed_buffers  = register_op(IORING_REGISTER_BUFFERS, vecs.data(), count) == 0;
+            return m_fixed_buffers;
+        }
+        void unregister_buffers() override {
+            if (m_fixed_buffers) register_op(IORING_UNREGISTER_BUFFERS, nullptr, 0);
+            m_fixed_buffers = false;
+        }
+        bool queue(const AsyncIORequest& request) override {
+            // only this thread moves the tail, the kernel moves the head as it consumes entries
+            const unsigned tail = *m_sq_tail;
+            if (tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) == m_sq_entries) return false;
+            const unsigned index = tail & m_sq_mask;
+            io_uring_sqe& sqe    = m_sqes[index];
+            ::memset(&sqe, 0, sizeof(sqe));
+            const bool read = request.op == AsyncIOOp::Read;
+            if (request.buffer_index >= 0 && m_fixed_buffers) {
+                sqe.opcode    = read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+                sqe.buf_index = static_cast<uint16_t>(request.buffer_index);
+            } else {
+                sqe.opcode = read ? IORING_OP_READ : IORING_OP_WRITE;
+            }
+            if (request.registered) {
+                sqe.fd    = static_cast<int>(request.file);
+                sqe.flags = IOSQE_FIXED_FILE;
+            } else {
+                sqe.fd = static_cast<int>(request.handle);
+            }
+            sqe.off           = request.offset;
+            sqe.addr          = reinterpret_cast<uintptr_t>(request.data);
+            sqe.len           = static_cast<uint32_t>(request.size);
+            sqe.user_data     = request.user_data;
+            m_sq_array[index] = index;
+            __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+            ++m_unsubmitted;
+            return true;
+        }
+        void submit() override {
+            while (m_unsubmitted != 0) {
+                const int ret = enter(m_unsubmitted, 0, 0);
+                if (ret < 0) {
+                    if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                    ASSERT_NOT_REACHED("io_uring_enter failed to submit");
+                }
+                m_unsubmitted -= static_cast<unsigned>(ret);
+            }
+        }
+        void reap(size_t min_completions, Vector<AsyncIOCompletion>& completed) override {
+            size_t reaped = 0;
+            while (true) {
+                unsigned head       = *m_cq_head;
+                const unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+                for (; head != tail; ++head) {
+                    const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+                    if (cqe.res < 0) {
+                        completed.append(AsyncIOCompletion{ cqe.user_data, 0, -cqe.res });
+                    } else {
+                        completed.append(AsyncIOCompletion{ cqe.user_data, static_cast<size_t>(cqe.res), 0 });
+                    }
+                    ++reaped;
+                }
+                __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+                if (reaped >= min_completions && m_unsubmitted == 0) return;
+                // submitting and waiting is a single syscall
+                const auto wanted = static_cast<unsigned>(reaped >= min_completions ? 0 : min_completions - reaped);
+                const int ret     = enter(m_unsubmitted, wanted, wanted != 0 ? IORING_ENTER_GETEVENTS : 0);
+                if (ret < 0) {
+                    if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                    ASSERT_NOT_REACHED("io_uring_enter failed to wait for completions");
+                }
+                m_unsubmitted -= static_cast<unsigned>(ret);
+            }
+        }
+    };
+    #endif
+}    // namespace detail
+AsyncFileIO::AsyncFileIO(const AsyncIOOptions& options) :
+    m_queue_depth(options.queue_depth != 0 ? options.queue_depth : 1), m_max_files(options.max_files) {
+    #ifdef ARLIB_HAS_IO_URING
+    if (!options.force_thread_pool) {
+        auto* ring = new detail::IoUringBackend{};
+        if (ring->setup(m_queue_depth, m_max_files)) {
+            m_backend = UniquePtr<detail::AsyncIOBackend>{ ring };
+        } else {
+            delete ring;
+        }
+    }
+    #endif
+    if (!m_backend) {
+        // blocking requests don't keep a core busy, more threads than cores keep more of them in flight
+        size_t thread_count = options.thread_count;
+        if (thread_count == 0) {
+            thread_count = min_bt(size_t{ m_queue_depth }, 4 * size_t{ Thread::hardware_concurrency() });
+        }
+        m_backend = UniquePtr<detail::AsyncIOBackend>{ new detail::ThreadPoolBackend{ thread_count } };
+    }
+}
+AsyncFileIO::~AsyncFileIO() {
+    // the kernel or the pool might still be writing into buffers, wait for them without calling anyone back
+    while (m_in_flight != 0) {
+        m_completed.clear_retain();
+        m_backend->reap(m_in_flight, m_completed);
+        m_in_flight -= m_completed.size();
+    }
+    for (int64_t handle : m_files) {
+        if (handle != -1) detail::native_close(handle);
+    }
+}
+AsyncIOBackendKind AsyncFileIO::backend() const {
+    return m_backend->kind();
+}
+Result<AsyncFileHandle, FileError> AsyncFileIO::open_file(const Path& path, OpenFileMode mode, bool registered) {
+    const int64_t handle = detail::native_open(path, mode);
+    if (handle == -1) return FileError{ last_error(), path };
+    uint32_t index = 0;
+    if (m_free_files.size() != 0) {
+        index = m_free_files.pop();
+    } else {
+        index = static_cast<uint32_t>(m_files.size());
+        m_files.append(-1);
+        m_registered.append(0);
+    }
+    m_files[index]      = handle;
+    m_registered[index] = registered && index < m_max_files && m_backend->file_opened(index, handle);
+    return AsyncFileHandle{ index };
+}
+Result<AsyncFileHandle, FileError> AsyncFileIO::open(const Path& path, OpenFileMode mode) {
+    return open_file(path, mode, true);
+}
+void AsyncFileIO::close(AsyncFileHandle file) {
+    if (m_registered[file.index]) m_backend->file_closed(file.index);
+    detail::native_close(m_files[file.index]);
+    m_files[file.index]      = -1;
+    m_registered[file.index] = 0;
+    m_free_files.append(file.index);
+}
+uint64_t AsyncFileIO::size(AsyncFileHandle file) const {
+    return detail::native_size(m_files[file.index]);
+}
+bool AsyncFileIO::register_buffers(Span<const Span<uint8_t>> buffers) {
+    HARD_ASSERT(m_in_flight == 0, "Buffers can't be registered while requests are in flight");
+    m_buffers.clear_retain();
+    if (!m_backend->register_buffers(buffers)) return false;
+    for (const auto& buffer : buffers) { m_buffers.append(buffer); }
+    return true;
+}
+void AsyncFileIO::unregister_buffers() {
+    HARD_ASSERT(m_in_flight == 0, "Buffers can't be unregistered while requests are in flight");
+    m_backend->unregister_buffers();
+    m_buffers.clear_retain();
+}
+void AsyncFileIO::queue(
+AsyncIOOp op, AsyncFileHandle file, uint64_t offset, uint8_t* data, size_t size, uint64_t user_data
+) {
+    HARD_ASSERT(size <= detail::max_transfer_size, "Requests can't be bigger than 2 GiB - 4 KiB");
+    int32_t buffer_index = -1;
+    const auto begin     = reinterpret_cast<uintptr_t>(data);
+    for (size_t i = 0; i < m_buffers.size(); ++i) {
+        const auto buffer = reinterpret_cast<uintptr_t>(m_buffers[i].data());
+        if (begin >= buffer && begin + size <= buffer + m_buffers[i].size()) {
+            buffer_index = static_cast<int32_t>(i);
+            break;
+        }
+    }
+    const bool registered = m_registered[file.index] != 0;
+    const int64_t handle  = m_files[file.index];
+    m_pending.append(
+    detail::AsyncIORequest{ op, file.index, registered, buffer_index, handle, offset, data, size, user_data }
+    );
+}
+void AsyncFileIO::flush_pending() {
+    while (m_pending_head < m_pending.size() && m_in_flight < m_queue_depth) {
+        if (!m_backend->queue(m_pending[m_pending_head])) break;
+        ++m_pending_head;
+        ++m_in_flight;
+    }
+    if (m_pending_head == m_pending.size()) {
+        m_pending.clear_retain();
+        m_pending_head = 0;
+    }
+}
+size_t AsyncFileIO::complete(size_t min_completions) {
+    m_backend->reap(min_completions, m_completed);
+    m_in_flight -= m_completed.size();
+    // the freed slots are refilled right away, they go to the kernel with the next submit or wait
+    flush_pending();
+    // the handler can queue new requests (or read the next chunk of a file) while the list is being walked
+    auto completed     = move(m_completed);
+    const size_t count = completed.size();
+    if (m_handler && m_loop) {
+        // the callbacks only get the completion and their own copy of the handler, the engine can be gone by the
+        // time the loop runs them
+        using Handler = Function<void(const AsyncIOCompletion&)>;
+        SharedPtr<Handler> handler{ Handler{ m_handler } };
+        for (const auto& completion : completed) {
+            m_loop->subscribe_callback([handler, completion]() { (*handler)(completion); });
+        }
+    } else if (m_handler) {
+        for (const auto& completion : completed) { m_handler(completion); }
+    }
+    completed.clear_retain();
+    m_completed = move(completed);
+    return count;
+}
+size_t AsyncFileIO::submit() {
+    const size_t before = m_in_flight;
+    flush_pending();
+    m_backend->submit();
+    return m_in_flight - before;
+}
+size_t AsyncFileIO::poll() {
+    flush_pending();
+    return complete(0);
+}
+size_t AsyncFileIO::wait(size_t min_completions) {
+    flush_pending();
+    return complete(min_bt(min_completions, m_in_flight));
+}
+void AsyncFileIO::drain() {
+    while (outstanding() != 0) {
+        flush_pending();
+        complete(m_in_flight);
+    }
+}
+Result<Vector<String>, FileError> AsyncFileIO::read_files(Span<const Path> paths) {
+    drain();
+    Vector<String> contents{};
+    contents.resize(paths.size());
+    Vector<AsyncFileHandle> files{};
+    files.resize(paths.size());
+    Vector<size_t> sizes{};
+    sizes.resize(paths.size());
+    Vector<size_t> filled{};
+    filled.resize(paths.size());
+    Vector<uint8_t> open{};
+    open.resize(paths.size());
+    auto user_handler = move(m_handler);
+    auto* user_loop   = m_loop;
+    m_loop            = nullptr;
+    FileError error{};
+    bool failed = false;
+    size_t next = 0;
+    size_t done = 0;
+    auto finish = [&](size_t index) {
+        contents[index].set_size(filled[index]);
+        close(files[index]);
+        open[index] = 0;
+        ++done;
+    };
+    m_handler = [&](const AsyncIOCompletion& completion) {
+        const auto index = static_cast<size_t>(completion.user_data);
+        if (!completion.ok()) {
+            if (!failed) error = FileError{ detail::error_message(completion.error), paths[index] };
+            failed = true;
+            finish(index);
+            return;
+        }
+        filled[index] += completion.bytes;
+        const size_t wanted = sizes[index];
+        if (completion.bytes == 0 || filled[index] >= wanted) {
+            finish(index);
+            return;
+        }
+        // a short read, the rest is asked for like any other request. a file that shrank meanwhile ends with a read
+        // of 0 bytes
+        auto* data = reinterpret_cast<uint8_t*>(contents[index].rawptr());
+        read(files[index], filled[index], Span<uint8_t>{ data + filled[index], wanted - filled[index] }, index);
+    };
+    while (done < paths.size() && !failed) {
+        // files are opened as slots free up, thousands of files don't need thousands of descriptors.
+        // a file that's read once isn't worth a syscall to put it in the fixed file table
+        while (next < paths.size() && outstanding() < m_queue_depth) {
+            auto file = open_file(paths[next], OpenFileMode::Read, false);
+            if (file.is_error()) {
+                error  = move(*file.to_error());
+                failed = true;
+                break;
+            }
+            files[next]     = file.to_ok();
+            open[next]      = 1;
+            const auto size = static_cast<size_t>(this->size(files[next]));
+            sizes[next]     = size;
+            if (size == 0) {
+                finish(next);
+            } else {
+                contents[next].reserve(size);
+                auto* data = reinterpret_cast<uint8_t*>(contents[next].rawptr());
+                // fresh allocations often aren't backed by pages yet, io_uring can't fault them in on the fast path
+                // and retries those reads the slow way, it's cheaper to fault them in here
+                for (size_t page = 0; page < size; page += 4096) data[page] = 0;
+                data[size - 1] = 0;
+                read(files[next], 0, Span<uint8_t>{ data, size }, next);
+            }
+            ++next;
+        }
+        if (outstanding() != 0) wait(1);
+    }
+    // on failure the requests that are still out finish before their buffers go away
+    drain();
+    for (size_t i = 0; i < next; ++i) {
+        if (open[i]) close(files[i]);
+    }
+    m_handler = move(user_handler);
+    m_loop    = user_loop;
+    if (failed) return error;
+    return contents;
+}
+}    // namespace ARLib
+#endif
@@ -0,0 +1,390 @@
+#include "CSVColumns.hpp"
+#include "CharConv.hpp"
+#include "CharConvHelpers.hpp"
+#include "MappedFile.hpp"
+namespace ARLib {
+// days between 1970-01-01 and the given date of the proleptic gregorian calendar
+static int64_t days_from_civil(int64_t year, int64_t month, int64_t day) {
+    year -= month <= 2 ? 1 : 0;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yoe = year - era * 400;
+    const int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+// inverse of days_from_civil
+static void civil_from_days(int64_t days, int64_t& year, int64_t& month, int64_t& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t doe = days - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp  = (5 * doy + 2) / 153;
+    day               = doy - (153 * mp + 2) / 5 + 1;
+    month             = mp < 10 ? mp + 3 : mp - 9;
+    year              = yoe + era * 400 + (month <= 2 ? 1 : 0);
+}
+static int64_t days_in_month(int64_t year, int64_t month) {
+    constexpr int64_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    const bool leap            = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+// YYYY-MM-DD, optionally followed by 'T' or ' ' and HH:MM[:SS[.fraction]] and then by 'Z' or +HH[:MM] / -HH[:MM]
+Optional<int64_t> parse_iso8601_timestamp(StringView value) {
+    size_t pos  = 0;
+    auto digits = [&](size_t count, int64_t& out) {
+        if (pos + count > value.size()) return false;
+        out = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const char c = value[pos + i];
+            if (c < '0' || c > '9') return false;
+            out = out * 10 + (c - '0');
+        }
+        pos += count;
+        return true;
+    };
+    auto expect = [&](char c) {
+        if (pos == value.size() || value[pos] != c) return false;
+        ++pos;
+        return true;
+    };
+    int64_t year = 0, month = 0, day = 0;
+    if (!digits(4, year) || !expect('-') || !digits(2, month) || !expect('-') || !digits(2, day)) return {};
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month)) return {};
+    int64_t seconds = 0, micros = 0;
+    if (pos < value.size()) {
+        if (!expect('T') && !expect(' ')) return {};
+        int64_t hour = 0, minute = 0, second = 0;
+        if (!digits(2, hour) || !expect(':') || !digits(2, minute)) return {};
+        if (expect(':')) {
+            if (!digits(2, second)) return {};
+            if (expect('.')) {
+                // digits past the microseconds are dropped
+                size_t count = 0;
+                for (; pos < value.size() && value[pos] >= '0' && value[pos] <= '9'; ++pos, ++count) {
+                    if (count < 6) micros = micros * 10 + (value[pos] - '0');
+                }
+                if (count == 0) return {};
+                for (; count < 6; ++count) { micros *= 10; }
+            }
+        }
+        if (hour > 23 || minute > 59 || second > 60) return {};
+        seconds = hour * 3600 + minute * 60 + second;
+        if (pos < value.size() && !expect('Z')) {
+            const int64_t sign = value[pos] == '-' ? -1 : 1;
+            if (!expect('+') && !expect('-')) return {};
+            int64_t offset_hours = 0, offset_minutes = 0;
+            if (!digits(2, offset_hours)) return {};
+            if (expect(':') || pos < value.size()) {
+                if (!digits(2, offset_minutes)) return {};
+            }
+            if (offset_hours > 23 || offset_minutes > 59) return {};
+            seconds -= sign * (offset_hours * 3600 + offset_minutes * 60);
+        }
+        if (pos != value.size()) return {};
+    }
+    return (days_from_civil(year, month, day) * 86400 + seconds) * 1000000 + micros;
+}
+// StrViewToDouble stops at the first character that can't be part of a number, a field has to be all number
+static bool is_decimal_number(StringView value) {
+    size_t pos  = 0;
+    auto digits = [&]() {
+        const size_t begin = pos;
+        while (pos < value.size() && value[pos] >= '0' && value[pos] <= '9') ++pos;
+        return pos - begin;
+    };
+    if (pos < value.size() && (value[pos] == '+' || value[pos] == '-')) ++pos;
+    size_t mantissa = digits();
+    if (pos < value.size() && value[pos] == '.') {
+        ++pos;
+        mantissa += digits();
+    }
+    if (mantissa == 0) return false;
+    if (pos < value.size() && (value[pos] == 'e' || value[pos] == 'E')) {
+        ++pos;
+        if (pos < value.size() && (value[pos] == '+' || value[pos] == '-')) ++pos;
+        if (digits() == 0) return false;
+    }
+    return pos == value.size();
+}
+static Optional<double> parse_double(StringView value) {
+    if (!is_decimal_number(value)) return {};
+    auto res = StrViewToDouble(value);
+    if (res.is_error()) {
+        res.ignore_error();
+        return {};
+    }
+    return res.to_ok();
+}
+size_t write_iso8601_timestamp(int64_t micros, char* buffer) {
+    // floor division, so times before the epoch still have a positive time of day
+    int64_t days     = micros / 86400000000;
+    int64_t day_time = micros % 86400000000;
+    if (day_time < 0) {
+        day_time += 86400000000;
+        --days;
+    }
+    int64_t year = 0, month = 0, day = 0;
+    civil_from_days(days, year, month, day);
+    const int64_t seconds  = day_time / 1000000;
+    const int64_t fraction = day_time % 1000000;
+    char* out              = buffer;
+    auto put  = [&out](int64_t value, size_t width) {
+        for (size_t i = width; i > 0; --i) {
+            out[i - 1] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        out += width;
+    };
+    if (year < 0) {
+        *out++ = '-';
+        year   = -year;
+    }
+    put(year, year > 9999 ? StrLenFromIntegral<10>(static_cast<uint64_t>(year)) : 4);
+    *out++ = '-';
+    put(month, 2);
+    *out++ = '-';
+    put(day, 2);
+    *out++ = 'T';
+    put(seconds / 3600, 2);
+    *out++ = ':';
+    put(seconds / 60 % 60, 2);
+    *out++ = ':';
+    put(seconds % 60, 2);
+    if (fraction != 0) {
+        *out++ = '.';
+        put(fraction, 6);
+    }
+    *out++ = 'Z';
+    return static_cast<size_t>(out - buffer);
+}
+static Optional<bool> parse_bool(StringView value) {
+    if (value == "true"_sv || value == "TRUE"_sv || value == "True"_sv) return true;
+    if (value == "false"_sv || value == "FALSE"_sv || value == "False"_sv) return false;
+    return {};
+}
+bool CSVColumn::append(StringView field) {
+    if (field.size() == 0 && m_type != CSVColumnType::String) {
+        if (m_nulls.size() == 0) m_nulls.resize(m_size);
+        m_nulls.append(1);
+    } else if (m_nulls.size() != 0) {
+        m_nulls.append(0);
+    }
+    switch (m_type) {
+        case CSVColumnType::Int64:
+            {
+                int64_t value = 0;
+                if (field.size() != 0) {
+                    auto res = StrViewToI64(field);
+                    if (res.is_error()) {
+                        res.ignore_error();
+                        return false;
+                    }
+                    value = res.to_ok();
+                }
+                m_integers.append(value);
+                break;
+            }
+        case CSVColumnType::Double:
+            {
+                const auto value = field.size() == 0 ? Optional<double>{ 0.0 } : parse_double(field);
+                if (value.empty()) return false;
+                m_doubles.append(*value);
+                break;
+            }
+        case CSVColumnType::Bool:
+            {
+                const auto value = field.size() == 0 ? Optional<bool>{ false } : parse_bool(field);
+                if (value.empty()) return false;
+                m_bools.append(*value ? 1 : 0);
+                break;
+            }
+        case CSVColumnType::Timestamp:
+            {
+                const auto value = field.size() == 0 ? Optional<int64_t>{ 0 } : parse_iso8601_timestamp(field);
+                if (value.empty()) return false;
+                m_integers.append(*value);
+                break;
+            }
+        case CSVColumnType::String:
+            return false;
+    }
+    ++m_size;
+    return true;
+}
+void CSVColumn::append_code(uint32_t code) {
+    if (m_nulls.size() != 0) m_nulls.append(0);
+    m_codes.append(code);
+    ++m_size;
+}
+// gives every distinct value of a String column a code while the column is filled, the keys are views into the
+// source so a value is only copied once, into the dictionary. unescaped fields don't live in the source, those
+// keys are copied to the heap
+class CSVStringInterner {
+    FlatMap<StringView, uint32_t> m_codes;
+    Vector<UniquePtr<String>> m_unescaped;
+    StringView m_source;
+
+    public:
+    explicit CSVStringInterner(StringView source) : m_source(source) {}
+    // the code of the value and whether it's the first time it shows up
+    Pair<uint32_t, bool> intern(StringView field) {
+        if (auto it = m_codes.find(field); it != m_codes.end()) return Pair{ (*it).val(), false };
+        const auto code = static_cast<uint32_t>(m_codes.size());
+        StringView key  = field;
+        if (field.data() < m_source.data() || field.data() >= m_source.data() + m_source.size()) {
+            m_unescaped.append(UniquePtr<String>{ field.str() });
+            key = m_unescaped.last()->view();
+        }
+        m_codes.insert(key, code);
+        return Pair{ code, true };
+    }
+};
+// the types a column can still be, narrowed by every value that's looked at
+enum CSVTypeCandidates : uint8_t {
+    CandidateBool      = 1 << 0,
+    CandidateInt64     = 1 << 1,
+    CandidateDouble    = 1 << 2,
+    CandidateTimestamp = 1 << 3,
+    CandidateAll       = CandidateBool | CandidateInt64 | CandidateDouble | CandidateTimestamp
+};
+static bool is_integer(StringView value) {
+    auto res = StrViewToI64(value);
+    if (res.is_error()) {
+        res.ignore_error();
+        return false;
+    }
+    return true;
+}
+static uint8_t narrow_candidates(uint8_t candidates, StringView value) {
+    uint8_t still = 0;
+    if ((candidates & CandidateBool) != 0 && !parse_bool(value).empty()) still |= CandidateBool;
+    if ((candidates & CandidateInt64) != 0 && is_integer(value)) still |= CandidateInt64;
+    if ((candidates & CandidateDouble) != 0 && !parse_double(value).empty()) still |= CandidateDouble;
+    if ((candidates & CandidateTimestamp) != 0 && !parse_iso8601_timestamp(value).empty()) {
+        still |= CandidateTimestamp;
+    }
+    return still;
+}
+Result<Vector<CSVColumnSpec>, CSVParseError>
+CSVTable::infer_schema(StringView source, const CSVTableOptions& options) {
+    CSVReader reader{ source, options.separator };
+    Vector<String> names{};
+    if (options.has_header) {
+        TRY(reader.read_header());
+        for (const auto& name : reader.header()) { names.append(name); }
+    }
+    Vector<uint8_t> candidates{};
+    // columns that only had empty values so far don't get a type from them
+    Vector<uint8_t> seen{};
+    candidates.resize(names.size());
+    seen.resize(names.size());
+    for (size_t i = 0; i < names.size(); ++i) { candidates[i] = CandidateAll; }
+    for (size_t row_index = 0; row_index < options.inference_rows; ++row_index) {
+        auto row = reader.read_row();
+        if (row.is_error()) {
+            auto error = row.to_error();
+            if (error->is_eof()) break;
+            return *error;
+        }
+        const auto fields = row.to_ok();
+        if (!options.has_header) {
+            for (size_t i = names.size(); i < fields.size(); ++i) {
+                names.append(IntToStr(i));
+                candidates.append(CandidateAll);
+                seen.append(0);
+            }
+        }
+        const size_t count = min_bt(fields.size(), names.size());
+        for (size_t i = 0; i < count; ++i) {
+            if (fields[i].size() == 0 || candidates[i] == 0) continue;
+            candidates[i] = narrow_candidates(candidates[i], fields[i]);
+            seen[i]       = 1;
+        }
+    }
+    Vector<CSVColumnSpec> schema{};
+    schema.reserve(names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        const uint8_t possible = seen[i] != 0 ? candidates[i] : 0;
+        CSVColumnType type     = CSVColumnType::String;
+        if ((possible & CandidateBool) != 0) {
+            type = CSVColumnType::Bool;
+        } else if ((possible & CandidateInt64) != 0) {
+            type = CSVColumnType::Int64;
+        } else if ((possible & CandidateDouble) != 0) {
+            type = CSVColumnType::Double;
+        } else if ((possible & CandidateTimestamp) != 0) {
+            type = CSVColumnType::Timestamp;
+        }
+        schema.append(CSVColumnSpec{ move(names[i]), type });
+    }
+    return schema;
+}
+Result<CSVTable, CSVParseError> CSVTable::parse(StringView source, const CSVTableOptions& options) {
+    TRY_SET(schema, infer_schema(source, options));
+    return parse(source, schema, options);
+}
+Result<CSVTable, CSVParseError>
+CSVTable::parse(StringView source, const Vector<CSVColumnSpec>& schema, const CSVTableOptions& options) {
+    CSVReader reader{ source, options.separator };
+    // the field of every row each column comes from
+    Vector<size_t> sources{};
+    sources.reserve(schema.size());
+    if (options.has_header) {
+        TRY(reader.read_header());
+        for (const auto& spec : schema) {
+            const size_t index = reader.column_index(spec.name.view());
+            if (index == npos_) return CSVParseError{ "Column "_s + spec.name + " isn't in the header"_s, 0 };
+            sources.append(index);
+        }
+    } else {
+        for (size_t i = 0; i < schema.size(); ++i) { sources.append(i); }
+    }
+    CSVTable table{};
+    table.m_columns.reserve(schema.size());
+    for (const auto& [i, spec] : schema.iter().enumerate()) {
+        table.m_columns.append(CSVColumn{ spec.name, spec.type });
+        table.m_column_index.insert(String{ spec.name }, i);
+    }
+    Vector<CSVStringInterner> interners{};
+    interners.reserve(schema.size());
+    for (size_t i = 0; i < schema.size(); ++i) { interners.append(CSVStringInterner{ source }); }
+    while (true) {
+        auto row = reader.read_row();
+        if (row.is_error()) {
+            auto error = row.to_error();
+            if (error->is_eof()) break;
+            return *error;
+        }
+        const auto fields = row.to_ok();
+        for (size_t i = 0; i < sources.size(); ++i) {
+            auto& column = table.m_columns[i];
+            if (sources[i] >= fields.size()) {
+                return CSVParseError{ "Row is missing column "_s + column.m_name, reader.row_offset() };
+            }
+            const StringView field = fields[sources[i]];
+            if (column.m_type == CSVColumnType::String) {
+                const auto [code, added] = interners[i].intern(field);
+                if (added) column.m_dictionary.append(field.str());
+                column.append_code(code);
+            } else if (!column.append(field)) {
+                return CSVParseError{ "Value doesn't match the type of column "_s + column.m_name,
+                                      reader.row_offset() };
+            }
+        }
+        ++table.m_rows;
+    }
+    return table;
+}
+Result<CSVTable, CSVParseError> CSVTable::from_file(const Path& filename, const CSVTableOptions& options) {
+    auto file = MappedFile::open(filename, MappedFile::sequential);
+    if (file.is_error()) return CSVParseError{ file.to_error()->error_string(), 0 };
+    const auto source = file.to_ok();
+    return parse(source.view(), options);
+}
+size_t CSVTable::column_index(StringView name) const {
+    auto it = m_column_index.find(name);
+    if (it == m_column_index.end()) return npos_;
+    return (*it).val();
+}
+}    // namespace ARLib
@@ -0,0 +1,119 @@
+#ifndef DISABLE_THREADING
+    #include "CSVParallel.hpp"
+    #include <immintrin.h>
+namespace ARLib {
+void CSVRowArena::add_row(Span<const StringView> row, size_t offset, StringView chunk) {
+    const char* chunk_begin = chunk.data();
+    const char* chunk_end   = chunk_begin + chunk.size();
+    for (const auto& field : row) {
+        if (field.size() == 0 || (field.data() >= chunk_begin && field.data() < chunk_end)) {
+            m_fields.append(field);
+            continue;
+        }
+        // unescaped fields live in the reader and are gone once it reads the next row
+        m_escaped.append(Pair{ m_fields.size(), m_unescaped.size() });
+        m_unescaped.append(field);
+        m_fields.append(field);
+    }
+    m_row_ends.append(m_fields.size());
+    m_offsets.append(offset);
+}
+void CSVRowArena::complete() {
+    for (const auto& [field, offset] : m_escaped) {
+        m_fields[field] = StringView{ m_unescaped.data() + offset, m_fields[field].size() };
+    }
+}
+void CSVRowArena::reset() {
+    m_fields.clear_retain();
+    m_row_ends.clear_retain();
+    m_offsets.clear_retain();
+    m_escaped.clear_retain();
+    m_unescaped.clear();
+}
+namespace detail {
+    bool odd_quotes(const char* begin, const char* end) {
+        bool odd = false;
+    #ifdef __AVX2__
+        const auto needle = _mm256_set1_epi8('"');
+        auto lanes        = _mm256_setzero_si256();
+        while (end - begin >= 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            lanes            = _mm256_xor_si256(lanes, _mm256_cmpeq_epi8(chunk, needle));
+            begin += 32;
+        }
+        // a byte of lanes is all ones if its position saw an odd number of quotes, the parity of those is the answer
+        auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(lanes));
+        bits ^= bits >> 16;
+        bits ^= bits >> 8;
+        bits ^= bits >> 4;
+        bits ^= bits >> 2;
+        bits ^= bits >> 1;
+        odd = (bits & 1) != 0;
+    #endif
+        for (; begin != end; ++begin) { odd ^= *begin == '"'; }
+        return odd;
+    }
+    size_t find_row_start(StringView buffer, size_t from, bool in_quotes) {
+        const char* data = buffer.data();
+        for (size_t i = from; i < buffer.size(); ++i) {
+            if (data[i] == '"') {
+                in_quotes = !in_quotes;
+            } else if (data[i] == '\n' && !in_quotes) {
+                return i + 1;
+            }
+        }
+        return buffer.size();
+    }
+    size_t complete_rows(StringView buffer) {
+        const char* data = buffer.data();
+        // the quotes before a newline are all of them minus the ones that come after it
+        const bool odd_total = odd_quotes(data, data + buffer.size());
+        bool odd_after       = false;
+        for (size_t i = buffer.size(); i > 0; --i) {
+            if (data[i - 1] == '"') {
+                odd_after = !odd_after;
+            } else if (data[i - 1] == '\n' && odd_total == odd_after) {
+                return i;
+            }
+        }
+        return 0;
+    }
+    Vector<size_t> split_rows(StringView buffer, size_t chunk_size, ThreadPool& pool) {
+        const char* data    = buffer.data();
+        const size_t size   = buffer.size();
+        chunk_size          = max_bt(chunk_size, size_t{ 1 });
+        const size_t pieces = (size + chunk_size - 1) / chunk_size;
+        Vector<size_t> bounds{};
+        bounds.reserve(pieces + 1);
+        if (pieces > 1) {
+            Vector<uint8_t> odd{};
+            odd.resize(pieces);
+            pool.run_indexed(pieces, [&](size_t piece) {
+                const size_t begin = piece * chunk_size;
+                odd[piece]         = odd_quotes(data + begin, data + min_bt(begin + chunk_size, size)) ? 1 : 0;
+            });
+            // piece i starts inside a quoted field if the pieces before it have an odd number of quotes in total
+            Vector<size_t> starts{};
+            starts.resize(pieces);
+            uint8_t in_quotes = 0;
+            for (size_t piece = 0; piece < pieces - 1; ++piece) {
+                in_quotes ^= odd[piece];
+                odd[piece] = in_quotes;
+            }
+            pool.run_indexed(pieces - 1, [&](size_t piece) {
+                starts[piece + 1] = find_row_start(buffer, (piece + 1) * chunk_size, odd[piece] != 0);
+            });
+            // a row longer than a piece makes the next ones find the same start, or none at all
+            bounds.append(0);
+            for (size_t piece = 1; piece < pieces; ++piece) {
+                if (starts[piece] > bounds.last() && starts[piece] < size) bounds.append(starts[piece]);
+            }
+        } else if (size != 0) {
+            bounds.append(0);
+        }
+        bounds.append(size);
+        return bounds;
+    }
+}    // namespace detail
+}    // namespace ARLib
+#endif
@@ -0,0 +1,174 @@
+#include "CSVReader.hpp"
+#include "BitOps.hpp"
+#include <immintrin.h>
+namespace ARLib {
+// bit i of every mask is set if byte i of the block is in that class
+struct CSVBlockMasks {
+    uint64_t quote;
+    uint64_t separator;
+    uint64_t newline;
+};
+constexpr size_t csv_block_size = 64;
+#ifdef __AVX2__
+static uint64_t match_byte(__m256i lo, __m256i hi, char c) {
+    const auto needle  = _mm256_set1_epi8(c);
+    const auto lo_bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    const auto hi_bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    return uint64_t{ lo_bits } | (uint64_t{ hi_bits } << 32);
+}
+static CSVBlockMasks classify_block(const char* block, char separator) {
+    const auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    return CSVBlockMasks{ match_byte(lo, hi, '"'), match_byte(lo, hi, separator), match_byte(lo, hi, '\n') };
+}
+#else
+static CSVBlockMasks classify_block(const char* block, char separator) {
+    CSVBlockMasks masks{};
+    for (size_t i = 0; i < csv_block_size; ++i) {
+        const uint64_t bit = uint64_t{ 1 } << i;
+        if (block[i] == '"') masks.quote |= bit;
+        if (block[i] == separator) masks.separator |= bit;
+        if (block[i] == '\n') masks.newline |= bit;
+    }
+    return masks;
+}
+#endif
+// bit i of the result is the xor of bits 0..i of the input
+static uint64_t prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+Result<CSVReader, CSVParseError> CSVReader::from_file(const Path& filename, char separator) {
+    auto file = MappedFile::open(filename, MappedFile::sequential);
+    if (file.is_error()) return CSVParseError{ file.to_error()->error_string(), 0 };
+    auto storage = file.to_ok();
+    CSVReader reader{ storage.view(), separator };
+    reader.m_storage = move(storage);
+    return reader;
+}
+bool CSVReader::next_block() {
+    const size_t size = m_view.size();
+    if (m_next_block >= size) return false;
+    const char* block = m_view.data() + m_next_block;
+    char padded[csv_block_size];
+    if (size - m_next_block < csv_block_size) {
+        // the tail is padded with bytes that can't be any of the characters the reader looks for
+        for (size_t i = 0; i < csv_block_size; ++i) {
+            padded[i] = m_next_block + i < size ? block[i] : (m_separator == 'a' ? 'b' : 'a');
+        }
+        block = padded;
+    }
+    const auto masks   = classify_block(block, m_separator);
+    const auto quoted  = prefix_xor(masks.quote) ^ m_in_quotes;
+    m_in_quotes        = static_cast<uint64_t>(static_cast<int64_t>(quoted) >> 63);
+    m_events           = masks.quote | ((masks.separator | masks.newline) & ~quoted);
+    m_block_base       = m_next_block;
+    m_next_block      += csv_block_size;
+    return true;
+}
+DiscardResult<CSVParseError> CSVReader::add_field(size_t begin, size_t end, size_t quotes, bool last) {
+    const char* data = m_view.data();
+    if (last && end > begin && data[end - 1] == '\r') --end;
+    if (quotes == 0) {
+        m_fields.append(StringView{ data + begin, data + end });
+        return {};
+    }
+    if (data[begin] != '"') {
+        return CSVParseError{ "Stray double quote inside of field not enclosed in double quotes"_s, begin };
+    }
+    size_t close = end;
+    while (close > begin + 1 && (data[close - 1] == ' ' || data[close - 1] == '\t')) --close;
+    if (close == begin + 1 || data[close - 1] != '"') {
+        return CSVParseError{ "Unexpected characters after the closing double quote"_s, close };
+    }
+    --close;
+    if (quotes == 2) {
+        m_fields.append(StringView{ data + begin + 1, data + close });
+        return {};
+    }
+    // every quote between the opening and the closing one has to be doubled
+    const size_t offset = m_unescaped.size();
+    size_t run          = begin + 1;
+    for (size_t i = run; i < close; ++i) {
+        if (data[i] != '"') continue;
+        if (i + 1 == close || data[i + 1] != '"') {
+            return CSVParseError{ "Double quote inside of quoted field is not escaped"_s, i };
+        }
+        m_unescaped.append(StringView{ data + run, data + i + 1 });
+        run = ++i + 1;
+    }
+    m_unescaped.append(StringView{ data + run, data + close });
+    // the real view is set once the row is complete, appending to m_unescaped can move its contents around
+    m_escaped.append(Pair{ m_fields.size(), offset });
+    m_fields.append(StringView{ data + begin, m_unescaped.size() - offset });
+    return {};
+}
+Result<Span<const StringView>, CSVParseError> CSVReader::read_row() {
+    m_fields.clear_retain();
+    m_escaped.clear_retain();
+    m_unescaped.clear();
+    const char* data   = m_view.data();
+    const size_t size  = m_view.size();
+    size_t field_begin = m_pos;
+    size_t quotes      = 0;
+    m_row_begin        = m_pos;
+    auto is_blank      = [data](size_t begin, size_t end) {
+        return begin == end || (end - begin == 1 && data[begin] == '\r');
+    };
+    auto complete_row = [this]() {
+        for (const auto& [field, offset] : m_escaped) {
+            m_fields[field] = StringView{ m_unescaped.data() + offset, m_fields[field].size() };
+        }
+        return Span<const StringView>{ m_fields.data(), m_fields.size() };
+    };
+    while (true) {
+        if (m_events == 0) {
+            if (!next_block()) break;
+            continue;
+        }
+        const size_t pos = m_block_base + internal::trailing_zeros(m_events);
+        m_events &= m_events - 1;
+        const char c = data[pos];
+        if (c == '"') {
+            ++quotes;
+            continue;
+        }
+        const bool row_end = c == '\n';
+        if (row_end && m_fields.size() == 0 && quotes == 0 && is_blank(field_begin, pos)) {
+            field_begin = pos + 1;
+            m_pos       = pos + 1;
+            m_row_begin = m_pos;
+            continue;
+        }
+        TRY(add_field(field_begin, pos, quotes, row_end));
+        quotes      = 0;
+        field_begin = pos + 1;
+        if (row_end) {
+            m_pos = pos + 1;
+            return complete_row();
+        }
+    }
+    if (m_in_quotes != 0) return CSVParseError{ "Missing end of double quotes on field"_s, size };
+    m_pos = size;
+    if (m_fields.size() == 0 && quotes == 0 && is_blank(field_begin, size)) return CSVEndOfFileError{};
+    TRY(add_field(field_begin, size, quotes, true));
+    return complete_row();
+}
+DiscardResult<CSVParseError> CSVReader::read_header() {
+    TRY_SET(row, read_row());
+    m_header.clear();
+    for (const auto& field : row) { m_header.append(field.str()); }
+    return {};
+}
+size_t CSVReader::column_index(StringView name) const {
+    for (size_t i = 0; i < m_header.size(); ++i) {
+        if (m_header[i].view() == name) return i;
+    }
+    return npos_;
+}
+}    // namespace ARLib
@@ -0,0 +1,170 @@
+#include "CSVWriter.hpp"
+#include "BitOps.hpp"
+#include "CharConv.hpp"
+#include "CharConvHelpers.hpp"
+#include <immintrin.h>
+namespace ARLib {
+// true if the field has to be quoted, that is if it has a separator, a quote or a line break in it
+static bool needs_quotes(const char* begin, const char* end, char separator) {
+#ifdef __AVX2__
+    const auto quote     = _mm256_set1_epi8('"');
+    const auto newline   = _mm256_set1_epi8('\n');
+    const auto carriage  = _mm256_set1_epi8('\r');
+    const auto separated = _mm256_set1_epi8(separator);
+    while (end - begin >= 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        const auto found = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, separated)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline), _mm256_cmpeq_epi8(chunk, carriage))
+        );
+        if (_mm256_movemask_epi8(found) != 0) return true;
+        begin += 32;
+    }
+#endif
+    for (; begin != end; ++begin) {
+        const char c = *begin;
+        if (c == '"' || c == separator || c == '\n' || c == '\r') return true;
+    }
+    return false;
+}
+static const char* find_quote(const char* begin, const char* end) {
+#ifdef __AVX2__
+    const auto quote = _mm256_set1_epi8('"');
+    while (end - begin >= 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        const auto mask  = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)));
+        if (mask != 0) return begin + internal::trailing_zeros(mask);
+        begin += 32;
+    }
+#endif
+    while (begin != end && *begin != '"') ++begin;
+    return begin;
+}
+void CSVWriter::write_field(StringView value, bool quoted) {
+    separate();
+    if (!quoted) {
+        m_out.append(value);
+        return;
+    }
+    const char* begin = value.data();
+    const char* end   = begin + value.size();
+    m_out.reserve(value.size() + 2);
+    m_out.append('"');
+    while (true) {
+        const char* quote = find_quote(begin, end);
+        if (quote == end) {
+            m_out.append(StringView{ begin, end });
+            break;
+        }
+        // the run up to and including the quote, then the quote once more
+        m_out.append(StringView{ begin, quote + 1 });
+        m_out.append('"');
+        begin = quote + 1;
+    }
+    m_out.append('"');
+}
+CSVWriter& CSVWriter::field(StringView value) {
+    write_field(value, needs_quotes(value.data(), value.data() + value.size(), m_options.separator));
+    return *this;
+}
+CSVWriter& CSVWriter::integer(int64_t value) {
+    separate();
+    const bool negative      = value < 0;
+    const uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    const size_t len         = StrLenFromIntegral<10>(magnitude);
+    char* out                = m_out.reserve(len + 1);
+    if (negative) *out++ = '-';
+    WriteToCharsImpl(out, len, magnitude);
+    m_out.commit(out + len);
+    return *this;
+}
+CSVWriter& CSVWriter::unsigned_integer(uint64_t value) {
+    separate();
+    const size_t len = StrLenFromIntegral<10>(value);
+    char* out        = m_out.reserve(len);
+    WriteToCharsImpl(out, len, value);
+    m_out.commit(out + len);
+    return *this;
+}
+CSVWriter& CSVWriter::number(double value) {
+    separate();
+    char* out = m_out.reserve(shortest_double_chars);
+    m_out.commit(out + DoubleToCharsShortest(value, out));
+    return *this;
+}
+CSVWriter& CSVWriter::boolean(bool value) {
+    separate();
+    m_out.append(value ? "true"_sv : "false"_sv);
+    return *this;
+}
+CSVWriter& CSVWriter::timestamp(int64_t micros) {
+    separate();
+    char* out = m_out.reserve(iso8601_timestamp_chars);
+    m_out.commit(out + write_iso8601_timestamp(micros, out));
+    return *this;
+}
+CSVWriter& CSVWriter::null() {
+    separate();
+    return *this;
+}
+CSVWriter& CSVWriter::end_row() {
+    if (m_out.size() == m_row_begin) m_out.append("\"\""_sv);
+    if (m_options.crlf) {
+        m_out.append("\r\n"_sv);
+    } else {
+        m_out.append('\n');
+    }
+    m_row_empty = true;
+    m_out.maybe_flush();
+    m_row_begin = m_out.size();
+    return *this;
+}
+CSVWriter& CSVWriter::table(const CSVTable& table, bool with_header) {
+    const auto& columns = table.columns();
+    // whether a value needs quotes is worked out once per distinct string instead of once per row
+    Vector<Vector<uint8_t>> quoted{};
+    quoted.resize(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i].type() != CSVColumnType::String) continue;
+        for (const auto& value : columns[i].dictionary()) {
+            const bool needs = needs_quotes(value.data(), value.data() + value.size(), m_options.separator);
+            quoted[i].append(needs ? 1 : 0);
+        }
+    }
+    if (with_header) {
+        for (const auto& column : columns) { field(column.name().view()); }
+        end_row();
+    }
+    for (size_t row = 0; row < table.rows(); ++row) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            const auto& column = columns[i];
+            if (column.is_null(row)) {
+                null();
+                continue;
+            }
+            switch (column.type()) {
+                case CSVColumnType::Int64:
+                    integer(column.integers()[row]);
+                    break;
+                case CSVColumnType::Double:
+                    number(column.doubles()[row]);
+                    break;
+                case CSVColumnType::Bool:
+                    boolean(column.bools()[row] != 0);
+                    break;
+                case CSVColumnType::String:
+                    {
+                        const uint32_t code = column.codes()[row];
+                        write_field(column.dictionary()[code].view(), quoted[i][code] != 0);
+                        break;
+                    }
+                case CSVColumnType::Timestamp:
+                    timestamp(column.integers()[row]);
+                    break;
+            }
+        }
+        end_row();
+    }
+    return *this;
+}
+}    // namespace ARLib
@@ -3,18 +3,23 @@
 namespace ARLib {
 void EventLoop::loop_function(EventLoop* loop) {
     while (loop->running()) {
-        if (loop->m_callbacks.size() > 0) {
-            Function<void()> callback;
-            {
-                UniqueLock lock{ loop->m_callback_loc };
-                callback = move(loop->m_callbacks.pop());
-                if (loop->m_callbacks.size() == 0) loop->stop();
+        Function<void()> callback;
+        {
+            // the loop only stops once the last callback has returned, a callback can subscribe new ones and
+            // callbacks that come in from other threads meanwhile keep it going
+            UniqueLock lock{ loop->m_callback_loc };
+            if (loop->m_callbacks.size() == 0) {
+                loop->stop();
+                break;
             }
-            callback();
+            callback = move(loop->m_callbacks.pop());
         }
+        callback();
     }
 }
 void EventLoop::start() {
+    // a loop that ran out of callbacks has left loop_function already, its thread only has to be joined
+    if (m_thread.joinable()) m_thread.join();
     m_running = true;
     m_thread  = Thread{ loop_function, this };
 }
@@ -5,15 +5,6 @@
 #endif
 namespace ARLib {
 namespace internal {
-    uint32_t trailing_zeros(uint32_t val) {
-#ifdef COMPILER_MSVC
-        unsigned long result = 0;
-        _BitScanForward(&result, val);
-        return result;
-#else
-        return static_cast<uint32_t>(__builtin_ctz(val));
-#endif
-    }
     uint32_t popcount(uint16_t val) {
 #ifdef COMPILER_MSVC
         return static_cast<uint32_t>(__popcnt16(val));
@@ -0,0 +1,266 @@
+#include "JSONCompact.hpp"
+namespace ARLib {
+namespace JSON {
+    static bool is_json_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+    static detail::CompactNode make_node(Type type, bool flag = false, uint32_t size = 0) {
+        detail::CompactNode node{};
+        node.type = type;
+        node.flag = flag;
+        node.size = size;
+        return node;
+    }
+    // children are collected on a stack while their container is open and get moved into the document, all next to
+    // each other, once it's closed. nodes only ever go into the document once, in their final position.
+    class CompactBuilder {
+        CompactDocument& m_document;
+        const char* m_data;
+        size_t m_size;
+        const uint32_t* m_tape;
+        size_t m_count;
+        size_t m_pos   = 0;
+        size_t m_depth = 0;
+        Vector<detail::CompactNode>& m_stack;
+
+        char current() const { return m_data[m_tape[m_pos]]; }
+        ParseError unexpected(const char* expected) const {
+            if (at_end()) {
+                return ParseError{ String::formatted("Expected %s but end of file was reached", expected), m_size };
+            }
+            return ParseError{ String::formatted("Invalid character, expected %s but got '%c'", expected, current()),
+                               offset() };
+        }
+        ParseError depth_limit_error() const {
+            return ParseError{ "Reached depth limit of "_s + IntToStr(ParseState::depth_limit), offset() };
+        }
+        void close_container(Type type, size_t stack_start, uint32_t size) {
+            const size_t first = m_document.m_nodes.size();
+            for (size_t i = stack_start; i < m_stack.size(); ++i) {
+                m_document.m_nodes.append(m_stack.index_unchecked(i));
+            }
+            m_stack.set_size(stack_start);
+            auto node   = make_node(type, false, size);
+            node.offset = first;
+            m_stack.append(node);
+            --m_depth;
+        }
+
+        public:
+        CompactBuilder(CompactDocument& document, const StructuralIndex& index) :
+            m_document(document), m_data(index.view().data()), m_size(index.view().size()),
+            m_tape(&index.indices()[0]), m_count(index.size()), m_stack(document.m_stack) {
+            m_stack.clear_retain();
+            // every node takes at least one tape entry, so this is the only allocation the node vector needs
+            m_document.m_nodes.reserve(m_count);
+        }
+        bool at_end() const { return m_pos == m_count; }
+        size_t offset() const { return m_tape[m_pos]; }
+        DiscardResult<ParseError> build() {
+            if (at_end()) return ParseError{ "Expected a valid json type but the input is empty"_s, 0 };
+            TRY(parse_value());
+            if (!at_end()) return ParseError{ "End of json reached but end of buffer not reached"_s, offset() };
+            m_document.m_root = m_stack.pop();
+            return {};
+        }
+        DiscardResult<ParseError> parse_value() {
+            if (at_end()) return unexpected("a value");
+            switch (current()) {
+                case '{':
+                    return parse_object();
+                case '[':
+                    return parse_array();
+                case '"':
+                    return parse_string();
+                case '}':
+                case ']':
+                case ':':
+                case ',':
+                    return unexpected("a value");
+                default:
+                    return parse_scalar();
+            }
+        }
+        DiscardResult<ParseError> parse_object() {
+            if (m_depth++ == ParseState::depth_limit) return depth_limit_error();
+            const size_t stack_start = m_stack.size();
+            uint32_t members         = 0;
+            ++m_pos;
+            if (!at_end() && current() == '}') {
+                ++m_pos;
+                close_container(Type::JObject, stack_start, 0);
+                return {};
+            }
+            while (true) {
+                if (at_end() || current() != '"') return unexpected("a string key");
+                TRY(parse_string());
+                if (at_end() || current() != ':') return unexpected("':'");
+                ++m_pos;
+                TRY(parse_value());
+                ++members;
+                if (at_end()) return unexpected("',' or '}'");
+                const char c = current();
+                if (c == '}') break;
+                if (c != ',') return unexpected("',' or '}'");
+                ++m_pos;
+            }
+            ++m_pos;
+            close_container(Type::JObject, stack_start, members);
+            return {};
+        }
+        DiscardResult<ParseError> parse_array() {
+            if (m_depth++ == ParseState::depth_limit) return depth_limit_error();
+            const size_t stack_start = m_stack.size();
+            ++m_pos;
+            if (!at_end() && current() == ']') {
+                ++m_pos;
+                close_container(Type::JArray, stack_start, 0);
+                return {};
+            }
+            while (true) {
+                TRY(parse_value());
+                if (at_end()) return unexpected("',' or ']'");
+                const char c = current();
+                if (c == ']') break;
+                if (c != ',') return unexpected("',' or ']'");
+                ++m_pos;
+            }
+            ++m_pos;
+            close_container(Type::JArray, stack_start, static_cast<uint32_t>(m_stack.size() - stack_start));
+            return {};
+        }
+        DiscardResult<ParseError> parse_string() {
+            const char* begin = m_data + m_tape[m_pos] + 1;
+            const char* end   = m_data + m_tape[m_pos + 1];
+            m_pos += 2;
+            if (detail::find_escape_or_control(begin, end) == end) {
+                auto node   = make_node(Type::JString, false, static_cast<uint32_t>(end - begin));
+                node.offset = static_cast<uint64_t>(begin - m_data);
+                m_stack.append(node);
+                return {};
+            }
+            auto& decoded      = m_document.m_decoded;
+            const size_t start = decoded.size();
+            TRY(detail::unescape_string(decoded, begin, end, m_data));
+            auto node   = make_node(Type::JString, true, static_cast<uint32_t>(decoded.size() - start));
+            node.offset = start;
+            m_stack.append(node);
+            return {};
+        }
+        DiscardResult<ParseError> parse_scalar() {
+            const char* begin = m_data + m_tape[m_pos];
+            const char* end   = m_data + m_tape[m_pos + 1];
+            ++m_pos;
+            while (end > begin && is_json_space(end[-1])) --end;
+            const StringView raw{ begin, end };
+            if (raw == "true"_sv || raw == "false"_sv) {
+                auto node    = make_node(Type::JBool);
+                node.boolean = *begin == 't';
+                m_stack.append(node);
+                return {};
+            }
+            if (raw == "null"_sv) {
+                m_stack.append(make_node(Type::JNull));
+                return {};
+            }
+            if (*begin == '-' || (*begin >= '0' && *begin <= '9')) {
+                TRY_SET(number, detail::parse_number(begin, end, m_data));
+                auto node = make_node(Type::JNumber, !number.is_integer());
+                if (number.is_integer()) {
+                    node.integer = number.value_integer();
+                } else {
+                    node.floating = number.value_double();
+                }
+                m_stack.append(node);
+                return {};
+            }
+            return ParseError{ "Expected a valid json type but got "_s + raw.str(),
+                               static_cast<size_t>(begin - m_data) };
+        }
+    };
+    StringView CompactValue::as_string() const {
+        HARD_ASSERT(is_string(), "Type must be string when this is called")
+        const StringView storage = m_node->flag ? m_document->m_decoded.view() : m_document->source();
+        return StringView{ storage.data() + m_node->offset, m_node->size };
+    }
+    StringView CompactValue::key_at(size_t index) const {
+        HARD_ASSERT(is_object(), "Type must be object when this is called")
+        HARD_ASSERT(index < m_node->size, "Index out of bounds")
+        return CompactValue{ m_document, &child(index * 2) }.as_string();
+    }
+    Optional<CompactValue> CompactValue::find(StringView key) const {
+        HARD_ASSERT(is_object(), "Type must be object when this is called")
+        for (size_t i = 0; i < m_node->size; ++i) {
+            if (key_at(i) == key) return value_at(i);
+        }
+        return {};
+    }
+    Value CompactValue::to_value() const {
+        switch (type()) {
+            case Type::JObject:
+                {
+                    Object obj{};
+                    for (size_t i = 0; i < size(); ++i) { obj.insert(key_at(i).str(), value_at(i).to_value()); }
+                    return ValueObj::construct(move(obj));
+                }
+            case Type::JArray:
+                {
+                    Array arr{};
+                    arr.reserve(size());
+                    for (size_t i = 0; i < size(); ++i) { arr.append((*this)[i].to_value()); }
+                    return ValueObj::construct(move(arr));
+                }
+            case Type::JString:
+                return ValueObj::construct(JString{ as_string().str() });
+            case Type::JNumber:
+                if (is_integer()) return ValueObj::construct(Number{ number_tag, as_int64() });
+                return ValueObj::construct(Number{ number_tag, as_double() });
+            case Type::JBool:
+                return ValueObj::construct(Bool{ bool_tag, as_bool() });
+            case Type::JNull:
+                return ValueObj::construct(Null{ null_tag });
+        }
+        return ValueObj::construct(Null{ null_tag });
+    }
+    Parsed<CompactDocument> CompactDocument::parse(StringView source) {
+        TRY_SET(index, StructuralIndex::build(source));
+        return parse(index);
+    }
+    Parsed<CompactDocument> CompactDocument::parse(const StructuralIndex& index) {
+        CompactDocument document{};
+        TRY(document.reparse(index));
+        return document;
+    }
+    Parsed<CompactDocument> CompactDocument::parse(String&& source) {
+        CompactDocument document{};
+        document.m_owned_source = move(source);
+        document.m_owns_source  = true;
+        // nodes only store offsets, so the source moving along with the document is fine
+        TRY_SET(index, StructuralIndex::build(document.m_owned_source.view()));
+        CompactBuilder builder{ document, index };
+        TRY(builder.build());
+        return document;
+    }
+    DiscardResult<ParseError> CompactDocument::reparse(const StructuralIndex& index) {
+        m_owned_source = String{};
+        m_owns_source  = false;
+        m_mapping      = MappedFile{};
+        m_source       = index.view();
+        m_decoded.clear();
+        m_nodes.clear_retain();
+        CompactBuilder builder{ *this, index };
+        return builder.build();
+    }
+    Parsed<CompactDocument> CompactDocument::from_file(const Path& filename) {
+        auto file_or_err = MappedFile::open(filename, MappedFile::sequential);
+        if (file_or_err.is_error()) { return ParseError{ file_or_err.to_error()->error_string(), 0 }; }
+        CompactDocument document{};
+        document.m_mapping = file_or_err.to_ok();
+        document.m_source  = document.m_mapping.view();
+        TRY_SET(index, StructuralIndex::build(document.m_source));
+        CompactBuilder builder{ document, index };
+        TRY(builder.build());
+        return document;
+    }
+}    // namespace JSON
+}    // namespace ARLib
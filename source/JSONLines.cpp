@@ -0,0 +1,58 @@
+#ifndef DISABLE_THREADING
+    #include "JSONLines.hpp"
+    #include "BitOps.hpp"
+    #include <immintrin.h>
+namespace ARLib {
+namespace JSON {
+    DiscardResult<ParseError> LinesArena::parse(StringView line, size_t offset) {
+        auto rebase = [offset](const ParseError& error) {
+            return ParseError{ error.message().view(), error.offset() + offset };
+        };
+        if (auto res = m_index.rebuild(line); res.is_error()) return rebase(*res.to_error());
+        if (m_count == m_documents.size()) {
+            m_documents.append(CompactDocument{});
+            m_offsets.append(0);
+        }
+        if (auto res = m_documents[m_count].reparse(m_index); res.is_error()) return rebase(*res.to_error());
+        m_offsets[m_count++] = offset;
+        return {};
+    }
+    namespace detail {
+        const char* find_newline(const char* begin, const char* end) {
+    #ifdef __AVX2__
+            const auto needle = _mm256_set1_epi8('\n');
+            while (end - begin >= 32) {
+                const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+                const auto mask  = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+                if (mask != 0) return begin + internal::trailing_zeros(mask);
+                begin += 32;
+            }
+    #endif
+            while (begin != end && *begin != '\n') ++begin;
+            return begin;
+        }
+        bool is_blank_line(const char* begin, const char* end) {
+            for (; begin != end; ++begin) {
+                if (*begin != ' ' && *begin != '\t' && *begin != '\r') return false;
+            }
+            return true;
+        }
+        Vector<size_t> split_lines(StringView buffer, size_t chunk_size) {
+            const char* data  = buffer.data();
+            const size_t size = buffer.size();
+            Vector<size_t> bounds{};
+            bounds.reserve(size / max_bt(chunk_size, size_t{ 1 }) + 2);
+            size_t begin = 0;
+            while (begin < size) {
+                bounds.append(begin);
+                if (size - begin <= chunk_size) break;
+                const char* newline = find_newline(data + begin + chunk_size, data + size);
+                begin               = static_cast<size_t>(newline - data) + 1;
+            }
+            bounds.append(size);
+            return bounds;
+        }
+    }    // namespace detail
+}    // namespace JSON
+}    // namespace ARLib
+#endif
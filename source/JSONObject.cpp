@@ -1,6 +1,8 @@
 #include "JSONObject.hpp"
 #include "File.hpp"
 #include "JSONParser.hpp"
+#include "JSONWriter.hpp"
+#include "Stream.hpp"
 namespace ARLib {
 namespace JSON {
     Bool::operator Value() && {
@@ -50,123 +52,30 @@ namespace JSON {
         TRY(m_value->serialize_to_file(f));
         return {};
     }
-    SerializeResult serialize_array_to_file(File& f, const Array& arr, size_t indent);
-    SerializeResult serialize_object_to_file(File& f, const Object& obj, size_t indent);
-    SerializeResult serialize_object_to_file(File& f, const Object& obj, size_t indent) {
-        if (obj.size() == 0) {
-            TRY(f.write("{}"_s));
-            return {};
+    // lets a Writer flush into a file that stays with the caller, the writer only ever writes
+    class FileSink : public BaseStream {
+        File& m_file;
+
+        public:
+        explicit FileSink(File& file) : m_file(file) {}
+        Result<size_t> write(Span<const uint8_t> buffer) override {
+            auto res = m_file.write(StringView{ reinterpret_cast<const char*>(buffer.data()), buffer.size() });
+            if (res.is_error()) return res.to_error()->error_string();
+            return res.to_ok();
         }
-        String indent_string{ indent, '\t' };
-        String prev_indent_string{ indent - 1, '\t' };
-        TRY(f.write(prev_indent_string + "{\n"_s));
-        size_t i = 0;
-        for (const auto& entry : obj) {
-            const auto& val = *entry.val();
-            const auto& key = entry.key();
-            TRY(f.write(indent_string));
-            TRY(f.write("\""_s + escape_string(key) + '"'));
-            TRY(f.write(": "_s));
-            switch (val.type()) {
-                case Type::JArray:
-                    TRY(serialize_array_to_file(f, val.as<Type::JArray>(), indent + 1));
-                    break;
-                case Type::JObject:
-                    TRY(serialize_object_to_file(f, val.as<Type::JObject>(), indent + 1));
-                    break;
-                case Type::JNumber:
-                    TRY(f.write(val.as<Type::JNumber>().to_string()));
-                    break;
-                case Type::JNull:
-                    TRY(f.write("null"_s));
-                    break;
-                case Type::JBool:
-                    TRY(f.write(BoolToStr(val.as<Type::JBool>().value())));
-                    break;
-                case Type::JString:
-                    TRY(f.write("\""_s + escape_string(val.as<Type::JString>()) + '"'));
-                    break;
-                default:
-                    ASSERT_NOT_REACHED("Invalid type in JSON object");
-                    break;
-            }
-            if (++i < obj.size()) {
-                TRY(f.write(",\n"_s));
-            } else {
-                TRY(f.write("\n"_s));
-            }
-        }
-        TRY(f.write(prev_indent_string + "}"_s));
-        return {};
-    }
-    SerializeResult serialize_array_to_file(File& f, const Array& arr, size_t indent) {
-        if (arr.size() == 0) {
-            TRY(f.write("[]"_s));
-            return {};
-        }
-        String prev_indent_string{ indent - 1, '\t' };
-        String indent_string{ indent, '\t' };
-        TRY(f.write(prev_indent_string + "[\n"));
-        size_t i = 0;
-        for (const auto& val_ptr : arr) {
-            const auto& val = *val_ptr;
-            switch (val.type()) {
-                case Type::JArray:
-                    TRY(serialize_array_to_file(f, val.as<Type::JArray>(), indent + 1));
-                    break;
-                case Type::JObject:
-                    TRY(serialize_object_to_file(f, val.as<Type::JObject>(), indent + 1));
-                    break;
-                case Type::JNumber:
-                    TRY(f.write(indent_string));
-                    TRY(f.write(val.as<Type::JNumber>().to_string()));
-                    break;
-                case Type::JNull:
-                    TRY(f.write(indent_string));
-                    TRY(f.write("null"_s));
-                    break;
-                case Type::JBool:
-                    TRY(f.write(indent_string));
-                    TRY(f.write(BoolToStr(val.as<Type::JBool>().value())));
-                    break;
-                case Type::JString:
-                    TRY(f.write(indent_string));
-                    TRY(f.write("\""_s + escape_string(val.as<Type::JString>()) + '"'));
-                    break;
-                default:
-                    ASSERT_NOT_REACHED("Invalid type in JSON object");
-                    break;
-            }
-            if (++i < arr.size()) {
-                TRY(f.write(",\n"_s));
-            } else {
-                TRY(f.write("\n"_s));
-            }
-        }
-        TRY(f.write(prev_indent_string + "]"_s));
-        return {};
-    }
+        Result<Vector<uint8_t>> read(size_t) override { return "A FileSink can't be read from"_s; }
+        Result<Vector<uint8_t>> read() override { return "A FileSink can't be read from"_s; }
+        size_t pos() const override { return m_file.pos(); }
+        size_t seek(size_t pos) override { return m_file.seek(pos); }
+    };
     SerializeResult ValueObj::serialize_to_file(File& f) const {
-        switch (m_type) {
-            case Type::JArray:
-                TRY(serialize_array_to_file(f, as<Array>(), 1));
-                break;
-            case Type::JObject:
-                TRY(serialize_object_to_file(f, as<Object>(), 1));
-                break;
-            case Type::JBool:
-                TRY(f.write(BoolToStr(as<Bool>().value())));
-                break;
-            case Type::JNull:
-                TRY(f.write("null"_s));
-                break;
-            case Type::JNumber:
-                TRY(f.write(as<Type::JNumber>().to_string()));
-                break;
-            case Type::JString:
-                TRY(f.write("\""_s + escape_string(as<Type::JString>()) + '"'));
-                break;
-        }
+        // same output as dump_json, but it goes to the file every flush_threshold bytes instead of being built
+        // in memory whole first
+        FileSink sink{ f };
+        Writer writer{ sink, WriteMode::Pretty };
+        writer.value(*this);
+        auto res = writer.flush();
+        if (res.is_error()) return FileError{ res.to_error()->error_string().str(), f.name() };
         return {};
     }
 }    // namespace JSON
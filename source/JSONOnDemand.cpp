@@ -0,0 +1,280 @@
+#include "JSONOnDemand.hpp"
+namespace ARLib {
+namespace JSON {
+    static bool is_json_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+    ErrorInfo OnDemandDocument::error_at(size_t pos, const char* message) const {
+        if (at_end(pos)) return ErrorInfo{ String{ message } + " but end of file was reached", m_index.view().size() };
+        return ErrorInfo{ String::formatted("%s but got '%c'", message, char_at(pos)), m_index[pos] };
+    }
+    Parsed<size_t> OnDemandDocument::skip_value(size_t pos) const {
+        if (at_end(pos)) return ParseError{ error_at(pos, "Expected a value") };
+        switch (char_at(pos)) {
+            case '"':
+                return pos + 2;
+            case '{':
+            case '[':
+                {
+                    // the tape already has everything that isn't part of a string, so skipping a container is just
+                    // a matter of counting brackets, the closing quote of a string is skipped with the opening one
+                    size_t depth = 1;
+                    ++pos;
+                    while (depth != 0) {
+                        if (at_end(pos)) return ParseError{ error_at(pos, "Expected the end of the container") };
+                        switch (char_at(pos)) {
+                            case '{':
+                            case '[':
+                                ++depth;
+                                break;
+                            case '}':
+                            case ']':
+                                --depth;
+                                break;
+                            case '"':
+                                ++pos;
+                                break;
+                            default:
+                                break;
+                        }
+                        ++pos;
+                    }
+                    return pos;
+                }
+            case '}':
+            case ']':
+            case ':':
+            case ',':
+                return ParseError{ error_at(pos, "Expected a value") };
+            default:
+                return pos + 1;
+        }
+    }
+    Parsed<bool> OnDemandDocument::next_element(size_t& pos, char close) const {
+        if (!at_end(pos)) {
+            const char c = char_at(pos++);
+            if (c == ',') return true;
+            if (c == close) return false;
+            --pos;
+        }
+        return ParseError{ error_at(pos, close == ']' ? "Expected ',' or ']'" : "Expected ',' or '}'") };
+    }
+    Parsed<OnDemandDocument> OnDemandDocument::parse(StringView source) {
+        TRY_SET(index, StructuralIndex::build(source));
+        if (index.size() == 0) return ParseError{ "Expected a valid json type but the input is empty"_s, 0 };
+        return OnDemandDocument{ move(index) };
+    }
+    OnDemandValue OnDemandDocument::root() {
+        return OnDemandValue{ this, 0 };
+    }
+    OnDemandValue OnDemandValue::fail(const char* message) const {
+        return OnDemandValue{ m_document, m_document->error_at(m_pos, message) };
+    }
+    size_t OnDemandValue::offset() const {
+        if (!m_ok) return m_error.error_offset;
+        if (m_document->at_end(m_pos)) return m_document->m_index.view().size();
+        return m_document->m_index[m_pos];
+    }
+    Parsed<Type> OnDemandValue::type() const {
+        if (!m_ok) return ParseError{ error_info() };
+        if (m_document->at_end(m_pos)) return ParseError{ m_document->error_at(m_pos, "Expected a value") };
+        switch (m_document->char_at(m_pos)) {
+            case '{':
+                return Type::JObject;
+            case '[':
+                return Type::JArray;
+            case '"':
+                return Type::JString;
+            case 't':
+            case 'f':
+                return Type::JBool;
+            case 'n':
+                return Type::JNull;
+            case '-':
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+                return Type::JNumber;
+            default:
+                return ParseError{ m_document->error_at(m_pos, "Expected a value") };
+        }
+    }
+    bool OnDemandValue::is_null() const {
+        auto raw = scalar_view();
+        if (raw.is_error()) {
+            raw.ignore_error();
+            return false;
+        }
+        return raw.to_ok() == "null"_sv;
+    }
+    OnDemandValue OnDemandValue::operator[](StringView key) const {
+        if (!m_ok) return *this;
+        const auto& doc = *m_document;
+        if (doc.at_end(m_pos) || doc.char_at(m_pos) != '{') return fail("Expected an object");
+        const auto view = doc.m_index.view();
+        size_t pos      = m_pos + 1;
+        auto not_found = [&]() { return OnDemandValue{ m_document, "Key not found", doc.m_index[m_pos] }; };
+        if (!doc.at_end(pos) && doc.char_at(pos) == '}') return not_found();
+        while (true) {
+            if (doc.at_end(pos) || doc.char_at(pos) != '"') {
+                return OnDemandValue{ m_document, doc.error_at(pos, "Expected a string key") };
+            }
+            const char* begin = view.data() + doc.m_index[pos] + 1;
+            const char* end   = view.data() + doc.m_index[pos + 1];
+            bool matches      = false;
+            if (detail::find_escape_or_control(begin, end) == end) {
+                matches = StringView{ begin, end } == key;
+            } else {
+                String unescaped{};
+                auto res = detail::unescape_string(unescaped, begin, end, view.data());
+                if (res.is_error()) return OnDemandValue{ m_document, res.to_error()->info() };
+                matches = unescaped.view() == key;
+            }
+            pos += 2;
+            if (doc.at_end(pos) || doc.char_at(pos) != ':') {
+                return OnDemandValue{ m_document, doc.error_at(pos, "Expected ':'") };
+            }
+            ++pos;
+            if (matches) return OnDemandValue{ m_document, pos };
+            auto skipped = doc.skip_value(pos);
+            if (skipped.is_error()) return OnDemandValue{ m_document, skipped.to_error()->info() };
+            pos       = skipped.to_ok();
+            auto more = doc.next_element(pos, '}');
+            if (more.is_error()) return OnDemandValue{ m_document, more.to_error()->info() };
+            if (!more.to_ok()) return not_found();
+        }
+    }
+    OnDemandValue OnDemandValue::operator[](size_t index) const {
+        if (!m_ok) return *this;
+        const auto& doc = *m_document;
+        if (doc.at_end(m_pos) || doc.char_at(m_pos) != '[') return fail("Expected an array");
+        auto out_of_bounds = [&]() { return OnDemandValue{ m_document, "Index out of bounds", doc.m_index[m_pos] }; };
+        size_t pos = m_pos + 1;
+        if (!doc.at_end(pos) && doc.char_at(pos) == ']') return out_of_bounds();
+        for (size_t i = 0;; ++i) {
+            if (i == index) return OnDemandValue{ m_document, pos };
+            auto skipped = doc.skip_value(pos);
+            if (skipped.is_error()) return OnDemandValue{ m_document, skipped.to_error()->info() };
+            pos       = skipped.to_ok();
+            auto more = doc.next_element(pos, ']');
+            if (more.is_error()) return OnDemandValue{ m_document, more.to_error()->info() };
+            if (!more.to_ok()) return out_of_bounds();
+        }
+    }
+    // a scalar runs until the next structural, minus the whitespace before it
+    Parsed<StringView> OnDemandValue::scalar_view() const {
+        if (!m_ok) return ParseError{ error_info() };
+        const auto& doc = *m_document;
+        if (doc.at_end(m_pos)) return ParseError{ doc.error_at(m_pos, "Expected a value") };
+        const char* data  = doc.m_index.view().data();
+        const char* begin = data + doc.m_index[m_pos];
+        const char* end   = data + doc.m_index[m_pos + 1];
+        while (end > begin && is_json_space(end[-1])) --end;
+        return StringView{ begin, end };
+    }
+    Parsed<int64_t> OnDemandValue::get_int64() const {
+        TRY_SET(raw, scalar_view());
+        const char* base = m_document->m_index.view().data();
+        TRY_SET(number, detail::parse_number(raw.data(), raw.data() + raw.size(), base));
+        if (!number.is_integer()) return ParseError{ m_document->error_at(m_pos, "Expected an integer") };
+        return number.value_integer();
+    }
+    Parsed<uint64_t> OnDemandValue::get_uint64() const {
+        TRY_SET(raw, scalar_view());
+        // parse_number stops at the max of int64_t, plain digits that may go past it are converted here
+        bool digits_only = raw.size() > 18 && raw[0] != '0';
+        for (size_t i = 0; i < raw.size() && digits_only; ++i) { digits_only = raw[i] >= '0' && raw[i] <= '9'; }
+        if (digits_only) {
+            uint64_t result = 0;
+            for (size_t i = 0; i < raw.size(); ++i) {
+                const auto digit = static_cast<uint64_t>(raw[i] - '0');
+                if (result > (NumberTraits<uint64_t>::max - digit) / 10) {
+                    return ParseError{ m_document->error_at(m_pos, "Integer out of range") };
+                }
+                result = result * 10 + digit;
+            }
+            return result;
+        }
+        const char* base = m_document->m_index.view().data();
+        TRY_SET(number, detail::parse_number(raw.data(), raw.data() + raw.size(), base));
+        if (!number.is_integer() || number.value_integer() < 0) {
+            return ParseError{ m_document->error_at(m_pos, "Expected an unsigned integer") };
+        }
+        return static_cast<uint64_t>(number.value_integer());
+    }
+    Parsed<double> OnDemandValue::get_double() const {
+        TRY_SET(raw, scalar_view());
+        const char* base = m_document->m_index.view().data();
+        TRY_SET(number, detail::parse_number(raw.data(), raw.data() + raw.size(), base));
+        if (number.is_integer()) return static_cast<double>(number.value_integer());
+        return number.value_double();
+    }
+    Parsed<bool> OnDemandValue::get_bool() const {
+        TRY_SET(raw, scalar_view());
+        if (raw == "true"_sv) return true;
+        if (raw == "false"_sv) return false;
+        return ParseError{ m_document->error_at(m_pos, "Expected a boolean") };
+    }
+    Parsed<StringView> OnDemandValue::get_raw_view() const {
+        if (!m_ok) return ParseError{ error_info() };
+        const auto& doc = *m_document;
+        if (doc.at_end(m_pos)) return ParseError{ doc.error_at(m_pos, "Expected a value") };
+        const char* data = doc.m_index.view().data();
+        switch (doc.char_at(m_pos)) {
+            case '"':
+                return StringView{ data + doc.m_index[m_pos] + 1, data + doc.m_index[m_pos + 1] };
+            case '{':
+            case '[':
+                {
+                    TRY_SET(end, doc.skip_value(m_pos));
+                    return StringView{ data + doc.m_index[m_pos], data + doc.m_index[end - 1] + 1 };
+                }
+            default:
+                return scalar_view();
+        }
+    }
+    Parsed<StringView> OnDemandValue::get_string_view() const {
+        if (!m_ok) return ParseError{ error_info() };
+        auto& doc = *m_document;
+        if (doc.at_end(m_pos) || doc.char_at(m_pos) != '"') {
+            return ParseError{ doc.error_at(m_pos, "Expected a string") };
+        }
+        const char* data  = doc.m_index.view().data();
+        const char* begin = data + doc.m_index[m_pos] + 1;
+        const char* end   = data + doc.m_index[m_pos + 1];
+        if (detail::find_escape_or_control(begin, end) == end) return StringView{ begin, end };
+        if (auto it = doc.m_decoded_at.find(m_pos); it != doc.m_decoded_at.end()) {
+            return doc.m_decoded[(*it).val()]->view();
+        }
+        UniquePtr<String> decoded{ String{} };
+        TRY(detail::unescape_string(*decoded, begin, end, data));
+        const StringView view = decoded->view();
+        doc.m_decoded_at.insert(size_t{ m_pos }, doc.m_decoded.size());
+        doc.m_decoded.append(move(decoded));
+        return view;
+    }
+    Parsed<String> OnDemandValue::get_string() const {
+        TRY_SET(view, get_string_view());
+        return view.str();
+    }
+    Parsed<size_t> OnDemandValue::count() const {
+        TRY_SET(type, this->type());
+        size_t count = 0;
+        if (type == Type::JArray) {
+            TRY(for_each_element([&count](const OnDemandValue&) { ++count; }));
+        } else if (type == Type::JObject) {
+            TRY(for_each_field([&count](StringView, const OnDemandValue&) { ++count; }));
+        } else {
+            return ParseError{ m_document->error_at(m_pos, "Expected an array or an object") };
+        }
+        return count;
+    }
+}    // namespace JSON
+}    // namespace ARLib
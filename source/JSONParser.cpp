@@ -2,6 +2,8 @@
 
 #include "Algorithm.hpp"
 #include "JSONObject.hpp"
+#include "JSONWriter.hpp"
+#include "MappedFile.hpp"
 #include "Optional.hpp"
 #include "Pair.hpp"
 namespace ARLib {
@@ -252,198 +254,45 @@ namespace JSON {
         return obj;
     }
     // FIXME: fix indentation
+    // the opening bracket of a container goes at the indentation of the level above its elements
+    template <typename T>
+    static String dump_pretty(const T& value, size_t indent) {
+        const size_t base_indent = indent == 0 ? 0 : indent - 1;
+        Writer writer{ WriteMode::Pretty, base_indent };
+        writer.value(value);
+        if (base_indent == 0) return writer.release();
+        return String{ base_indent, '\t' } + writer.str();
+    }
     String dump_array(const Array& arr, size_t indent) {
         if (arr.size() == 0) return "[]"_s;
-        String prev_indent_string{ indent - 1, '\t' };
-        String indent_string{ indent, '\t' };
-        String repr{ prev_indent_string + "[\n" };
-        size_t i = 0;
-        for (const auto& val_ptr : arr) {
-            const auto& val = *val_ptr;
-            switch (val.type()) {
-                case Type::JArray:
-                    repr.append(dump_array(val.as<Type::JArray>(), indent + 1));
-                    break;
-                case Type::JObject:
-                    repr.append(dump_object(val.as<Type::JObject>(), indent + 1));
-                    break;
-                case Type::JNumber:
-                    repr.append(indent_string + val.as<Type::JNumber>().to_string());
-                    break;
-                case Type::JNull:
-                    repr.append(indent_string + "null"_s);
-                    break;
-                case Type::JBool:
-                    repr.append(indent_string + BoolToStr(val.as<Type::JBool>().value()));
-                    break;
-                case Type::JString:
-                    repr.append(indent_string + "\""_s + escape_string(val.as<Type::JString>()) + '"');
-                    break;
-                default:
-                    ASSERT_NOT_REACHED("Invalid type in JSON object");
-                    break;
-            }
-            if (++i < arr.size()) {
-                repr.append(",\n");
-            } else {
-                repr.append('\n');
-            }
-        }
-        repr.append(prev_indent_string + "]"_s);
-        return repr;
+        return dump_pretty(arr, indent);
+    }
+    String dump_object(const Object& obj, size_t indent) {
+        if (obj.size() == 0) return "{}"_s;
+        return dump_pretty(obj, indent);
     }
     String dump_array_compact(const Array& arr) {
-        String repr{ "[" };
-        size_t i = 0;
-        for (const auto& val_ptr : arr) {
-            const auto& val = *val_ptr;
-            switch (val.type()) {
-                case Type::JArray:
-                    repr.append(dump_array_compact(val.as<Type::JArray>()));
-                    break;
-                case Type::JObject:
-                    repr.append(dump_object_compact(val.as<Type::JObject>()));
-                    break;
-                case Type::JNumber:
-                    repr.append(val.as<Type::JNumber>().to_string());
-                    break;
-                case Type::JNull:
-                    repr.append("null"_s);
-                    break;
-                case Type::JBool:
-                    repr.append(BoolToStr(val.as<Type::JBool>().value()));
-                    break;
-                case Type::JString:
-                    repr.append("\""_s + escape_string(val.as<Type::JString>()) + '"');
-                    break;
-                default:
-                    ASSERT_NOT_REACHED("Invalid type in JSON object");
-                    break;
-            }
-            if (++i < arr.size()) { repr.append(","); }
-        }
-        repr.append(']');
-        return repr;
+        Writer writer{};
+        writer.value(arr);
+        return writer.release();
     }
     String dump_object_compact(const Object& obj) {
-        String repr{ "{" };
-        for (const auto& entry : obj) {
-            const auto& val = *entry.val();
-            const auto& key = entry.key();
-            repr.append("\""_s + escape_string(key) + '"');
-            repr.append(":"_s);
-            switch (val.type()) {
-                case Type::JArray:
-                    repr.append(dump_array_compact(val.as<Type::JArray>()));
-                    break;
-                case Type::JObject:
-                    repr.append(dump_object_compact(val.as<Type::JObject>()));
-                    break;
-                case Type::JNumber:
-                    repr.append(val.as<Type::JNumber>().to_string());
-                    break;
-                case Type::JNull:
-                    repr.append("null"_s);
-                    break;
-                case Type::JBool:
-                    repr.append(BoolToStr(val.as<Type::JBool>().value()));
-                    break;
-                case Type::JString:
-                    repr.append("\""_s + escape_string(val.as<Type::JString>()) + '"');
-                    break;
-                default:
-                    ASSERT_NOT_REACHED("Invalid type in JSON object");
-                    break;
-            }
-        }
-        repr.append("}");
-        return repr;
-    }
-    String dump_object(const Object& obj, size_t indent) {
-        if (obj.size() == 0) return "{}"_s;
-        String indent_string{ indent, '\t' };
-        String prev_indent_string{ indent - 1, '\t' };
-        String repr{ prev_indent_string + "{\n"_s };
-        size_t i = 0;
-        for (const auto& entry : obj) {
-            const auto& val = *entry.val();
-            const auto& key = entry.key();
-            repr.append(indent_string);
-            repr.append("\""_s + escape_string(key) + '"');
-            repr.append(": "_s);
-            switch (val.type()) {
-                case Type::JArray:
-                    {
-                        String arrrepr = dump_array(val.as<Type::JArray>(), indent + 1);
-                        arrrepr.iltrim();
-                        repr.append(move(arrrepr));
-                    }
-                    break;
-                case Type::JObject:
-                    {
-                        String objrepr = dump_object(val.as<Type::JObject>(), indent + 1);
-                        objrepr.iltrim();
-                        repr.append(move(objrepr));
-                    }
-                    break;
-                case Type::JNumber:
-                    repr.append(val.as<Type::JNumber>().to_string());
-                    break;
-                case Type::JNull:
-                    repr.append("null"_s);
-                    break;
-                case Type::JBool:
-                    repr.append(BoolToStr(val.as<Type::JBool>().value()));
-                    break;
-                case Type::JString:
-                    repr.append("\""_s + escape_string(val.as<Type::JString>()) + '"');
-                    break;
-                default:
-                    ASSERT_NOT_REACHED("Invalid type in JSON object");
-                    break;
-            }
-            if (++i < obj.size()) {
-                repr.append(",\n");
-            } else {
-                repr.append('\n');
-            }
-        }
-        repr.append(prev_indent_string + "}"_s);
-        return repr;
+        Writer writer{};
+        writer.value(obj);
+        return writer.release();
     }
     String dump_json(const ValueObj& val, size_t index) {
         switch (val.type()) {
             case JSON::Type::JArray:
                 return dump_array(val.as<Type::JArray>(), index);
-            case JSON::Type::JBool:
-                return BoolToStr(val.as<Type::JBool>().value());
-            case JSON::Type::JNull:
-                return "null"_s;
-            case JSON::Type::JNumber:
-                return val.as<Type::JNumber>().to_string();
             case JSON::Type::JObject:
                 return dump_object(val.as<Type::JObject>(), index);
-            case JSON::Type::JString:
-                return "\""_s + escape_string(val.as<Type::JString>()) + "\""_s;
+            default:
+                return to_json(val);
         }
-        return "{}"_s;
     }
     String dump_json_compact(const ValueObj& val) {
-        switch (val.type()) {
-            case JSON::Type::JArray:
-                return dump_array_compact(val.as<Type::JArray>());
-            case JSON::Type::JBool:
-                return BoolToStr(val.as<Type::JBool>().value());
-            case JSON::Type::JNull:
-                return "null"_s;
-            case JSON::Type::JNumber:
-                return val.as<Type::JNumber>().to_string();
-            case JSON::Type::JObject:
-                return dump_object_compact(val.as<Type::JObject>());
-            case JSON::Type::JString:
-                return "\""_s + escape_string(val.as<Type::JString>()) + "\""_s;
-        }
-        return "{}"_s;
+        return to_json(val);
     }
 #define CHECK_STATE_AT_END()                                                                                           \
     skip_whitespace(state);                                                                                            \
@@ -508,15 +357,11 @@ namespace JSON {
         return p.parse_internal();
     }
     ParseResult Parser::from_file(const Path& filename) {
-        File f{ filename };
-        if (auto err = f.open(OpenFileMode::Read); err.is_error()) {
-            return ParseError{ err.to_error()->error_string(), 0 };
-        }
-        auto val_or_err = f.read_all();
-        if (val_or_err.is_error()) { return ParseError{ val_or_err.to_error()->error_string(), 0 };
-        }
-        auto val = val_or_err.to_ok();
-        TRY_RET(Parser::parse(val.view()));
+        // the document owns copies of everything it needs, the file is parsed where it's mapped
+        auto file_or_err = MappedFile::open(filename, MappedFile::sequential);
+        if (file_or_err.is_error()) { return ParseError{ file_or_err.to_error()->error_string(), 0 }; }
+        const auto file = file_or_err.to_ok();
+        TRY_RET(Parser::parse(file.view()));
     }
 }    // namespace JSON
 }    // namespace ARLib
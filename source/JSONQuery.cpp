@@ -0,0 +1,236 @@
+#include "JSONQuery.hpp"
+#include "CharConv.hpp"
+namespace ARLib {
+namespace JSON {
+    namespace detail {
+        SliceBounds slice_bounds(const Query::Step& step, size_t len) {
+            const int64_t size = static_cast<int64_t>(len);
+            auto clamp         = [size](int64_t bound, int64_t low, int64_t high) {
+                if (bound < 0) bound += size;
+                return bound < low ? low : (bound > high ? high : bound);
+            };
+            if (step.step > 0) {
+                return SliceBounds{ step.has_start ? clamp(step.start, 0, size) : 0,
+                                    step.has_end ? clamp(step.end, 0, size) : size, step.step };
+            }
+            return SliceBounds{ step.has_start ? clamp(step.start, -1, size - 1) : size - 1,
+                                step.has_end ? clamp(step.end, -1, size - 1) : -1, step.step };
+        }
+        size_t resolve_index(int64_t index, size_t len) {
+            const int64_t resolved = index < 0 ? index + static_cast<int64_t>(len) : index;
+            if (resolved < 0 || resolved >= static_cast<int64_t>(len)) return static_cast<size_t>(-1);
+            return static_cast<size_t>(resolved);
+        }
+    }    // namespace detail
+    // "0" or digits without a leading zero, like RFC 6901 wants for array indices
+    static int64_t as_array_index(StringView token) {
+        if (token.size() == 0 || token.size() > 18 || (token.size() > 1 && token[0] == '0')) return -1;
+        int64_t value = 0;
+        for (char c : token) {
+            if (c < '0' || c > '9') return -1;
+            value = value * 10 + (c - '0');
+        }
+        return value;
+    }
+    void Query::add_member(String&& key, bool index_allowed) {
+        Step step{};
+        step.kind  = Step::Kind::Member;
+        step.hash  = Hash<String>{}(key);
+        step.index = index_allowed ? as_array_index(key.view()) : -1;
+        step.key   = move(key);
+        m_steps.append(move(step));
+    }
+    Parsed<Query> Query::pointer(StringView pointer) {
+        Query query{};
+        if (pointer.size() == 0) return query;
+        if (pointer[0] != '/') return ParseError{ "A json pointer has to be empty or start with '/'"_s, 0 };
+        size_t pos = 1;
+        while (true) {
+            String token{};
+            while (pos < pointer.size() && pointer[pos] != '/') {
+                const char c = pointer[pos];
+                if (c == '~') {
+                    const char next = pos + 1 < pointer.size() ? pointer[pos + 1] : '\0';
+                    if (next != '0' && next != '1') {
+                        return ParseError{ "Invalid escape in json pointer, only ~0 and ~1 are allowed"_s, pos };
+                    }
+                    token.append(next == '0' ? '~' : '/');
+                    pos += 2;
+                } else {
+                    token.append(c);
+                    ++pos;
+                }
+            }
+            query.add_member(move(token), true);
+            if (pos == pointer.size()) return query;
+            ++pos;
+        }
+    }
+    // [-]digits starting at pos, pos is left after them
+    static Parsed<int64_t> parse_path_integer(StringView path, size_t& pos) {
+        const size_t begin = pos;
+        if (pos < path.size() && path[pos] == '-') ++pos;
+        while (pos < path.size() && path[pos] >= '0' && path[pos] <= '9') ++pos;
+        auto value = StrViewToI64(path.substringview(begin, pos));
+        if (value.is_error()) {
+            value.ignore_error();
+            return ParseError{ "Expected an integer"_s, begin };
+        }
+        return value.to_ok();
+    }
+    static void skip_path_spaces(StringView path, size_t& pos) {
+        while (pos < path.size() && path[pos] == ' ') ++pos;
+    }
+    Parsed<Query> Query::path(StringView path) {
+        Query query{};
+        if (path.size() == 0 || path[0] != '$') return ParseError{ "A json path has to start with '$'"_s, 0 };
+        size_t pos = 1;
+        while (pos < path.size()) {
+            const size_t step_begin = pos;
+            if (path[pos] == '.') {
+                ++pos;
+                if (pos < path.size() && path[pos] == '.') {
+                    return ParseError{ "Recursive descent isn't supported"_s, step_begin };
+                }
+                if (pos < path.size() && path[pos] == '*') {
+                    query.m_steps.append(Step{ .kind = Step::Kind::Wildcard });
+                    query.m_single = false;
+                    ++pos;
+                    continue;
+                }
+                while (pos < path.size() && path[pos] != '.' && path[pos] != '[') ++pos;
+                if (pos == step_begin + 1) return ParseError{ "Expected a member name after '.'"_s, pos };
+                query.add_member(path.substringview(step_begin + 1, pos).str(), false);
+                continue;
+            }
+            if (path[pos] != '[') return ParseError{ "Expected '.' or '['"_s, pos };
+            ++pos;
+            skip_path_spaces(path, pos);
+            if (pos == path.size()) return ParseError{ "Missing ']'"_s, step_begin };
+            const char c = path[pos];
+            if (c == '\'' || c == '"') {
+                String key{};
+                ++pos;
+                while (pos < path.size() && path[pos] != c) {
+                    if (path[pos] == '\\' && pos + 1 < path.size()) ++pos;
+                    key.append(path[pos++]);
+                }
+                if (pos == path.size()) return ParseError{ "Missing end of quotation on member name"_s, step_begin };
+                ++pos;
+                query.add_member(move(key), false);
+            } else if (c == '*') {
+                ++pos;
+                query.m_steps.append(Step{ .kind = Step::Kind::Wildcard });
+                query.m_single = false;
+            } else if (c == '?') {
+                return ParseError{ "Filters aren't supported"_s, pos };
+            } else {
+                Step step{};
+                if (c != ':') {
+                    TRY_SET(start, parse_path_integer(path, pos));
+                    step.start     = start;
+                    step.has_start = true;
+                }
+                skip_path_spaces(path, pos);
+                if (pos < path.size() && path[pos] == ':') {
+                    step.kind = Step::Kind::Slice;
+                    ++pos;
+                    skip_path_spaces(path, pos);
+                    if (pos < path.size() && path[pos] != ':' && path[pos] != ']') {
+                        TRY_SET(end, parse_path_integer(path, pos));
+                        step.end     = end;
+                        step.has_end = true;
+                    }
+                    skip_path_spaces(path, pos);
+                    if (pos < path.size() && path[pos] == ':') {
+                        ++pos;
+                        skip_path_spaces(path, pos);
+                        if (pos < path.size() && path[pos] != ']') {
+                            const size_t step_pos = pos;
+                            TRY_SET(increment, parse_path_integer(path, pos));
+                            if (increment == 0) return ParseError{ "The step of a slice can't be 0"_s, step_pos };
+                            step.step = increment;
+                        }
+                    }
+                    query.m_single = false;
+                } else {
+                    step.kind  = Step::Kind::Index;
+                    step.index = step.start;
+                }
+                if (pos < path.size() && path[pos] == ',') return ParseError{ "Unions aren't supported"_s, pos };
+                query.m_steps.append(move(step));
+            }
+            skip_path_spaces(path, pos);
+            if (pos == path.size() || path[pos] != ']') return ParseError{ "Expected ']'"_s, pos };
+            ++pos;
+        }
+        return query;
+    }
+    const ValueObj* Query::step_into(const ValueObj& value, const Step& step) {
+        if (step.kind == Step::Kind::Member && value.type() == Type::JObject) {
+            const auto& object = value.as<Type::JObject>();
+            auto it            = object.find_hashed(step.key, step.hash);
+            if (it == object.end()) return nullptr;
+            return (*it).val().get();
+        }
+        if (value.type() != Type::JArray || (step.index < 0 && step.kind == Step::Kind::Member)) return nullptr;
+        const auto& array  = value.as<Type::JArray>();
+        const size_t index = detail::resolve_index(step.index, array.size());
+        if (index == static_cast<size_t>(-1)) return nullptr;
+        return &array[index];
+    }
+    const ValueObj* Query::find_from(const ValueObj& value, size_t step) const {
+        const ValueObj* current = &value;
+        for (; step < m_steps.size(); ++step) {
+            const Step& next = m_steps[step];
+            if (next.kind == Step::Kind::Wildcard || next.kind == Step::Kind::Slice) {
+                const ValueObj* first = nullptr;
+                auto keep_first       = [&first](const ValueObj& match) {
+                    if (first == nullptr) first = &match;
+                };
+                walk(*current, step, keep_first);
+                return first;
+            }
+            current = step_into(*current, next);
+            if (current == nullptr) return nullptr;
+        }
+        return current;
+    }
+    OnDemandValue Query::step_into(const OnDemandValue& value, const Step& step) {
+        if (!value.m_ok) return value;
+        auto type = value.type();
+        if (type.is_error()) return OnDemandValue{ value.m_document, type.to_error()->info() };
+        const auto missing = [&value]() {
+            return OnDemandValue{ value.m_document, "Nothing matches the query", value.offset() };
+        };
+        if (step.kind == Step::Kind::Member && type.to_ok() == Type::JObject) return value[step.key.view()];
+        if (type.to_ok() != Type::JArray || (step.index < 0 && step.kind == Step::Kind::Member)) return missing();
+        if (step.index >= 0) return value[static_cast<size_t>(step.index)];
+        auto count = value.count();
+        if (count.is_error()) return OnDemandValue{ value.m_document, count.to_error()->info() };
+        const size_t index = detail::resolve_index(step.index, count.to_ok());
+        if (index == static_cast<size_t>(-1)) return missing();
+        return value[index];
+    }
+    OnDemandValue Query::find(const OnDemandValue& root) const {
+        if (!m_single) {
+            Optional<OnDemandValue> first{};
+            auto keep_first = [&first](const OnDemandValue& match) {
+                if (first.empty()) first = match;
+            };
+            auto res = walk(root, 0, keep_first);
+            if (res.is_error()) return OnDemandValue{ root.m_document, res.to_error()->info() };
+            if (first.empty()) {
+                return OnDemandValue{ root.m_document, "Nothing matches the query", root.offset() };
+            }
+            return move(first).value();
+        }
+        OnDemandValue current = root;
+        for (const auto& step : m_steps) {
+            current = step_into(current, step);
+            if (!current.is_ok()) return current;
+        }
+        return current;
+    }
+}    // namespace JSON
+}    // namespace ARLib
@@ -0,0 +1,253 @@
+#include "JSONStreamReader.hpp"
+#include "BitOps.hpp"
+#include <immintrin.h>
+namespace ARLib {
+namespace JSON {
+    static bool is_json_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+    static bool is_scalar_end(char c) {
+        return is_json_space(c) || c == ',' || c == ']' || c == '}';
+    }
+    static const char* find_quote_or_backslash(const char* begin, const char* end) {
+#ifdef __AVX2__
+        const auto quote     = _mm256_set1_epi8('"');
+        const auto backslash = _mm256_set1_epi8('\\');
+        while (end - begin >= 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            const auto found = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+            const auto mask  = static_cast<uint32_t>(_mm256_movemask_epi8(found));
+            if (mask != 0) return begin + internal::trailing_zeros(mask);
+            begin += 32;
+        }
+#endif
+        while (begin != end && *begin != '"' && *begin != '\\') ++begin;
+        return begin;
+    }
+    // returns the closing quote or end, escaped carries a backslash that was the last character over to the next call
+    static const char* find_string_end(const char* ptr, const char* end, bool& escaped) {
+        if (escaped && ptr != end) {
+            ++ptr;
+            escaped = false;
+        }
+        while (true) {
+            ptr = find_quote_or_backslash(ptr, end);
+            if (ptr == end || *ptr == '"') return ptr;
+            if (++ptr == end) {
+                escaped = true;
+                return end;
+            }
+            ++ptr;
+        }
+    }
+    // the shared helpers report offsets relative to the token, move them to where the token is in the whole input
+    static ParseError rebase(const ParseError& error, size_t offset) {
+        return ParseError{ error.message().view(), error.offset() + offset };
+    }
+    ParseError StreamReader::unexpected(char c, const char* expected, size_t offset) const {
+        return ParseError{ String::formatted("Invalid character, expected %s but got '%c'", expected, c), offset };
+    }
+    void StreamReader::close_container() {
+        if (m_containers.pop() == '{') {
+            m_handler.on_object_end();
+        } else {
+            m_handler.on_array_end();
+        }
+        end_value();
+    }
+    DiscardResult<ParseError> StreamReader::structural(char c, size_t offset) {
+        switch (m_state) {
+            case State::Done:
+                return ParseError{ "End of json reached but end of buffer not reached"_s, offset };
+            case State::Colon:
+                if (c != ':') return unexpected(c, "':'", offset);
+                m_state = State::Value;
+                return {};
+            case State::Separator:
+                {
+                    const bool in_object = m_containers[m_containers.size() - 1] == '{';
+                    if (c == ',') {
+                        m_state = in_object ? State::Key : State::Value;
+                    } else if (c == (in_object ? '}' : ']')) {
+                        close_container();
+                    } else {
+                        return unexpected(c, in_object ? "',' or '}'" : "',' or ']'", offset);
+                    }
+                    return {};
+                }
+            case State::FirstKey:
+            case State::Key:
+                if (m_state == State::FirstKey && c == '}') {
+                    close_container();
+                    return {};
+                }
+                if (c != '"') return unexpected(c, "a string key", offset);
+                m_in_key       = true;
+                m_state        = State::String;
+                m_token_offset = offset + 1;
+                return {};
+            default:
+                break;
+        }
+        if (m_state == State::FirstValue && c == ']') {
+            close_container();
+            return {};
+        }
+        switch (c) {
+            case '{':
+            case '[':
+                if (m_containers.size() == ParseState::depth_limit) {
+                    return ParseError{ "Reached depth limit of "_s + IntToStr(ParseState::depth_limit), offset };
+                }
+                m_containers.append(c);
+                if (c == '{') {
+                    m_handler.on_object_start();
+                    m_state = State::FirstKey;
+                } else {
+                    m_handler.on_array_start();
+                    m_state = State::FirstValue;
+                }
+                return {};
+            case '"':
+                m_in_key       = false;
+                m_state        = State::String;
+                m_token_offset = offset + 1;
+                return {};
+            case '}':
+            case ']':
+            case ':':
+            case ',':
+                return unexpected(c, "a value", offset);
+            default:
+                m_state        = State::Scalar;
+                m_token_offset = offset;
+                return {};
+        }
+    }
+    DiscardResult<ParseError> StreamReader::finish_string(const char* begin, const char* end) {
+        StringView value{ begin, end };
+        if (detail::find_escape_or_control(begin, end) != end) {
+            m_decoded.clear();
+            auto res = detail::unescape_string(m_decoded, begin, end, begin);
+            if (res.is_error()) return rebase(*res.to_error(), m_token_offset);
+            value = m_decoded.view();
+        }
+        if (m_in_key) {
+            m_handler.on_key(value);
+            m_state = State::Colon;
+        } else {
+            m_handler.on_string(value);
+            end_value();
+        }
+        return {};
+    }
+    DiscardResult<ParseError> StreamReader::finish_scalar(const char* begin, const char* end) {
+        const StringView raw{ begin, end };
+        if (raw == "true"_sv || raw == "false"_sv) {
+            m_handler.on_bool(*begin == 't');
+        } else if (raw == "null"_sv) {
+            m_handler.on_null();
+        } else if (*begin == '-' || (*begin >= '0' && *begin <= '9')) {
+            auto number = detail::parse_number(begin, end, begin);
+            if (number.is_error()) return rebase(*number.to_error(), m_token_offset);
+            m_handler.on_number(number.to_ok());
+        } else {
+            return ParseError{ "Expected a valid json type but got "_s + raw.str(), m_token_offset };
+        }
+        end_value();
+        return {};
+    }
+    // both scanners take the token straight from the chunk when it starts and ends in it, and only copy it otherwise
+    DiscardResult<ParseError> StreamReader::scan_string(const char* data, size_t size, size_t& pos) {
+        const char* begin = data + pos;
+        const char* end   = find_string_end(begin, data + size, m_escaped);
+        if (end == data + size) {
+            m_token.append(StringView{ begin, end });
+            pos = size;
+            return {};
+        }
+        pos = static_cast<size_t>(end - data) + 1;
+        if (m_token.size() == 0) return finish_string(begin, end);
+        m_token.append(StringView{ begin, end });
+        TRY(finish_string(m_token.data(), m_token.data() + m_token.size()));
+        m_token.clear();
+        return {};
+    }
+    DiscardResult<ParseError> StreamReader::scan_scalar(const char* data, size_t size, size_t& pos) {
+        const char* begin = data + pos;
+        const char* end   = begin;
+        while (end != data + size && !is_scalar_end(*end)) ++end;
+        if (end == data + size) {
+            m_token.append(StringView{ begin, end });
+            pos = size;
+            return {};
+        }
+        pos = static_cast<size_t>(end - data);
+        if (m_token.size() == 0) return finish_scalar(begin, end);
+        m_token.append(StringView{ begin, end });
+        TRY(finish_scalar(m_token.data(), m_token.data() + m_token.size()));
+        m_token.clear();
+        return {};
+    }
+    DiscardResult<ParseError> StreamReader::feed(StringView chunk) {
+        const char* data  = chunk.data();
+        const size_t size = chunk.size();
+        size_t pos        = 0;
+        while (pos < size) {
+            if (m_state == State::String) {
+                TRY(scan_string(data, size, pos));
+            } else if (m_state == State::Scalar) {
+                TRY(scan_scalar(data, size, pos));
+            } else if (is_json_space(data[pos])) {
+                ++pos;
+            } else {
+                TRY(structural(data[pos], m_offset + pos));
+                // strings start after the quote, scalars on their first character
+                if (m_state != State::Scalar) ++pos;
+            }
+        }
+        m_offset += size;
+        return {};
+    }
+    DiscardResult<ParseError> StreamReader::finish() {
+        switch (m_state) {
+            case State::Done:
+                return {};
+            case State::String:
+                return ParseError{ "Missing end of quotation on string"_s, m_offset };
+            case State::Scalar:
+                TRY(finish_scalar(m_token.data(), m_token.data() + m_token.size()));
+                m_token.clear();
+                if (m_state == State::Done) return {};
+                break;
+            case State::Value:
+                if (m_containers.size() == 0) {
+                    return ParseError{ "Expected a valid json type but the input is empty"_s, 0 };
+                }
+                break;
+            default:
+                break;
+        }
+        return ParseError{ "Expected the end of the container but end of file was reached"_s, m_offset };
+    }
+    DiscardResult<ParseError> StreamReader::parse(CharacterStream& stream, SaxHandler& handler, size_t chunk_size) {
+        StreamReader reader{ handler };
+        while (true) {
+            auto chunk = stream.read_some(chunk_size);
+            if (chunk.is_error()) return ParseError{ chunk.to_error()->error_string(), reader.offset() };
+            const auto& data = chunk.to_ok();
+            if (data.size() == 0) break;
+            TRY(reader.feed(data.view()));
+        }
+        return reader.finish();
+    }
+    DiscardResult<ParseError> StreamReader::from_file(const Path& filename, SaxHandler& handler, size_t chunk_size) {
+        File f{ filename };
+        if (auto err = f.open(OpenFileMode::Read); err.is_error()) {
+            return ParseError{ err.to_error()->error_string(), 0 };
+        }
+        FileStream stream{ move(f) };
+        return parse(stream, handler, chunk_size);
+    }
+}    // namespace JSON
+}    // namespace ARLib
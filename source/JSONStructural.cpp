@@ -0,0 +1,528 @@
+#include "JSONStructural.hpp"
+#include "BitOps.hpp"
+#include "MappedFile.hpp"
+#include <immintrin.h>
+namespace ARLib {
+namespace JSON {
+    static bool is_json_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+    static bool is_digit(char c) {
+        return c >= '0' && c <= '9';
+    }
+    // bit i of every mask is set if byte i of the block is in that class
+    struct BlockMasks {
+        uint64_t backslash;
+        uint64_t quote;
+        uint64_t whitespace;
+        uint64_t op;
+    };
+    constexpr size_t block_size = 64;
+#ifdef __AVX2__
+    static uint64_t movemask64(__m256i lo, __m256i hi) {
+        const auto lo_bits = static_cast<uint32_t>(_mm256_movemask_epi8(lo));
+        const auto hi_bits = static_cast<uint32_t>(_mm256_movemask_epi8(hi));
+        return uint64_t{ lo_bits } | (uint64_t{ hi_bits } << 32);
+    }
+    static uint64_t match_byte(__m256i lo, __m256i hi, char c) {
+        const auto needle = _mm256_set1_epi8(c);
+        return movemask64(_mm256_cmpeq_epi8(lo, needle), _mm256_cmpeq_epi8(hi, needle));
+    }
+    // looks up the low nibble of every byte in table and keeps the bytes that found themselves,
+    // bytes >= 0x80 always look up 0 so they never match
+    static uint64_t match_table(__m256i lo, __m256i hi, __m256i table) {
+        return movemask64(
+        _mm256_cmpeq_epi8(_mm256_shuffle_epi8(table, lo), lo), _mm256_cmpeq_epi8(_mm256_shuffle_epi8(table, hi), hi)
+        );
+    }
+    static BlockMasks classify_block(const char* block) {
+        const auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        const auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+        // ' ' 0x20, '\t' 0x09, '\n' 0x0A, '\r' 0x0D all have a different low nibble
+        const auto whitespace_table = _mm256_setr_epi8(
+        ' ', -1, -1, -1, -1, -1, -1, -1, -1, '\t', '\n', -1, -1, '\r', -1, -1, ' ', -1, -1, -1, -1, -1, -1, -1, -1,
+        '\t', '\n', -1, -1, '\r', -1, -1
+        );
+        // or-ing 0x20 folds '[' into '{' and ']' into '}', after that ':' ',' '{' '}' have a different low nibble
+        const auto op_table = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, ':', '{', ',', '}', -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        ':', '{', ',', '}', -1, -1
+        );
+        const auto fold = _mm256_set1_epi8(0x20);
+        BlockMasks masks{};
+        masks.backslash  = match_byte(lo, hi, '\\');
+        masks.quote      = match_byte(lo, hi, '"');
+        masks.whitespace = match_table(lo, hi, whitespace_table);
+        masks.op         = match_table(_mm256_or_si256(lo, fold), _mm256_or_si256(hi, fold), op_table);
+        return masks;
+    }
+#else
+    static BlockMasks classify_block(const char* block) {
+        BlockMasks masks{};
+        for (size_t i = 0; i < block_size; ++i) {
+            const uint64_t bit = uint64_t{ 1 } << i;
+            switch (block[i]) {
+                case '\\':
+                    masks.backslash |= bit;
+                    break;
+                case '"':
+                    masks.quote |= bit;
+                    break;
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r':
+                    masks.whitespace |= bit;
+                    break;
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case ':':
+                case ',':
+                    masks.op |= bit;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return masks;
+    }
+#endif
+    // bit i of the result is the xor of bits 0..i of the input
+    static uint64_t prefix_xor(uint64_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+    // carries the state that crosses from one block to the next
+    class BlockScanner {
+        uint64_t m_next_is_escaped = 0;
+        // all ones if the previous block ended inside a string
+        uint64_t m_prev_in_string = 0;
+        uint64_t m_prev_scalar    = 0;
+        constexpr static uint64_t odd_bits = 0xAAAA'AAAA'AAAA'AAAAull;
+
+        // a character is escaped if it's preceded by an odd-length run of backslashes
+        uint64_t escaped_bits(uint64_t backslash) {
+            if (backslash == 0) {
+                const uint64_t escaped = m_next_is_escaped;
+                m_next_is_escaped      = 0;
+                return escaped;
+            }
+            // a backslash that is itself escaped can't escape anything
+            const uint64_t potential_escape = backslash & ~m_next_is_escaped;
+            // subtracting each run of backslashes from the odd bits carries past the end of the run, the carry lands
+            // on the odd or even bit depending on where the run started and how long it is
+            const uint64_t escape_and_terminal =
+            (((potential_escape << 1) | odd_bits) - potential_escape) ^ odd_bits;
+            const uint64_t escaped = escape_and_terminal ^ (backslash | m_next_is_escaped);
+            m_next_is_escaped      = (escape_and_terminal & backslash) >> 63;
+            return escaped;
+        }
+
+        public:
+        // returns the bits of the block that go on the tape
+        uint64_t next(const BlockMasks& masks) {
+            const uint64_t quote     = masks.quote & ~escaped_bits(masks.backslash);
+            const uint64_t in_string = prefix_xor(quote) ^ m_prev_in_string;
+            m_prev_in_string         = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+            // in_string includes the opening quote but not the closing one, the tail is the other way around
+            const uint64_t string_tail     = in_string ^ quote;
+            const uint64_t scalar          = ~(masks.op | masks.whitespace);
+            const uint64_t nonquote_scalar = scalar & ~quote;
+            const uint64_t follows_scalar  = (nonquote_scalar << 1) | m_prev_scalar;
+            m_prev_scalar                  = nonquote_scalar >> 63;
+            const uint64_t scalar_start    = scalar & ~follows_scalar;
+            return ((masks.op | scalar_start) & ~string_tail) | (quote & ~in_string);
+        }
+        bool in_string() const { return m_prev_in_string != 0; }
+    };
+    static void flatten_bits(Vector<uint32_t>& indices, uint32_t base, uint64_t bits) {
+        while (bits != 0) {
+            indices.append(base + internal::trailing_zeros(bits));
+            bits &= bits - 1;
+        }
+    }
+    Parsed<StructuralIndex> StructuralIndex::build(StringView view) {
+        StructuralIndex index{};
+        TRY(index.rebuild(view));
+        return index;
+    }
+    DiscardResult<ParseError> StructuralIndex::rebuild(StringView view) {
+        if (view.size() >= NumberTraits<uint32_t>::max) {
+            return ParseError{ "Input is too big to be indexed with 32 bit offsets"_s, 0 };
+        }
+        m_view            = view;
+        const char* data  = view.data();
+        const size_t size = view.size();
+        m_indices.clear_retain();
+        // most json has a structural every few bytes, this avoids most of the regrowing
+        m_indices.reserve(size / 4 + 2);
+        BlockScanner scanner{};
+        size_t offset = 0;
+        for (; offset + block_size <= size; offset += block_size) {
+            flatten_bits(m_indices, static_cast<uint32_t>(offset), scanner.next(classify_block(data + offset)));
+        }
+        if (offset < size) {
+            // the tail is padded with whitespace, which never ends up on the tape
+            char padded[block_size];
+            for (size_t i = 0; i < block_size; ++i) { padded[i] = offset + i < size ? data[offset + i] : ' '; }
+            flatten_bits(m_indices, static_cast<uint32_t>(offset), scanner.next(classify_block(padded)));
+        }
+        if (scanner.in_string()) { return ParseError{ "Missing end of quotation on string"_s, size }; }
+        m_indices.append(static_cast<uint32_t>(size));
+        return {};
+    }
+    static bool parse_hex4(const char* ptr, const char* end, uint32_t& value) {
+        if (end - ptr < 4) return false;
+        value = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const char c = ptr[i];
+            uint32_t digit;
+            if (c >= '0' && c <= '9') {
+                digit = static_cast<uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                digit = static_cast<uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                digit = static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                return false;
+            }
+            value = (value << 4) | digit;
+        }
+        return true;
+    }
+    static void append_utf8(String& str, uint32_t code_point) {
+        if (code_point < 0x80) {
+            str.append(static_cast<char>(code_point));
+        } else if (code_point < 0x800) {
+            str.append(static_cast<char>(0xC0 | (code_point >> 6)));
+            str.append(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else if (code_point < 0x10000) {
+            str.append(static_cast<char>(0xE0 | (code_point >> 12)));
+            str.append(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            str.append(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else {
+            str.append(static_cast<char>(0xF0 | (code_point >> 18)));
+            str.append(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            str.append(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            str.append(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+    }
+    namespace detail {
+        const char* find_escape_or_control(const char* begin, const char* end) {
+#ifdef __AVX2__
+            const auto backslash = _mm256_set1_epi8('\\');
+            const auto control   = _mm256_set1_epi8(0x1F);
+            while (end - begin >= 32) {
+                const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+                // there's no unsigned compare, a byte is <= 0x1F if max(byte, 0x1F) is still 0x1F
+                const auto is_control = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control);
+                const auto found      = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, backslash), is_control);
+                const auto mask       = static_cast<uint32_t>(_mm256_movemask_epi8(found));
+                if (mask != 0) return begin + internal::trailing_zeros(mask);
+                begin += 32;
+            }
+#endif
+            while (begin != end && *begin != '\\' && static_cast<unsigned char>(*begin) >= 0x20) ++begin;
+            return begin;
+        }
+        DiscardResult<ParseError> unescape_string(String& str, const char* begin, const char* end, const char* base) {
+            auto offset_of     = [base](const char* ptr) { return static_cast<size_t>(ptr - base); };
+            const char* escape = find_escape_or_control(begin, end);
+            const char* run    = begin;
+            // the closing quote can't be escaped, so there's always a character after a backslash
+            while (escape != end) {
+                if (*escape != '\\') return ParseError{ "Unescaped control character in string"_s, offset_of(escape) };
+                str.append(StringView{ run, escape });
+                const char* sequence = escape++;
+                switch (*escape++) {
+                    case '"':
+                        str.append('"');
+                        break;
+                    case '\\':
+                        str.append('\\');
+                        break;
+                    case '/':
+                        str.append('/');
+                        break;
+                    case 'b':
+                        str.append('\b');
+                        break;
+                    case 'f':
+                        str.append('\f');
+                        break;
+                    case 'n':
+                        str.append('\n');
+                        break;
+                    case 'r':
+                        str.append('\r');
+                        break;
+                    case 't':
+                        str.append('\t');
+                        break;
+                    case 'u':
+                        {
+                            uint32_t code_point = 0;
+                            if (!parse_hex4(escape, end, code_point)) {
+                                return ParseError{ "Invalid unicode escape sequence"_s, offset_of(sequence) };
+                            }
+                            escape += 4;
+                            if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+                                uint32_t low = 0;
+                                if (end - escape < 2 || escape[0] != '\\' || escape[1] != 'u' ||
+                                    !parse_hex4(escape + 2, end, low) || low < 0xDC00 || low > 0xDFFF) {
+                                    return ParseError{ "Unpaired surrogate in unicode escape sequence"_s,
+                                                       offset_of(sequence) };
+                                }
+                                escape += 6;
+                                code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                            } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+                                return ParseError{ "Unpaired surrogate in unicode escape sequence"_s,
+                                                   offset_of(sequence) };
+                            }
+                            append_utf8(str, code_point);
+                            break;
+                        }
+                    default:
+                        return ParseError{ "Invalid escape sequence"_s, offset_of(sequence) };
+                }
+                run    = escape;
+                escape = find_escape_or_control(run, end);
+            }
+            str.append(StringView{ run, end });
+            return {};
+        }
+        Parsed<Number> parse_number(const char* begin, const char* end, const char* base) {
+            auto offset_of      = [base](const char* ptr) { return static_cast<size_t>(ptr - base); };
+            const char* ptr     = begin;
+            auto invalid_number = [&]() {
+                return ParseError{ "Invalid number "_s + StringView{ begin, end }.str(), offset_of(begin) };
+            };
+            const bool negative = *ptr == '-';
+            if (negative) ++ptr;
+            if (ptr == end || !is_digit(*ptr)) return invalid_number();
+            const char* digits = ptr;
+            uint64_t mantissa  = 0;
+            if (*ptr == '0') {
+                ++ptr;
+            } else {
+                while (ptr != end && is_digit(*ptr)) { mantissa = mantissa * 10 + static_cast<uint64_t>(*ptr++ - '0'); }
+            }
+            const auto digit_count = static_cast<size_t>(ptr - digits);
+            bool is_double         = false;
+            if (ptr != end && *ptr == '.') {
+                is_double = true;
+                if (++ptr == end || !is_digit(*ptr)) return invalid_number();
+                while (ptr != end && is_digit(*ptr)) ++ptr;
+            }
+            if (ptr != end && (*ptr == 'e' || *ptr == 'E')) {
+                is_double = true;
+                if (++ptr != end && (*ptr == '+' || *ptr == '-')) ++ptr;
+                if (ptr == end || !is_digit(*ptr)) return invalid_number();
+                while (ptr != end && is_digit(*ptr)) ++ptr;
+            }
+            if (ptr != end) return invalid_number();
+            if (!is_double) {
+                // 18 digits always fit in an int64_t, anything longer goes through the checked conversion
+                if (digit_count <= 18) {
+                    const auto value = static_cast<int64_t>(mantissa);
+                    return Number{ number_tag, negative ? -value : value };
+                }
+                auto res = StrViewToI64(StringView{ begin, end });
+                if (res.is_error()) return ParseError{ res.to_error()->error_string(), offset_of(begin) };
+                return Number{ number_tag, res.to_ok() };
+            }
+            auto res = StrViewToDouble(StringView{ begin, end });
+            if (res.is_error()) return ParseError{ res.to_error()->error_string(), offset_of(begin) };
+            return Number{ number_tag, res.to_ok() };
+        }
+    }    // namespace detail
+    // stage two, walks the tape once and builds the document
+    class TapeBuilder {
+        const char* m_data;
+        size_t m_size;
+        const uint32_t* m_tape;
+        size_t m_count;
+        size_t m_pos   = 0;
+        size_t m_depth = 0;
+
+        char current() const { return m_data[m_tape[m_pos]]; }
+        ParseError unexpected(const char* expected) const {
+            if (at_end()) {
+                return ParseError{ String::formatted("Expected %s but end of file was reached", expected), m_size };
+            }
+            return ParseError{ String::formatted("Invalid character, expected %s but got '%c'", expected, current()),
+                               offset() };
+        }
+        ParseError depth_limit_error() const {
+            return ParseError{ "Reached depth limit of "_s + IntToStr(ParseState::depth_limit), offset() };
+        }
+        bool enter() {
+            if (m_depth == ParseState::depth_limit) return false;
+            ++m_depth;
+            return true;
+        }
+
+        public:
+        TapeBuilder(const StructuralIndex& index) :
+            m_data(index.view().data()), m_size(index.view().size()), m_tape(&index.indices()[0]),
+            m_count(index.size()) {}
+        bool at_end() const { return m_pos == m_count; }
+        size_t offset() const { return m_tape[m_pos]; }
+        Parsed<Value> parse_value() {
+            if (at_end()) return unexpected("a value");
+            switch (current()) {
+                case '{':
+                    {
+                        TRY_SET(obj, parse_object());
+                        return ValueObj::construct(move(obj));
+                    }
+                case '[':
+                    {
+                        TRY_SET(arr, parse_array());
+                        return ValueObj::construct(move(arr));
+                    }
+                case '"':
+                    {
+                        TRY_SET(str, parse_string());
+                        return ValueObj::construct(JString{ move(str) });
+                    }
+                case '}':
+                case ']':
+                case ':':
+                case ',':
+                    return unexpected("a value");
+                default:
+                    return parse_scalar();
+            }
+        }
+        Parsed<Object> parse_object() {
+            if (!enter()) return depth_limit_error();
+            Object obj{};
+            ++m_pos;
+            if (!at_end() && current() == '}') {
+                ++m_pos;
+                --m_depth;
+                return obj;
+            }
+            while (true) {
+                if (at_end() || current() != '"') return unexpected("a string key");
+                TRY_SET(key, parse_string());
+                if (at_end() || current() != ':') return unexpected("':'");
+                ++m_pos;
+                TRY_SET(value, parse_value());
+                obj.insert(move(key), move(value));
+                if (at_end()) return unexpected("',' or '}'");
+                const char c = current();
+                ++m_pos;
+                if (c == '}') break;
+                if (c != ',') {
+                    --m_pos;
+                    return unexpected("',' or '}'");
+                }
+            }
+            --m_depth;
+            return obj;
+        }
+        Parsed<Array> parse_array() {
+            if (!enter()) return depth_limit_error();
+            Array arr{};
+            ++m_pos;
+            if (!at_end() && current() == ']') {
+                ++m_pos;
+                --m_depth;
+                return arr;
+            }
+            while (true) {
+                TRY_SET(value, parse_value());
+                arr.append(move(value));
+                if (at_end()) return unexpected("',' or ']'");
+                const char c = current();
+                ++m_pos;
+                if (c == ']') break;
+                if (c != ',') {
+                    --m_pos;
+                    return unexpected("',' or ']'");
+                }
+            }
+            --m_depth;
+            return arr;
+        }
+        // the tape holds the opening quote followed by the closing one
+        Parsed<String> parse_string() {
+            const char* begin = m_data + m_tape[m_pos] + 1;
+            const char* end   = m_data + m_tape[m_pos + 1];
+            m_pos += 2;
+            const auto size = static_cast<size_t>(end - begin);
+            if (detail::find_escape_or_control(begin, end) == end) return String{ begin, size };
+            String str{};
+            str.reserve(size);
+            TRY(detail::unescape_string(str, begin, end, m_data));
+            return str;
+        }
+        // a scalar runs until the next structural, minus the whitespace before it
+        Parsed<Value> parse_scalar() {
+            const char* begin = m_data + m_tape[m_pos];
+            const char* end   = m_data + m_tape[m_pos + 1];
+            ++m_pos;
+            while (end > begin && is_json_space(end[-1])) --end;
+            const StringView raw{ begin, end };
+            switch (*begin) {
+                case 't':
+                    if (raw == "true"_sv) return ValueObj::construct(Bool{ bool_tag, true });
+                    break;
+                case 'f':
+                    if (raw == "false"_sv) return ValueObj::construct(Bool{ bool_tag, false });
+                    break;
+                case 'n':
+                    if (raw == "null"_sv) return ValueObj::construct(Null{ null_tag });
+                    break;
+                case '-':
+                case '0':
+                case '1':
+                case '2':
+                case '3':
+                case '4':
+                case '5':
+                case '6':
+                case '7':
+                case '8':
+                case '9':
+                    {
+                        TRY_SET(number, detail::parse_number(begin, end, m_data));
+                        return ValueObj::construct(move(number));
+                    }
+                default:
+                    break;
+            }
+            return ParseError{ "Expected a valid json type but got "_s + raw.str(),
+                               static_cast<size_t>(begin - m_data) };
+        }
+    };
+    ParseResult StructuralParser::parse(StringView view) {
+        TRY_SET(index, StructuralIndex::build(view));
+        return parse(index);
+    }
+    ParseResult StructuralParser::parse(const StructuralIndex& index) {
+        TapeBuilder builder{ index };
+        if (builder.at_end()) return ParseError{ "Expected a valid json type but the input is empty"_s, 0 };
+        TRY_SET(value, builder.parse_value());
+        if (!builder.at_end()) {
+            return ParseError{ "End of json reached but end of buffer not reached"_s, builder.offset() };
+        }
+        return ParseResult{ Document{ move(value) } };
+    }
+    ParseResult StructuralParser::from_file(const Path& filename) {
+        auto file_or_err = MappedFile::open(filename, MappedFile::sequential);
+        if (file_or_err.is_error()) { return ParseError{ file_or_err.to_error()->error_string(), 0 }; }
+        const auto file = file_or_err.to_ok();
+        TRY_RET(StructuralParser::parse(file.view()));
+    }
+}    // namespace JSON
+}    // namespace ARLib
@@ -0,0 +1,260 @@
+#include "JSONWriter.hpp"
+#include "BitOps.hpp"
+#include "Memory.hpp"
+#include "CharConvHelpers.hpp"
+#include <immintrin.h>
+namespace ARLib {
+namespace JSON {
+    static bool needs_escape(char c) {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    }
+    static const char* find_escape(const char* begin, const char* end) {
+#ifdef __AVX2__
+        const auto quote     = _mm256_set1_epi8('"');
+        const auto backslash = _mm256_set1_epi8('\\');
+        const auto control   = _mm256_set1_epi8(0x1F);
+        while (end - begin >= 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            // there's no unsigned compare, a byte is <= 0x1F if max(byte, 0x1F) is still 0x1F
+            const auto is_control = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control);
+            const auto found      = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)), is_control
+            );
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(found));
+            if (mask != 0) return begin + internal::trailing_zeros(mask);
+            begin += 32;
+        }
+#endif
+        while (begin != end && !needs_escape(*begin)) ++begin;
+        return begin;
+    }
+    void Writer::newline_and_indent(size_t level) {
+        char* out = m_out.reserve(level + 1);
+        *out++    = '\n';
+        for (size_t i = 0; i < level; ++i) *out++ = '\t';
+        m_out.commit(out);
+    }
+    void Writer::separate() {
+        if (m_after_key) {
+            m_after_key = false;
+            return;
+        }
+        if (m_open == 0) return;
+        if (!m_first) m_out.append(',');
+        m_first = false;
+        if (m_mode == WriteMode::Pretty) newline_and_indent(m_base_indent + m_open);
+    }
+    void Writer::write_escaped(StringView str) {
+        constexpr char hex_digits[] = "0123456789abcdef";
+        const char* begin           = str.data();
+        const char* end             = begin + str.size();
+        m_out.reserve(str.size() + 2);
+        m_out.append('"');
+        while (true) {
+            const char* special = find_escape(begin, end);
+            if (special != begin) m_out.append(StringView{ begin, special });
+            if (special == end) break;
+            const char c = *special;
+            switch (c) {
+                case '"':
+                    m_out.append("\\\""_sv);
+                    break;
+                case '\\':
+                    m_out.append("\\\\"_sv);
+                    break;
+                case '\b':
+                    m_out.append("\\b"_sv);
+                    break;
+                case '\f':
+                    m_out.append("\\f"_sv);
+                    break;
+                case '\n':
+                    m_out.append("\\n"_sv);
+                    break;
+                case '\r':
+                    m_out.append("\\r"_sv);
+                    break;
+                case '\t':
+                    m_out.append("\\t"_sv);
+                    break;
+                default:
+                    {
+                        const char escape[] = { '\\', 'u', '0', '0', hex_digits[(c >> 4) & 0xF], hex_digits[c & 0xF] };
+                        m_out.append(StringView{ escape, sizeof(escape) });
+                        break;
+                    }
+            }
+            begin = special + 1;
+        }
+        m_out.append('"');
+    }
+    Writer& Writer::begin_object() {
+        separate();
+        m_out.append('{');
+        ++m_open;
+        m_first = true;
+        return *this;
+    }
+    Writer& Writer::begin_array() {
+        separate();
+        m_out.append('[');
+        ++m_open;
+        m_first = true;
+        return *this;
+    }
+    Writer& Writer::end_object() {
+        HARD_ASSERT(m_open > 0 && !m_after_key, "end_object() without a matching begin_object()")
+        --m_open;
+        if (!m_first && m_mode == WriteMode::Pretty) newline_and_indent(m_base_indent + m_open);
+        m_out.append('}');
+        m_first = false;
+        m_out.maybe_flush();
+        return *this;
+    }
+    Writer& Writer::end_array() {
+        HARD_ASSERT(m_open > 0 && !m_after_key, "end_array() without a matching begin_array()")
+        --m_open;
+        if (!m_first && m_mode == WriteMode::Pretty) newline_and_indent(m_base_indent + m_open);
+        m_out.append(']');
+        m_first = false;
+        m_out.maybe_flush();
+        return *this;
+    }
+    Writer& Writer::key(StringView key) {
+        separate();
+        write_escaped(key);
+        if (m_mode == WriteMode::Pretty) {
+            m_out.append(": "_sv);
+        } else {
+            m_out.append(':');
+        }
+        m_after_key = true;
+        return *this;
+    }
+    Writer& Writer::string(StringView value) {
+        separate();
+        write_escaped(value);
+        m_out.maybe_flush();
+        return *this;
+    }
+    Writer& Writer::integer(int64_t value) {
+        separate();
+        const bool negative      = value < 0;
+        const uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        const size_t len         = StrLenFromIntegral<10>(magnitude);
+        char* out                = m_out.reserve(len + 1);
+        if (negative) *out++ = '-';
+        WriteToCharsImpl(out, len, magnitude);
+        m_out.commit(out + len);
+        m_out.maybe_flush();
+        return *this;
+    }
+    Writer& Writer::unsigned_integer(uint64_t value) {
+        separate();
+        const size_t len = StrLenFromIntegral<10>(value);
+        char* out        = m_out.reserve(len);
+        WriteToCharsImpl(out, len, value);
+        m_out.commit(out + len);
+        m_out.maybe_flush();
+        return *this;
+    }
+    Writer& Writer::number(double value) {
+        constexpr uint64_t exponent_mask = 0x7FF0000000000000ull;
+        if ((BitCast<uint64_t>(value) & exponent_mask) == exponent_mask) return null();
+        separate();
+        char* out        = m_out.reserve(shortest_double_chars + 2);
+        const size_t len = DoubleToCharsShortest(value, out);
+        // integral doubles come out without a fraction, keep them doubles when they're read back
+        bool has_fraction = false;
+        for (size_t i = 0; i < len && !has_fraction; ++i) has_fraction = out[i] == '.' || out[i] == 'e';
+        if (has_fraction) {
+            m_out.commit(out + len);
+        } else {
+            out[len]     = '.';
+            out[len + 1] = '0';
+            m_out.commit(out + len + 2);
+        }
+        m_out.maybe_flush();
+        return *this;
+    }
+    Writer& Writer::number(const Number& value) {
+        return value.is_integer() ? integer(value.value_integer()) : number(value.value_double());
+    }
+    Writer& Writer::boolean(bool value) {
+        separate();
+        m_out.append(value ? "true"_sv : "false"_sv);
+        m_out.maybe_flush();
+        return *this;
+    }
+    Writer& Writer::null() {
+        separate();
+        m_out.append("null"_sv);
+        m_out.maybe_flush();
+        return *this;
+    }
+    Writer& Writer::value(const ValueObj& value) {
+        switch (value.type()) {
+            case Type::JObject:
+                return this->value(value.as<Type::JObject>());
+            case Type::JArray:
+                return this->value(value.as<Type::JArray>());
+            case Type::JString:
+                return string(value.as<Type::JString>().view());
+            case Type::JNumber:
+                return number(value.as<Type::JNumber>());
+            case Type::JBool:
+                return boolean(value.as<Type::JBool>().value());
+            case Type::JNull:
+                return null();
+        }
+        return *this;
+    }
+    Writer& Writer::value(const Object& value) {
+        begin_object();
+        for (const auto& entry : value) {
+            key(entry.key().view());
+            this->value(*entry.val());
+        }
+        return end_object();
+    }
+    Writer& Writer::value(const Array& value) {
+        begin_array();
+        for (const auto& item : value) { this->value(*item); }
+        return end_array();
+    }
+    Writer& Writer::value(CompactValue value) {
+        switch (value.type()) {
+            case Type::JObject:
+                begin_object();
+                for (size_t i = 0; i < value.size(); ++i) {
+                    key(value.key_at(i));
+                    this->value(value.value_at(i));
+                }
+                return end_object();
+            case Type::JArray:
+                begin_array();
+                for (size_t i = 0; i < value.size(); ++i) { this->value(value[i]); }
+                return end_array();
+            case Type::JString:
+                return string(value.as_string());
+            case Type::JNumber:
+                return value.is_integer() ? integer(value.as_int64()) : number(value.as_double());
+            case Type::JBool:
+                return boolean(value.as_bool());
+            case Type::JNull:
+                return null();
+        }
+        return *this;
+    }
+    String to_json(const ValueObj& value, WriteMode mode) {
+        Writer writer{ mode };
+        writer.value(value);
+        return writer.release();
+    }
+    String to_json(CompactValue value, WriteMode mode) {
+        Writer writer{ mode };
+        writer.value(value);
+        return writer.release();
+    }
+}    // namespace JSON
+}    // namespace ARLib
@@ -0,0 +1,24 @@
+#include "MappedFile.hpp"
+namespace ARLib {
+Result<MappedFile, FileError> MappedFile::open(const Path& path, const MappedFileOptions& options) {
+    NativeMappedFile native{};
+    if (!native.map(path, options.populate, options.huge_pages)) return FileError{ last_error(), path };
+    MappedFile file{ move(native) };
+    file.advise(options.access);
+    if (options.will_need && !options.populate) file.will_need(0, file.size());
+    return file;
+}
+void MappedFile::advise(MappedFileAccess access) {
+    switch (access) {
+        case MappedFileAccess::Normal:
+            m_native.advise_normal();
+            break;
+        case MappedFileAccess::Sequential:
+            m_native.advise_sequential();
+            break;
+        case MappedFileAccess::Random:
+            m_native.advise_random();
+            break;
+    }
+}
+}    // namespace ARLib
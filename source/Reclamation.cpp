@@ -0,0 +1,221 @@
+#ifndef DISABLE_THREADING
+    #include "Reclamation.hpp"
+    #include "Algorithm.hpp"
+namespace ARLib {
+// records are never freed while the domain is alive, unregistering only marks them as free for reuse
+// this way walking the list never has to worry about a record disappearing under it
+template <typename Record>
+static Record* acquire_record_from(Atomic<Record*>& records, bool& allocated) {
+    allocated = false;
+    for (Record* record = records.load(MemoryOrder::Acquire); record; record = record->next) {
+        bool in_use = false;
+        if (!record->in_use.load(MemoryOrder::Relaxed) &&
+            record->in_use.compare_exchange_strong(in_use, true, MemoryOrder::Acquire, MemoryOrder::Relaxed)) {
+            return record;
+        }
+    }
+    auto* record = new Record{};
+    allocated    = true;
+    record->next = records.load(MemoryOrder::Relaxed);
+    while (!records.compare_exchange_weak(record->next, record, MemoryOrder::Release, MemoryOrder::Relaxed)) {}
+    return record;
+}
+template <typename Record>
+static void free_records(Atomic<Record*>& records) {
+    for (Record* record = records.exchange(nullptr); record;) {
+        Record* next = record->next;
+        delete record;
+        record = next;
+    }
+}
+EpochDomain::Record* EpochDomain::acquire_record() {
+    bool allocated = false;
+    return acquire_record_from(m_records, allocated);
+}
+EpochDomain::~EpochDomain() {
+    for (const auto& retired : m_orphans) { retired.reclaim(); }
+    free_records(m_records);
+}
+EpochParticipant EpochDomain::register_thread() {
+    return EpochParticipant{ this, acquire_record() };
+}
+void EpochDomain::try_advance() {
+    uint64_t epoch = m_epoch.load(MemoryOrder::Relaxed);
+    // pairs with the fence in EpochParticipant::enter, either we see the reader pinned or it sees the new epoch
+    atomic_thread_fence(MemoryOrder::SeqCst);
+    for (Record* record = m_records.load(MemoryOrder::Acquire); record; record = record->next) {
+        const uint64_t state = record->state.load(MemoryOrder::Relaxed);
+        if ((state & 1) && (state >> 1) != epoch) return;
+    }
+    atomic_thread_fence(MemoryOrder::Acquire);
+    // if this fails somebody else already advanced it, which is just as good
+    m_epoch.compare_exchange_strong(epoch, epoch + 1, MemoryOrder::Release, MemoryOrder::Relaxed);
+}
+size_t EpochDomain::collect_orphans(uint64_t epoch) {
+    if (!m_orphans_mutex.try_lock()) return 0;
+    size_t freed = 0;
+    size_t kept  = 0;
+    for (size_t i = 0; i < m_orphans.size(); ++i) {
+        if (m_orphans[i].epoch + 2 <= epoch) {
+            m_orphans[i].reclaim();
+            ++freed;
+        } else {
+            m_orphans[kept++] = m_orphans[i];
+        }
+    }
+    while (m_orphans.size() > kept) { m_orphans.pop(); }
+    m_orphans_mutex.unlock();
+    return freed;
+}
+void EpochDomain::adopt(Vector<detail::RetiredObject>& retired) {
+    ScopedLock lock{ m_orphans_mutex };
+    for (const auto& object : retired) { m_orphans.append(object); }
+    retired.clear();
+}
+EpochDomain& EpochDomain::global() {
+    static EpochDomain domain{};
+    return domain;
+}
+EpochParticipant::EpochParticipant(EpochParticipant&& other) noexcept :
+    m_domain(other.m_domain), m_record(other.m_record), m_pin_depth(other.m_pin_depth),
+    m_retired(move(other.m_retired)) {
+    other.m_domain    = nullptr;
+    other.m_record    = nullptr;
+    other.m_pin_depth = 0;
+}
+EpochParticipant& EpochParticipant::operator=(EpochParticipant&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_domain          = other.m_domain;
+        m_record          = other.m_record;
+        m_pin_depth       = other.m_pin_depth;
+        m_retired         = move(other.m_retired);
+        other.m_domain    = nullptr;
+        other.m_record    = nullptr;
+        other.m_pin_depth = 0;
+    }
+    return *this;
+}
+void EpochParticipant::release() {
+    if (!m_record) return;
+    HARD_ASSERT(m_pin_depth == 0, "EpochParticipant destroyed while an EpochGuard was still alive")
+    collect();
+    if (!m_retired.empty()) m_domain->adopt(m_retired);
+    m_record->in_use.store(false, MemoryOrder::Release);
+    m_record = nullptr;
+    m_domain = nullptr;
+}
+void EpochParticipant::enter() {
+    if (m_pin_depth++ != 0) return;
+    const uint64_t epoch = m_domain->m_epoch.load(MemoryOrder::Relaxed);
+    m_record->state.store((epoch << 1) | 1, MemoryOrder::Relaxed);
+    // the pin has to be visible before anything protected by it is read
+    atomic_thread_fence(MemoryOrder::SeqCst);
+}
+void EpochParticipant::exit() {
+    if (--m_pin_depth != 0) return;
+    m_record->state.store(0, MemoryOrder::Release);
+}
+void EpochParticipant::retire(void* ptr, void (*deleter)(void*)) {
+    m_retired.append(detail::RetiredObject{ ptr, deleter, m_domain->m_epoch.load(MemoryOrder::SeqCst) });
+    if (m_retired.size() >= collect_threshold) collect();
+}
+size_t EpochParticipant::collect() {
+    m_domain->try_advance();
+    // a reader that pinned epoch e keeps the global epoch from going past e + 1,
+    // so anything retired in e - 1 or before can't be reachable by anyone once the epoch is e + 1
+    const uint64_t epoch = m_domain->m_epoch.load(MemoryOrder::Acquire);
+    size_t freed         = 0;
+    size_t kept          = 0;
+    for (size_t i = 0; i < m_retired.size(); ++i) {
+        if (m_retired[i].epoch + 2 <= epoch) {
+            m_retired[i].reclaim();
+            ++freed;
+        } else {
+            m_retired[kept++] = m_retired[i];
+        }
+    }
+    while (m_retired.size() > kept) { m_retired.pop(); }
+    return freed + m_domain->collect_orphans(epoch);
+}
+HazardDomain::Record* HazardDomain::acquire_record() {
+    bool allocated = false;
+    auto* record   = acquire_record_from(m_records, allocated);
+    if (allocated) m_record_count.fetch_add(1, MemoryOrder::Relaxed);
+    return record;
+}
+HazardDomain::~HazardDomain() {
+    for (RetiredNode* node = m_retired.exchange(nullptr); node;) {
+        RetiredNode* next = node->next;
+        node->object.reclaim();
+        delete node;
+        node = next;
+    }
+    free_records(m_records);
+}
+HazardPointer HazardDomain::make_hazard_pointer() {
+    return HazardPointer{ acquire_record() };
+}
+void HazardDomain::push_retired(RetiredNode* first, RetiredNode* last) {
+    last->next = m_retired.load(MemoryOrder::Relaxed);
+    while (!m_retired.compare_exchange_weak(last->next, first, MemoryOrder::Release, MemoryOrder::Relaxed)) {}
+}
+void HazardDomain::retire(void* ptr, void (*deleter)(void*)) {
+    auto* node = new RetiredNode{ detail::RetiredObject{ ptr, deleter, 0 }, nullptr };
+    push_retired(node, node);
+    const size_t retired = m_retired_count.fetch_add(1, MemoryOrder::Relaxed) + 1;
+    // scanning is O(retired + hazard pointers), doing it this rarely keeps the amortized cost per retire constant
+    if (retired >= reclaim_threshold + 2 * m_record_count.load(MemoryOrder::Relaxed)) reclaim();
+}
+size_t HazardDomain::reclaim() {
+    // every concurrent reclaim takes a disjoint batch, so nothing gets freed twice
+    RetiredNode* batch = m_retired.exchange(nullptr, MemoryOrder::Acquire);
+    if (!batch) return 0;
+    // pairs with the store in HazardPointer::reset_protection, either we see the hazard
+    // or the reader's validating reload sees the object already unlinked
+    atomic_thread_fence(MemoryOrder::SeqCst);
+    Vector<uintptr_t> hazards{};
+    for (Record* record = m_records.load(MemoryOrder::Acquire); record; record = record->next) {
+        const uintptr_t ptr = record->protected_ptr.load(MemoryOrder::Acquire);
+        if (ptr != 0) hazards.append(ptr);
+    }
+    sort(hazards);
+    auto is_protected = [&hazards](uintptr_t ptr) {
+        size_t lo = 0;
+        size_t hi = hazards.size();
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (hazards[mid] < ptr) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo < hazards.size() && hazards[lo] == ptr;
+    };
+    size_t freed           = 0;
+    RetiredNode* kept      = nullptr;
+    RetiredNode* kept_last = nullptr;
+    while (batch) {
+        RetiredNode* next = batch->next;
+        if (is_protected(reinterpret_cast<uintptr_t>(batch->object.ptr))) {
+            batch->next = kept;
+            kept        = batch;
+            if (!kept_last) kept_last = batch;
+        } else {
+            batch->object.reclaim();
+            delete batch;
+            ++freed;
+        }
+        batch = next;
+    }
+    if (kept) push_retired(kept, kept_last);
+    m_retired_count.fetch_sub(freed, MemoryOrder::Relaxed);
+    return freed;
+}
+HazardDomain& HazardDomain::global() {
+    static HazardDomain domain{};
+    return domain;
+}
+}    // namespace ARLib
+#endif
@@ -2,10 +2,11 @@
 #include "Array.hpp"
 #include "Pair.hpp"
 #include "Printer.hpp"
+#include "Sort.hpp"
 #include "Stack.hpp"
 namespace ARLib {
-constexpr static Array re_tok_chars{ '.', '(', ')', '[', ']', '|', '$', '^', '?', '*', '+', '{', '}' };
-constexpr static Array re_esc_chars{ 's', 'w', 'W', 'd' };
+constexpr static Array re_tok_chars{ '.', '(', ')', '[', ']', '|', '^', '$', '?', '*', '+', '{', '}' };
+constexpr static Array re_esc_chars{ 's', 'w', 'W', 'd', 'S', 'D' };
 
 constexpr static inline bool REGEX_DEBUG = false;
 template <typename Func>
@@ -15,7 +16,7 @@ void regex_debug_print(Func&& func) {
 #define REGEX_DEBUG(format, ...) regex_debug_print([&]() { Printer::print(format, __VA_ARGS__); })
 
 static_assert(enum_size<RegexToken>() == re_tok_chars.size());
-static_assert(from_enum(EscapedRegexToken::NumberChar) + 1 == re_esc_chars.size());
+static_assert(from_enum(EscapedRegexToken::NotNumberChar) + 1 == re_esc_chars.size());
 static Result<Regex::CountToken, RegexParseError>
 parse_count_token(ARLib::Iterator<char>& it, ARLib::Iterator<char> end, size_t& index) {
     // get stringview from current up until }
@@ -33,7 +34,13 @@ parse_count_token(ARLib::Iterator<char>& it, ARLib::Iterator<char> end, size_t&
     StringView view{ start_ptr, end_ptr };
     Regex::CountToken tok{};
 
-    if (view.index_of(',') != StringView::npos) {
+    if (view.size() > 1 && view[view.size() - 1] == ',') {
+        // {n,} has no upper bound
+        TRY_SET(min, StrViewToU64Decimal(view.substringview(0, view.size() - 1)).map_error([&](auto&& err) {
+            return RegexParseError{ err.error_string().str(), index };
+        }));
+        tok = Regex::CountToken{ .m_min = min, .m_max = npos_ };
+    } else if (view.index_of(',') != StringView::npos) {
         auto values = view.split(",");
         if (values.size() != 2) { return RegexParseError{ "Count has more than 2 values"_s, index }; }
         TRY_SET(min, StrViewToU64Decimal(values[0]).map_error([&](auto&& err) {
@@ -88,6 +95,12 @@ Result<Regex, RegexParseError> Regex::parse_regex(String&& regex) {
             if (auto fit = find(re_esc_chars, cur); fit != npos_) {
                 auto tok = to_enum<EscapedRegexToken>(fit);
                 current_tokens()->emplace(tok);
+            } else if (cur == 'n') {
+                current_tokens()->emplace('\n');
+            } else if (cur == 't') {
+                current_tokens()->emplace('\t');
+            } else if (cur == 'r') {
+                current_tokens()->emplace('\r');
             } else {
                 current_tokens()->emplace(cur);
             }
@@ -181,6 +194,587 @@ Result<Regex, RegexParseError> Regex::parse_regex(String&& regex) {
     if (state.in_group != 0 || state.in_square != 0)
         return RegexParseError{ "Unclosed group or character group"_s, index };
     REGEX_DEBUG("PARSED_REGEX_TOKENS: {}", tokens);
-    return Regex{ move(tokens) };
+    Regex compiled{ move(tokens) };
+    TRY(compiled.compile());
+    return compiled;
+}
+// anything past this in a {m,n} count is refused, every repeat is a copy of the repeated instructions
+constexpr static size_t max_repeat_count = 1000;
+class RegexCompiler {
+    using Tokens = Vector<Regex::RegexVariant>;
+    using Op     = detail::RegexOp;
+    struct Piece {
+        size_t index;
+        size_t min;
+        size_t max;
+        bool lazy;
+    };
+    detail::RegexProgram& m_program;
+    bool m_reverse;
+    size_t m_group_count = 0;
+    // set of every single byte that's been used, so literals don't each get their own
+    uint32_t m_single_sets[256];
+
+    uint32_t pc() const { return static_cast<uint32_t>(m_program.insts.size()); }
+    uint32_t emit(Op op, uint32_t x = 0, uint32_t y = 0) {
+        m_program.insts.append(detail::RegexInst{ op, x, y });
+        return pc() - 1;
+    }
+    // x is the branch that's tried first
+    void patch_split(uint32_t split, uint32_t x, uint32_t y) {
+        m_program.insts[split].x = x;
+        m_program.insts[split].y = y;
+    }
+    void emit_set(const detail::RegexByteSet& set) {
+        m_program.sets.append(set);
+        emit(Op::ByteSet, static_cast<uint32_t>(m_program.sets.size() - 1));
+    }
+    void emit_byte(uint8_t c) {
+        if (m_single_sets[c] == npos32) {
+            detail::RegexByteSet set{};
+            set.add(c);
+            m_program.sets.append(set);
+            m_single_sets[c] = static_cast<uint32_t>(m_program.sets.size() - 1);
+        }
+        emit(Op::ByteSet, m_single_sets[c]);
+    }
+    static bool is_token(const Regex::RegexVariant& token, RegexToken kind) {
+        return token.contains_type<RegexToken>() && token.get<RegexToken>() == kind;
+    }
+    static bool is_quantifier(const Regex::RegexVariant& token) {
+        return token.contains_type<Regex::CountToken>() || is_token(token, RegexToken::Asterisk) ||
+               is_token(token, RegexToken::Plus) || is_token(token, RegexToken::Lazy);
+    }
+    static detail::RegexByteSet escaped_set(EscapedRegexToken token) {
+        detail::RegexByteSet set{};
+        switch (token) {
+            case EscapedRegexToken::WhiteSpace:
+            case EscapedRegexToken::NotWhiteSpace:
+                for (char c : { ' ', '\t', '\n', '\r', '\f', '\v' }) set.add(static_cast<uint8_t>(c));
+                break;
+            case EscapedRegexToken::WordChar:
+            case EscapedRegexToken::NotWordChar:
+                set.add_range('a', 'z');
+                set.add_range('A', 'Z');
+                set.add_range('0', '9');
+                set.add('_');
+                break;
+            case EscapedRegexToken::NumberChar:
+            case EscapedRegexToken::NotNumberChar:
+                set.add_range('0', '9');
+                break;
+        }
+        if (token == EscapedRegexToken::NotWhiteSpace || token == EscapedRegexToken::NotWordChar ||
+            token == EscapedRegexToken::NotNumberChar) {
+            set.negate();
+        }
+        return set;
+    }
+    // the character a token inside of [] stands for
+    static Optional<char> literal(const Regex::RegexVariant& token) {
+        if (token.contains_type<char>()) return token.get<char>();
+        if (token.contains_type<RegexToken>()) return re_tok_chars[from_enum(token.get<RegexToken>())];
+        return {};
+    }
+    Result<detail::RegexByteSet, RegexParseError> char_group(const Tokens& tokens) {
+        detail::RegexByteSet set{};
+        size_t i = 0;
+        // [^...]
+        const bool negated = tokens.size() > 0 && is_token(tokens[0], RegexToken::StartString);
+        if (negated) i = 1;
+        for (; i < tokens.size(); ++i) {
+            if (tokens[i].contains_type<EscapedRegexToken>()) {
+                set.add_set(escaped_set(tokens[i].get<EscapedRegexToken>()));
+                continue;
+            }
+            const auto lo = literal(tokens[i]);
+            if (!lo) return RegexParseError{ "Invalid token in character group"_s, 0 };
+            const bool is_range = i + 2 < tokens.size() && tokens[i + 1].contains_type<char>() &&
+                                  tokens[i + 1].get<char>() == '-' && literal(tokens[i + 2]).has_value();
+            if (!is_range) {
+                set.add(static_cast<uint8_t>(*lo));
+                continue;
+            }
+            const auto hi = static_cast<uint8_t>(*literal(tokens[i + 2]));
+            if (hi < static_cast<uint8_t>(*lo)) return RegexParseError{ "Invalid range in character group"_s, 0 };
+            set.add_range(static_cast<uint8_t>(*lo), hi);
+            i += 2;
+        }
+        if (negated) set.negate();
+        return set;
+    }
+    DiscardResult<RegexParseError> atom(const Regex::RegexVariant& token) {
+        if (token.contains_type<char>()) {
+            emit_byte(static_cast<uint8_t>(token.get<char>()));
+        } else if (token.contains_type<EscapedRegexToken>()) {
+            emit_set(escaped_set(token.get<EscapedRegexToken>()));
+        } else if (token.contains_type<Regex::CharGroup>()) {
+            TRY_SET(set, char_group(*token.get<Regex::CharGroup>().m_char_group));
+            emit_set(set);
+        } else if (token.contains_type<Regex::Group>()) {
+            const auto& group = token.get<Regex::Group>();
+            m_group_count     = max_bt(m_group_count, group.m_group_number);
+            const auto slot   = static_cast<uint32_t>(group.m_group_number * 2);
+            if (!m_reverse) emit(Op::Save, slot);
+            TRY(alternation(*group.m_group_regex));
+            if (!m_reverse) emit(Op::Save, slot + 1);
+        } else if (is_token(token, RegexToken::Dot)) {
+            detail::RegexByteSet set{};
+            set.add('\n');
+            set.negate();
+            emit_set(set);
+        } else if (is_token(token, RegexToken::StartString)) {
+            // the reversed program sees the start of the input last
+            emit(m_reverse ? Op::AssertEnd : Op::AssertBegin);
+        } else if (is_token(token, RegexToken::EndString)) {
+            emit(m_reverse ? Op::AssertBegin : Op::AssertEnd);
+        } else {
+            return RegexParseError{ "Nothing to repeat"_s, 0 };
+        }
+        return {};
+    }
+    DiscardResult<RegexParseError> repeat(const Tokens& tokens, const Piece& piece) {
+        const auto& token = tokens[piece.index];
+        if (piece.min > max_repeat_count || (piece.max != npos_ && piece.max > max_repeat_count)) {
+            return RegexParseError{ "Count is too large"_s, 0 };
+        }
+        auto branch = [&](uint32_t split, uint32_t repeat, uint32_t exit) {
+            if (piece.lazy) {
+                patch_split(split, exit, repeat);
+            } else {
+                patch_split(split, repeat, exit);
+            }
+        };
+        if (piece.max == npos_) {
+            if (piece.min == 0) {
+                const uint32_t split = emit(Op::Split);
+                TRY(atom(token));
+                emit(Op::Jump, split);
+                branch(split, split + 1, pc());
+                return {};
+            }
+            for (size_t i = 1; i < piece.min; ++i) TRY(atom(token));
+            const uint32_t loop = pc();
+            TRY(atom(token));
+            const uint32_t split = emit(Op::Split);
+            branch(split, loop, pc());
+            return {};
+        }
+        for (size_t i = 0; i < piece.min; ++i) TRY(atom(token));
+        // e{2,4} is ee(e(e)?)?
+        Vector<uint32_t> splits{};
+        for (size_t i = piece.min; i < piece.max; ++i) {
+            splits.append(emit(Op::Split));
+            TRY(atom(token));
+        }
+        for (uint32_t split : splits) branch(split, split + 1, pc());
+        return {};
+    }
+    static Result<Vector<Piece>, RegexParseError> pieces(const Tokens& tokens, size_t begin, size_t end) {
+        Vector<Piece> pieces{};
+        for (size_t i = begin; i < end;) {
+            if (is_quantifier(tokens[i])) return RegexParseError{ "Nothing to repeat"_s, 0 };
+            Piece piece{ i++, 1, 1, false };
+            if (i < end && is_quantifier(tokens[i])) {
+                const auto& quantifier = tokens[i++];
+                if (quantifier.contains_type<Regex::CountToken>()) {
+                    const auto& count = quantifier.get<Regex::CountToken>();
+                    if (count.m_min > count.m_max) return RegexParseError{ "Invalid count"_s, 0 };
+                    piece.min = count.m_min;
+                    piece.max = count.m_max;
+                } else if (is_token(quantifier, RegexToken::Asterisk)) {
+                    piece.min = 0;
+                    piece.max = npos_;
+                } else if (is_token(quantifier, RegexToken::Plus)) {
+                    piece.max = npos_;
+                } else {
+                    piece.min = 0;
+                }
+                // a ? after a quantifier makes it lazy
+                if (i < end && is_token(tokens[i], RegexToken::Lazy)) {
+                    piece.lazy = true;
+                    ++i;
+                }
+            }
+            pieces.append(piece);
+        }
+        return pieces;
+    }
+    DiscardResult<RegexParseError> sequence(const Tokens& tokens, size_t begin, size_t end) {
+        TRY_SET(parsed, pieces(tokens, begin, end));
+        for (size_t i = 0; i < parsed.size(); ++i) {
+            TRY(repeat(tokens, parsed[m_reverse ? parsed.size() - 1 - i : i]));
+        }
+        return {};
+    }
+    DiscardResult<RegexParseError> alternation(const Tokens& tokens) {
+        Vector<uint32_t> jumps{};
+        size_t begin = 0;
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            if (!is_token(tokens[i], RegexToken::Or)) continue;
+            const uint32_t split = emit(Op::Split);
+            TRY(sequence(tokens, begin, i));
+            jumps.append(emit(Op::Jump));
+            patch_split(split, split + 1, pc());
+            begin = i + 1;
+        }
+        TRY(sequence(tokens, begin, tokens.size()));
+        for (uint32_t jump : jumps) m_program.insts[jump].x = pc();
+        return {};
+    }
+
+    // what's known about the strings a part of the pattern matches
+    struct Literals {
+        // set when the part only ever matches this one string
+        Optional<String> exact;
+        // every match starts with prefix and ends with suffix
+        String prefix;
+        String suffix;
+        // every match contains required, starting at most required_offset bytes in (npos_ if there's no limit)
+        String required;
+        size_t required_offset = 0;
+        // the longest match, npos_ if there's no limit
+        size_t max_size = 0;
+    };
+    // longer literals than this aren't worth building out of repeats
+    constexpr static size_t max_literal_size = 256;
+    static size_t add_sizes(size_t a, size_t b) { return a == npos_ || b == npos_ ? npos_ : a + b; }
+    static Literals exact_literals(String literal) {
+        Literals lits{};
+        lits.max_size = literal.size();
+        lits.prefix   = literal;
+        lits.suffix   = literal;
+        lits.required = literal;
+        lits.exact    = move(literal);
+        return lits;
+    }
+    // a longer literal is rarer, with the same length the one closer to the start of the match wins
+    static void consider(Literals& lits, const String& literal, size_t offset) {
+        if (literal.size() > lits.required.size() ||
+            (literal.size() == lits.required.size() && offset < lits.required_offset)) {
+            lits.required        = literal;
+            lits.required_offset = offset;
+        }
+    }
+    static Literals atom_literals(const Regex::RegexVariant& token) {
+        if (token.contains_type<char>()) return exact_literals(String{ 1, token.get<char>() });
+        if (token.contains_type<Regex::Group>()) return alternation_literals(*token.get<Regex::Group>().m_group_regex);
+        if (is_token(token, RegexToken::StartString) || is_token(token, RegexToken::EndString)) {
+            return exact_literals(String{});
+        }
+        // a single byte out of a set
+        Literals lits{};
+        lits.max_size = 1;
+        return lits;
+    }
+    static Literals repeat_literals(const Tokens& tokens, const Piece& piece) {
+        Literals one = atom_literals(tokens[piece.index]);
+        if (piece.max == 0) return exact_literals(String{});
+        if (one.exact && piece.min == piece.max && one.exact->size() * piece.min <= max_literal_size) {
+            String repeated{};
+            for (size_t i = 0; i < piece.min; ++i) repeated += *one.exact;
+            return exact_literals(move(repeated));
+        }
+        Literals lits{};
+        if (one.max_size != npos_ && piece.max != npos_) {
+            lits.max_size = one.max_size * piece.max;
+        } else {
+            lits.max_size = one.max_size == 0 ? 0 : npos_;
+        }
+        // with at least one repetition everything about the first and the last one holds
+        if (piece.min == 0) return lits;
+        lits.prefix          = move(one.prefix);
+        lits.suffix          = move(one.suffix);
+        lits.required        = move(one.required);
+        lits.required_offset = one.required_offset;
+        return lits;
+    }
+    static Literals concat_literals(Literals left, const Literals& right) {
+        if (left.exact && right.exact) return exact_literals(move(*left.exact) + *right.exact);
+        Literals lits{};
+        lits.max_size = add_sizes(left.max_size, right.max_size);
+        lits.prefix   = left.exact ? *left.exact + right.prefix : move(left.prefix);
+        lits.suffix   = right.exact ? left.suffix + *right.exact : right.suffix;
+        consider(lits, lits.prefix, 0);
+        consider(lits, left.required, left.required_offset);
+        consider(lits, right.required, add_sizes(left.max_size, right.required_offset));
+        // the end of the left side runs straight into the start of the right one
+        const size_t joined_offset = left.max_size == npos_ ? npos_ : left.max_size - left.suffix.size();
+        consider(lits, left.suffix + right.prefix, joined_offset);
+        return lits;
+    }
+    static Literals alternate_literals(Literals left, const Literals& right) {
+        if (left.exact && right.exact && *left.exact == *right.exact) return left;
+        Literals lits{};
+        lits.max_size = max_bt(left.max_size, right.max_size);
+        size_t common = 0;
+        while (common < left.prefix.size() && common < right.prefix.size() &&
+               left.prefix[common] == right.prefix[common]) {
+            ++common;
+        }
+        lits.prefix = left.prefix.substring(0, common);
+        common      = 0;
+        while (common < left.suffix.size() && common < right.suffix.size() &&
+               left.suffix[left.suffix.size() - 1 - common] == right.suffix[right.suffix.size() - 1 - common]) {
+            ++common;
+        }
+        lits.suffix = left.suffix.substring(left.suffix.size() - common);
+        consider(lits, lits.prefix, 0);
+        consider(lits, lits.suffix, lits.max_size == npos_ ? npos_ : lits.max_size - lits.suffix.size());
+        return lits;
+    }
+    static Literals sequence_literals(const Tokens& tokens, size_t begin, size_t end) {
+        // the pattern has already been compiled, it can't be invalid here
+        auto parsed   = pieces(tokens, begin, end).to_ok();
+        Literals lits = exact_literals(String{});
+        for (const auto& piece : parsed) lits = concat_literals(move(lits), repeat_literals(tokens, piece));
+        return lits;
+    }
+    static Literals alternation_literals(const Tokens& tokens) {
+        Optional<Literals> lits{};
+        size_t begin = 0;
+        for (size_t i = 0; i <= tokens.size(); ++i) {
+            if (i < tokens.size() && !is_token(tokens[i], RegexToken::Or)) continue;
+            auto branch = sequence_literals(tokens, begin, i);
+            lits        = lits ? alternate_literals(move(*lits), branch) : move(branch);
+            begin       = i + 1;
+        }
+        return move(*lits);
+    }
+
+    public:
+    constexpr static uint32_t npos32 = 0xFFFFFFFF;
+    RegexCompiler(detail::RegexProgram& program, bool reverse) : m_program(program), m_reverse(reverse) {
+        for (auto& set : m_single_sets) set = npos32;
+    }
+    void begin_program() {
+        // 0: the lazy .*? that moves the start of the match forward, the program itself is preferred
+        detail::RegexByteSet any{};
+        any.negate();
+        emit(Op::Split, 3, 1);
+        emit_set(any);
+        emit(Op::Jump, 0);
+        m_program.unanchored_start = 0;
+        m_program.anchored_start   = pc();
+    }
+    void end_program() {
+        m_program.slot_count = (m_group_count + 1) * 2;
+        m_program.compute_byte_classes();
+    }
+    DiscardResult<RegexParseError> compile(const Tokens& tokens) {
+        begin_program();
+        if (!m_reverse) emit(Op::Save, 0);
+        TRY(alternation(tokens));
+        if (!m_reverse) emit(Op::Save, 1);
+        emit(Op::Match);
+        end_program();
+        return {};
+    }
+    // how many tokens at the start of the pattern are plain characters that can be shared with other patterns
+    static size_t literal_prefix_size(const Tokens& tokens) {
+        for (const auto& token : tokens) {
+            if (is_token(token, RegexToken::Or)) return 0;
+        }
+        size_t size = 0;
+        while (size < tokens.size() && tokens[size].contains_type<char>()) ++size;
+        // a repeat only applies to the last character
+        if (size > 0 && size < tokens.size() && is_quantifier(tokens[size])) --size;
+        return size;
+    }
+    // node of the trie of literal prefixes, children go on with one more byte
+    struct PrefixNode {
+        Vector<size_t> patterns;
+        Vector<Pair<uint8_t, size_t>> children;
+    };
+    DiscardResult<RegexParseError> emit_prefix_node(const Vector<Regex>& regexes, const Vector<PrefixNode>& nodes,
+                                                    const Vector<size_t>& prefix_sizes, size_t node) {
+        // every branch ends in a Match, so the split chain doesn't need jumps back together
+        const auto& current   = nodes[node];
+        const size_t branches = current.patterns.size() + current.children.size();
+        for (size_t i = 0; i < branches; ++i) {
+            const bool last      = i + 1 == branches;
+            const uint32_t split = last ? npos32 : emit(Op::Split);
+            if (i < current.patterns.size()) {
+                const size_t pattern = current.patterns[i];
+                const auto& tokens   = *regexes[pattern].m_regex;
+                // only a pattern without a | at the top has a prefix
+                if (prefix_sizes[pattern] == 0) {
+                    TRY(alternation(tokens));
+                } else {
+                    TRY(sequence(tokens, prefix_sizes[pattern], tokens.size()));
+                }
+                emit(Op::Match, static_cast<uint32_t>(pattern));
+            } else {
+                const auto& child = current.children[i - current.patterns.size()];
+                emit_byte(child.first());
+                TRY(emit_prefix_node(regexes, nodes, prefix_sizes, child.second()));
+            }
+            if (!last) patch_split(split, split + 1, pc());
+        }
+        return {};
+    }
+    // every pattern ends in its own Match with the index of the pattern in it. patterns that start with the same
+    // characters share them, otherwise every state would have a thread for each pattern waiting on its first byte.
+    // the order doesn't matter, a set is only ever run by a longest match DFA that keeps every thread
+    DiscardResult<RegexParseError> compile_set(const Vector<Regex>& regexes) {
+        begin_program();
+        Vector<PrefixNode> nodes{};
+        nodes.append(PrefixNode{});
+        Vector<size_t> prefix_sizes{};
+        for (size_t i = 0; i < regexes.size(); ++i) {
+            const auto& tokens = *regexes[i].m_regex;
+            const size_t size  = literal_prefix_size(tokens);
+            size_t node        = 0;
+            for (size_t j = 0; j < size; ++j) {
+                const auto c = static_cast<uint8_t>(tokens[j].get<char>());
+                size_t next  = npos_;
+                for (const auto& child : nodes[node].children) {
+                    if (child.first() == c) next = child.second();
+                }
+                if (next == npos_) {
+                    next = nodes.size();
+                    nodes[node].children.append(Pair<uint8_t, size_t>{ c, next });
+                    nodes.append(PrefixNode{});
+                }
+                node = next;
+            }
+            nodes[node].patterns.append(i);
+            prefix_sizes.append(size);
+        }
+        TRY(emit_prefix_node(regexes, nodes, prefix_sizes, 0));
+        end_program();
+        return {};
+    }
+    // the text the pattern stands for if it's nothing but plain characters
+    static Optional<String> plain_literal(const Tokens& tokens) {
+        String literal{};
+        for (const auto& token : tokens) {
+            if (!token.contains_type<char>()) return {};
+            literal.append(token.get<char>());
+        }
+        return literal;
+    }
+    // a literal every match contains for the search to skip to, the prefix if it's at least as long as anything
+    // else since it tells exactly where the match starts. nothing if the pattern has no literal
+    static detail::RegexPrefilter prefilter(const Tokens& tokens) {
+        Literals lits = alternation_literals(tokens);
+        if (lits.prefix.size() > 0 && lits.prefix.size() >= lits.required.size()) {
+            return detail::RegexPrefilter{ move(lits.prefix), 0 };
+        }
+        if (lits.required.size() == 0) return {};
+        return detail::RegexPrefilter{ move(lits.required), lits.required_offset };
+    }
+};
+DiscardResult<RegexParseError> Regex::compile() {
+    RegexCompiler forward{ m_program, false };
+    TRY(forward.compile(*m_regex));
+    m_prefilter = RegexCompiler::prefilter(*m_regex);
+    if (!m_prefilter.empty()) m_forward_dfa.enable_skipping();
+    RegexCompiler reverse{ m_reverse, true };
+    return reverse.compile(*m_regex);
+}
+Optional<RegexMatch> Regex::search_with_pikevm(
+StringView text, size_t from, bool anchored, bool with_groups, size_t stop
+) const {
+    if (!m_pikevm.search(m_program, text, from, anchored, false, m_slots, stop)) return {};
+    Vector<size_t> groups{};
+    if (with_groups) {
+        for (size_t i = 2; i < m_slots.size(); ++i) groups.append(m_slots[i]);
+    }
+    return RegexMatch{ text, m_slots[0], m_slots[1], move(groups) };
+}
+bool Regex::match(StringView text) const {
+    const auto scan = m_longest_dfa.scan_forward(m_program, text, 0, true, false);
+    if (scan.gave_up) return m_pikevm.search(m_program, text, 0, true, true, m_slots);
+    return scan.match.has_value() && *scan.match == text.size();
+}
+bool Regex::contains(StringView text) const {
+    const auto scan = m_forward_dfa.scan_forward(m_program, text, 0, false, true, &m_prefilter);
+    if (scan.gave_up) return m_pikevm.search(m_program, text, 0, false, false, m_slots);
+    return scan.match.has_value();
+}
+Optional<RegexMatch> Regex::search(StringView text, size_t from) const {
+    if (from > text.size()) return {};
+    const auto forward = m_forward_dfa.scan_forward(m_program, text, from, false, false, &m_prefilter);
+    if (forward.gave_up) return search_with_pikevm(text, from, false, false);
+    if (!forward.match) return {};
+    // the leftmost match starts where the longest match that ends there backwards does
+    const size_t end    = *forward.match;
+    const auto backward = m_reverse_dfa.scan_reverse(m_reverse, text, from, end);
+    if (backward.gave_up) return search_with_pikevm(text, from, false, false);
+    return RegexMatch{ text, *backward.match, end };
+}
+Optional<RegexMatch> Regex::captures(StringView text, size_t from) const {
+    auto found = search(text, from);
+    if (!found) return {};
+    // the PikeVM only has to look at the match the DFAs found, it starts where it starts and stops where it ends
+    return search_with_pikevm(text, found->begin(), true, true, found->end());
+}
+RegexMatches Regex::find_all(StringView text) const {
+    return RegexMatches{ *this, text };
+}
+Result<RegexSet, RegexParseError> RegexSet::create(Span<const StringView> patterns) {
+    RegexSet set{};
+    for (const auto& pattern : patterns) {
+        TRY_SET(regex, Regex::create(pattern));
+        set.m_regexes.append(move(regex));
+    }
+    set.m_seen.resize(set.m_regexes.size());
+    if (set.m_regexes.size() == 0) return set;
+    Vector<String> literals{};
+    for (const auto& regex : set.m_regexes) {
+        auto literal = RegexCompiler::plain_literal(*regex.m_regex);
+        if (!literal) break;
+        literals.append(move(literal).value());
+    }
+    if (literals.size() == set.m_regexes.size()) {
+        Vector<StringView> views{};
+        for (const auto& literal : literals) views.append(literal.view());
+        set.m_literals = AhoCorasick{ Span<const StringView>{ views.data(), views.size() } };
+        return set;
+    }
+    RegexCompiler compiler{ set.m_program, false };
+    TRY(compiler.compile_set(set.m_regexes));
+    return set;
+}
+bool RegexSet::contains(StringView text) const {
+    if (m_regexes.size() == 0) return false;
+    if (m_literals) return m_literals->contains(text);
+    const auto scan = m_dfa.scan_forward(m_program, text, 0, false, true);
+    if (!scan.gave_up) return scan.match.has_value();
+    for (const auto& regex : m_regexes) {
+        if (regex.contains(text)) return true;
+    }
+    return false;
+}
+void RegexSet::matches(StringView text, Vector<size_t>& matched) const {
+    matched.clear_retain();
+    if (m_regexes.size() == 0) return;
+    if (m_literals) {
+        m_literals->which(text, matched);
+    } else {
+        detail::RegexSetOutput output{ m_seen, matched };
+        const bool done = m_dfa.scan_set(m_program, text, output);
+        for (size_t pattern : matched) m_seen[pattern] = 0;
+        if (!done) {
+            // too many states for the cache, one pattern at a time
+            matched.clear_retain();
+            for (size_t i = 0; i < m_regexes.size(); ++i) {
+                if (m_regexes[i].contains(text)) matched.append(i);
+            }
+        }
+    }
+    sort(matched);
+}
+Vector<size_t> RegexSet::matches(StringView text) const {
+    Vector<size_t> matched{};
+    matches(text, matched);
+    return matched;
+}
+void RegexMatchIterator::advance() {
+    m_current = m_regex->search(m_text, m_next);
+    if (!m_current) return;
+    // an empty match would be found again and again, skip ahead by one
+    m_next = m_current->size() == 0 ? m_current->end() + 1 : m_current->end();
 }
 }    // namespace ARLib
\ No newline at end of file
@@ -0,0 +1,465 @@
+#include "RegexEngine.hpp"
+#include "BitOps.hpp"
+#include "cstring_compat.hpp"
+#include <immintrin.h>
+namespace ARLib {
+namespace detail {
+    size_t RegexPrefilter::find(StringView text, size_t from) const {
+        const size_t size = m_literal.size();
+        if (from > text.size() || text.size() - from < size) return npos_;
+        const char* haystack = text.data();
+        const char* needle   = m_literal.data();
+        const size_t last    = text.size() - size;
+        size_t pos           = from;
+#ifdef __AVX2__
+        // compares the first and the last byte of the literal at 32 positions at once, only the positions where
+        // both are right get compared in full
+        const auto first_byte = _mm256_set1_epi8(needle[0]);
+        const auto last_byte  = _mm256_set1_epi8(needle[size - 1]);
+        for (; pos + 32 <= last + 1; pos += 32) {
+            const auto firsts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + pos));
+            const auto lasts  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + pos + size - 1));
+            auto mask         = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(firsts, first_byte), _mm256_cmpeq_epi8(lasts, last_byte))
+            ));
+            while (mask != 0) {
+                const size_t candidate = pos + internal::trailing_zeros(mask);
+                if (size <= 2 || memcmp(haystack + candidate + 1, needle + 1, size - 2) == 0) return candidate;
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; pos <= last; ++pos) {
+            if (haystack[pos] == needle[0] && memcmp(haystack + pos, needle, size) == 0) return pos;
+        }
+        return npos_;
+    }
+    size_t RegexPrefilter::next_candidate(StringView text, size_t from, size_t& found) const {
+        // found is npos_ once there's no occurrence left
+        if (found == npos_) return npos_;
+        if (found < from || (found == 0 && from == 0)) {
+            found = find(text, from);
+            if (found == npos_) return npos_;
+        }
+        if (m_max_offset == npos_) return from;
+        return found - from > m_max_offset ? found - m_max_offset : from;
+    }
+    void RegexProgram::compute_byte_classes() {
+        // a new class starts at every byte where some set changes from containing the byte to not or the opposite
+        bool boundary[256]{};
+        for (const auto& set : sets) {
+            for (size_t c = 1; c < 256; ++c) {
+                if (set.contains(static_cast<uint8_t>(c)) != set.contains(static_cast<uint8_t>(c - 1))) {
+                    boundary[c] = true;
+                }
+            }
+        }
+        size_t current = 0;
+        class_byte[0]  = 0;
+        for (size_t c = 0; c < 256; ++c) {
+            if (c != 0 && boundary[c]) {
+                ++current;
+                class_byte[current] = static_cast<uint8_t>(c);
+            }
+            byte_class[c] = static_cast<uint8_t>(current);
+        }
+        class_count = current + 1;
+    }
+    void RegexLazyDFA::reset(const RegexProgram& program) {
+        m_stride = program.class_count + 1;
+        m_threads.clear_retain();
+        m_state_begin.clear_retain();
+        m_state_match.clear_retain();
+        m_transitions.clear_retain();
+        m_reported.clear_retain();
+        m_table.clear_retain();
+        m_table.resize(1024);
+        m_state_begin.append(0);
+        for (auto& anchored : m_start) {
+            for (auto& start : anchored) start = unknown;
+        }
+        if (m_visited.size() < program.insts.size()) m_visited.resize(program.insts.size());
+        // the dead state, no threads left, is always the first one
+        m_skip_state             = unknown;
+        Vector<uint32_t> threads = move(m_scratch);
+        bool full                = false;
+        find_or_add_state(program, full);
+        if (m_skipping) {
+            // built right away so that every transition to it gets the flag
+            m_skip_state = (start_state(program, false, false, full) & ~special_mask) / static_cast<uint32_t>(m_stride);
+        }
+        m_scratch = move(threads);
+    }
+    size_t RegexLazyDFA::memory_used() const {
+        return (m_threads.size() + m_transitions.size() + m_table.size() + m_state_begin.size()) * sizeof(uint32_t) +
+               m_state_match.size();
+    }
+    uint32_t RegexLazyDFA::find_or_add_state(const RegexProgram& program, bool& full) {
+        uint32_t hash = 2166136261u;
+        for (uint32_t pc : m_scratch) hash = (hash ^ pc) * 16777619u;
+        const size_t mask = m_table.size() - 1;
+        size_t slot       = hash & mask;
+        auto flags_of     = [this](uint32_t index) {
+            uint32_t value = static_cast<uint32_t>(index * m_stride);
+            if (m_state_match[index] != 0) value |= match_flag;
+            if (index == 0) value |= dead_flag;
+            if (index == m_skip_state) value |= start_flag;
+            return value;
+        };
+        for (; m_table[slot] != 0; slot = (slot + 1) & mask) {
+            const uint32_t index = m_table[slot] - 1;
+            const size_t begin   = m_state_begin[index];
+            const size_t size    = m_state_begin[index + 1] - begin;
+            if (size != m_scratch.size()) continue;
+            bool same = true;
+            for (size_t i = 0; i < size && same; ++i) same = m_threads[begin + i] == m_scratch[i];
+            if (same) return flags_of(index);
+        }
+        const size_t cost = (m_stride + m_scratch.size() + 3) * sizeof(uint32_t);
+        if (m_state_match.size() != 0 && memory_used() + cost > m_memory_limit) {
+            full = true;
+            return unknown;
+        }
+        const uint32_t index = static_cast<uint32_t>(m_state_match.size());
+        bool is_match        = false;
+        for (uint32_t pc : m_scratch) {
+            m_threads.append(pc);
+            is_match = is_match || program.insts[pc].op == RegexOp::Match;
+        }
+        m_state_begin.append(static_cast<uint32_t>(m_threads.size()));
+        m_state_match.append(is_match ? 1 : 0);
+        for (size_t i = 0; i < m_stride; ++i) m_transitions.append(index == 0 ? dead_flag : unknown);
+        m_table[slot] = index + 1;
+        if (m_state_match.size() * 2 > m_table.size()) {
+            // grow the table and put every state back in
+            const size_t new_size = m_table.size() * 2;
+            m_table.clear_retain();
+            m_table.resize(new_size);
+            for (uint32_t state = 0; state < m_state_match.size(); ++state) {
+                uint32_t state_hash = 2166136261u;
+                for (size_t i = m_state_begin[state]; i < m_state_begin[state + 1]; ++i) {
+                    state_hash = (state_hash ^ m_threads[i]) * 16777619u;
+                }
+                size_t new_slot = state_hash & (new_size - 1);
+                while (m_table[new_slot] != 0) new_slot = (new_slot + 1) & (new_size - 1);
+                m_table[new_slot] = state + 1;
+            }
+        }
+        return flags_of(index);
+    }
+    // adds the threads reachable from pc to m_scratch in priority order, true if a match was added and the threads
+    // after it have to be dropped
+    bool RegexLazyDFA::add_closure(const RegexProgram& program, uint32_t pc, bool at_begin, bool at_end) {
+        m_stack.clear_retain();
+        m_stack.append(pc);
+        while (!m_stack.empty()) {
+            pc = m_stack.pop();
+            while (m_visited[pc] != m_generation) {
+                m_visited[pc]         = m_generation;
+                const RegexInst& inst = program.insts[pc];
+                bool follow           = false;
+                switch (inst.op) {
+                    case RegexOp::Split:
+                        m_stack.append(inst.y);
+                        pc     = inst.x;
+                        follow = true;
+                        break;
+                    case RegexOp::Jump:
+                        pc     = inst.x;
+                        follow = true;
+                        break;
+                    case RegexOp::Save:
+                        ++pc;
+                        follow = true;
+                        break;
+                    case RegexOp::AssertBegin:
+                        if (at_begin) {
+                            ++pc;
+                            follow = true;
+                        }
+                        break;
+                    case RegexOp::AssertEnd:
+                        if (at_end) {
+                            ++pc;
+                            follow = true;
+                        } else {
+                            // stays around until it's known whether the input ends here
+                            m_scratch.append(pc);
+                        }
+                        break;
+                    case RegexOp::ByteSet:
+                        m_scratch.append(pc);
+                        break;
+                    case RegexOp::Match:
+                        m_scratch.append(pc);
+                        if (m_leftmost_first) return true;
+                        break;
+                }
+                if (!follow) break;
+            }
+        }
+        return false;
+    }
+    uint32_t RegexLazyDFA::start_state(const RegexProgram& program, bool anchored, bool at_boundary, bool& full) {
+        uint32_t& start = m_start[anchored][at_boundary];
+        if (start != unknown) return start;
+        ++m_generation;
+        m_scratch.clear_retain();
+        add_closure(program, anchored ? program.anchored_start : program.unanchored_start, at_boundary, false);
+        const uint32_t state = find_or_add_state(program, full);
+        if (!full) start = state;
+        return state;
+    }
+    uint32_t RegexLazyDFA::next_state(const RegexProgram& program, uint32_t row, size_t byte_class, bool at_begin,
+                                      bool& full) {
+        const size_t index = row / m_stride;
+        const bool at_end  = byte_class == program.class_count;
+        const uint8_t byte = program.class_byte[at_end ? 0 : byte_class];
+        ++m_generation;
+        m_scratch.clear_retain();
+        for (size_t i = m_state_begin[index]; i < m_state_begin[index + 1]; ++i) {
+            const uint32_t pc     = m_threads[i];
+            const RegexInst& inst = program.insts[pc];
+            bool matched          = false;
+            if (inst.op == RegexOp::Match) {
+                if (m_leftmost_first) break;
+            } else if (at_end) {
+                if (inst.op == RegexOp::AssertEnd) matched = add_closure(program, pc + 1, at_begin, true);
+            } else if (inst.op == RegexOp::ByteSet && program.sets[inst.x].contains(byte)) {
+                matched = add_closure(program, pc + 1, false, false);
+            }
+            if (matched) break;
+        }
+        const uint32_t next = find_or_add_state(program, full);
+        if (!full && !at_begin) m_transitions[row + byte_class] = next;
+        return next;
+    }
+    bool RegexLazyDFA::report(const RegexProgram& program, uint32_t state, RegexSetOutput& output) {
+        const size_t index = (state & ~special_mask) / m_stride;
+        // a state that shows up again has nothing new to say in the same scan
+        if (m_reported.size() <= index) m_reported.resize(m_state_match.size());
+        if (m_reported[index] == m_set_scan) return false;
+        m_reported[index] = m_set_scan;
+        for (size_t i = m_state_begin[index]; i < m_state_begin[index + 1]; ++i) {
+            const RegexInst& inst = program.insts[m_threads[i]];
+            if (inst.op != RegexOp::Match || output.seen[inst.x] != 0) continue;
+            output.seen[inst.x] = 1;
+            output.matched.append(inst.x);
+            --m_set_left;
+        }
+        return m_set_left == 0;
+    }
+    template <bool Reverse>
+    RegexScan RegexLazyDFA::scan(const RegexProgram& program, StringView text, size_t from, size_t to,
+                                 bool anchored, bool earliest, const RegexPrefilter* prefilter,
+                                 RegexSetOutput* output) {
+        if (m_stride == 0) reset(program);
+        const bool skipping = !Reverse && !anchored && m_skipping && prefilter != nullptr;
+        size_t found        = 0;
+        RegexScan result{};
+        size_t bad_resets = 0;
+        size_t reset_at   = Reverse ? to : from;
+        // the cache is full, start over from the state in m_scratch. gives up when the cache gets thrown away
+        // over and over with few bytes scanned in between, the PikeVM is faster than that
+        auto recover = [&](size_t pos, uint32_t& state) {
+            ++m_resets;
+            const size_t scanned = Reverse ? reset_at - pos : pos - reset_at;
+            if (scanned < 10 * m_state_match.size() && ++bad_resets > 3) return false;
+            reset_at = pos;
+            reset(program);
+            bool full = false;
+            state     = find_or_add_state(program, full);
+            return !full;
+        };
+        bool full              = false;
+        const bool at_boundary = Reverse ? to == text.size() : from == 0;
+        uint32_t state         = start_state(program, anchored, at_boundary, full);
+        if (full && !recover(Reverse ? to : from, state)) {
+            result.gave_up = true;
+            return result;
+        }
+        if (state & match_flag) {
+            result.match = Reverse ? to : from;
+            if (earliest || (output && report(program, state, *output))) return result;
+        }
+        if (state & dead_flag) return result;
+        const auto* bytes      = reinterpret_cast<const uint8_t*>(text.data());
+        const uint8_t* classes = program.byte_class;
+        size_t pos             = Reverse ? to : from;
+        uint32_t row           = state & ~special_mask;
+        while (Reverse ? pos > from : pos < to) {
+            if (skipping && row == m_skip_state * m_stride) {
+                // nothing is in progress, no match can start before the next candidate
+                const size_t candidate = prefilter->next_candidate(text, pos, found);
+                if (candidate == npos_) return result;
+                pos = candidate;
+                if (pos == to) break;
+            }
+            // the hot loop, one lookup per byte until a state that's new, matching or dead shows up
+            const uint32_t* table = &m_transitions[0];
+            uint32_t next         = 0;
+            if constexpr (Reverse) {
+                while (pos > from) {
+                    next = table[row + classes[bytes[pos - 1]]];
+                    if (next & special_mask) break;
+                    row = next;
+                    --pos;
+                }
+                if (pos == from) break;
+            } else {
+                while (pos < to) {
+                    next = table[row + classes[bytes[pos]]];
+                    if (next & special_mask) break;
+                    row = next;
+                    ++pos;
+                }
+                if (pos == to) break;
+            }
+            const size_t byte_class = classes[bytes[Reverse ? pos - 1 : pos]];
+            if (next == unknown) {
+                full = false;
+                next = next_state(program, row, byte_class, false, full);
+                if (full && !recover(pos, next)) {
+                    result.gave_up = true;
+                    return result;
+                }
+            }
+            pos = Reverse ? pos - 1 : pos + 1;
+            if (next & dead_flag) return result;
+            if (next & match_flag) {
+                result.match = pos;
+                if (earliest || (output && report(program, next, *output))) return result;
+            }
+            row = next & ~special_mask;
+        }
+        // only a real end of the input satisfies $ (or ^ when reversed)
+        if (Reverse ? from != 0 : to != text.size()) return result;
+        // with an empty input the end is also the start, that one transition isn't kept
+        const bool empty_input = text.size() == 0;
+        uint32_t last          = empty_input ? unknown : m_transitions[row + program.class_count];
+        if (last == unknown) {
+            full = false;
+            last = next_state(program, row, program.class_count, empty_input, full);
+            if (full && !recover(pos, last)) {
+                result.gave_up = true;
+                return result;
+            }
+        }
+        if (last & match_flag) {
+            result.match = pos;
+            if (output) report(program, last, *output);
+        }
+        return result;
+    }
+    RegexScan RegexLazyDFA::scan_forward(const RegexProgram& program, StringView text, size_t from, bool anchored,
+                                         bool earliest, const RegexPrefilter* prefilter) {
+        return scan<false>(program, text, from, text.size(), anchored, earliest, prefilter, nullptr);
+    }
+    RegexScan RegexLazyDFA::scan_reverse(const RegexProgram& program, StringView text, size_t from, size_t to) {
+        return scan<true>(program, text, from, to, true, false, nullptr, nullptr);
+    }
+    bool RegexLazyDFA::scan_set(const RegexProgram& program, StringView text, RegexSetOutput& output) {
+        ++m_set_scan;
+        m_set_left = output.seen.size() - output.matched.size();
+        if (m_set_left == 0) return true;
+        return !scan<false>(program, text, 0, text.size(), false, false, nullptr, &output).gave_up;
+    }
+    void RegexPikeVM::prepare(const RegexProgram& program) {
+        const size_t count = program.insts.size();
+        for (ThreadList* list : { &m_current, &m_next }) {
+            if (list->sparse.size() < count) {
+                list->sparse.resize(count);
+                list->dense.resize(count);
+            }
+            if (list->slots.size() < count * program.slot_count) list->slots.resize(count * program.slot_count);
+            list->size = 0;
+        }
+        if (m_slots.size() < program.slot_count) m_slots.resize(program.slot_count);
+    }
+    void RegexPikeVM::add_thread(const RegexProgram& program, ThreadList& list, uint32_t pc, size_t pos,
+                                 StringView text) {
+        constexpr uint32_t restore = 0xFFFFFFFF;
+        m_stack.clear_retain();
+        m_stack.append(Frame{ pc, 0, 0 });
+        while (!m_stack.empty()) {
+            const Frame frame = m_stack.pop();
+            if (frame.pc == restore) {
+                m_slots[frame.slot] = frame.value;
+                continue;
+            }
+            pc = frame.pc;
+            while (!list.contains(pc)) {
+                const size_t index = list.size++;
+                list.sparse[pc]    = static_cast<uint32_t>(index);
+                list.dense[index]  = pc;
+                const auto& inst   = program.insts[pc];
+                bool follow        = true;
+                switch (inst.op) {
+                    case RegexOp::Jump:
+                        pc = inst.x;
+                        break;
+                    case RegexOp::Split:
+                        m_stack.append(Frame{ inst.y, 0, 0 });
+                        pc = inst.x;
+                        break;
+                    case RegexOp::Save:
+                        m_stack.append(Frame{ restore, inst.x, m_slots[inst.x] });
+                        m_slots[inst.x] = pos;
+                        ++pc;
+                        break;
+                    case RegexOp::AssertBegin:
+                        follow = pos == 0;
+                        ++pc;
+                        break;
+                    case RegexOp::AssertEnd:
+                        follow = pos == text.size();
+                        ++pc;
+                        break;
+                    case RegexOp::ByteSet:
+                    case RegexOp::Match:
+                        for (size_t i = 0; i < program.slot_count; ++i) {
+                            list.slots[index * program.slot_count + i] = m_slots[i];
+                        }
+                        follow = false;
+                        break;
+                }
+                if (!follow) break;
+            }
+        }
+    }
+    bool RegexPikeVM::search(const RegexProgram& program, StringView text, size_t from, bool anchored, bool to_end,
+                             Vector<size_t>& slots, size_t stop) {
+        const size_t last = stop < text.size() ? stop : text.size();
+        prepare(program);
+        const size_t slot_count = program.slot_count;
+        for (size_t i = 0; i < slot_count; ++i) m_slots[i] = npos_;
+        ThreadList* current = &m_current;
+        ThreadList* next    = &m_next;
+        add_thread(program, *current, anchored ? program.anchored_start : program.unanchored_start, from, text);
+        bool matched = false;
+        for (size_t pos = from; current->size != 0; ++pos) {
+            next->size = 0;
+            for (size_t i = 0; i < current->size; ++i) {
+                const auto& inst = program.insts[current->dense[i]];
+                if (inst.op == RegexOp::Match) {
+                    if (to_end && pos != text.size()) continue;
+                    // every thread after this one has less priority, the match is the best they could do
+                    matched = true;
+                    slots.clear_retain();
+                    for (size_t s = 0; s < slot_count; ++s) slots.append(current->slots[i * slot_count + s]);
+                    break;
+                }
+                if (inst.op != RegexOp::ByteSet || pos == last) continue;
+                if (!program.sets[inst.x].contains(static_cast<uint8_t>(text[pos]))) continue;
+                for (size_t s = 0; s < slot_count; ++s) m_slots[s] = current->slots[i * slot_count + s];
+                add_thread(program, *next, current->dense[i] + 1, pos + 1, text);
+            }
+            if (pos == last) break;
+            ThreadList* tmp = current;
+            current         = next;
+            next            = tmp;
+        }
+        return matched;
+    }
+}    // namespace detail
+}    // namespace ARLib
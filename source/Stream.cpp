@@ -44,6 +44,11 @@ Result<String> FileStream::read_line(bool& eof_reached) {
     if (res.is_error()) return Result<String>{ res.to_error()->error_string(), emplace_error };
     return Result<String>{ res.to_ok(), emplace_ok };
 }
+Result<String> FileStream::read_some(size_t n) {
+    auto res = m_file.read_some(n);
+    if (res.is_error()) return Result<String>{ res.to_error()->error_string(), emplace_error };
+    return Result<String>{ res.to_ok(), emplace_ok };
+}
 size_t FileStream::pos() const {
     return m_file.pos();
 }
@@ -181,4 +186,23 @@ Result<String> StringStream::read_line(bool& eof_reached) {
     m_pos    = pos_of_n + 1;
     return { ret, emplace_ok };
 }
-}    // namespace ARLib
\ No newline at end of file
+Result<String> StringStream::read_some(size_t n) {
+    const size_t left = m_pos < m_buffer.size() ? m_buffer.size() - m_pos : 0;
+    if (n > left) { n = left; }
+    auto chunk = m_buffer.substring(m_pos, m_pos + n);
+    m_pos += n;
+    return Result<String>{ move(chunk), emplace_ok };
+}
+void BufferedSink::write_out() {
+    if (!m_error.empty() || m_buffer.size() == 0) return;
+    const Span<const uint8_t> bytes{ reinterpret_cast<const uint8_t*>(m_buffer.data()), m_buffer.size() };
+    auto res = m_stream->write(bytes);
+    if (res.is_error()) m_error = res.to_error()->error_string().str();
+    m_buffer.clear();
+}
+DiscardResult<Error> BufferedSink::flush() {
+    if (m_stream) write_out();
+    if (!m_error.empty()) return Error{ move(m_error).value() };
+    return {};
+}
+}    // namespace ARLib
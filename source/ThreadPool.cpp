@@ -0,0 +1,69 @@
+#ifndef DISABLE_THREADING
+    #include "ThreadPool.hpp"
+namespace ARLib {
+ThreadPool::ThreadPool(size_t thread_count) {
+    m_workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        m_workers.append(Thread{ [this]() { worker_loop(); } });
+    }
+}
+ThreadPool::~ThreadPool() {
+    {
+        UniqueLock lock{ m_mutex };
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    for (auto& worker : m_workers) { worker.join(); }
+}
+bool ThreadPool::pop_task(Function<void()>& task) {
+    if (m_head == m_tasks.size()) return false;
+    task = move(m_tasks[m_head++]);
+    if (m_head == m_tasks.size()) {
+        m_tasks.clear_retain();
+        m_head = 0;
+    } else if (m_head > m_tasks.size() / 2) {
+        // under steady load the queue never runs empty and would only ever grow, move what's left to the front.
+        // fewer tasks are moved than were popped since the last time, so a pop stays O(1) amortized
+        const size_t left = m_tasks.size() - m_head;
+        for (size_t i = 0; i < left; ++i) { m_tasks[i] = move(m_tasks[m_head + i]); }
+        while (m_tasks.size() != left) { m_tasks.pop(); }
+        m_head = 0;
+    }
+    return true;
+}
+void ThreadPool::worker_loop() {
+    while (true) {
+        Function<void()> task;
+        {
+            UniqueLock lock{ m_mutex };
+            // drain whatever is left in the queue before shutting down
+            m_cv.wait(lock, [this]() { return m_stopping || m_head != m_tasks.size(); });
+            if (!pop_task(task)) return;
+        }
+        task();
+    }
+}
+void ThreadPool::submit(Function<void()> task) {
+    {
+        UniqueLock lock{ m_mutex };
+        m_tasks.append(move(task));
+    }
+    m_cv.notify_one();
+}
+bool ThreadPool::run_pending_task() {
+    Function<void()> task;
+    {
+        UniqueLock lock{ m_mutex };
+        if (!pop_task(task)) return false;
+    }
+    task();
+    return true;
+}
+ThreadPool& ThreadPool::global() {
+    // the thread calling into the pool does its share of the work, so one worker less is enough to use every core
+    const auto cores = Thread::hardware_concurrency();
+    static ThreadPool pool{ cores > 1 ? cores - 1 : 1 };
+    return pool;
+}
+}    // namespace ARLib
+#endif
@@ -1,2 +1,104 @@
 #include "Threading.hpp"
-namespace ARLib {}
+namespace ARLib {
+void AdaptiveMutex::lock_contended() noexcept {
+    for (size_t spin = 0; spin < spin_count; ++spin) {
+        uint32_t state = m_state.load(MemoryOrder::Relaxed);
+        if (state == unlocked) {
+            if (m_state.compare_exchange_weak(state, locked, MemoryOrder::Acquire)) { return; }
+        } else if (state == contended) {
+            // somebody is already parked, spinning more is only going to steal the wakeup
+            break;
+        }
+        pause_sync();
+    }
+    // from here on we mark the lock as contended so that unlock() knows it has to wake somebody up
+    while (m_state.exchange(contended, MemoryOrder::Acquire) != unlocked) {
+        m_state.wait(contended, MemoryOrder::Relaxed);
+    }
+}
+uint32_t SharedMutex::spin_read() noexcept {
+    uint32_t state = m_state.load(MemoryOrder::Relaxed);
+    for (size_t spin = 0; spin < spin_count; ++spin) {
+        if (!is_write_locked(state) || has_readers_waiting(state) || has_writers_waiting(state)) { break; }
+        pause_sync();
+        state = m_state.load(MemoryOrder::Relaxed);
+    }
+    return state;
+}
+uint32_t SharedMutex::spin_write() noexcept {
+    uint32_t state = m_state.load(MemoryOrder::Relaxed);
+    for (size_t spin = 0; spin < spin_count; ++spin) {
+        if (is_unlocked(state) || has_writers_waiting(state)) { break; }
+        pause_sync();
+        state = m_state.load(MemoryOrder::Relaxed);
+    }
+    return state;
+}
+void SharedMutex::lock_shared_contended() noexcept {
+    uint32_t state = spin_read();
+    while (true) {
+        if (is_read_lockable(state)) {
+            if (m_state.compare_exchange_weak(state, state + read_locked, MemoryOrder::Acquire)) { return; }
+            continue;
+        }
+        HARD_ASSERT((state & mask) != max_readers, "Too many readers on SharedMutex");
+        if (!has_readers_waiting(state)) {
+            if (!m_state.compare_exchange_strong(state, state | readers_waiting, MemoryOrder::Relaxed)) { continue; }
+        }
+        m_state.wait(state | readers_waiting, MemoryOrder::Relaxed);
+        state = spin_read();
+    }
+}
+void SharedMutex::lock_contended() noexcept {
+    uint32_t state                 = spin_write();
+    uint32_t other_writers_waiting = 0;
+    while (true) {
+        if (is_unlocked(state)) {
+            const uint32_t desired = state | write_locked | other_writers_waiting;
+            if (m_state.compare_exchange_weak(state, desired, MemoryOrder::Acquire)) { return; }
+            continue;
+        }
+        if (!has_writers_waiting(state)) {
+            if (!m_state.compare_exchange_strong(state, state | writers_waiting, MemoryOrder::Relaxed)) { continue; }
+        }
+        // we can't know if we're the only writer waiting, so keep the bit set once we get the lock
+        other_writers_waiting = writers_waiting;
+        ++m_writers_sleeping;
+        // read the notification counter before re-checking the state so that a wakeup can't be missed
+        const uint32_t seq = m_writer_notify.load();
+        state              = m_state.load();
+        if (is_unlocked(state) || !has_writers_waiting(state)) {
+            --m_writers_sleeping;
+            continue;
+        }
+        m_writer_notify.wait(seq);
+        --m_writers_sleeping;
+        state = spin_write();
+    }
+}
+bool SharedMutex::wake_writer() noexcept {
+    ++m_writer_notify;
+    if (m_writers_sleeping.load() == 0) { return false; }
+    m_writer_notify.notify_one();
+    return true;
+}
+void SharedMutex::wake_writer_or_readers(uint32_t state) noexcept {
+    // if the lock gets locked again while we're here, whoever locked it will do the waking on unlock
+    if (state == writers_waiting) {
+        if (m_state.compare_exchange_strong(state, 0, MemoryOrder::Relaxed)) {
+            wake_writer();
+            return;
+        }
+    }
+    // with both readers and writers waiting only a writer gets woken up, the readers keep waiting
+    if (state == (readers_waiting | writers_waiting)) {
+        if (!m_state.compare_exchange_strong(state, readers_waiting, MemoryOrder::Relaxed)) { return; }
+        if (wake_writer()) { return; }
+        // no writer was actually parked, so we can't be sure one will come around to wake the readers
+        state = readers_waiting;
+    }
+    if (state == readers_waiting) {
+        if (m_state.compare_exchange_strong(state, 0, MemoryOrder::Relaxed)) { m_state.notify_all(); }
+    }
+}
+}    // namespace ARLib
@@ -75,6 +75,14 @@ class SRWLockGuard {
     private:
     PthreadMutex* m_locked;
 };
+#ifdef __x86_64__
+bool atomic_wait_compare_16(const void* storage, void* comp, size_t, void*) noexcept {
+    const auto dest              = static_cast<long long*>(const_cast<void*>(storage));
+    const auto cmp               = static_cast<const long long*>(comp);
+    alignas(16) long long tmp[2] = { cmp[0], cmp[1] };
+    return atomic_compare_exchange_nolock(dest, tmp[1], tmp[0], tmp) != 0;
+}
+#endif
 int atomic_wait_for(
 const void* storage, void* cmp, size_t size, void* param, equal_callback_t callback, unsigned long timeout
 ) noexcept {
@@ -128,7 +136,8 @@ void atomic_notify_all(const void* const storage) noexcept {
 }
 int atomic_wait_nolock(volatile void* const storage, void* const comparand, const unsigned long timeout_) {
     TimeSpec timeout = { static_cast<long>(timeout_), 0 };
-    auto res         = syscall(SYS_futex, storage, FUTEX_WAIT_PRIVATE, comparand, &timeout, 0, 0);
+    const int value  = *static_cast<const int*>(comparand);
+    auto res         = syscall(SYS_futex, storage, FUTEX_WAIT_PRIVATE, value, &timeout, 0, 0);
     return static_cast<int>(res);
 }
 void atomic_notify_all_nolock(const void* const storage) noexcept {
@@ -137,139 +146,11 @@ void atomic_notify_all_nolock(const void* const storage) noexcept {
 void atomic_notify_one_nolock(const void* const storage) noexcept {
     syscall(SYS_futex, storage, FUTEX_WAKE_PRIVATE, 1, 0, 0, 0);
 }
-void atomic_store_nolock(volatile char* addend, char value) {
-    __atomic_store_n(addend, value, __ATOMIC_SEQ_CST);
-}
-void atomic_store_nolock(volatile short* addend, short value) {
-    __atomic_store_n(addend, value, __ATOMIC_SEQ_CST);
-}
-void atomic_store_nolock(volatile int* addend, int value) {
-    __atomic_store_n(addend, value, __ATOMIC_SEQ_CST);
-}
-void atomic_store_nolock(volatile long long* addend, long long value) {
-    __atomic_store_n(addend, value, __ATOMIC_SEQ_CST);
-}
-char atomic_load_nolock(const volatile char* addr) {
-    char ret = 0;
-    __atomic_load(addr, &ret, __ATOMIC_SEQ_CST);
-    return ret;
-}
-short atomic_load_nolock(const volatile short* addr) {
-    short ret = 0;
-    __atomic_load(addr, &ret, __ATOMIC_SEQ_CST);
-    return ret;
-}
-int atomic_load_nolock(const volatile int* addr) {
-    int ret = 0;
-    __atomic_load(addr, &ret, __ATOMIC_SEQ_CST);
-    return ret;
-}
-long long atomic_load_nolock(const volatile long long* addr) {
-    long long ret = 0;
-    __atomic_load(addr, &ret, __ATOMIC_SEQ_CST);
-    return ret;
-}
-char atomic_exchange_nolock(volatile char* addr, char value) {
-    return __atomic_exchange_n(addr, value, __ATOMIC_SEQ_CST);
-}
-short atomic_exchange_nolock(volatile short* addr, short value) {
-    return __atomic_exchange_n(addr, value, __ATOMIC_SEQ_CST);
-}
-int atomic_exchange_nolock(volatile int* addr, int value) {
-    return __atomic_exchange_n(addr, value, __ATOMIC_SEQ_CST);
-}
-long long atomic_exchange_nolock(volatile long long* addr, long long value) {
-    return __atomic_exchange_n(addr, value, __ATOMIC_SEQ_CST);
-}
-char atomic_compare_exchange_nolock(volatile char* addr, char value, char comparand) {
-    __atomic_compare_exchange_n(addr, &value, comparand, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
-    return value;
-}
-short atomic_compare_exchange_nolock(volatile short* addr, short value, short comparand) {
-    __atomic_compare_exchange_n(addr, &value, comparand, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
-    return value;
-}
-int atomic_compare_exchange_nolock(volatile int* addr, int value, int comparand) {
-    __atomic_compare_exchange_n(addr, &value, comparand, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
-    return value;
-}
-long long atomic_compare_exchange_nolock(volatile long long* addr, long long value, long long comparand) {
-    __atomic_compare_exchange_n(addr, &value, comparand, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
-    return value;
-}
 void memory_barrier() {
     __sync_synchronize();
 }
 void pause_sync() {
     _mm_pause();
 }
-char atomic_integral_op_nolock(volatile char* addr, char value, AtomicIntegralOp op_type) {
-    switch (op_type) {
-        case AtomicIntegralOp::ExchAdd:
-            return __atomic_fetch_add(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::And:
-            return __atomic_fetch_and(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Or:
-            return __atomic_fetch_or(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Xor:
-            return __atomic_fetch_xor(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Inc:
-            return __atomic_fetch_add(addr, 1, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Dec:
-            return __atomic_fetch_sub(addr, 1, __ATOMIC_SEQ_CST);
-    }
-    arlib_unreachable;
-}
-short atomic_integral_op_nolock(volatile short* addr, short value, AtomicIntegralOp op_type) {
-    switch (op_type) {
-        case AtomicIntegralOp::ExchAdd:
-            return __atomic_fetch_add(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::And:
-            return __atomic_fetch_and(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Or:
-            return __atomic_fetch_or(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Xor:
-            return __atomic_fetch_xor(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Inc:
-            return __atomic_fetch_add(addr, 1, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Dec:
-            return __atomic_fetch_sub(addr, 1, __ATOMIC_SEQ_CST);
-    }
-    arlib_unreachable;
-}
-int atomic_integral_op_nolock(volatile int* addr, int value, AtomicIntegralOp op_type) {
-    switch (op_type) {
-        case AtomicIntegralOp::ExchAdd:
-            return __atomic_fetch_add(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::And:
-            return __atomic_fetch_and(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Or:
-            return __atomic_fetch_or(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Xor:
-            return __atomic_fetch_xor(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Inc:
-            return __atomic_fetch_add(addr, 1, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Dec:
-            return __atomic_fetch_sub(addr, 1, __ATOMIC_SEQ_CST);
-    }
-    arlib_unreachable;
-}
-long long atomic_integral_op_nolock(volatile long long* addr, long long value, AtomicIntegralOp op_type) {
-    switch (op_type) {
-        case AtomicIntegralOp::ExchAdd:
-            return __atomic_fetch_add(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::And:
-            return __atomic_fetch_and(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Or:
-            return __atomic_fetch_or(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Xor:
-            return __atomic_fetch_xor(addr, value, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Inc:
-            return __atomic_fetch_add(addr, 1, __ATOMIC_SEQ_CST);
-        case AtomicIntegralOp::Dec:
-            return __atomic_fetch_sub(addr, 1, __ATOMIC_SEQ_CST);
-    }
-    arlib_unreachable;
-}
 }    // namespace ARLib
 #endif
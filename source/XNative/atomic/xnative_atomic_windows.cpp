@@ -25,13 +25,13 @@ void atomic_lock_acquire(long& lock) {
         }
     }
 }
-void atomic_lock_acquire(SharedMutex* lock) {
+void atomic_lock_acquire(SharedMutexHandle* lock) {
     sharedmutex_lock_exclusive(lock);
 }
 void atomic_lock_release(long& lock) {
     _InterlockedExchange(&lock, 0);
 }
-void atomic_lock_release(SharedMutex* lock) {
+void atomic_lock_release(SharedMutexHandle* lock) {
     sharedmutex_unlock_exclusive(lock);
 }
 struct WaitContext {
@@ -41,7 +41,7 @@ struct WaitContext {
     internal::ConditionVariable condition;
 };
 struct alignas(64) WaitTableEntry {
-    SharedMutex lock           = { 0 };
+    SharedMutexHandle lock     = { 0 };
     WaitContext wait_list_head = { nullptr, nullptr, nullptr, { 0 } };
 
     constexpr WaitTableEntry() noexcept = default;
@@ -70,13 +70,15 @@ struct GuardedWaitContext : WaitContext {
 };
 class SRWLockGuard {
     public:
-    explicit SRWLockGuard(SharedMutex& locked) noexcept : m_locked(&locked) { sharedmutex_lock_exclusive(m_locked); }
+    explicit SRWLockGuard(SharedMutexHandle& locked) noexcept : m_locked(&locked) {
+        sharedmutex_lock_exclusive(m_locked);
+    }
     ~SRWLockGuard() { sharedmutex_unlock_exclusive(m_locked); }
     SRWLockGuard(const SRWLockGuard&)            = delete;
     SRWLockGuard& operator=(const SRWLockGuard&) = delete;
 
     private:
-    SharedMutex* m_locked;
+    SharedMutexHandle* m_locked;
 };
 bool __stdcall atomic_wait_compare_16(const void* storage, void* comp, size_t, void*) noexcept {
     const auto dest              = static_cast<long long*>(const_cast<void*>(storage));
@@ -201,6 +203,11 @@ volatile long long* addr, long long value_high, long long value_low, long long*
 ) {
     return _InterlockedCompareExchange128(addr, value_high, value_low, comparand);
 }
+void atomic_thread_fence(MemoryOrder order) {
+    if (order == MemoryOrder::Relaxed) { return; }
+    _ReadWriteBarrier();
+    if (order == MemoryOrder::SeqCst) { _mm_mfence(); }
+}
 void memory_barrier() {
     _ReadWriteBarrier();
 }
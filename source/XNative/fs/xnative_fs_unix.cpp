@@ -9,6 +9,9 @@
 #include <dirent.h>
 #include <glob.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
 #include "Chrono.hpp"
 namespace ARLib {
 UnixFileInfo::UnixFileInfo(const Path& path) {
@@ -287,5 +290,103 @@ FsString combine_paths(const FsString& p1, const FsString& p2) {
         return p1 + p2;
     }
 }
+// transparent huge pages are 2 MiB with 4 KiB pages, only the parts of a mapping aligned to one can be backed by them
+constexpr static size_t huge_page_size = 2 * 1024 * 1024;
+UnixMappedFile& UnixMappedFile::operator=(UnixMappedFile&& other) noexcept {
+    unmap();
+    m_address       = other.m_address;
+    m_size          = other.m_size;
+    other.m_address = nullptr;
+    other.m_size    = 0;
+    return *this;
+}
+bool UnixMappedFile::map(const Path& path, bool populate, bool huge_pages) {
+    unmap();
+    const int fd = ::open(path.string().data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (!S_ISREG(info.st_mode)) {
+        ::close(fd);
+        errno = EINVAL;
+        return false;
+    }
+    const auto size = static_cast<size_t>(info.st_size);
+    // mmap refuses a length of 0, an empty file is just an empty view
+    if (size == 0) {
+        ::close(fd);
+        return true;
+    }
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (populate) flags |= MAP_POPULATE;
+#endif
+    // for huge pages the file goes at a huge page boundary inside a reservation that's a huge page bigger than it,
+    // the rest of the reservation is given back once the file is in place
+    void* reserved       = MAP_FAILED;
+    size_t reserved_size = 0;
+    void* target         = nullptr;
+    if (huge_pages && size >= huge_page_size) {
+        reserved_size = size + huge_page_size;
+        reserved      = ::mmap(nullptr, reserved_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (reserved != MAP_FAILED) {
+            const auto base = reinterpret_cast<uintptr_t>(reserved);
+            target          = reinterpret_cast<void*>((base + huge_page_size - 1) & ~(huge_page_size - 1));
+            flags |= MAP_FIXED;
+        }
+    }
+    void* address   = ::mmap(target, size, PROT_READ, flags, fd, 0);
+    const int error = errno;
+    // the mapping keeps the file alive on its own
+    ::close(fd);
+    if (reserved != MAP_FAILED) {
+        auto* begin = static_cast<uint8_t*>(reserved);
+        auto* end   = begin + reserved_size;
+        if (address == MAP_FAILED) {
+            ::munmap(reserved, reserved_size);
+        } else {
+            const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            auto* mapped_begin   = static_cast<uint8_t*>(address);
+            auto* mapped_end     = mapped_begin + (size + page_size - 1) / page_size * page_size;
+            if (mapped_begin != begin) ::munmap(begin, static_cast<size_t>(mapped_begin - begin));
+            if (mapped_end != end) ::munmap(mapped_end, static_cast<size_t>(end - mapped_end));
+        }
+    }
+    if (address == MAP_FAILED) {
+        errno = error;
+        return false;
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) ::madvise(address, size, MADV_HUGEPAGE);
+#endif
+    m_address = address;
+    m_size    = size;
+    return true;
+}
+void UnixMappedFile::advise_normal() {
+    if (m_address) ::madvise(m_address, m_size, MADV_NORMAL);
+}
+void UnixMappedFile::advise_sequential() {
+    if (m_address) ::madvise(m_address, m_size, MADV_SEQUENTIAL);
+}
+void UnixMappedFile::advise_random() {
+    if (m_address) ::madvise(m_address, m_size, MADV_RANDOM);
+}
+void UnixMappedFile::will_need(size_t offset, size_t size) {
+    if (!m_address || offset >= m_size) return;
+    if (size > m_size - offset) size = m_size - offset;
+    // madvise wants a page aligned start
+    const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t begin   = offset / page_size * page_size;
+    ::madvise(static_cast<uint8_t*>(m_address) + begin, size + offset - begin, MADV_WILLNEED);
+}
+void UnixMappedFile::unmap() {
+    if (m_address) ::munmap(m_address, m_size);
+    m_address = nullptr;
+    m_size    = 0;
+}
 }    // namespace ARLib
 #endif
@@ -244,5 +244,58 @@ FsString combine_paths(const FsString& p1, const FsString& p2) {
     str.set_size(wstrlen(str.data()));
     return str;
 }
+Win32MappedFile& Win32MappedFile::operator=(Win32MappedFile&& other) noexcept {
+    unmap();
+    m_address       = other.m_address;
+    m_size          = other.m_size;
+    other.m_address = nullptr;
+    other.m_size    = 0;
+    return *this;
+}
+bool Win32MappedFile::map(const Path& path, bool populate, [[maybe_unused]] bool huge_pages) {
+    unmap();
+    // large pages can't back a view of a file on windows, huge_pages doesn't do anything here
+    HANDLE file = CreateFileW(
+    path.string().data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL
+    );
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return false;
+    }
+    const auto size = static_cast<size_t>(file_size.QuadPart);
+    // a mapping of an empty file can't be created, an empty file is just an empty view
+    if (size == 0) {
+        CloseHandle(file);
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) return false;
+    void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    // the view keeps the mapping alive on its own
+    CloseHandle(mapping);
+    if (address == NULL) return false;
+    m_address = address;
+    m_size    = size;
+    if (populate) will_need(0, size);
+    return true;
+}
+// windows has no access pattern hints for views, only prefetching
+void Win32MappedFile::advise_normal() {}
+void Win32MappedFile::advise_sequential() {}
+void Win32MappedFile::advise_random() {}
+void Win32MappedFile::will_need(size_t offset, size_t size) {
+    if (!m_address || offset >= m_size) return;
+    if (size > m_size - offset) size = m_size - offset;
+    WIN32_MEMORY_RANGE_ENTRY range{ static_cast<uint8_t*>(m_address) + offset, size };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+void Win32MappedFile::unmap() {
+    if (m_address) UnmapViewOfFile(m_address);
+    m_address = nullptr;
+    m_size    = 0;
+}
 }    // namespace ARLib
 #endif
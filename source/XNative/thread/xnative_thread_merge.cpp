@@ -44,6 +44,9 @@ void ThreadNative::swap(ThreadT& t1, ThreadT& t2) {
 void ThreadNative::sleep(Micros microseconds) {
     pthread_sleep(microseconds.value);
 }
+unsigned int ThreadNative::hardware_concurrency() {
+    return pthread_hardware_concurrency();
+}
 Pair<MutexT, bool> MutexNative::init() {
     MutexT mtx{};
     auto state = pthread_mutex_init(&mtx, nullptr);
@@ -198,6 +201,9 @@ void ThreadNative::swap(ThreadT& t1, ThreadT& t2) {
 void ThreadNative::sleep(Micros microseconds) {
     thread_sleep_microseconds(microseconds.value);
 }
+unsigned int ThreadNative::hardware_concurrency() {
+    return thread_hardware_concurrency();
+}
 Pair<MutexT, bool> MutexNative::init() {
     MutexT mtx{};
     auto state = mutex_init(&mtx, MutexType::Plain);
@@ -6,6 +6,7 @@
 
 #ifdef UNIX_OR_MINGW
 #include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 namespace ARLib {
 int pthread_sleep(int64_t microseconds) {
@@ -17,6 +18,16 @@ int pthread_sleep(int64_t microseconds) {
     };
     return ::clock_nanosleep(CLOCK_MONOTONIC, 0, &spec, nullptr);    // millis to nano
 }
+unsigned int pthread_hardware_concurrency() {
+#ifndef ON_MINGW
+    // respect the affinity mask (taskset, cgroups cpusets) instead of reporting every core on the machine
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) == 0) { return static_cast<unsigned int>(CPU_COUNT(&set)); }
+#endif
+    const long count = ::sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<unsigned int>(count) : 1;
+}
 int pthread_attr_destroy(PthreadAttr* attr) {
     return ::pthread_attr_destroy(cast<pthread_attr_t*>(attr));
 }
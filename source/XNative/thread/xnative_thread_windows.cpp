@@ -213,24 +213,26 @@ void __cdecl mutex_reset_owner(MutexHandle mutex) {
     mutex->thread_id = static_cast<long>(GetCurrentThreadId());
     ++mutex->count;
 }
-static_assert(sizeof(SharedMutex) == sizeof(SRWLOCK), "SharedMutex must be the same size as SRWLOCK.");
-static_assert(alignof(SharedMutex) == alignof(SRWLOCK), "SharedMutex must be the same alignment as SRWLOCK.");
-void __cdecl sharedmutex_lock_exclusive(SharedMutex* smutex) {
+static_assert(sizeof(SharedMutexHandle) == sizeof(SRWLOCK), "SharedMutexHandle must be the same size as SRWLOCK.");
+static_assert(
+alignof(SharedMutexHandle) == alignof(SRWLOCK), "SharedMutexHandle must be the same alignment as SRWLOCK."
+);
+void __cdecl sharedmutex_lock_exclusive(SharedMutexHandle* smutex) {
     AcquireSRWLockExclusive(cast<PSRWLOCK>(smutex));
 }
-void __cdecl sharedmutex_lock_shared(SharedMutex* smutex) {
+void __cdecl sharedmutex_lock_shared(SharedMutexHandle* smutex) {
     AcquireSRWLockShared(cast<PSRWLOCK>(smutex));
 }
-int __cdecl sharedmutex_try_lock_exclusive(SharedMutex* smutex) {
+int __cdecl sharedmutex_try_lock_exclusive(SharedMutexHandle* smutex) {
     return TryAcquireSRWLockExclusive(cast<PSRWLOCK>(smutex));
 }
-int __cdecl sharedmutex_try_lock_shared(SharedMutex* smutex) {
+int __cdecl sharedmutex_try_lock_shared(SharedMutexHandle* smutex) {
     return TryAcquireSRWLockShared(cast<PSRWLOCK>(smutex));
 }
-void __cdecl sharedmutex_unlock_exclusive(SharedMutex* smutex) {
+void __cdecl sharedmutex_unlock_exclusive(SharedMutexHandle* smutex) {
     ReleaseSRWLockExclusive(cast<PSRWLOCK>(smutex));
 }
-void __cdecl sharedmutex_unlock_shared(SharedMutex* smutex) {
+void __cdecl sharedmutex_unlock_shared(SharedMutexHandle* smutex) {
     ReleaseSRWLockShared(cast<PSRWLOCK>(smutex));
 }
 ThreadState __cdecl cond_init(CondHandle* condition) {
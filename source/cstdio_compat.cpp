@@ -116,6 +116,15 @@ size_t fread(void* buffer, size_t size, size_t count, FILE* fp) {
     return ::fread(buffer, size, count, fp);
 #endif
 }
+int ferror(FILE* fp) {
+#ifdef WINDOWS
+    // the native handles have no error flag, ReadFileGeneric and WriteFileGeneric return EOF instead
+    (void)fp;
+    return 0;
+#else
+    return ::ferror(fp);
+#endif
+}
 size_t fwrite(const void* buffer, size_t size, size_t count, FILE* fp) {
 #ifdef WINDOWS
     return WriteFileGeneric(buffer, size, count, fp);